@@ -18,14 +18,38 @@ class LayrzBle {
   /// [onScan] is a stream of BLE devices detected during a scan.
   Stream<BleDevice> get onScan => LayrzBlePlatform.instance.onScan;
 
+  /// [onScanBatch] is a stream of the BLE devices detected during a batch
+  /// window of a scan, see the `batchInterval` argument of [startScan].
+  Stream<List<BleDevice>> get onScanBatch => LayrzBlePlatform.instance.onScanBatch;
+
+  /// [onScanLost] is a stream of the MAC addresses of the devices forgotten
+  /// during a scan, see the `maxDevices` and `deviceTtl` arguments of [startScan].
+  Stream<String> get onScanLost => LayrzBlePlatform.instance.onScanLost;
+
   /// [onEvent] is a stream of BLE events.
   Stream<BleEvent> get onEvent => LayrzBlePlatform.instance.onEvent;
 
+  /// [onDeviceEvent] is a stream of the connection events of each device,
+  /// carrying its MAC address. This stream is only working on Windows.
+  Stream<BleDeviceEvent> get onDeviceEvent => LayrzBlePlatform.instance.onDeviceEvent;
+
   /// [onNotify] is a stream of BLE notifications.
   /// To add a new notification listener, use [startNotify] method.
   /// This stream will emit the raw bytes of the notification.
   Stream<BleCharacteristicNotification> get onNotify => LayrzBlePlatform.instance.onNotify;
 
+  /// [onMtuChanged] is a stream of the MTU changes of the connected
+  /// devices. This stream is only working on Windows.
+  Stream<BleMtuChanged> get onMtuChanged => LayrzBlePlatform.instance.onMtuChanged;
+
+  /// [onSessionStatus] is a stream of the GATT session status changes of
+  /// the connected devices. This stream is only working on Windows.
+  Stream<BleSessionStatus> get onSessionStatus => LayrzBlePlatform.instance.onSessionStatus;
+
+  /// [onWriteProgress] is a stream of the progress of the
+  /// [writeLongCharacteristic] calls. This stream is only working on Windows.
+  Stream<BleWriteProgress> get onWriteProgress => LayrzBlePlatform.instance.onWriteProgress;
+
   /// [startScan] starts scanning for BLE devices.
   ///
   /// To get the results, you need to set a callback function using
@@ -39,16 +63,122 @@ class LayrzBle {
 
     /// [servicesUuids] is a list of service UUIDs to filter the services to
     /// be discovered.
-    /// This property is only working on Web, other platforms will be ignored.
+    /// This property is only working on Web and Windows, other platforms will be ignored.
     List<String>? servicesUuids,
+
+    /// [filter] is the set of criteria that an advertisement must match to
+    /// be reported.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanFilter? filter,
+
+    /// [batchInterval] enables the batched delivery of the scan results
+    /// through [onScanBatch], collapsing repeated advertisements of the same
+    /// device to the latest one.
+    /// This property is only working on Windows, other platforms will be ignored.
+    Duration? batchInterval,
+
+    /// [maxBatchSize] is the number of devices that forces a batch to be
+    /// delivered before the end of the [batchInterval].
+    /// This property is only working on Windows, other platforms will be ignored.
+    int? maxBatchSize,
+
+    /// [maxDevices] is the maximum number of devices remembered during the
+    /// scan. When the limit is reached, the least recently seen device is
+    /// forgotten and reported through [onScanLost].
+    /// This property is only working on Windows, other platforms will be ignored.
+    int? maxDevices,
+
+    /// [deviceTtl] is the time after which a device that is no longer
+    /// advertising is forgotten and reported through [onScanLost].
+    /// This property is only working on Windows, other platforms will be ignored.
+    Duration? deviceTtl,
+
+    /// [suppression] enables the suppression of repeated advertisements
+    /// that did not change enough to be worth reporting.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanSuppression? suppression,
+
+    /// [packed] delivers the scan results as packed binary records instead
+    /// of maps, decoded from a single buffer. The results are still emitted
+    /// on [onScan] and [onScanBatch].
+    /// This property is only working on Windows, other platforms will be ignored.
+    bool? packed,
+
+    /// [simulation] replaces the radio by deterministic virtual advertisers,
+    /// to load test the scan pipeline, see the `scanAdvertisements` and
+    /// `scanProcessingUs` counters of [getStats].
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanSimulation? simulation,
+
+    /// [replay] replaces the radio by a capture file written with
+    /// [capturePath], played back at the speed it was captured or faster.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanReplay? replay,
+
+    /// [capturePath] appends every received advertisement to a binary
+    /// capture file at this path until the scan stops.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? capturePath,
   }) =>
-      LayrzBlePlatform.instance.startScan(macAddress: macAddress, servicesUuids: servicesUuids);
+      LayrzBlePlatform.instance.startScan(
+        macAddress: macAddress,
+        servicesUuids: servicesUuids,
+        filter: filter,
+        batchInterval: batchInterval,
+        maxBatchSize: maxBatchSize,
+        maxDevices: maxDevices,
+        deviceTtl: deviceTtl,
+        suppression: suppression,
+        packed: packed,
+        simulation: simulation,
+        replay: replay,
+        capturePath: capturePath,
+      );
 
   /// [stopScan] stops scanning for BLE devices.
   ///
   /// This method will stop the streaming of BLE devices.
   Future<bool?> stopScan() => LayrzBlePlatform.instance.stopScan();
 
+  /// [getStats] returns the counters of the native side, like the number
+  /// of scan events emitted and suppressed, the depth of the UI queue, the
+  /// connections and the GATT operations of each kind by status. Latency
+  /// histograms are flattened into `<name>Count`, `<name>MeanUs`,
+  /// `<name>P50Us`, `<name>P90Us`, `<name>P99Us`, `<name>P999Us` and
+  /// `<name>MaxUs`.
+  /// This method is only working on Windows.
+  Future<Map<String, int>> getStats() => LayrzBlePlatform.instance.getStats();
+
+  /// [resetStats] clears the counters and latency histograms returned by
+  /// [getStats].
+  /// This method is only working on Windows.
+  Future<bool?> resetStats() => LayrzBlePlatform.instance.resetStats();
+
+  /// [setLogLevel] sets the lowest [level] logged by the native side,
+  /// [BleLogLevel.info] by default.
+  /// This method is only working on Windows.
+  Future<bool?> setLogLevel(BleLogLevel level) => LayrzBlePlatform.instance.setLogLevel(level);
+
+  /// [getNotifyStats] returns the counters of the buffer of every active
+  /// notification subscription, only the ones of [macAddress] when provided.
+  /// This method is only working on Windows.
+  Future<List<BleNotifyStats>> getNotifyStats({String? macAddress}) =>
+      LayrzBlePlatform.instance.getNotifyStats(macAddress: macAddress);
+
+  /// [configureOperations] sets how the GATT operations of each device are
+  /// scheduled: at most [maxConcurrent] operations run at once, and an
+  /// operation without its own `timeout` fails after [defaultTimeout].
+  /// This method is only working on Windows.
+  Future<bool?> configureOperations({int? maxConcurrent, Duration? defaultTimeout}) =>
+      LayrzBlePlatform.instance.configureOperations(maxConcurrent: maxConcurrent, defaultTimeout: defaultTimeout);
+
+  /// [cancelOperations] cancels the queued and running GATT operations of
+  /// [macAddress] (every device when not provided), only the ones tagged
+  /// [tag] when provided, and returns the number of cancelled operations.
+  /// This method is only working on Windows.
+  Future<int> cancelOperations({String? macAddress, int? tag}) =>
+      LayrzBlePlatform.instance.cancelOperations(macAddress: macAddress, tag: tag);
+
   /// [checkCapabilities] checks if the device supports BLE.
   Future<BleCapabilities> checkCapabilities() => LayrzBlePlatform.instance.checkCapabilities();
 
@@ -60,20 +190,38 @@ class LayrzBle {
   ///
   /// The return value is the new MTU size, after a negotion with
   /// the peripheral.
-  Future<int?> setMtu({required int newMtu}) => LayrzBlePlatform.instance.setMtu(newMtu: newMtu);
+  ///
+  /// [macAddress] selects the connected device on Windows, the last
+  /// connected one when not provided.
+  Future<int?> setMtu({required int newMtu, String? macAddress}) =>
+      LayrzBlePlatform.instance.setMtu(newMtu: newMtu, macAddress: macAddress);
+
+  /// [currentMtu] is the MTU of a connected device as last reported by the
+  /// platform, read without a call to the native side. This property is
+  /// only working on Windows.
+  int? currentMtu({String? macAddress}) => LayrzBlePlatform.instance.currentMtu(macAddress: macAddress);
 
   /// [connect] connects to a BLE device.
+  ///
+  /// On Windows, several devices can be connected at the same time, the
+  /// GATT methods take the `macAddress` of the device to use.
   Future<bool?> connect({required String macAddress}) => LayrzBlePlatform.instance.connect(macAddress: macAddress);
 
-  /// [disconnect] disconnects from any connected BLE device.
-  Future<bool?> disconnect() => LayrzBlePlatform.instance.disconnect();
+  /// [lastConnectTimings] is the per-phase latency breakdown of the last
+  /// successful [connect]. This property is only working on Windows.
+  BleConnectTimings? get lastConnectTimings => LayrzBlePlatform.instance.lastConnectTimings;
+
+  /// [disconnect] disconnects from any connected BLE device, or only from
+  /// [macAddress] when provided (Windows).
+  Future<bool?> disconnect({String? macAddress}) => LayrzBlePlatform.instance.disconnect(macAddress: macAddress);
 
   /// [discoverServices] discovers the services of a BLE device.
   Future<List<BleService>?> discoverServices({
     /// [timeout] is the duration to wait for the services to be discovered.
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
   }) =>
-      LayrzBlePlatform.instance.discoverServices(timeout: timeout);
+      LayrzBlePlatform.instance.discoverServices(timeout: timeout, macAddress: macAddress);
 
   /// [writeCharacteristic] sends a payload to a BLE characteristic.
   ///
@@ -84,6 +232,8 @@ class LayrzBle {
     required Uint8List payload,
     Duration timeout = const Duration(seconds: 30),
     required bool withResponse,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) =>
       LayrzBlePlatform.instance.writeCharacteristic(
         serviceUuid: serviceUuid,
@@ -91,19 +241,59 @@ class LayrzBle {
         payload: payload,
         timeout: timeout,
         withResponse: withResponse,
+        macAddress: macAddress,
+        operation: operation,
+      );
+
+  /// [writeLongCharacteristic] sends a payload of any size to a BLE
+  /// characteristic, split natively in fragments of the negotiated ATT
+  /// payload size and sent back to back. The progress is reported through
+  /// [onWriteProgress]. This method is only working on Windows.
+  ///
+  /// The return value is `true` if every fragment was sent successfully.
+  Future<bool> writeLongCharacteristic({
+    required String serviceUuid,
+    required String characteristicUuid,
+    required Uint8List payload,
+    bool withResponse = true,
+    int? fragmentSize,
+    String? macAddress,
+    BleOperationOptions? operation,
+  }) =>
+      LayrzBlePlatform.instance.writeLongCharacteristic(
+        serviceUuid: serviceUuid,
+        characteristicUuid: characteristicUuid,
+        payload: payload,
+        withResponse: withResponse,
+        fragmentSize: fragmentSize,
+        macAddress: macAddress,
+        operation: operation,
       );
 
   /// [readCharacteristic] reads the value of a BLE characteristic.
   /// The return value is the raw bytes of the characteristic.
   ///
   /// If the characteristic is not readable, this method will return `null`.
+  ///
+  /// [cacheMode] and [maxAge] allow to return the last value read instead of
+  /// reading the device again, and concurrent reads of the same
+  /// characteristic share one read from the device.
+  /// This property is only working on Windows, other platforms will be ignored.
   Future<Uint8List?> readCharacteristic({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
+    BleReadCacheMode? cacheMode,
+    Duration? maxAge,
   }) =>
       LayrzBlePlatform.instance.readCharacteristic(
         serviceUuid: serviceUuid,
         characteristicUuid: characteristicUuid,
+        macAddress: macAddress,
+        operation: operation,
+        cacheMode: cacheMode,
+        maxAge: maxAge,
       );
 
   /// [startNotify] starts listening to notifications from a
@@ -112,19 +302,48 @@ class LayrzBle {
   Future<bool?> startNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    bool? packed,
+    BleNotifyBuffer? buffer,
+    BleOperationOptions? operation,
   }) =>
       LayrzBlePlatform.instance.startNotify(
         serviceUuid: serviceUuid,
         characteristicUuid: characteristicUuid,
+        macAddress: macAddress,
+        packed: packed,
+        buffer: buffer,
+        operation: operation,
       );
 
   /// [stopNotify] stops listening to notifications from a BLE characteristic.
   Future<bool?> stopNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) =>
       LayrzBlePlatform.instance.stopNotify(
         serviceUuid: serviceUuid,
         characteristicUuid: characteristicUuid,
+        macAddress: macAddress,
+        operation: operation,
+      );
+
+  /// [batch] runs a list of GATT operations with a single call to the
+  /// native side, and returns one result per operation, in the same order.
+  /// The failure of an operation does not stop the others.
+  /// This method is only working on Windows.
+  Future<List<BleBatchResult>> batch({
+    required List<BleBatchOperation> operations,
+    String? macAddress,
+    Duration? timeout,
+    BleOperationOptions? operation,
+  }) =>
+      LayrzBlePlatform.instance.batch(
+        operations: operations,
+        macAddress: macAddress,
+        timeout: timeout,
+        operation: operation,
       );
 }
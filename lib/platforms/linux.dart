@@ -65,7 +65,20 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   }
 
   @override
-  Future<bool?> startScan({String? macAddress, List<String>? servicesUuids}) async {
+  Future<bool?> startScan({
+    String? macAddress,
+    List<String>? servicesUuids,
+    BleScanFilter? filter,
+    Duration? batchInterval,
+    int? maxBatchSize,
+    int? maxDevices,
+    Duration? deviceTtl,
+    BleScanSuppression? suppression,
+    bool? packed,
+    BleScanSimulation? simulation,
+    BleScanReplay? replay,
+    String? capturePath,
+  }) async {
     if (_client == null) {
       log("Error initializing BlueZClient");
       return false;
@@ -106,7 +119,7 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   }
 
   @override
-  Future<int?> setMtu({required int newMtu}) async {
+  Future<int?> setMtu({required int newMtu, String? macAddress}) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
       return null;
@@ -177,7 +190,7 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   }
 
   @override
-  Future<bool> disconnect() async {
+  Future<bool> disconnect({String? macAddress}) async {
     _connectedDevice?.disconnect();
     _connectedDevice = null;
     _services.clear();
@@ -189,6 +202,7 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   Future<List<BleService>?> discoverServices({
     Duration timeout = const Duration(seconds: 30),
     List<String>? serviceUuids,
+    String? macAddress,
   }) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
@@ -205,6 +219,8 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
     required Uint8List payload,
     Duration timeout = const Duration(seconds: 30),
     required bool withResponse,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
@@ -237,6 +253,10 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
     required String serviceUuid,
     required String characteristicUuid,
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
+    BleOperationOptions? operation,
+    BleReadCacheMode? cacheMode,
+    Duration? maxAge,
   }) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
@@ -273,6 +293,10 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   Future<bool?> startNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    bool? packed,
+    BleNotifyBuffer? buffer,
+    BleOperationOptions? operation,
   }) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
@@ -321,6 +345,8 @@ class LayrzBlePluginLinux extends LayrzBlePlatform {
   Future<bool?> stopNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) async {
     if (_connectedDevice == null) {
       log("Not connected to any device");
@@ -26,6 +26,16 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
   Future<bool?> startScan({
     String? macAddress,
     List<String>? servicesUuids,
+    BleScanFilter? filter,
+    Duration? batchInterval,
+    int? maxBatchSize,
+    int? maxDevices,
+    Duration? deviceTtl,
+    BleScanSuppression? suppression,
+    bool? packed,
+    BleScanSimulation? simulation,
+    BleScanReplay? replay,
+    String? capturePath,
   }) =>
       throw UnimplementedError('startScan() has not been implemented.');
 
@@ -37,7 +47,8 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
       throw UnimplementedError('checkCapabilities() has not been implemented.');
 
   @override
-  Future<int?> setMtu({required int newMtu}) => throw UnimplementedError('setMtu() has not been implemented.');
+  Future<int?> setMtu({required int newMtu, String? macAddress}) =>
+      throw UnimplementedError('setMtu() has not been implemented.');
 
   @override
   Future<bool?> connect({
@@ -46,11 +57,12 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
       throw UnimplementedError('connect() has not been implemented.');
 
   @override
-  Future<bool?> disconnect() => throw UnimplementedError('disconnect() has not been implemented.');
+  Future<bool?> disconnect({String? macAddress}) => throw UnimplementedError('disconnect() has not been implemented.');
 
   @override
   Future<List<BleService>?> discoverServices({
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
   }) =>
       throw UnimplementedError('discoverServices() has not been implemented.');
 
@@ -61,6 +73,8 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
     required Uint8List payload,
     Duration timeout = const Duration(seconds: 30),
     required bool withResponse,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('writeCharacteristic() has not been implemented.');
 
@@ -69,6 +83,10 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
     required String serviceUuid,
     required String characteristicUuid,
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
+    BleOperationOptions? operation,
+    BleReadCacheMode? cacheMode,
+    Duration? maxAge,
   }) =>
       throw UnimplementedError('readCharacteristic() has not been implemented.');
 
@@ -76,6 +94,10 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
   Future<bool?> startNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    bool? packed,
+    BleNotifyBuffer? buffer,
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('startNotify() has not been implemented.');
 
@@ -83,6 +105,8 @@ class LayrzBlePluginStub extends LayrzBlePlatform {
   Future<bool?> stopNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('stopNotify() has not been implemented.');
 }
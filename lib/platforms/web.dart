@@ -47,7 +47,20 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   }
 
   @override
-  Future<bool?> startScan({String? macAddress, List<String>? servicesUuids}) async {
+  Future<bool?> startScan({
+    String? macAddress,
+    List<String>? servicesUuids,
+    BleScanFilter? filter,
+    Duration? batchInterval,
+    int? maxBatchSize,
+    int? maxDevices,
+    Duration? deviceTtl,
+    BleScanSuppression? suppression,
+    bool? packed,
+    BleScanSimulation? simulation,
+    BleScanReplay? replay,
+    String? capturePath,
+  }) async {
     _devices.clear();
     final requestOptions = RequestOptionsBuilder.acceptAllDevices(optionalServices: servicesUuids);
     try {
@@ -68,7 +81,7 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   Future<bool?> stopScan() => Future.value(true);
 
   @override
-  Future<int?> setMtu({required int newMtu}) async {
+  Future<int?> setMtu({required int newMtu, String? macAddress}) async {
     log("Feature not supported on Web");
     return null;
   }
@@ -122,7 +135,7 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   }
 
   @override
-  Future<bool?> disconnect() async {
+  Future<bool?> disconnect({String? macAddress}) async {
     if (_currentConnected == null) {
       log("No device connected");
       return true;
@@ -138,6 +151,7 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   Future<List<BleService>?> discoverServices({
     Duration timeout = const Duration(seconds: 30),
     List<String>? serviceUuids,
+    String? macAddress,
   }) async {
     if (_currentConnected == null) {
       log("No device connected");
@@ -154,6 +168,8 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
     required Uint8List payload,
     Duration timeout = const Duration(seconds: 30),
     required bool withResponse,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) async {
     if (_currentConnected == null) {
       log("No device connected");
@@ -193,6 +209,10 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
     required String serviceUuid,
     required String characteristicUuid,
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
+    BleOperationOptions? operation,
+    BleReadCacheMode? cacheMode,
+    Duration? maxAge,
   }) async {
     if (_currentConnected == null) {
       log("No device connected");
@@ -225,6 +245,10 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   Future<bool?> startNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    bool? packed,
+    BleNotifyBuffer? buffer,
+    BleOperationOptions? operation,
   }) async {
     if (_currentConnected == null) {
       log("No device connected");
@@ -263,6 +287,8 @@ class LayrzBlePluginWeb extends LayrzBlePlatform {
   Future<bool?> stopNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) async {
     if (_currentConnected == null) {
       log("No device connected");
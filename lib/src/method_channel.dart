@@ -2,6 +2,7 @@ import 'dart:async';
 
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
+import 'package:layrz_ble/src/packed_events.dart';
 import 'package:layrz_ble/src/types.dart';
 import 'package:layrz_models/layrz_models.dart';
 
@@ -18,38 +19,60 @@ class LayrzBleNative extends LayrzBlePlatform {
       switch (call.method) {
         case 'onScan':
           try {
-            final args = Map<String, dynamic>.from(call.arguments);
-            if (args['serviceData'] == null) {
-              args['serviceData'] = [];
-            }
-
-            final serviceData = args['serviceData'].map((e) {
-              return Map<String, dynamic>.from(e);
-            }).toList();
-
-            args['serviceData'] = serviceData;
+            final device = _parseDevice(call.arguments);
+            _scanController.add(device);
+          } catch (e) {
+            log('Error parsing BleDevice: $e - ${call.arguments}');
+          }
+          break;
 
-            if (args['manufacturerData'] == null) {
-              args['manufacturerData'] = [];
+        case 'onScanBatch':
+          final List<BleDevice> devices = [];
+          for (final raw in call.arguments as List) {
+            try {
+              final device = _parseDevice(raw);
+              devices.add(device);
+              _scanController.add(device);
+            } catch (e) {
+              log('Error parsing BleDevice: $e - $raw');
             }
+          }
+          _scanBatchController.add(devices);
+          break;
 
-            final manufacturerData = args['manufacturerData'].map((e) {
-              return Map<String, dynamic>.from(e);
-            }).toList();
-
-            args['manufacturerData'] = manufacturerData;
-
-            final device = BleDevice.fromJson(args);
-            _scanController.add(device);
+        case 'onScanPacked':
+        case 'onScanBatchPacked':
+          final List<BleDevice> packedDevices = [];
+          try {
+            for (final raw in BlePackedDecoder.decodeScan(call.arguments as Uint8List)) {
+              final device = _parseDevice(raw);
+              packedDevices.add(device);
+              _scanController.add(device);
+            }
           } catch (e) {
-            log('Error parsing BleDevice: $e - ${call.arguments}');
+            log('Error parsing packed BleDevice: $e');
           }
+          if (call.method == 'onScanBatchPacked') _scanBatchController.add(packedDevices);
+          break;
+
+        case 'onScanLost':
+          _scanLostController.add(call.arguments as String);
           break;
 
         case 'onEvent':
           try {
-            final event = BleEvent.fromPlatform(call.arguments);
-            _eventController.add(event);
+            if (call.arguments is Map) {
+              final event = BleDeviceEvent.fromMap(Map<String, dynamic>.from(call.arguments));
+              if (event.event == BleEvent.disconnected) {
+                _handles.remove(event.macAddress.toLowerCase());
+                _mtus.remove(event.macAddress.toLowerCase());
+              }
+              _deviceEventController.add(event);
+              _eventController.add(event.event);
+            } else {
+              final event = BleEvent.fromPlatform(call.arguments);
+              _eventController.add(event);
+            }
           } catch (e) {
             log('Error parsing BleEvent: $e');
           }
@@ -64,6 +87,42 @@ class LayrzBleNative extends LayrzBlePlatform {
           }
           break;
 
+        case 'onNotifyPacked':
+          try {
+            _notifyController.add(BlePackedDecoder.decodeNotify(call.arguments as Uint8List));
+          } catch (e) {
+            log('Error parsing packed BleCharacteristicNotification: $e');
+          }
+          break;
+
+        case 'onMtuChanged':
+          try {
+            final change = BleMtuChanged.fromMap(Map<String, dynamic>.from(call.arguments));
+            _mtus[change.macAddress.toLowerCase()] = change.mtu;
+            _mtuChangedController.add(change);
+          } catch (e) {
+            log('Error parsing BleMtuChanged: $e');
+          }
+          break;
+
+        case 'onSessionStatus':
+          try {
+            final status = BleSessionStatus.fromMap(Map<String, dynamic>.from(call.arguments));
+            _sessionStatusController.add(status);
+          } catch (e) {
+            log('Error parsing BleSessionStatus: $e');
+          }
+          break;
+
+        case 'onWriteProgress':
+          try {
+            final progress = BleWriteProgress.fromMap(Map<String, dynamic>.from(call.arguments));
+            _writeProgressController.add(progress);
+          } catch (e) {
+            log('Error parsing BleWriteProgress: $e');
+          }
+          break;
+
         default:
           log('Unknown method: ${call.method}');
           break;
@@ -71,6 +130,31 @@ class LayrzBleNative extends LayrzBlePlatform {
     });
   }
 
+  BleDevice _parseDevice(dynamic raw) {
+    final args = Map<String, dynamic>.from(raw);
+    if (args['serviceData'] == null) {
+      args['serviceData'] = [];
+    }
+
+    final serviceData = args['serviceData'].map((e) {
+      return Map<String, dynamic>.from(e);
+    }).toList();
+
+    args['serviceData'] = serviceData;
+
+    if (args['manufacturerData'] == null) {
+      args['manufacturerData'] = [];
+    }
+
+    final manufacturerData = args['manufacturerData'].map((e) {
+      return Map<String, dynamic>.from(e);
+    }).toList();
+
+    args['manufacturerData'] = manufacturerData;
+
+    return BleDevice.fromJson(args);
+  }
+
   final checkCapabilitiesChannel = const MethodChannel('com.layrz.ble.checkCapabilities');
   final startScanChannel = const MethodChannel('com.layrz.ble.startScan');
   final stopScanChannel = const MethodChannel('com.layrz.ble.stopScan');
@@ -79,34 +163,137 @@ class LayrzBleNative extends LayrzBlePlatform {
   final discoverServicesChannel = const MethodChannel('com.layrz.ble.discoverServices');
   final setMtuChannel = const MethodChannel('com.layrz.ble.setMtu');
   final writeCharacteristicChannel = const MethodChannel('com.layrz.ble.writeCharacteristic');
+  final writeLongCharacteristicChannel = const MethodChannel('com.layrz.ble.writeLongCharacteristic');
   final readCharacteristicChannel = const MethodChannel('com.layrz.ble.readCharacteristic');
   final startNotifyChannel = const MethodChannel('com.layrz.ble.startNotify');
   final stopNotifyChannel = const MethodChannel('com.layrz.ble.stopNotify');
+  final getStatsChannel = const MethodChannel('com.layrz.ble.getStats');
+  final resetStatsChannel = const MethodChannel('com.layrz.ble.resetStats');
+  final setLogLevelChannel = const MethodChannel('com.layrz.ble.setLogLevel');
+  final getNotifyStatsChannel = const MethodChannel('com.layrz.ble.getNotifyStats');
+  final configureOperationsChannel = const MethodChannel('com.layrz.ble.configureOperations');
+  final cancelOperationsChannel = const MethodChannel('com.layrz.ble.cancelOperations');
+  final batchChannel = const MethodChannel('com.layrz.ble.batch');
   final eventsChannel = const MethodChannel('com.layrz.ble.events');
 
   final StreamController<BleDevice> _scanController = StreamController<BleDevice>.broadcast();
+  final StreamController<List<BleDevice>> _scanBatchController = StreamController<List<BleDevice>>.broadcast();
+  final StreamController<String> _scanLostController = StreamController<String>.broadcast();
   final StreamController<BleEvent> _eventController = StreamController<BleEvent>.broadcast();
+  final StreamController<BleDeviceEvent> _deviceEventController = StreamController<BleDeviceEvent>.broadcast();
   final StreamController<BleCharacteristicNotification> _notifyController =
       StreamController<BleCharacteristicNotification>.broadcast();
+  final StreamController<BleMtuChanged> _mtuChangedController = StreamController<BleMtuChanged>.broadcast();
+  final StreamController<BleSessionStatus> _sessionStatusController = StreamController<BleSessionStatus>.broadcast();
+  final StreamController<BleWriteProgress> _writeProgressController = StreamController<BleWriteProgress>.broadcast();
 
   @override
   Stream<BleDevice> get onScan => _scanController.stream;
 
+  @override
+  Stream<List<BleDevice>> get onScanBatch => _scanBatchController.stream;
+
+  @override
+  Stream<String> get onScanLost => _scanLostController.stream;
+
   @override
   Stream<BleEvent> get onEvent => _eventController.stream;
 
+  @override
+  Stream<BleDeviceEvent> get onDeviceEvent => _deviceEventController.stream;
+
   @override
   Stream<BleCharacteristicNotification> get onNotify => _notifyController.stream;
 
   @override
-  Future<bool?> startScan({String? macAddress, List<String>? servicesUuids}) => startScanChannel.invokeMethod<bool>(
+  Stream<BleMtuChanged> get onMtuChanged => _mtuChangedController.stream;
+
+  @override
+  Stream<BleSessionStatus> get onSessionStatus => _sessionStatusController.stream;
+
+  @override
+  Stream<BleWriteProgress> get onWriteProgress => _writeProgressController.stream;
+
+  @override
+  Future<bool?> startScan({
+    String? macAddress,
+    List<String>? servicesUuids,
+    BleScanFilter? filter,
+    Duration? batchInterval,
+    int? maxBatchSize,
+    int? maxDevices,
+    Duration? deviceTtl,
+    BleScanSuppression? suppression,
+    bool? packed,
+    BleScanSimulation? simulation,
+    BleScanReplay? replay,
+    String? capturePath,
+  }) =>
+      startScanChannel.invokeMethod<bool>(
         'startScan',
-        {if (macAddress != null) 'macAddress': macAddress},
+        {
+          if (macAddress != null) 'macAddress': macAddress,
+          if (servicesUuids != null) 'servicesUuids': servicesUuids,
+          if (filter != null) 'filter': filter.toMap(),
+          if (batchInterval != null) 'batchInterval': batchInterval.inMilliseconds,
+          if (maxBatchSize != null) 'maxBatchSize': maxBatchSize,
+          if (maxDevices != null) 'maxDevices': maxDevices,
+          if (deviceTtl != null) 'deviceTtl': deviceTtl.inMilliseconds,
+          if (suppression != null) 'suppression': suppression.toMap(),
+          if (packed != null) 'packed': packed,
+          if (simulation != null) 'simulation': simulation.toMap(),
+          if (replay != null) 'replay': replay.toMap(),
+          if (capturePath != null) 'capturePath': capturePath,
+        },
       );
 
   @override
   Future<bool?> stopScan() => stopScanChannel.invokeMethod<bool>('stopScan');
 
+  @override
+  Future<Map<String, int>> getStats() async {
+    final result = await getStatsChannel.invokeMethod<Map>('getStats');
+    return Map<String, int>.from(result ?? {});
+  }
+
+  @override
+  Future<bool?> resetStats() => resetStatsChannel.invokeMethod<bool>('resetStats');
+
+  @override
+  Future<bool?> setLogLevel(BleLogLevel level) =>
+      setLogLevelChannel.invokeMethod<bool>('setLogLevel', level.toPlatform());
+
+  @override
+  Future<List<BleNotifyStats>> getNotifyStats({String? macAddress}) async {
+    final result = await getNotifyStatsChannel.invokeMethod<List>(
+      'getNotifyStats',
+      {if (macAddress != null) 'macAddress': macAddress},
+    );
+    return (result ?? []).map((raw) => BleNotifyStats.fromMap(Map<String, dynamic>.from(raw))).toList();
+  }
+
+  @override
+  Future<bool?> configureOperations({int? maxConcurrent, Duration? defaultTimeout}) =>
+      configureOperationsChannel.invokeMethod<bool>(
+        'configureOperations',
+        {
+          if (maxConcurrent != null) 'maxConcurrent': maxConcurrent,
+          if (defaultTimeout != null) 'defaultTimeout': defaultTimeout.inMilliseconds,
+        },
+      );
+
+  @override
+  Future<int> cancelOperations({String? macAddress, int? tag}) async {
+    final result = await cancelOperationsChannel.invokeMethod<int>(
+      'cancelOperations',
+      {
+        if (macAddress != null) 'macAddress': macAddress,
+        if (tag != null) 'tag': tag,
+      },
+    );
+    return result ?? 0;
+  }
+
   @override
   Future<BleCapabilities> checkCapabilities() async {
     debugPrint("Calling");
@@ -135,21 +322,84 @@ class LayrzBleNative extends LayrzBlePlatform {
   }
 
   @override
-  Future<int?> setMtu({required int newMtu}) => setMtuChannel.invokeMethod<int>('setMtu', newMtu);
+  Future<int?> setMtu({required int newMtu, String? macAddress}) => setMtuChannel.invokeMethod<int>(
+        'setMtu',
+        macAddress == null ? newMtu : {'newMtu': newMtu, 'macAddress': macAddress},
+      );
+
+  /// [_handles] maps each `serviceUuid/characteristicUuid` pair of each connected device to the integer handle
+  /// returned by `discoverServices`, when the native side provides one.
+  final Map<String, Map<String, int>> _handles = {};
+
+  /// [_lastConnected] is the device used by the native side when a GATT call has no `macAddress`.
+  String? _lastConnected;
+
+  String _deviceKey(String? macAddress) => (macAddress ?? _lastConnected ?? '').toLowerCase();
+
+  String _handleKey(String serviceUuid, String characteristicUuid) =>
+      '${serviceUuid.toLowerCase()}/${characteristicUuid.toLowerCase()}';
+
+  /// [_characteristicArgs] identifies a characteristic and its device for the native side, by its handle
+  /// when known.
+  Map<String, dynamic> _characteristicArgs(String serviceUuid, String characteristicUuid, String? macAddress) {
+    final handle = _handles[_deviceKey(macAddress)]?[_handleKey(serviceUuid, characteristicUuid)];
+    return {
+      if (macAddress != null) 'macAddress': macAddress,
+      'serviceUuid': serviceUuid,
+      'characteristicUuid': characteristicUuid,
+      if (handle != null) 'handle': handle,
+    };
+  }
+
+  BleConnectTimings? _lastConnectTimings;
+
+  /// [_mtus] is the MTU of each connected device, from `connect` and the `onMtuChanged` events.
+  final Map<String, int> _mtus = {};
+
+  @override
+  int? currentMtu({String? macAddress}) => _mtus[_deviceKey(macAddress)];
 
   @override
-  Future<bool?> connect({required String macAddress}) => connectChannel.invokeMethod<bool>('connect', macAddress);
+  BleConnectTimings? get lastConnectTimings => _lastConnectTimings;
+
+  @override
+  Future<bool?> connect({required String macAddress}) async {
+    _handles.remove(macAddress.toLowerCase());
+    final result = await connectChannel.invokeMethod<dynamic>('connect', macAddress);
+    if (result is Map) {
+      if (result['timings'] != null) {
+        _lastConnectTimings = BleConnectTimings.fromMap(Map<String, dynamic>.from(result['timings']));
+      }
+      if (result['connected'] == true) _lastConnected = macAddress;
+      if (result['mtu'] is int) _mtus[macAddress.toLowerCase()] = result['mtu'];
+      return result['connected'] as bool?;
+    }
+
+    if (result == true) _lastConnected = macAddress;
+    return result as bool?;
+  }
 
   @override
-  Future<bool?> disconnect() => disconnectChannel.invokeMethod<bool>('disconnect');
+  Future<bool?> disconnect({String? macAddress}) {
+    if (macAddress == null) {
+      _handles.clear();
+      _mtus.clear();
+    } else {
+      _handles.remove(macAddress.toLowerCase());
+      _mtus.remove(macAddress.toLowerCase());
+    }
+    return disconnectChannel.invokeMethod<bool>('disconnect', macAddress);
+  }
 
   @override
   Future<List<BleService>?> discoverServices({
     /// [timeout] is the duration to wait for the services to be discovered.
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
   }) async {
     final result = await discoverServicesChannel.invokeMethod<List>('discoverServices', {
       'timeout': timeout.inSeconds,
+      if (macAddress != null) 'macAddress': macAddress,
     });
     if (result == null) {
       log('Error discovering services from native side');
@@ -157,6 +407,7 @@ class LayrzBleNative extends LayrzBlePlatform {
     }
 
     List<BleService> services = [];
+    final handles = _handles[_deviceKey(macAddress)] = {};
 
     for (var service in result) {
       try {
@@ -165,6 +416,9 @@ class LayrzBleNative extends LayrzBlePlatform {
         for (var characteristic in service['characteristics']) {
           try {
             characteristics.add(BleCharacteristic.fromJson(Map<String, dynamic>.from(characteristic)));
+            if (characteristic['handle'] is int) {
+              handles[_handleKey(service['uuid'], characteristic['uuid'])] = characteristic['handle'];
+            }
           } catch (e) {
             log('Error parsing BleCharacteristic: $e');
           }
@@ -188,13 +442,15 @@ class LayrzBleNative extends LayrzBlePlatform {
     required Uint8List payload,
     Duration timeout = const Duration(seconds: 30),
     required bool withResponse,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) async {
     final result = await writeCharacteristicChannel.invokeMethod<bool>('writeCharacteristic', <String, dynamic>{
-      'serviceUuid': serviceUuid,
-      'characteristicUuid': characteristicUuid,
+      ..._characteristicArgs(serviceUuid, characteristicUuid, macAddress),
       'payload': payload,
       'timeout': timeout.inSeconds,
       'withResponse': withResponse,
+      if (operation != null) 'operation': operation.toMap(),
     });
 
     if (result == null) {
@@ -205,16 +461,51 @@ class LayrzBleNative extends LayrzBlePlatform {
     return result;
   }
 
+  @override
+  Future<bool> writeLongCharacteristic({
+    required String serviceUuid,
+    required String characteristicUuid,
+    required Uint8List payload,
+    bool withResponse = true,
+    int? fragmentSize,
+    String? macAddress,
+    BleOperationOptions? operation,
+  }) async {
+    final result = await writeLongCharacteristicChannel.invokeMethod<bool>(
+      'writeLongCharacteristic',
+      <String, dynamic>{
+        ..._characteristicArgs(serviceUuid, characteristicUuid, macAddress),
+        'payload': payload,
+        'withResponse': withResponse,
+        if (fragmentSize != null) 'fragmentSize': fragmentSize,
+        if (operation != null) 'operation': operation.toMap(),
+      },
+    );
+
+    if (result == null) {
+      log('Error sending long payload from native side');
+      return false;
+    }
+
+    return result;
+  }
+
   @override
   Future<Uint8List?> readCharacteristic({
     required String serviceUuid,
     required String characteristicUuid,
     Duration timeout = const Duration(seconds: 30),
+    String? macAddress,
+    BleOperationOptions? operation,
+    BleReadCacheMode? cacheMode,
+    Duration? maxAge,
   }) async {
     final result = await readCharacteristicChannel.invokeMethod<Uint8List>('readCharacteristic', <String, dynamic>{
-      'serviceUuid': serviceUuid,
-      'characteristicUuid': characteristicUuid,
+      ..._characteristicArgs(serviceUuid, characteristicUuid, macAddress),
       'timeout': timeout.inSeconds,
+      if (operation != null) 'operation': operation.toMap(),
+      if (cacheMode != null) 'cacheMode': cacheMode.toPlatform(),
+      if (maxAge != null) 'maxAge': maxAge.inMilliseconds,
     });
 
     if (result == null) {
@@ -229,21 +520,53 @@ class LayrzBleNative extends LayrzBlePlatform {
   Future<bool?> startNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    bool? packed,
+    BleNotifyBuffer? buffer,
+    BleOperationOptions? operation,
   }) {
-    return startNotifyChannel.invokeMethod<bool>('startNotify', <String, String>{
-      'serviceUuid': serviceUuid,
-      'characteristicUuid': characteristicUuid,
-    });
+    return startNotifyChannel.invokeMethod<bool>(
+      'startNotify',
+      {
+        ..._characteristicArgs(serviceUuid, characteristicUuid, macAddress),
+        if (packed != null) 'packed': packed,
+        if (buffer != null) 'buffer': buffer.toMap(),
+        if (operation != null) 'operation': operation.toMap(),
+      },
+    );
   }
 
   @override
   Future<bool?> stopNotify({
     required String serviceUuid,
     required String characteristicUuid,
+    String? macAddress,
+    BleOperationOptions? operation,
   }) {
-    return stopNotifyChannel.invokeMethod<bool>('stopNotify', <String, String>{
-      'serviceUuid': serviceUuid,
-      'characteristicUuid': characteristicUuid,
+    return stopNotifyChannel.invokeMethod<bool>(
+      'stopNotify',
+      {
+        ..._characteristicArgs(serviceUuid, characteristicUuid, macAddress),
+        if (operation != null) 'operation': operation.toMap(),
+      },
+    );
+  }
+
+  @override
+  Future<List<BleBatchResult>> batch({
+    required List<BleBatchOperation> operations,
+    String? macAddress,
+    Duration? timeout,
+    BleOperationOptions? operation,
+  }) async {
+    final result = await batchChannel.invokeMethod<List>('batch', {
+      'operations': operations
+          .map((op) => {..._characteristicArgs(op.serviceUuid, op.characteristicUuid, macAddress), ...op.toMap()})
+          .toList(),
+      if (macAddress != null) 'macAddress': macAddress,
+      if (timeout != null) 'timeout': timeout.inSeconds,
+      if (operation != null) 'operation': operation.toMap(),
     });
+    return (result ?? []).map((raw) => BleBatchResult.fromMap(Map<String, dynamic>.from(raw))).toList();
   }
 }
@@ -0,0 +1,135 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:layrz_ble/src/types.dart';
+
+/// Decoder of the packed scan and notify records sent by the Windows plugin, see `packed_events.h`.
+///
+/// Records are self-delimiting, little-endian, and read straight from the received [Uint8List], the
+/// payloads are views on it instead of copies.
+class BlePackedDecoder {
+  static const int _scanRecord = 1;
+  static const int _notifyRecord = 2;
+
+  static const int _hasName = 0x01;
+  static const int _hasTxPower = 0x02;
+
+  static const int _scanHeaderSize = 18;
+  static const int _notifyHeaderSize = 44;
+
+  static const String _hex = '0123456789abcdef';
+
+  /// [decodeScan] decodes every scan record of [bytes] into the map sent by the non-packed `onScan`.
+  static List<Map<String, dynamic>> decodeScan(Uint8List bytes) {
+    final data = ByteData.sublistView(bytes);
+    final List<Map<String, dynamic>> devices = [];
+
+    int offset = 0;
+    while (offset + _scanHeaderSize <= bytes.length) {
+      final size = data.getUint16(offset, Endian.little);
+      if (size < _scanHeaderSize || offset + size > bytes.length) {
+        throw const FormatException('Truncated packed scan record');
+      }
+
+      if (bytes[offset + 2] == _scanRecord) {
+        devices.add(_decodeScanRecord(bytes, data, offset));
+      }
+      offset += size;
+    }
+
+    return devices;
+  }
+
+  /// [decodeNotify] decodes a notify record.
+  static BleCharacteristicNotification decodeNotify(Uint8List bytes) {
+    final data = ByteData.sublistView(bytes);
+    if (bytes.length < _notifyHeaderSize || bytes[2] != _notifyRecord) {
+      throw const FormatException('Not a packed notify record');
+    }
+
+    final length = data.getUint16(_notifyHeaderSize - 2, Endian.little);
+    if (_notifyHeaderSize + length > bytes.length) {
+      throw const FormatException('Truncated packed notify record');
+    }
+
+    return BleCharacteristicNotification(
+      macAddress: _address(bytes, 4),
+      serviceUuid: _uuid(bytes, 10),
+      characteristicUuid: _uuid(bytes, 26),
+      value: Uint8List.sublistView(bytes, _notifyHeaderSize, _notifyHeaderSize + length),
+    );
+  }
+
+  static Map<String, dynamic> _decodeScanRecord(Uint8List bytes, ByteData data, int start) {
+    final flags = bytes[start + 3];
+    final nameLength = bytes[start + 14];
+    final manufacturerCount = bytes[start + 15];
+    final serviceDataCount = bytes[start + 16];
+
+    int offset = start + _scanHeaderSize;
+    String name = 'Unknown';
+    if (flags & _hasName != 0) {
+      name = utf8.decode(Uint8List.sublistView(bytes, offset, offset + nameLength), allowMalformed: true);
+    }
+    offset += nameLength;
+
+    final List<Map<String, dynamic>> manufacturerData = [];
+    for (int i = 0; i < manufacturerCount; i++) {
+      final companyId = data.getUint16(offset, Endian.little);
+      final length = data.getUint16(offset + 2, Endian.little);
+      offset += 4;
+      manufacturerData.add({
+        'companyId': companyId,
+        'data': Uint8List.sublistView(bytes, offset, offset + length),
+      });
+      offset += length;
+    }
+
+    final List<Map<String, dynamic>> serviceData = [];
+    for (int i = 0; i < serviceDataCount; i++) {
+      final uuidOffset = offset;
+      final length = data.getUint16(offset + 16, Endian.little);
+      offset += 18;
+      serviceData.add({
+        // Same 16-bit form as the non-packed event
+        'uuid': (bytes[uuidOffset + 2] << 8) | bytes[uuidOffset + 3],
+        'fullUuid': _uuid(bytes, uuidOffset),
+        'data': Uint8List.sublistView(bytes, offset, offset + length),
+      });
+      offset += length;
+    }
+
+    return {
+      'macAddress': _address(bytes, start + 4),
+      'name': name,
+      'rssi': data.getInt16(start + 10, Endian.little),
+      if (flags & _hasTxPower != 0) 'txPower': data.getUint16(start + 12, Endian.little),
+      'manufacturerData': manufacturerData,
+      'serviceData': serviceData,
+    };
+  }
+
+  /// 48-bit little-endian address, formatted as aa:bb:cc:dd:ee:ff
+  static String _address(Uint8List bytes, int offset) {
+    final buffer = StringBuffer();
+    for (int i = 5; i >= 0; i--) {
+      final byte = bytes[offset + i];
+      buffer.write(_hex[byte >> 4]);
+      buffer.write(_hex[byte & 0x0F]);
+      if (i > 0) buffer.write(':');
+    }
+    return buffer.toString();
+  }
+
+  /// 16 bytes in canonical order, formatted as the lowercase UUID
+  static String _uuid(Uint8List bytes, int offset) {
+    final buffer = StringBuffer();
+    for (int i = 0; i < 16; i++) {
+      if (i == 4 || i == 6 || i == 8 || i == 10) buffer.write('-');
+      final byte = bytes[offset + i];
+      buffer.write(_hex[byte >> 4]);
+      buffer.write(_hex[byte & 0x0F]);
+    }
+    return buffer.toString();
+  }
+}
@@ -22,15 +22,41 @@ abstract class LayrzBlePlatform extends PlatformInterface {
   /// [onScan] is a stream of BLE devices detected during a scan.
   Stream<BleDevice> get onScan => throw UnimplementedError('_scanSubscription has not been implemented.');
 
+  /// [onScanBatch] is a stream of the BLE devices detected during a batch window of a scan, see the
+  /// `batchInterval` argument of [startScan]. Every device of a batch is also emitted on [onScan].
+  Stream<List<BleDevice>> get onScanBatch =>
+      throw UnimplementedError('_scanBatchSubscription has not been implemented.');
+
+  /// [onScanLost] is a stream of the MAC addresses of the devices forgotten during a scan, see the
+  /// `maxDevices` and `deviceTtl` arguments of [startScan].
+  Stream<String> get onScanLost => throw UnimplementedError('_scanLostSubscription has not been implemented.');
+
   /// [onEvent] is a stream of BLE events.
   Stream<BleEvent> get onEvent => throw UnimplementedError('_eventSubscription has not been implemented.');
 
+  /// [onDeviceEvent] is a stream of the connection events of each device, carrying its MAC address.
+  /// Every event is also emitted on [onEvent].
+  Stream<BleDeviceEvent> get onDeviceEvent =>
+      throw UnimplementedError('_deviceEventSubscription has not been implemented.');
+
   /// [onNotify] is a stream of BLE notifications.
   /// To add a new notification listener, use [startNotify] method.
   /// This stream will emit the raw bytes of the notification.
   Stream<BleCharacteristicNotification> get onNotify =>
       throw UnimplementedError('_notifySubscription has not been implemented.');
 
+  /// [onMtuChanged] is a stream of the MTU changes of the connected devices.
+  Stream<BleMtuChanged> get onMtuChanged =>
+      throw UnimplementedError('_mtuChangedSubscription has not been implemented.');
+
+  /// [onSessionStatus] is a stream of the GATT session status changes of the connected devices.
+  Stream<BleSessionStatus> get onSessionStatus =>
+      throw UnimplementedError('_sessionStatusSubscription has not been implemented.');
+
+  /// [onWriteProgress] is a stream of the progress of the [writeLongCharacteristic] calls.
+  Stream<BleWriteProgress> get onWriteProgress =>
+      throw UnimplementedError('_writeProgressSubscription has not been implemented.');
+
   /// [startScan] starts scanning for BLE devices.
   ///
   /// To get the results, you need to set a callback function using [onScanResult].
@@ -42,8 +68,61 @@ abstract class LayrzBlePlatform extends PlatformInterface {
     String? macAddress,
 
     /// [servicesUuids] is a list of service UUIDs to filter the services to be discovered.
-    /// This property is only working on Web, other platforms will be ignored.
+    /// This property is only working on Web and Windows, other platforms will be ignored.
     List<String>? servicesUuids,
+
+    /// [filter] is the set of criteria that an advertisement must match to be reported.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanFilter? filter,
+
+    /// [batchInterval] enables the batched delivery of the scan results. Within one interval, repeated
+    /// advertisements of the same device are collapsed to the latest one, and the results are delivered
+    /// as a single list through [onScanBatch].
+    /// This property is only working on Windows, other platforms will be ignored.
+    Duration? batchInterval,
+
+    /// [maxBatchSize] is the number of devices that forces a batch to be delivered before the end
+    /// of the [batchInterval].
+    /// This property is only working on Windows, other platforms will be ignored.
+    int? maxBatchSize,
+
+    /// [maxDevices] is the maximum number of devices remembered during the scan. When a new device is
+    /// detected and the limit is reached, the least recently seen device is forgotten and reported
+    /// through [onScanLost].
+    /// This property is only working on Windows, other platforms will be ignored.
+    int? maxDevices,
+
+    /// [deviceTtl] is the time after which a device that is no longer advertising is forgotten and
+    /// reported through [onScanLost]. If this value is not provided, devices are kept until the limit of
+    /// [maxDevices] is reached.
+    /// This property is only working on Windows, other platforms will be ignored.
+    Duration? deviceTtl,
+
+    /// [suppression] enables the suppression of repeated advertisements that did not change enough to be
+    /// worth reporting. If this value is not provided, every advertisement is reported.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanSuppression? suppression,
+
+    /// [packed] delivers the scan results as packed binary records instead of maps, decoded in Dart from
+    /// a single buffer. The results are still emitted on [onScan] and [onScanBatch].
+    /// This property is only working on Windows, other platforms will be ignored.
+    bool? packed,
+
+    /// [simulation] replaces the radio by deterministic virtual advertisers, to load test the scan pipeline.
+    /// The throughput of the pipeline is reported by the `scanAdvertisements` and `scanProcessingUs`
+    /// counters of [getStats].
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanSimulation? simulation,
+
+    /// [replay] replaces the radio by a capture file written with [capturePath], played back through the
+    /// same pipeline at the speed it was captured or faster.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleScanReplay? replay,
+
+    /// [capturePath] appends every received advertisement, before any filtering, to a binary capture file
+    /// at this path until the scan stops. The file can be played back later with [replay].
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? capturePath,
   }) =>
       throw UnimplementedError('startScan() has not been implemented.');
 
@@ -52,6 +131,51 @@ abstract class LayrzBlePlatform extends PlatformInterface {
   /// This method will stop the streaming of BLE devices.
   Future<bool?> stopScan() => throw UnimplementedError('stopScan() has not been implemented.');
 
+  /// [getStats] returns the counters of the native side, like the number of scan events emitted and
+  /// suppressed, the depth of the UI queue, the connections and the GATT operations of each kind by status.
+  ///
+  /// Latency histograms are flattened into `<name>Count`, `<name>MeanUs`, `<name>P50Us`, `<name>P90Us`,
+  /// `<name>P99Us`, `<name>P999Us` and `<name>MaxUs`, for `scanLatency`, `uiWait`, the connect phases
+  /// (`connectAddressResolve`, `connectDatabaseHash`, `connectServiceEnumeration`,
+  /// `connectCharacteristicEnumeration` and `connectTotal`) and each GATT operation (`gattReadLatency`,
+  /// `gattWriteLatency`, `gattWriteLongLatency`, `gattStartNotifyLatency` and `gattStopNotifyLatency`).
+  /// Percentiles are within 12.5% of the measured latency.
+  /// This method is only working on Windows.
+  Future<Map<String, int>> getStats() => throw UnimplementedError('getStats() has not been implemented.');
+
+  /// [resetStats] clears the counters and latency histograms returned by [getStats], to measure from now
+  /// on.
+  /// This method is only working on Windows.
+  Future<bool?> resetStats() => throw UnimplementedError('resetStats() has not been implemented.');
+
+  /// [setLogLevel] sets the lowest [level] logged by the native side, [BleLogLevel.info] by default. The
+  /// logs are written by a background thread, and the disabled levels cost nothing.
+  /// This method is only working on Windows.
+  Future<bool?> setLogLevel(BleLogLevel level) =>
+      throw UnimplementedError('setLogLevel() has not been implemented.');
+
+  /// [getNotifyStats] returns the counters of the buffer of every active notification subscription, only
+  /// the ones of [macAddress] when provided.
+  /// This method is only working on Windows.
+  Future<List<BleNotifyStats>> getNotifyStats({String? macAddress}) =>
+      throw UnimplementedError('getNotifyStats() has not been implemented.');
+
+  /// [configureOperations] sets how the GATT operations of each device are scheduled: at most
+  /// [maxConcurrent] operations run at once (1 by default), and an operation without its own `timeout`
+  /// fails after [defaultTimeout] (30 seconds by default, no timeout when zero).
+  /// This method is only working on Windows.
+  Future<bool?> configureOperations({int? maxConcurrent, Duration? defaultTimeout}) =>
+      throw UnimplementedError('configureOperations() has not been implemented.');
+
+  /// [cancelOperations] cancels the queued and running GATT operations of [macAddress], of every device
+  /// when not provided, only the ones with the [BleOperationOptions.tag] of [tag] when provided. A cancelled
+  /// operation fails with a `PlatformException` of code `CANCELLED`, and one that times out with `TIMEOUT`.
+  ///
+  /// The return value is the number of cancelled operations.
+  /// This method is only working on Windows.
+  Future<int> cancelOperations({String? macAddress, int? tag}) =>
+      throw UnimplementedError('cancelOperations() has not been implemented.');
+
   /// [checkCapabilities] checks if the device supports BLE.
   Future<BleCapabilities> checkCapabilities() =>
       throw UnimplementedError('checkCapabilities() has not been implemented.');
@@ -61,22 +185,50 @@ abstract class LayrzBlePlatform extends PlatformInterface {
   /// Maximum Transmission Unit and it is the maximum size of a packet that can be sent in a single transmission.
   ///
   /// The return value is the new MTU size, after a negotion with the peripheral.
-  Future<int?> setMtu({required int newMtu}) => throw UnimplementedError('setMtu() has not been implemented.');
+  Future<int?> setMtu({
+    /// [newMtu] is the MTU size to request.
+    required int newMtu,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+  }) =>
+      throw UnimplementedError('setMtu() has not been implemented.');
+
+  /// [currentMtu] is the MTU of a connected device as last reported by the platform, without a call to the
+  /// native side, or null when unknown.
+  int? currentMtu({String? macAddress}) => null;
 
   /// [connect] connects to a BLE device.
+  ///
+  /// On Windows, several devices can be connected at the same time. The GATT methods take the `macAddress` of
+  /// the device to use, and the notifications and events carry the address of their device.
   Future<bool?> connect({
     /// [macAddress] is the MAC address or UUID of the device to connect.
     required String macAddress,
   }) =>
       throw UnimplementedError('connect() has not been implemented.');
 
+  /// [lastConnectTimings] is the per-phase latency breakdown of the last successful [connect], or null when
+  /// the platform does not measure it.
+  BleConnectTimings? get lastConnectTimings => null;
+
   /// [disconnect] disconnects from any connected BLE device.
-  Future<bool?> disconnect() => throw UnimplementedError('disconnect() has not been implemented.');
+  Future<bool?> disconnect({
+    /// [macAddress] is the device to disconnect, every connected device when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+  }) =>
+      throw UnimplementedError('disconnect() has not been implemented.');
 
   /// [discoverServices] discovers the services of a BLE device.
   Future<List<BleService>?> discoverServices({
     /// [timeout] is the duration to wait for the services to be discovered.
     Duration timeout = const Duration(seconds: 30),
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
   }) =>
       throw UnimplementedError('discoverServices() has not been implemented.');
 
@@ -98,9 +250,47 @@ abstract class LayrzBlePlatform extends PlatformInterface {
 
     /// [withResponse] is a flag to indicate if the write should be with response or not.
     required bool withResponse,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+
+    /// [operation] sets the priority and the cancellation tag of the operation in the queue of the device.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('writeCharacteristic() has not been implemented.');
 
+  /// [writeLongCharacteristic] sends a payload of any size to a BLE characteristic. The payload is split
+  /// natively in fragments of the negotiated ATT payload size (MTU - 3) that are sent back to back, and the
+  /// progress is reported through [onWriteProgress].
+  ///
+  /// The return value is `true` if every fragment was sent successfully.
+  Future<bool> writeLongCharacteristic({
+    /// [serviceUuid] is the UUID of the service.
+    required String serviceUuid,
+
+    /// [characteristicUuid] is the UUID of the characteristic.
+    required String characteristicUuid,
+
+    /// [payload] is the data to send to the characteristic.
+    required Uint8List payload,
+
+    /// [withResponse] is a flag to indicate if each fragment should be written with response or not.
+    bool withResponse = true,
+
+    /// [fragmentSize] caps the size of each fragment below the negotiated ATT payload size.
+    int? fragmentSize,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    String? macAddress,
+
+    /// [operation] sets the priority and the cancellation tag of the operation in the queue of the device.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleOperationOptions? operation,
+  }) =>
+      throw UnimplementedError('writeLongCharacteristic() has not been implemented.');
+
   /// [readCharacteristic] reads the value of a BLE characteristic.
   /// The return value is the raw bytes of the characteristic.
   ///
@@ -114,6 +304,24 @@ abstract class LayrzBlePlatform extends PlatformInterface {
 
     /// [timeout] is the duration to wait for the characteristic to be read.
     Duration timeout = const Duration(seconds: 30),
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+
+    /// [operation] sets the priority and the cancellation tag of the operation in the queue of the device.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleOperationOptions? operation,
+
+    /// [cacheMode] is how fresh the value must be, [BleReadCacheMode.uncached] when not provided. Concurrent
+    /// reads of the same characteristic share one read from the device, whatever their mode.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleReadCacheMode? cacheMode,
+
+    /// [maxAge] is the oldest cached value returned with [BleReadCacheMode.maxAge], which is implied when
+    /// [cacheMode] is not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    Duration? maxAge,
   }) =>
       throw UnimplementedError('readCharacteristic() has not been implemented.');
 
@@ -125,6 +333,24 @@ abstract class LayrzBlePlatform extends PlatformInterface {
 
     /// [characteristicUuid] is the UUID of the characteristic.
     required String characteristicUuid,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+
+    /// [packed] delivers the notifications as packed binary records instead of maps, decoded in Dart
+    /// from a single buffer. The notifications are still emitted on [onNotify].
+    /// This property is only working on Windows, other platforms will be ignored.
+    bool? packed,
+
+    /// [buffer] bounds the notifications waiting to be delivered, 64 with [BleNotifyOverflow.dropOldest]
+    /// when not provided. The counters of the buffer are returned by [getNotifyStats].
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleNotifyBuffer? buffer,
+
+    /// [operation] sets the priority and the cancellation tag of the operation in the queue of the device.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('startNotify() has not been implemented.');
 
@@ -135,6 +361,37 @@ abstract class LayrzBlePlatform extends PlatformInterface {
 
     /// [characteristicUuid] is the UUID of the characteristic.
     required String characteristicUuid,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    /// This property is only working on Windows, other platforms will be ignored.
+    String? macAddress,
+
+    /// [operation] sets the priority and the cancellation tag of the operation in the queue of the device.
+    /// This property is only working on Windows, other platforms will be ignored.
+    BleOperationOptions? operation,
   }) =>
       throw UnimplementedError('stopNotify() has not been implemented.');
+
+  /// [batch] runs a list of GATT operations with a single call to the native side, back to back or in parallel
+  /// up to the `maxConcurrent` of [configureOperations]. Operations without their own priority keep the order
+  /// of the list.
+  ///
+  /// The return value has one result per operation, in the same order, the failure of an operation does not
+  /// stop the others.
+  /// This method is only working on Windows.
+  Future<List<BleBatchResult>> batch({
+    /// [operations] is the list of operations to run.
+    required List<BleBatchOperation> operations,
+
+    /// [macAddress] is the connected device to use, the last connected one when not provided.
+    String? macAddress,
+
+    /// [timeout] is the duration to wait for each operation, the default timeout of [configureOperations]
+    /// when not provided.
+    Duration? timeout,
+
+    /// [operation] is the priority and the cancellation tag of the operations without their own.
+    BleOperationOptions? operation,
+  }) =>
+      throw UnimplementedError('batch() has not been implemented.');
 }
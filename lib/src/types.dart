@@ -130,7 +130,34 @@ enum BleEvent {
   }
 }
 
+class BleDeviceEvent {
+  /// [macAddress] is the MAC address of the device.
+  final String macAddress;
+
+  /// [event] is what happened to the device.
+  final BleEvent event;
+
+  /// [BleDeviceEvent] is a connection event of one device, when several devices are connected.
+  BleDeviceEvent({
+    required this.macAddress,
+    required this.event,
+  });
+
+  factory BleDeviceEvent.fromMap(Map<String, dynamic> map) {
+    return BleDeviceEvent(
+      macAddress: map['macAddress'],
+      event: BleEvent.fromPlatform(map['event']),
+    );
+  }
+
+  @override
+  String toString() => 'BleDeviceEvent(macAddress: $macAddress, event: $event)';
+}
+
 class BleCharacteristicNotification {
+  /// [macAddress] is the MAC address of the device that sent the notification, when the platform provides it.
+  final String? macAddress;
+
   /// [serviceUuid] is the UUID of the service.
   final String serviceUuid;
 
@@ -141,6 +168,7 @@ class BleCharacteristicNotification {
   final Uint8List value;
 
   BleCharacteristicNotification({
+    this.macAddress,
     required this.serviceUuid,
     required this.characteristicUuid,
     required this.value,
@@ -148,6 +176,7 @@ class BleCharacteristicNotification {
 
   factory BleCharacteristicNotification.fromMap(Map<String, dynamic> map) {
     return BleCharacteristicNotification(
+      macAddress: map['macAddress'],
       serviceUuid: map['serviceUuid'],
       characteristicUuid: map['characteristicUuid'],
       value: Uint8List.fromList(List<int>.from(map['value'])),
@@ -156,7 +185,737 @@ class BleCharacteristicNotification {
 
   @override
   String toString() {
-    return 'BleCharacteristicNotification(serviceUuid: $serviceUuid, '
+    return 'BleCharacteristicNotification(macAddress: $macAddress, serviceUuid: $serviceUuid, '
         'characteristicUuid: $characteristicUuid, value: $value)';
   }
 }
+
+class BleMtuChanged {
+  /// [macAddress] is the MAC address of the device.
+  final String macAddress;
+
+  /// [mtu] is the new ATT MTU of the connection.
+  final int mtu;
+
+  /// [BleMtuChanged] is sent when the MTU of a connection changes.
+  BleMtuChanged({
+    required this.macAddress,
+    required this.mtu,
+  });
+
+  factory BleMtuChanged.fromMap(Map<String, dynamic> map) {
+    return BleMtuChanged(
+      macAddress: map['macAddress'],
+      mtu: map['mtu'],
+    );
+  }
+
+  @override
+  String toString() => 'BleMtuChanged(macAddress: $macAddress, mtu: $mtu)';
+}
+
+class BleSessionStatus {
+  /// [macAddress] is the MAC address of the device.
+  final String macAddress;
+
+  /// [active] is true when the GATT session of the device is open.
+  final bool active;
+
+  /// [error] is the platform error code of the change, 0 when there is none.
+  final int error;
+
+  /// [BleSessionStatus] is sent when the GATT session of a connection opens or closes.
+  BleSessionStatus({
+    required this.macAddress,
+    required this.active,
+    this.error = 0,
+  });
+
+  factory BleSessionStatus.fromMap(Map<String, dynamic> map) {
+    return BleSessionStatus(
+      macAddress: map['macAddress'],
+      active: map['active'] ?? false,
+      error: map['error'] ?? 0,
+    );
+  }
+
+  @override
+  String toString() => 'BleSessionStatus(macAddress: $macAddress, active: $active, error: $error)';
+}
+
+class BleWriteProgress {
+  /// [macAddress] is the MAC address of the device being written.
+  final String? macAddress;
+
+  /// [serviceUuid] is the UUID of the service.
+  final String serviceUuid;
+
+  /// [characteristicUuid] is the UUID of the characteristic.
+  final String characteristicUuid;
+
+  /// [written] is the number of bytes acknowledged so far.
+  final int written;
+
+  /// [total] is the size of the whole payload.
+  final int total;
+
+  /// [done] is true on the last event of the write.
+  final bool done;
+
+  /// [success] is the final status of the write, only meaningful when [done] is true.
+  final bool success;
+
+  /// [BleWriteProgress] is the progress of a `writeLongCharacteristic` call.
+  BleWriteProgress({
+    this.macAddress,
+    required this.serviceUuid,
+    required this.characteristicUuid,
+    required this.written,
+    required this.total,
+    this.done = false,
+    this.success = false,
+  });
+
+  /// [fraction] is the written part of the payload, between 0 and 1.
+  double get fraction => total == 0 ? 1 : written / total;
+
+  factory BleWriteProgress.fromMap(Map<String, dynamic> map) {
+    return BleWriteProgress(
+      macAddress: map['macAddress'],
+      serviceUuid: map['serviceUuid'],
+      characteristicUuid: map['characteristicUuid'],
+      written: map['written'] ?? 0,
+      total: map['total'] ?? 0,
+      done: map['done'] ?? false,
+      success: map['success'] ?? false,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'BleWriteProgress(macAddress: $macAddress, serviceUuid: $serviceUuid, '
+        'characteristicUuid: $characteristicUuid, written: $written, total: $total, done: $done, success: $success)';
+  }
+}
+
+class BleManufacturerDataFilter {
+  /// [companyId] is the company identifier the manufacturer data must belong to.
+  /// If this value is not provided, the manufacturer data of any company will be checked.
+  final int? companyId;
+
+  /// [offset] is the position of the first byte of [data], relative to the manufacturer data
+  /// (without the company identifier).
+  final int offset;
+
+  /// [data] is the byte pattern to look for.
+  final Uint8List data;
+
+  /// [mask] defines the bits of each byte of [data] to compare, must have the same length as [data].
+  /// If this value is not provided, every bit will be compared.
+  final Uint8List? mask;
+
+  /// [BleManufacturerDataFilter] is a masked byte pattern matched against the manufacturer data.
+  BleManufacturerDataFilter({
+    this.companyId,
+    this.offset = 0,
+    required this.data,
+    this.mask,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      if (companyId != null) 'companyId': companyId,
+      'offset': offset,
+      'data': data,
+      if (mask != null) 'mask': mask,
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleManufacturerDataFilter(companyId: $companyId, offset: $offset, data: $data, mask: $mask)';
+  }
+}
+
+class BleScanFilter {
+  /// [macAddresses] is the list of MAC addresses allowed.
+  final List<String>? macAddresses;
+
+  /// [servicesUuids] is the list of advertised service UUIDs allowed, in their 16, 32 or 128-bit form.
+  final List<String>? servicesUuids;
+
+  /// [companyIds] is the list of manufacturer data company identifiers allowed.
+  final List<int>? companyIds;
+
+  /// [namePrefixes] is the list of prefixes allowed for the advertised name.
+  final List<String>? namePrefixes;
+
+  /// [minRssi] is the minimum RSSI (in dBm) for an advertisement to be reported.
+  final int? minRssi;
+
+  /// [manufacturerData] is the list of manufacturer data patterns allowed.
+  final List<BleManufacturerDataFilter>? manufacturerData;
+
+  /// [BleScanFilter] defines the criteria that an advertisement must match to be reported by the scan.
+  ///
+  /// Every criterion provided must match, but any value of a criterion is enough. The filter is
+  /// evaluated on the native side, so rejected advertisements are never sent to Dart.
+  ///
+  /// This filter is only supported on Windows, other platforms will be ignored.
+  BleScanFilter({
+    this.macAddresses,
+    this.servicesUuids,
+    this.companyIds,
+    this.namePrefixes,
+    this.minRssi,
+    this.manufacturerData,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      if (macAddresses != null) 'macAddresses': macAddresses,
+      if (servicesUuids != null) 'servicesUuids': servicesUuids,
+      if (companyIds != null) 'companyIds': companyIds,
+      if (namePrefixes != null) 'namePrefixes': namePrefixes,
+      if (minRssi != null) 'minRssi': minRssi,
+      if (manufacturerData != null) 'manufacturerData': manufacturerData!.map((e) => e.toMap()).toList(),
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleScanFilter(macAddresses: $macAddresses, servicesUuids: $servicesUuids, companyIds: $companyIds, '
+        'namePrefixes: $namePrefixes, minRssi: $minRssi, manufacturerData: $manufacturerData)';
+  }
+}
+
+class BleScanSuppression {
+  /// [rssiHysteresis] is the minimum change of RSSI (in dBm), from the last reported value, worth reporting.
+  /// Values below 1 count as 1, so an identical advertisement at the same RSSI is always suppressed.
+  final int rssiHysteresis;
+
+  /// [maxSilence] is the longest time an unchanged device goes without being reported.
+  final Duration maxSilence;
+
+  /// [BleScanSuppression] defines when a repeated advertisement of a device is worth reporting again.
+  ///
+  /// A device is reported when its name, manufacturer data or service data changed, when its RSSI moved
+  /// by at least [rssiHysteresis], or when it was not reported for [maxSilence]. Every other advertisement
+  /// is suppressed on the native side, see the `scanEventsSuppressed` counter of `getStats`.
+  ///
+  /// This suppression is only supported on Windows, other platforms will be ignored.
+  BleScanSuppression({
+    this.rssiHysteresis = 5,
+    this.maxSilence = const Duration(seconds: 5),
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'rssiHysteresis': rssiHysteresis,
+      'maxSilence': maxSilence.inMilliseconds,
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleScanSuppression(rssiHysteresis: $rssiHysteresis, maxSilence: $maxSilence)';
+  }
+}
+
+class BleConnectTimings {
+  /// [addressResolve] is the time spent resolving the address into a device.
+  final Duration addressResolve;
+
+  /// [databaseHash] is the time spent reading the Database Hash of a device with a cached GATT layout.
+  final Duration databaseHash;
+
+  /// [serviceEnumeration] is the time spent listing the GATT services.
+  final Duration serviceEnumeration;
+
+  /// [characteristicEnumeration] is the time spent listing the characteristics of every service.
+  final Duration characteristicEnumeration;
+
+  /// [total] is the time spent connecting, from the address resolution to the last characteristic.
+  final Duration total;
+
+  /// [cacheHit] is true when the GATT layout was taken from the persistent cache instead of the device.
+  final bool cacheHit;
+
+  /// [BleConnectTimings] is the per-phase latency breakdown of the last successful `connect`.
+  ///
+  /// This breakdown is only supported on Windows.
+  BleConnectTimings({
+    required this.addressResolve,
+    this.databaseHash = Duration.zero,
+    required this.serviceEnumeration,
+    required this.characteristicEnumeration,
+    required this.total,
+    this.cacheHit = false,
+  });
+
+  factory BleConnectTimings.fromMap(Map<String, dynamic> map) {
+    return BleConnectTimings(
+      addressResolve: Duration(microseconds: map['addressResolveUs'] ?? 0),
+      databaseHash: Duration(microseconds: map['databaseHashUs'] ?? 0),
+      serviceEnumeration: Duration(microseconds: map['serviceEnumerationUs'] ?? 0),
+      characteristicEnumeration: Duration(microseconds: map['characteristicEnumerationUs'] ?? 0),
+      total: Duration(microseconds: map['totalUs'] ?? 0),
+      cacheHit: map['cacheHit'] ?? false,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'BleConnectTimings(addressResolve: $addressResolve, databaseHash: $databaseHash, '
+        'serviceEnumeration: $serviceEnumeration, characteristicEnumeration: $characteristicEnumeration, '
+        'total: $total, cacheHit: $cacheHit)';
+  }
+}
+
+enum BleNotifyOverflow {
+  /// [dropOldest] drops the oldest pending notification to make room for the new one.
+  dropOldest,
+
+  /// [dropNewest] drops the new notification.
+  dropNewest,
+
+  /// [coalesceLatest] replaces the newest pending notification, so the latest value is always delivered.
+  coalesceLatest,
+  ;
+
+  @override
+  String toString() => toPlatform();
+
+  String toPlatform() {
+    switch (this) {
+      case BleNotifyOverflow.dropNewest:
+        return 'DROP_NEWEST';
+      case BleNotifyOverflow.coalesceLatest:
+        return 'COALESCE_LATEST';
+      default:
+        return 'DROP_OLDEST';
+    }
+  }
+}
+
+class BleNotifyBuffer {
+  /// [capacity] is the maximum number of notifications of the subscription waiting to be delivered.
+  final int capacity;
+
+  /// [overflow] is what happens to a notification received while [capacity] notifications are pending.
+  final BleNotifyOverflow overflow;
+
+  /// [BleNotifyBuffer] bounds the notifications of a subscription waiting to be delivered to Dart, so a
+  /// busy UI thread drops notifications by the [overflow] policy instead of queueing them without limit.
+  /// The dropped notifications are counted by `getNotifyStats`.
+  ///
+  /// This buffer is only supported on Windows, other platforms will be ignored.
+  BleNotifyBuffer({
+    this.capacity = 64,
+    this.overflow = BleNotifyOverflow.dropOldest,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'capacity': capacity,
+      'overflow': overflow.toPlatform(),
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleNotifyBuffer(capacity: $capacity, overflow: $overflow)';
+  }
+}
+
+class BleNotifyStats {
+  /// [macAddress] is the MAC address of the device.
+  final String macAddress;
+
+  /// [serviceUuid] is the UUID of the service.
+  final String serviceUuid;
+
+  /// [characteristicUuid] is the UUID of the characteristic.
+  final String characteristicUuid;
+
+  /// [capacity] is the capacity of the buffer of the subscription.
+  final int capacity;
+
+  /// [delivered] is the number of notifications delivered to Dart.
+  final int delivered;
+
+  /// [dropped] is the number of notifications dropped or coalesced because the buffer was full.
+  final int dropped;
+
+  /// [peakDepth] is the largest number of notifications that were pending at once.
+  final int peakDepth;
+
+  /// [BleNotifyStats] are the counters of the buffer of one active notification subscription.
+  BleNotifyStats({
+    required this.macAddress,
+    required this.serviceUuid,
+    required this.characteristicUuid,
+    required this.capacity,
+    required this.delivered,
+    required this.dropped,
+    required this.peakDepth,
+  });
+
+  factory BleNotifyStats.fromMap(Map<String, dynamic> map) {
+    return BleNotifyStats(
+      macAddress: map['macAddress'],
+      serviceUuid: map['serviceUuid'],
+      characteristicUuid: map['characteristicUuid'],
+      capacity: map['capacity'] ?? 0,
+      delivered: map['delivered'] ?? 0,
+      dropped: map['dropped'] ?? 0,
+      peakDepth: map['peakDepth'] ?? 0,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'BleNotifyStats(macAddress: $macAddress, serviceUuid: $serviceUuid, '
+        'characteristicUuid: $characteristicUuid, capacity: $capacity, delivered: $delivered, '
+        'dropped: $dropped, peakDepth: $peakDepth)';
+  }
+}
+
+enum BleOperationPriority {
+  /// [control] is for short control writes, started before anything else queued for the device.
+  control,
+
+  /// [normal] is the default of reads.
+  normal,
+
+  /// [bulk] is for long writes and polling reads, started when nothing else is queued for the device.
+  bulk,
+  ;
+
+  @override
+  String toString() => toPlatform();
+
+  String toPlatform() {
+    switch (this) {
+      case BleOperationPriority.control:
+        return 'CONTROL';
+      case BleOperationPriority.bulk:
+        return 'BULK';
+      default:
+        return 'NORMAL';
+    }
+  }
+}
+
+class BleOperationOptions {
+  /// [priority] is the order of the operation in the queue of the device. When not provided, writes and
+  /// notification changes are [BleOperationPriority.control], reads are [BleOperationPriority.normal] and
+  /// long writes are [BleOperationPriority.bulk].
+  final BleOperationPriority? priority;
+
+  /// [tag] groups operations to cancel them together with `cancelOperations`.
+  final int? tag;
+
+  /// [BleOperationOptions] sets how a GATT operation is scheduled among the other operations of its device.
+  ///
+  /// These options are only supported on Windows, other platforms will be ignored.
+  BleOperationOptions({
+    this.priority,
+    this.tag,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      if (priority != null) 'priority': priority!.toPlatform(),
+      if (tag != null) 'tag': tag,
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleOperationOptions(priority: $priority, tag: $tag)';
+  }
+}
+
+enum BleReadCacheMode {
+  /// [uncached] always reads the value from the device.
+  uncached,
+
+  /// [cached] returns the last value read from the device, and reads it when there is none.
+  cached,
+
+  /// [maxAge] returns the last value read from the device when it is not older than the `maxAge` of the read.
+  maxAge,
+  ;
+
+  @override
+  String toString() => toPlatform();
+
+  String toPlatform() {
+    switch (this) {
+      case BleReadCacheMode.cached:
+        return 'CACHED';
+      case BleReadCacheMode.maxAge:
+        return 'MAX_AGE';
+      default:
+        return 'UNCACHED';
+    }
+  }
+}
+
+enum BleBatchOperationType {
+  /// [read] reads the characteristic, its result is the value or null.
+  read,
+
+  /// [write] writes the payload to the characteristic, its result is true when written.
+  write,
+
+  /// [startNotify] starts the notifications of the characteristic, its result is true when started.
+  startNotify,
+
+  /// [stopNotify] stops the notifications of the characteristic, its result is true when stopped.
+  stopNotify,
+  ;
+
+  @override
+  String toString() => toPlatform();
+
+  String toPlatform() {
+    switch (this) {
+      case BleBatchOperationType.write:
+        return 'WRITE';
+      case BleBatchOperationType.startNotify:
+        return 'START_NOTIFY';
+      case BleBatchOperationType.stopNotify:
+        return 'STOP_NOTIFY';
+      default:
+        return 'READ';
+    }
+  }
+}
+
+class BleBatchOperation {
+  /// [type] is the kind of the operation.
+  final BleBatchOperationType type;
+
+  /// [serviceUuid] is the UUID of the service.
+  final String serviceUuid;
+
+  /// [characteristicUuid] is the UUID of the characteristic.
+  final String characteristicUuid;
+
+  /// [payload] is the payload of a [BleBatchOperationType.write].
+  final Uint8List? payload;
+
+  /// [withResponse] is whether a [BleBatchOperationType.write] waits for the response of the device.
+  final bool withResponse;
+
+  /// [cacheMode] is how fresh the value of a [BleBatchOperationType.read] must be, see `readCharacteristic`.
+  final BleReadCacheMode? cacheMode;
+
+  /// [maxAge] is the oldest cached value returned by a [BleBatchOperationType.read], see `readCharacteristic`.
+  final Duration? maxAge;
+
+  /// [operation] sets the priority and the cancellation tag of the operation, the ones of the batch when
+  /// not provided.
+  final BleOperationOptions? operation;
+
+  /// [BleBatchOperation] is one operation of a `batch` call.
+  BleBatchOperation({
+    required this.type,
+    required this.serviceUuid,
+    required this.characteristicUuid,
+    this.payload,
+    this.withResponse = false,
+    this.cacheMode,
+    this.maxAge,
+    this.operation,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'type': type.toPlatform(),
+      if (type == BleBatchOperationType.write) 'payload': payload ?? Uint8List(0),
+      if (type == BleBatchOperationType.write) 'withResponse': withResponse,
+      if (cacheMode != null) 'cacheMode': cacheMode!.toPlatform(),
+      if (maxAge != null) 'maxAge': maxAge!.inMilliseconds,
+      if (operation != null) 'operation': operation!.toMap(),
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleBatchOperation(type: $type, serviceUuid: $serviceUuid, characteristicUuid: $characteristicUuid)';
+  }
+}
+
+class BleBatchResult {
+  /// [value] is the result of the operation, as returned by its own method: the value of a read, or true
+  /// when a write or a notification change succeeded.
+  final dynamic value;
+
+  /// [error] is the code of the error of the operation, like `TIMEOUT` or `CANCELLED`, null on success.
+  final String? error;
+
+  /// [message] is the description of the [error].
+  final String? message;
+
+  /// [BleBatchResult] is the result of one operation of a `batch` call.
+  BleBatchResult({
+    this.value,
+    this.error,
+    this.message,
+  });
+
+  /// [isSuccess] is true when the operation did not fail with an error. A read of a characteristic that
+  /// is not readable still succeeds with a null [value].
+  bool get isSuccess => error == null;
+
+  factory BleBatchResult.fromMap(Map<String, dynamic> map) {
+    return BleBatchResult(
+      value: map['value'],
+      error: map['error'],
+      message: map['message'],
+    );
+  }
+
+  @override
+  String toString() {
+    return 'BleBatchResult(value: $value, error: $error, message: $message)';
+  }
+}
+
+class BleScanSimulation {
+  /// [advertisers] is the number of virtual devices advertising at once.
+  final int advertisers;
+
+  /// [rate] is the number of advertisements per second over every advertiser, 0 to emit them as fast as
+  /// possible.
+  final double rate;
+
+  /// [payloadSize] is the size of the manufacturer data of each advertisement, up to 252 bytes.
+  final int payloadSize;
+
+  /// [churn] is the fraction of the advertisers replaced by new devices every second.
+  final double churn;
+
+  /// [changeRatio] is the fraction of the advertisements whose manufacturer data changed since the
+  /// previous one of the same device.
+  final double changeRatio;
+
+  /// [namedRatio] is the fraction of the advertisers that advertise a local name.
+  final double namedRatio;
+
+  /// [seed] is the seed of the generator, the same seed and settings give the same advertisements.
+  final int seed;
+
+  /// [limit] is the number of advertisements after which the simulation stops, when provided.
+  final int? limit;
+
+  /// [BleScanSimulation] replaces the radio of a scan by deterministic virtual advertisers. Their
+  /// advertisements go through the same filtering, suppression, batching and delivery as real ones, with
+  /// the manufacturer data of the company identifier `0xFFFF`.
+  ///
+  /// This simulation is only supported on Windows, other platforms will be ignored.
+  BleScanSimulation({
+    this.advertisers = 1000,
+    this.rate = 10000,
+    this.payloadSize = 20,
+    this.churn = 0,
+    this.changeRatio = 0.1,
+    this.namedRatio = 0.5,
+    this.seed = 1,
+    this.limit,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'advertisers': advertisers,
+      'rate': rate,
+      'payloadSize': payloadSize,
+      'churn': churn,
+      'changeRatio': changeRatio,
+      'namedRatio': namedRatio,
+      'seed': seed,
+      if (limit != null) 'limit': limit,
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleScanSimulation(advertisers: $advertisers, rate: $rate, payloadSize: $payloadSize, churn: $churn, '
+        'changeRatio: $changeRatio, namedRatio: $namedRatio, seed: $seed, limit: $limit)';
+  }
+}
+
+class BleScanReplay {
+  /// [path] is the capture file, written by a scan started with a `capturePath`.
+  final String path;
+
+  /// [speed] is the playback speed, 1 for the timing of the capture, 10 for ten times faster, 0 to replay
+  /// as fast as possible.
+  final double speed;
+
+  /// [BleScanReplay] replaces the radio of a scan by the advertisements of a capture file. They go
+  /// through the same filtering, suppression, batching and delivery as when they were captured, and the
+  /// scan stops receiving at the end of the file.
+  ///
+  /// This replay is only supported on Windows, other platforms will be ignored.
+  BleScanReplay({
+    required this.path,
+    this.speed = 1,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'path': path,
+      'speed': speed,
+    };
+  }
+
+  @override
+  String toString() {
+    return 'BleScanReplay(path: $path, speed: $speed)';
+  }
+}
+
+enum BleLogLevel {
+  /// [trace] logs everything.
+  trace,
+
+  /// [debug] logs the method calls and the steps of each operation.
+  debug,
+
+  /// [info] logs the scans, connections and subscriptions. This is the default level.
+  info,
+
+  /// [warning] logs the invalid arguments and the operations that could not be done.
+  warning,
+
+  /// [error] logs the failures of the Bluetooth stack only.
+  error,
+
+  /// [off] disables the logs.
+  off,
+  ;
+
+  @override
+  String toString() => toPlatform();
+
+  String toPlatform() {
+    switch (this) {
+      case BleLogLevel.trace:
+        return 'TRACE';
+      case BleLogLevel.debug:
+        return 'DEBUG';
+      case BleLogLevel.warning:
+        return 'WARNING';
+      case BleLogLevel.error:
+        return 'ERROR';
+      case BleLogLevel.off:
+        return 'OFF';
+      default:
+        return 'INFO';
+    }
+  }
+}
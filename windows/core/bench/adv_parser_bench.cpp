@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "adv_parser.h"
+#include "advertisement_corpus.h"
+#include "alloc_counter.h"
+
+namespace layrz_ble::bench {
+  /// @brief Parse one shape of advertisement over and over
+  void BM_ParseAdvertisement(benchmark::State &state) {
+    const auto &payload = advertisementShapes()[static_cast<size_t>(state.range(0))];
+    ByteView bytes(payload.bytes.data(), payload.bytes.size());
+    ParsedAdvertisement parsed;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      parsed.clear();
+      benchmark::DoNotOptimize(parseAdvertisement(bytes, parsed));
+      benchmark::DoNotOptimize(parsed.manufacturerDataCount());
+    }
+    reportPerEvent(state, allocations.count());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * payload.bytes.size()));
+    state.SetLabel(payload.name);
+  }
+  BENCHMARK(BM_ParseAdvertisement)->DenseRange(0, 6);
+
+  /// @brief Parse a corpus mixing every shape over many devices, as the scan ingest thread sees it
+  void BM_ParseCorpus(benchmark::State &state) {
+    auto corpus = advertisementCorpus(static_cast<size_t>(state.range(0)));
+    ParsedAdvertisement parsed;
+    uint64_t events = 0;
+    uint64_t bytes = 0;
+    size_t sections = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (const auto &payload : corpus) {
+        parsed.clear();
+        parseAdvertisement(ByteView(payload.bytes.data(), payload.bytes.size()), parsed);
+        sections += parsed.manufacturerDataCount() + parsed.serviceDataCount() + parsed.Name().size();
+        bytes += payload.bytes.size();
+      }
+      events += corpus.size();
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    benchmark::DoNotOptimize(sections);
+  }
+  BENCHMARK(BM_ParseCorpus)->Arg(4096);
+} // namespace layrz_ble::bench
@@ -0,0 +1,131 @@
+#include "advertisement_corpus.h"
+
+#include <initializer_list>
+#include <string_view>
+
+#include "adv_parser.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    /// @brief Append one length/type/value structure
+    void structure(std::vector<uint8_t> &out, uint8_t type, std::initializer_list<uint8_t> value) {
+      out.push_back(static_cast<uint8_t>(value.size() + 1));
+      out.push_back(type);
+      out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void structure(std::vector<uint8_t> &out, uint8_t type, std::string_view value) {
+      out.push_back(static_cast<uint8_t>(value.size() + 1));
+      out.push_back(type);
+      out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void flags(std::vector<uint8_t> &out) { structure(out, AdType::Flags, {0x06}); }
+
+    std::vector<CorpusPayload> buildShapes() {
+      std::vector<CorpusPayload> shapes;
+
+      {
+        CorpusPayload payload{"ibeacon", 0xC82B96A10001ULL, -71, {}};
+        flags(payload.bytes);
+        structure(payload.bytes, AdType::ManufacturerSpecificData, {
+          0x4C, 0x00, 0x02, 0x15,
+          0xE2, 0xC5, 0x6D, 0xB5, 0xDF, 0xFB, 0x48, 0xD2, 0xB0, 0x60, 0xD0, 0xF5, 0xA7, 0x10, 0x96, 0xE0,
+          0x00, 0x2A, 0x01, 0x07, 0xC5,
+        });
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        CorpusPayload payload{"eddystone-uid", 0xD4F51EA20002ULL, -80, {}};
+        flags(payload.bytes);
+        structure(payload.bytes, AdType::CompleteServices16, {0xAA, 0xFE});
+        structure(payload.bytes, AdType::ServiceData16, {
+          0xAA, 0xFE, 0x00, 0xEE,
+          0x8B, 0x0C, 0x97, 0x99, 0x2B, 0x11, 0x4F, 0x0E, 0x3F, 0x77,
+          0x00, 0x00, 0x00, 0x00, 0x04, 0x2A, 0x00, 0x00,
+        });
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        CorpusPayload payload{"eddystone-url", 0xD4F51EA20003ULL, -62, {}};
+        flags(payload.bytes);
+        structure(payload.bytes, AdType::CompleteServices16, {0xAA, 0xFE});
+        structure(payload.bytes, AdType::ServiceData16, {0xAA, 0xFE, 0x10, 0xEB, 0x03, 'l', 'a', 'y', 'r', 'z', 0x07});
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        // Advertisement with a 128-bit service, scan response with the name and the TX power
+        CorpusPayload payload{"named-sensor", 0xE01F0A3B0004ULL, -58, {}};
+        flags(payload.bytes);
+        structure(payload.bytes, AdType::CompleteServices128, {
+          0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E,
+        });
+        structure(payload.bytes, AdType::CompleteLocalName, std::string_view("LAYRZ-SENSOR-0042"));
+        structure(payload.bytes, AdType::TxPowerLevel, {0x04});
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        CorpusPayload payload{"battery-tag", 0xF2A1B3C40005ULL, -88, {}};
+        flags(payload.bytes);
+        structure(payload.bytes, AdType::IncompleteServices16, {0x0F, 0x18, 0x1A, 0x18});
+        structure(payload.bytes, AdType::ServiceData16, {0x0F, 0x18, 0x5A});
+        structure(payload.bytes, AdType::ServiceData16, {0x1A, 0x18, 0x0B, 0x09, 0x37, 0x14});
+        structure(payload.bytes, AdType::ManufacturerSpecificData, {
+          0xFF, 0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+        });
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        CorpusPayload payload{"phone", 0x5A12E7C90006ULL, -49, {}};
+        structure(payload.bytes, AdType::Flags, {0x1A});
+        structure(payload.bytes, AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x10, 0x05, 0x41, 0x1C, 0x6E, 0x2F, 0x93});
+        structure(payload.bytes, AdType::ManufacturerSpecificData, {
+          0x06, 0x00, 0x01, 0x09, 0x20, 0x02, 0x7D, 0x1E, 0x5B, 0x6A, 0x33, 0xC1, 0x4F, 0x08, 0x1D, 0x0B,
+          0xA0, 0x6C, 0xE4, 0x3B, 0x93, 0x51, 0x02, 0x3E, 0x4D, 0x2A,
+        });
+        structure(payload.bytes, AdType::ShortenedLocalName, std::string_view("Pixel"));
+        shapes.push_back(std::move(payload));
+      }
+
+      {
+        // The last structure claims more bytes than the payload has
+        CorpusPayload payload{"truncated", 0xC82B96A10007ULL, -95, {}};
+        flags(payload.bytes);
+        payload.bytes.insert(payload.bytes.end(), {0x1A, AdType::ManufacturerSpecificData, 0x4C, 0x00, 0x02, 0x15});
+        shapes.push_back(std::move(payload));
+      }
+
+      return shapes;
+    } // buildShapes
+  } // namespace
+
+  const std::vector<CorpusPayload> &advertisementShapes() {
+    static const std::vector<CorpusPayload> shapes = buildShapes();
+    return shapes;
+  } // advertisementShapes
+
+  std::vector<CorpusPayload> advertisementCorpus(size_t size, uint64_t seed) {
+    const auto &shapes = advertisementShapes();
+    std::vector<CorpusPayload> corpus;
+    corpus.reserve(size);
+
+    uint64_t state = seed != 0 ? seed : 1;
+    for (size_t i = 0; i < size; ++i) {
+      // xorshift64, the same corpus for the same seed
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+
+      CorpusPayload payload = shapes[state % shapes.size()];
+      payload.address = (payload.address & 0xFFFFFF000000ULL) | ((state >> 16) & 0xFFFFFF);
+      payload.rssi -= static_cast<int64_t>((state >> 40) % 8);
+      corpus.push_back(std::move(payload));
+    }
+    return corpus;
+  } // advertisementCorpus
+} // namespace layrz_ble::bench
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace layrz_ble::bench {
+  /// @brief One advertisement payload of the corpus, the raw AD structures of the advertisement and its
+  /// scan response as the radio delivers them
+  struct CorpusPayload {
+    std::string name;
+    uint64_t address = 0;
+    int64_t rssi = 0;
+    std::vector<uint8_t> bytes;
+  }; // struct CorpusPayload
+
+  /// @brief The shapes of advertisement seen around a tracker fleet: iBeacon, Eddystone UID and URL, a
+  /// named sensor with a 128-bit service and a scan response, a tag with 16-bit service data, a phone with
+  /// several manufacturer sections and a truncated payload
+  /// @return std::vector<CorpusPayload>, one payload per shape
+  const std::vector<CorpusPayload> &advertisementShapes();
+
+  /// @brief A corpus mixing the shapes over many addresses, in a fixed pseudo-random order
+  /// @param size
+  /// @param seed
+  /// @return std::vector<CorpusPayload>
+  std::vector<CorpusPayload> advertisementCorpus(size_t size, uint64_t seed = 1);
+} // namespace layrz_ble::bench
@@ -0,0 +1,77 @@
+#include "alloc_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+  // Per thread, so a benchmark running on several threads counts its own allocations only
+  thread_local uint64_t allocationCount = 0;
+
+  void *allocate(std::size_t size) {
+    ++allocationCount;
+    if (void *pointer = std::malloc(size != 0 ? size : 1))
+      return pointer;
+    throw std::bad_alloc();
+  }
+
+#ifndef _WIN32
+  void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+    ++allocationCount;
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size = (size + align - 1) / align * align;
+    if (void *pointer = std::aligned_alloc(align, size != 0 ? size : align))
+      return pointer;
+    throw std::bad_alloc();
+  }
+#endif
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  ++allocationCount;
+  return std::malloc(size != 0 ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  ++allocationCount;
+  return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+// The aligned forms pair with _aligned_free on Windows, where they are left to the runtime and not counted
+#ifndef _WIN32
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+#endif
+
+namespace layrz_ble::bench {
+  uint64_t threadAllocations() { return allocationCount; }
+
+  void reportPerEvent(benchmark::State &state, uint64_t events, uint64_t allocations) {
+    state.SetItemsProcessed(static_cast<int64_t>(events));
+    if (events == 0) return;
+
+    // Shown as seconds with an SI prefix, 95n is 95 ns per event
+    state.counters["time/event"] = benchmark::Counter(
+      static_cast<double>(events),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert
+    );
+    state.counters["allocs/event"] = benchmark::Counter(
+      static_cast<double>(allocations) / static_cast<double>(events),
+      benchmark::Counter::kAvgThreads
+    );
+  } // reportPerEvent
+} // namespace layrz_ble::bench
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace layrz_ble::bench {
+  /// @brief Number of heap allocations made by the calling thread so far, counted by the replaced global
+  /// operator new of alloc_counter.cpp
+  /// @return uint64_t
+  uint64_t threadAllocations();
+
+  /// @brief Counts the heap allocations of the calling thread from its construction
+  class AllocationScope {
+    public:
+      AllocationScope() : startedAt_(threadAllocations()) {}
+
+      uint64_t count() const { return threadAllocations() - startedAt_; }
+
+    private:
+      uint64_t startedAt_;
+  }; // class AllocationScope
+
+  /// @brief Report the time and heap allocations per event of a benchmark, for benchmarks whose
+  /// iterations handle more than one event each
+  /// @param state
+  /// @param events number of events handled over every iteration
+  /// @param allocations number of heap allocations over every iteration
+  void reportPerEvent(benchmark::State &state, uint64_t events, uint64_t allocations);
+
+  /// @brief Report the time and heap allocations per event of a benchmark handling one event per iteration
+  /// @param state
+  /// @param allocations number of heap allocations over every iteration
+  inline void reportPerEvent(benchmark::State &state, uint64_t allocations) {
+    reportPerEvent(state, static_cast<uint64_t>(state.iterations()), allocations);
+  }
+} // namespace layrz_ble::bench
@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "bt_address.h"
+#include "change_detector.h"
+#include "device_table.hpp"
+
+namespace layrz_ble::bench {
+  namespace {
+    constexpr size_t kMillion = 1000000;
+
+    struct Device {
+      ChangeDetector::State change;
+      int64_t rssi = 0;
+    };
+
+    /// @brief Distinct random 48-bit addresses, the same for every benchmark
+    /// @param count
+    /// @return std::vector<uint64_t>
+    const std::vector<uint64_t> &addresses(size_t count) {
+      static std::vector<uint64_t> generated;
+      if (generated.size() < count) {
+        generated.clear();
+        generated.reserve(count);
+        std::unordered_map<uint64_t, bool> seen;
+        seen.reserve(count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        while (generated.size() < count) {
+          state ^= state << 13;
+          state ^= state >> 7;
+          state ^= state << 17;
+          uint64_t address = state & 0xFFFFFFFFFFFFULL;
+          if (seen.emplace(address, true).second) generated.push_back(address);
+        }
+      }
+      return generated;
+    }
+  } // namespace
+
+  /// @brief Advertisements of devices already in a table holding range(0) devices
+  void BM_DeviceTableUpsertHit(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    const auto &keys = addresses(count);
+    DeviceTable<Device> table(count);
+    bool inserted = false;
+    auto now = DeviceTable<Device>::Clock::now();
+    for (size_t i = 0; i < count; ++i) table.upsert(keys[i], now, inserted, [](uint64_t, Device &) {});
+
+    size_t next = 0;
+    AllocationScope allocations;
+    for (auto _ : state) {
+      auto &device = table.upsert(keys[next], now, inserted, [](uint64_t, Device &) {});
+      device.rssi = -60;
+      if (++next == count) next = 0;
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_DeviceTableUpsertHit)->Arg(2048)->Arg(kMillion);
+
+  /// @brief A stream of one million devices through a table capped at range(0), every insert evicting
+  /// the least recently seen device once full
+  void BM_DeviceTableInsertEvict(benchmark::State &state) {
+    const auto &keys = addresses(kMillion);
+    DeviceTable<Device> table(static_cast<size_t>(state.range(0)));
+    bool inserted = false;
+    uint64_t evicted = 0;
+    auto now = DeviceTable<Device>::Clock::now();
+
+    size_t next = 0;
+    AllocationScope allocations;
+    for (auto _ : state) {
+      table.upsert(keys[next], now, inserted, [&evicted](uint64_t, Device &) { ++evicted; });
+      if (++next == kMillion) next = 0;
+    }
+    reportPerEvent(state, allocations.count());
+    benchmark::DoNotOptimize(evicted);
+  }
+  BENCHMARK(BM_DeviceTableInsertEvict)->Arg(2048)->Arg(65536);
+
+  /// @brief Lookups of devices missing from a full table of one million devices
+  void BM_DeviceTableFindMiss(benchmark::State &state) {
+    const auto &keys = addresses(2 * kMillion);
+    DeviceTable<Device> table(kMillion);
+    bool inserted = false;
+    auto now = DeviceTable<Device>::Clock::now();
+    for (size_t i = 0; i < kMillion; ++i) table.upsert(keys[i], now, inserted, [](uint64_t, Device &) {});
+
+    size_t next = kMillion;
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(table.find(keys[next]));
+      if (++next == 2 * kMillion) next = kMillion;
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_DeviceTableFindMiss);
+
+  /// @brief The table DeviceTable replaced: an unordered_map keyed by the MAC address string, rebuilt
+  /// for every advertisement, and never pruned
+  void BM_StringMapUpsertHit(benchmark::State &state) {
+    auto count = static_cast<size_t>(state.range(0));
+    const auto &keys = addresses(count);
+    std::unordered_map<std::string, Device> table;
+    char macAddress[18];
+    for (size_t i = 0; i < count; ++i) {
+      formatBluetoothAddress(keys[i], macAddress);
+      table[macAddress] = Device();
+    }
+
+    size_t next = 0;
+    AllocationScope allocations;
+    for (auto _ : state) {
+      formatBluetoothAddress(keys[next], macAddress);
+      std::string key(macAddress);
+      table[key].rssi = -60;
+      if (++next == count) next = 0;
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_StringMapUpsertHit)->Arg(2048)->Arg(kMillion);
+} // namespace layrz_ble::bench
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifdef LAYRZ_BLE_BENCH_FLUTTER_CODEC
+
+#include <flutter/encodable_value.h>
+
+namespace layrz_ble::bench {
+  /// @brief The value type of the plugin, from the Flutter client wrapper
+  using Value = flutter::EncodableValue;
+  using ValueList = flutter::EncodableList;
+  using ValueMap = flutter::EncodableMap;
+} // namespace layrz_ble::bench
+
+#else
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace layrz_ble::bench {
+  class Value;
+  using ValueList = std::vector<Value>;
+  using ValueMap = std::map<Value, Value>;
+
+  using ValueVariant = std::variant<
+    std::monostate,
+    bool,
+    int32_t,
+    int64_t,
+    double,
+    std::string,
+    std::vector<uint8_t>,
+    ValueList,
+    ValueMap
+  >;
+
+  /// @brief Stand-in for flutter::EncodableValue when its client wrapper is not available: the same
+  /// variant, so the events built as maps cost here what they cost in the plugin
+  class Value : public ValueVariant {
+    public:
+      using ValueVariant::ValueVariant;
+      using ValueVariant::operator=;
+
+      Value() = default;
+      explicit Value(const char *str) : ValueVariant(std::string(str)) {}
+
+      friend bool operator<(const Value &lhs, const Value &rhs) {
+        return static_cast<const ValueVariant &>(lhs) < static_cast<const ValueVariant &>(rhs);
+      }
+  }; // class Value
+} // namespace layrz_ble::bench
+
+#endif // LAYRZ_BLE_BENCH_FLUTTER_CODEC
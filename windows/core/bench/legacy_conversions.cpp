@@ -0,0 +1,40 @@
+#include "legacy_conversions.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace layrz_ble::bench {
+  std::string streamGuidToString(const Guid &guid) {
+    std::ostringstream oss;
+    oss << std::hex << std::uppercase << std::setfill('0')
+        << std::setw(8) << guid.Data1 << '-'
+        << std::setw(4) << guid.Data2 << '-'
+        << std::setw(4) << guid.Data3 << '-'
+        << std::setw(2) << static_cast<int>(guid.Data4[0])
+        << std::setw(2) << static_cast<int>(guid.Data4[1]) << '-';
+
+    for (int i = 2; i < 8; ++i) {
+      oss << std::setw(2) << static_cast<int>(guid.Data4[i]);
+    }
+
+    return oss.str();
+  } // streamGuidToString
+
+  Guid streamStringToGuid(const std::string &str) {
+    Guid guid{};
+    std::istringstream iss(str);
+    iss >> std::hex >> guid.Data1;
+    iss.ignore(1);
+    iss >> std::hex >> guid.Data2;
+    iss.ignore(1);
+    iss >> std::hex >> guid.Data3;
+    iss.ignore(1);
+    iss >> std::hex >> guid.Data4[0];
+    iss >> std::hex >> guid.Data4[1];
+    iss.ignore(1);
+    for (int i = 2; i < 8; ++i) {
+      iss >> std::hex >> guid.Data4[i];
+    }
+    return guid;
+  } // streamStringToGuid
+} // namespace layrz_ble::bench
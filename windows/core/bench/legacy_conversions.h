@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace layrz_ble::bench {
+  /// @brief Field layout of winrt::guid
+  struct Guid {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+  }; // struct Guid
+
+  /// @brief GuidToString as it was before Uuid: an ostringstream with setw and setfill per field
+  /// @param guid
+  /// @return std::string in uppercase
+  std::string streamGuidToString(const Guid &guid);
+
+  /// @brief StringToGuid as it was before Uuid: an istringstream read field by field
+  /// @param str
+  /// @return Guid
+  Guid streamStringToGuid(const std::string &str);
+} // namespace layrz_ble::bench
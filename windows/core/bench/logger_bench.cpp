@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "alloc_counter.h"
+#include "logger.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    constexpr const char *kMacAddress = "c8:2b:96:a1:07:5e";
+    constexpr size_t kDrainEvery = 256;
+
+#ifdef _WIN32
+    constexpr const char *kNullDevice = "NUL";
+#else
+    constexpr const char *kNullDevice = "/dev/null";
+#endif
+
+    /// @brief Send the lines of the logger to a counter instead of the console, at the default level
+    Logger &quietLogger(uint64_t &lines) {
+      auto &logger = Logger::instance();
+      logger.setSink([&lines](LogLevel, std::string_view) { ++lines; });
+      Logger::setLevel(Logger::kDefaultLevel);
+      return logger;
+    }
+
+    const char *enabledLabel(LogLevel level) {
+      return Logger::enabled(level) ? "enabled" : "disabled";
+    }
+  } // namespace
+
+  /// @brief A log call at level range(0) with the logger at its default level, Info: a check of the level
+  /// for Trace and Debug, a record copied into the ring for the others. The ring is drained outside of the
+  /// timing, the formatting is measured by BM_LogDrain
+  void BM_Log(benchmark::State &state) {
+    uint64_t lines = 0;
+    auto &logger = quietLogger(lines);
+    auto level = static_cast<LogLevel>(state.range(0));
+    std::string macAddress = kMacAddress;
+    size_t pending = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      Log(level, "Received {} bytes from {}", 20, macAddress);
+      if (++pending == kDrainEvery) {
+        state.PauseTiming();
+        logger.drain();
+        pending = 0;
+        state.ResumeTiming();
+      }
+    }
+    reportPerEvent(state, allocations.count());
+    logger.drain();
+    state.SetLabel(enabledLabel(level));
+    state.counters["dropped"] = static_cast<double>(logger.Dropped());
+  }
+  BENCHMARK(BM_Log)
+    ->Arg(static_cast<int64_t>(LogLevel::Trace))
+    ->Arg(static_cast<int64_t>(LogLevel::Debug))
+    ->Arg(static_cast<int64_t>(LogLevel::Info))
+    ->Arg(static_cast<int64_t>(LogLevel::Warning))
+    ->Arg(static_cast<int64_t>(LogLevel::Error));
+
+  /// @brief Formatting the pending records and handing them to the sink, as the thread of the logger does
+  void BM_LogDrain(benchmark::State &state) {
+    uint64_t lines = 0;
+    auto &logger = quietLogger(lines);
+    std::string macAddress = kMacAddress;
+    uint64_t events = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      state.PauseTiming();
+      for (size_t i = 0; i < kDrainEvery; ++i)
+        Log(LogLevel::Info, "Received {} bytes from {}", 20, macAddress);
+      state.ResumeTiming();
+
+      logger.drain();
+      events += kDrainEvery;
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.counters["lines/event"] = static_cast<double>(lines) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_LogDrain);
+
+  /// @brief The Log(message) the logger replaced: the message concatenated by the caller whatever the
+  /// level, then streamed with std::endl, which flushes on every line, here into the null device
+  void BM_LogLegacy(benchmark::State &state) {
+    std::ofstream console(kNullDevice);
+    std::string macAddress = kMacAddress;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      std::string message = "Received " + std::to_string(20) + " bytes from " + macAddress;
+      console << "LayrzBlePlugin/Windows: " << message << std::endl;
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_LogLegacy);
+} // namespace layrz_ble::bench
@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "encodable_value.h"
+#include "legacy_conversions.h"
+#include "notify_buffer.hpp"
+#include "packed_events.h"
+#include "standard_codec.h"
+#include "uuid.h"
+
+#ifdef LAYRZ_BLE_BENCH_FLUTTER_CODEC
+#include "notify_subscription.h"
+#endif
+
+namespace layrz_ble::bench {
+  namespace {
+    constexpr uint64_t kAddress = 0xC82B96A1075EULL;
+    constexpr const char *kMacAddress = "c8:2b:96:a1:07:5e";
+    constexpr size_t kValueSize = 20;
+
+    const Uuid kServiceUuid = Uuid::fromShort(0x180D);
+    const Uuid kCharacteristicUuid = Uuid::fromShort(0x2A37);
+    const Guid kServiceGuid = {0x0000180D, 0x0000, 0x1000, {0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB}};
+    const Guid kCharacteristicGuid = {0x00002A37, 0x0000, 0x1000, {0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB}};
+
+    /// @brief The onNotify event NotifySubscription precomputed before it encoded its messages, without its value
+    ValueMap subscriptionEvent() {
+      ValueMap event;
+      event[Value("macAddress")] = Value(std::string(kMacAddress));
+      event[Value("serviceUuid")] = Value(kServiceUuid.toString());
+      event[Value("characteristicUuid")] = Value(kCharacteristicUuid.toString());
+      return event;
+    }
+
+    /// @brief The event of a value as the UI thread built it, the precomputed map copied strings included,
+    /// then encoded as InvokeMethod encodes it
+    void encodeNotifyEvent(const ValueMap &precomputed, std::vector<uint8_t> &&value, std::vector<uint8_t> &out) {
+      auto event = precomputed;
+      event[Value("value")] = Value(std::move(value));
+      encodeStandard(Value("onNotify"), out);
+      encodeStandard(Value(std::move(event)), out);
+    }
+  } // namespace
+
+#ifdef LAYRZ_BLE_BENCH_FLUTTER_CODEC
+  /// @brief One notification through the subscription ring, from the onNotify message encoded by
+  /// NotifySubscription on the callback thread to the UI thread, which hands it to the messenger as is.
+  /// The UI thread drains every range(0) notifications, a drain is posted only when the ring goes from
+  /// idle to pending
+  void BM_NotifyBuffer(benchmark::State &state) {
+    auto burst = static_cast<size_t>(state.range(0));
+    NotifySubscription subscription(kAddress, kMacAddress, kServiceUuid, kCharacteristicUuid);
+    uint8_t value[kValueSize] = {0x16, 0x4C};
+    uint64_t events = 0;
+    uint64_t posts = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (size_t i = 0; i < burst; ++i) {
+        if (subscription.Pending().push(subscription.Message(value, kValueSize))) ++posts;
+      }
+      subscription.Pending().drain([](std::vector<uint8_t> &&message) { benchmark::DoNotOptimize(message.data()); });
+      events += burst;
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.counters["posts/event"] = static_cast<double>(posts) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_NotifyBuffer)->Arg(1)->Arg(16)->Arg(64);
+#endif
+
+  /// @brief The same before the messages were encoded by NotifySubscription: the value copied into the
+  /// ring, and the UI thread copying the precomputed event map into each event before encoding it
+  void BM_NotifyBufferEventMap(benchmark::State &state) {
+    auto burst = static_cast<size_t>(state.range(0));
+    NotifyBuffer<std::vector<uint8_t>> buffer(64);
+    auto precomputed = subscriptionEvent();
+    uint8_t value[kValueSize] = {0x16, 0x4C};
+    uint64_t events = 0;
+    uint64_t posts = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (size_t i = 0; i < burst; ++i) {
+        if (buffer.push(std::vector<uint8_t>(value, value + kValueSize))) ++posts;
+      }
+      buffer.drain([&precomputed](std::vector<uint8_t> &&pending) {
+        std::vector<uint8_t> out;
+        encodeNotifyEvent(precomputed, std::move(pending), out);
+        benchmark::DoNotOptimize(out.data());
+      });
+      events += burst;
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.counters["posts/event"] = static_cast<double>(posts) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_NotifyBufferEventMap)->Arg(1)->Arg(16)->Arg(64);
+
+  /// @brief The same with a packed subscription, the record built on the callback thread from the
+  /// precomputed header and handed over as is
+  void BM_NotifyBufferPacked(benchmark::State &state) {
+    auto burst = static_cast<size_t>(state.range(0));
+    NotifyBuffer<std::vector<uint8_t>> buffer(64);
+    auto header = packed::notifyHeader(kAddress, kServiceUuid, kCharacteristicUuid);
+    uint8_t value[kValueSize] = {0x16, 0x4C};
+    uint64_t events = 0;
+    uint64_t posts = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (size_t i = 0; i < burst; ++i) {
+        if (buffer.push(packed::notifyRecord(header, value, kValueSize))) ++posts;
+      }
+      buffer.drain([](std::vector<uint8_t> &&record) { benchmark::DoNotOptimize(record.data()); });
+      events += burst;
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.counters["posts/event"] = static_cast<double>(posts) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_NotifyBufferPacked)->Arg(1)->Arg(16)->Arg(64);
+
+  /// @brief The ValueChanged handler before NotifySubscription: both UUIDs formatted through stringstreams,
+  /// the event map built on the callback thread and copied into a std::function posted per notification,
+  /// then copied again for InvokeMethod
+  void BM_NotifyLegacy(benchmark::State &state) {
+    uint8_t value[kValueSize] = {0x16, 0x4C};
+    std::string macAddress = kMacAddress;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      auto characteristicUuid = streamGuidToString(kCharacteristicGuid);
+      auto serviceUuid = streamGuidToString(kServiceGuid);
+      std::vector<uint8_t> bytes(value, value + kValueSize);
+
+      ValueMap response;
+      response[Value("macAddress")] = Value(macAddress);
+      response[Value("serviceUuid")] = Value(serviceUuid);
+      response[Value("characteristicUuid")] = Value(characteristicUuid);
+      response[Value("value")] = Value(bytes);
+
+      std::function<void()> post = [response]() {
+        auto event = std::make_unique<Value>(response);
+        benchmark::DoNotOptimize(event.get());
+      };
+      post();
+    }
+    reportPerEvent(state, allocations.count());
+    state.counters["posts/event"] = 1;
+  }
+  BENCHMARK(BM_NotifyLegacy);
+} // namespace layrz_ble::bench
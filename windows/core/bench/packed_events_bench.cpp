@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "encodable_value.h"
+#include "packed_events.h"
+#include "standard_codec.h"
+#include "uuid.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    constexpr uint64_t kAddress = 0xC82B96A1075EULL;
+    constexpr std::string_view kName = "LAYRZ-TRACKER-0042";
+
+    const Uuid kServiceUuid = Uuid::fromShort(0x180D);
+    const Uuid kCharacteristicUuid = Uuid::fromShort(0x2A37);
+
+    /// @brief Size of the record once the codec wraps it in a Uint8List, as onScanPacked sends it
+    double wireSize(const std::vector<uint8_t> &record) {
+      std::vector<uint8_t> out;
+      encodeStandard(Value(record), out);
+      return static_cast<double>(out.size());
+    }
+  } // namespace
+
+  /// @brief A scan record with a name, a txPower, the manufacturer data of a beacon and one service data,
+  /// appended to a reused batch buffer as the scan batcher does
+  void BM_PackScanRecord(benchmark::State &state) {
+    std::vector<uint8_t> manufacturerData(static_cast<size_t>(state.range(0)), 0xA5);
+    std::vector<uint8_t> serviceData = {0x16, 0x4C};
+    uint16_t txPower = 4;
+    std::vector<uint8_t> out;
+    out.reserve(packed::kMaxRecordSize);
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      out.clear();
+      packed::ScanRecordWriter writer(out, kAddress, -67, &txPower, &kName);
+      writer.addManufacturerData(0x0059, manufacturerData.data(), manufacturerData.size());
+      writer.addServiceData(kServiceUuid, serviceData.data(), serviceData.size());
+      writer.finish();
+      benchmark::DoNotOptimize(out.data());
+    }
+    reportPerEvent(state, allocations.count());
+    state.counters["bytes/event"] = wireSize(out);
+  }
+  BENCHMARK(BM_PackScanRecord)->Arg(8)->Arg(24)->Arg(200);
+
+  /// @brief The same scan event as the map handleBleScanResult builds for onScan, encoded by the standard
+  /// codec into a reused buffer
+  void BM_ScanEventMap(benchmark::State &state) {
+    std::vector<uint8_t> manufacturerData(static_cast<size_t>(state.range(0)), 0xA5);
+    std::vector<uint8_t> serviceData = {0x16, 0x4C};
+    uint16_t txPower = 4;
+    std::string macAddress = "c8:2b:96:a1:07:5e";
+    std::string name(kName);
+    std::vector<uint8_t> out;
+    out.reserve(packed::kMaxRecordSize);
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      ValueMap response;
+      response[Value("macAddress")] = Value(macAddress);
+      response[Value("name")] = Value(name);
+      response[Value("rssi")] = Value(int64_t{-67});
+      response[Value("txPower")] = Value(txPower);
+
+      ValueList manufacturerDataList;
+      ValueMap mfdMap;
+      mfdMap[Value("companyId")] = Value(0x0059);
+      mfdMap[Value("data")] = Value(manufacturerData);
+      manufacturerDataList.push_back(mfdMap);
+      response[Value("manufacturerData")] = Value(manufacturerDataList);
+
+      ValueList serviceDataList;
+      ValueMap serviceDataMap;
+      serviceDataMap[Value("uuid")] = Value((kServiceUuid.bytes[2] << 8) | kServiceUuid.bytes[3]);
+      serviceDataMap[Value("fullUuid")] = Value(kServiceUuid.toString());
+      serviceDataMap[Value("data")] = Value(serviceData);
+      serviceDataList.push_back(serviceDataMap);
+      response[Value("serviceData")] = Value(serviceDataList);
+
+      out.clear();
+      encodeStandard(Value(std::move(response)), out);
+      benchmark::DoNotOptimize(out.data());
+    }
+    reportPerEvent(state, allocations.count());
+    state.counters["bytes/event"] = static_cast<double>(out.size());
+  }
+  BENCHMARK(BM_ScanEventMap)->Arg(8)->Arg(24)->Arg(200);
+
+  /// @brief A notify record built from the header precomputed by startNotify
+  void BM_PackNotifyRecord(benchmark::State &state) {
+    auto header = packed::notifyHeader(kAddress, kServiceUuid, kCharacteristicUuid);
+    std::vector<uint8_t> value(static_cast<size_t>(state.range(0)), 0x5A);
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      auto record = packed::notifyRecord(header, value.data(), value.size());
+      benchmark::DoNotOptimize(record.data());
+    }
+    reportPerEvent(state, allocations.count());
+    state.counters["bytes/event"] = wireSize(packed::notifyRecord(header, value.data(), value.size()));
+  }
+  BENCHMARK(BM_PackNotifyRecord)->Arg(20)->Arg(244);
+
+  /// @brief The same notification as the onNotify map, copied from the map precomputed by startNotify and
+  /// encoded by the standard codec
+  void BM_NotifyEventMap(benchmark::State &state) {
+    std::vector<uint8_t> value(static_cast<size_t>(state.range(0)), 0x5A);
+    ValueMap precomputed;
+    precomputed[Value("macAddress")] = Value(std::string("c8:2b:96:a1:07:5e"));
+    precomputed[Value("serviceUuid")] = Value(kServiceUuid.toString());
+    precomputed[Value("characteristicUuid")] = Value(kCharacteristicUuid.toString());
+    std::vector<uint8_t> out;
+    out.reserve(packed::kMaxRecordSize);
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      auto event = precomputed;
+      event[Value("value")] = Value(value);
+      out.clear();
+      encodeStandard(Value(std::move(event)), out);
+      benchmark::DoNotOptimize(out.data());
+    }
+    reportPerEvent(state, allocations.count());
+    state.counters["bytes/event"] = static_cast<double>(out.size());
+  }
+  BENCHMARK(BM_NotifyEventMap)->Arg(20)->Arg(244);
+} // namespace layrz_ble::bench
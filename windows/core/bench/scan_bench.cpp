@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+
+#include "alloc_counter.h"
+#include "scan_filter.h"
+#include "scan_pipeline.h"
+#include "simulated_advertiser.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    void ignoreLost(const BleScanResult &) {}
+
+    SimulationConfig simulation(int64_t advertisers) {
+      SimulationConfig config;
+      config.advertisers = static_cast<size_t>(advertisers);
+      config.rate = 0;
+      return config;
+    }
+  } // namespace
+
+  /// @brief Generating and parsing the advertisements alone, the baseline of BM_MergeAdvertisement
+  void BM_SimulatedAdvertisement(benchmark::State &state) {
+    SimulatedAdvertiser advertiser(simulation(state.range(0)));
+    uint64_t rssiSum = 0;
+    ScanBackend::Sink sink = [&rssiSum](const ReceivedAdvertisement &advertisement) {
+      rssiSum += static_cast<uint64_t>(advertisement.rssi);
+    };
+
+    AllocationScope allocations;
+    for (auto _ : state) advertiser.emit(1, sink);
+    reportPerEvent(state, allocations.count());
+    benchmark::DoNotOptimize(rssiSum);
+  }
+  BENCHMARK(BM_SimulatedAdvertisement)->Arg(100)->Arg(10000);
+
+  /// @brief Advertisements through the ScanPipeline of the plugin with an empty filter, merged into the
+  /// visible devices, most of them into a device already seen. range(1) enables the suppression of
+  /// unchanged results
+  void BM_MergeAdvertisement(benchmark::State &state) {
+    SimulatedAdvertiser advertiser(simulation(state.range(0)));
+    ScanStats stats;
+    ScanPipeline pipeline(&stats, static_cast<size_t>(state.range(0)));
+    pipeline.Changes().configure(state.range(1) != 0, 5, std::chrono::seconds(5));
+    ScanBackend::Sink sink = [&pipeline](const ReceivedAdvertisement &advertisement) {
+      pipeline.handle(advertisement, [](const BleScanResult &device) { benchmark::DoNotOptimize(&device); }, ignoreLost);
+    };
+
+    // Every advertiser is seen once before measuring, so the steady state is measured
+    advertiser.emit(static_cast<size_t>(state.range(0)) * 4, sink);
+    stats.reset();
+
+    AllocationScope allocations;
+    for (auto _ : state) advertiser.emit(1, sink);
+    reportPerEvent(state, allocations.count());
+    state.counters["emitted"] = static_cast<double>(stats.emitted.load()) /
+      static_cast<double>(stats.emitted.load() + stats.suppressed.load());
+  }
+  BENCHMARK(BM_MergeAdvertisement)->Args({100, 0})->Args({10000, 0})->Args({100, 1})->Args({10000, 1});
+
+  /// @brief Events per second through the scan pipeline as startScan runs it with a simulation: the
+  /// unpaced backend emits from its own thread into the filter and the visible devices of range(0)
+  /// advertisers
+  void BM_ScanThroughput(benchmark::State &state) {
+    constexpr uint64_t kAdvertisements = 100000;
+    auto config = simulation(state.range(0));
+    config.limit = kAdvertisements;
+
+    auto filter = std::make_shared<ScanFilter>();
+    filter->setMinRssi(-90);
+    filter->addCompanyId(SimulatedAdvertiser::kCompanyId);
+    filter->compile();
+
+    uint64_t events = 0;
+    uint64_t allocations = 0;
+    uint64_t matched = 0;
+    for (auto _ : state) {
+      state.PauseTiming();
+      SimulatedAdvertiser advertiser(config);
+      ScanPipeline pipeline(nullptr, static_cast<size_t>(state.range(0)));
+      pipeline.setFilter(filter);
+      std::promise<uint64_t> done;
+      uint64_t received = 0;
+      uint64_t startedAt = 0;
+      state.ResumeTiming();
+
+      advertiser.start([&](const ReceivedAdvertisement &advertisement) {
+        if (received++ == 0) startedAt = threadAllocations();
+        if (pipeline.handle(advertisement, [](const BleScanResult &) {}, ignoreLost))
+          ++matched;
+        if (received == kAdvertisements) done.set_value(threadAllocations() - startedAt);
+      });
+      allocations += done.get_future().get();
+      advertiser.stop();
+      events += kAdvertisements;
+    }
+    reportPerEvent(state, events, allocations);
+    state.counters["matched"] = static_cast<double>(matched) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_ScanThroughput)->Arg(100)->Arg(10000)->UseRealTime()->Unit(benchmark::kMillisecond);
+} // namespace layrz_ble::bench
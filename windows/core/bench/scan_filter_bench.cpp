@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "adv_parser.h"
+#include "advertisement_corpus.h"
+#include "alloc_counter.h"
+#include "scan_filter.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    enum Shape : size_t { kIBeacon = 0, kEddystoneUid = 1, kNamedSensor = 3, kPhone = 5 };
+
+    /// @brief The filter of a fleet app: the iBeacons of its UUID, above -85 dBm
+    ScanFilter fleetFilter() {
+      ScanFilter filter;
+      filter.setMinRssi(-85);
+
+      ManufacturerDataPattern ibeacon;
+      ibeacon.companyId = 0x004C;
+      ibeacon.data = {0x02, 0x15, 0xE2, 0xC5};
+      filter.addManufacturerDataPattern(ibeacon);
+      filter.compile();
+      return filter;
+    }
+
+    ParsedAdvertisement parse(const CorpusPayload &payload) {
+      ParsedAdvertisement parsed;
+      parseAdvertisement(ByteView(payload.bytes.data(), payload.bytes.size()), parsed);
+      return parsed;
+    }
+
+    /// @brief Check one advertisement over and over, reporting the cost of the outcome
+    void checkShape(benchmark::State &state, const ScanFilter &filter, size_t shape, int64_t rssi) {
+      const auto &payload = advertisementShapes()[shape];
+      auto parsed = parse(payload);
+      auto expected = filter.check(payload.address, rssi, parsed);
+
+      AllocationScope allocations;
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.check(payload.address, rssi, parsed));
+      }
+      reportPerEvent(state, allocations.count());
+      state.SetLabel(
+        expected == FilterMatch::Matched ? "matched" :
+        expected == FilterMatch::Rejected ? "rejected" : "content mismatch"
+      );
+    }
+  } // namespace
+
+  void BM_FilterRejectRssi(benchmark::State &state) {
+    checkShape(state, fleetFilter(), kIBeacon, -95);
+  }
+  BENCHMARK(BM_FilterRejectRssi);
+
+  /// @brief An advertisement of a device outside an allowlist of range(0) addresses
+  void BM_FilterRejectAddress(benchmark::State &state) {
+    ScanFilter filter;
+    for (int64_t i = 0; i < state.range(0); ++i)
+      filter.addAddress(0xA0B0C0000000ULL + static_cast<uint64_t>(i) * 7919);
+    filter.compile();
+    checkShape(state, filter, kIBeacon, -60);
+  }
+  BENCHMARK(BM_FilterRejectAddress)->Arg(1)->Arg(64)->Arg(4096);
+
+  void BM_FilterRejectCompany(benchmark::State &state) {
+    ScanFilter filter;
+    filter.addCompanyId(0x0059);
+    filter.addCompanyId(0x0075);
+    filter.compile();
+    checkShape(state, filter, kPhone, -60);
+  }
+  BENCHMARK(BM_FilterRejectCompany);
+
+  void BM_FilterRejectPattern(benchmark::State &state) {
+    checkShape(state, fleetFilter(), kPhone, -60);
+  }
+  BENCHMARK(BM_FilterRejectPattern);
+
+  void BM_FilterRejectService(benchmark::State &state) {
+    ScanFilter filter;
+    filter.addServiceUuid("180F");
+    filter.addServiceUuid("6e400001-b5a3-f393-e0a9-e50e24dcca9f");
+    filter.compile();
+    checkShape(state, filter, kEddystoneUid, -60);
+  }
+  BENCHMARK(BM_FilterRejectService);
+
+  void BM_FilterRejectName(benchmark::State &state) {
+    ScanFilter filter;
+    filter.addNamePrefix("LAYRZ-TRACKER");
+    filter.addNamePrefix("GPS-");
+    filter.compile();
+    checkShape(state, filter, kNamedSensor, -60);
+  }
+  BENCHMARK(BM_FilterRejectName);
+
+  void BM_FilterMatch(benchmark::State &state) {
+    checkShape(state, fleetFilter(), kIBeacon, -60);
+  }
+  BENCHMARK(BM_FilterMatch);
+
+  /// @brief The fleet filter over a mixed corpus, parse included, as the ingest thread runs it
+  void BM_FilterCorpus(benchmark::State &state) {
+    auto filter = fleetFilter();
+    auto corpus = advertisementCorpus(4096);
+    ParsedAdvertisement parsed;
+    uint64_t events = 0;
+    uint64_t matched = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (const auto &payload : corpus) {
+        parsed.clear();
+        parseAdvertisement(ByteView(payload.bytes.data(), payload.bytes.size()), parsed);
+        matched += filter.matches(payload.address, payload.rssi, parsed);
+      }
+      events += corpus.size();
+    }
+    reportPerEvent(state, events, allocations.count());
+    state.counters["matched"] = static_cast<double>(matched) / static_cast<double>(events);
+  }
+  BENCHMARK(BM_FilterCorpus);
+} // namespace layrz_ble::bench
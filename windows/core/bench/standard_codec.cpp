@@ -0,0 +1,116 @@
+#include "standard_codec.h"
+
+#ifdef LAYRZ_BLE_BENCH_FLUTTER_CODEC
+
+#include <flutter/standard_codec_serializer.h>
+
+#include "byte_buffer_streams.h"
+
+namespace layrz_ble::bench {
+  void encodeStandard(const Value &value, std::vector<uint8_t> &out) {
+    // What StandardMessageCodec::EncodeMessage does, appending to out instead of a new buffer
+    flutter::ByteBufferStreamWriter stream(&out);
+    flutter::StandardCodecSerializer::GetInstance().WriteValue(value, &stream);
+  } // encodeStandard
+} // namespace layrz_ble::bench
+
+#else
+
+#include <cstring>
+
+namespace layrz_ble::bench {
+  namespace {
+    enum Type : uint8_t {
+      kNull = 0,
+      kTrue = 1,
+      kFalse = 2,
+      kInt32 = 3,
+      kInt64 = 4,
+      kFloat64 = 6,
+      kString = 7,
+      kUint8List = 8,
+      kList = 12,
+      kMap = 13,
+    };
+
+    template <typename T>
+    void put(std::vector<uint8_t> &out, T value) {
+      uint8_t bytes[sizeof(T)];
+      std::memcpy(bytes, &value, sizeof(T));
+      out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void putSize(std::vector<uint8_t> &out, size_t size) {
+      if (size < 254) {
+        out.push_back(static_cast<uint8_t>(size));
+      } else if (size <= UINT16_MAX) {
+        out.push_back(254);
+        put(out, static_cast<uint16_t>(size));
+      } else {
+        out.push_back(255);
+        put(out, static_cast<uint32_t>(size));
+      }
+    }
+
+    void putBytes(std::vector<uint8_t> &out, const void *data, size_t size) {
+      auto bytes = static_cast<const uint8_t *>(data);
+      putSize(out, size);
+      out.insert(out.end(), bytes, bytes + size);
+    }
+  } // namespace
+
+  void encodeStandard(const Value &value, std::vector<uint8_t> &out) {
+    switch (value.index()) {
+      case 0:
+        out.push_back(kNull);
+        break;
+      case 1:
+        out.push_back(std::get<bool>(value) ? kTrue : kFalse);
+        break;
+      case 2:
+        out.push_back(kInt32);
+        put(out, std::get<int32_t>(value));
+        break;
+      case 3:
+        out.push_back(kInt64);
+        put(out, std::get<int64_t>(value));
+        break;
+      case 4:
+        out.push_back(kFloat64);
+        while (out.size() % 8 != 0) out.push_back(0);
+        put(out, std::get<double>(value));
+        break;
+      case 5: {
+        const auto &str = std::get<std::string>(value);
+        out.push_back(kString);
+        putBytes(out, str.data(), str.size());
+        break;
+      }
+      case 6: {
+        const auto &bytes = std::get<std::vector<uint8_t>>(value);
+        out.push_back(kUint8List);
+        putBytes(out, bytes.data(), bytes.size());
+        break;
+      }
+      case 7: {
+        const auto &list = std::get<ValueList>(value);
+        out.push_back(kList);
+        putSize(out, list.size());
+        for (const auto &item : list) encodeStandard(item, out);
+        break;
+      }
+      case 8: {
+        const auto &map = std::get<ValueMap>(value);
+        out.push_back(kMap);
+        putSize(out, map.size());
+        for (const auto &[key, item] : map) {
+          encodeStandard(key, out);
+          encodeStandard(item, out);
+        }
+        break;
+      }
+    }
+  } // encodeStandard
+} // namespace layrz_ble::bench
+
+#endif // LAYRZ_BLE_BENCH_FLUTTER_CODEC
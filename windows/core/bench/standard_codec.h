@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "encodable_value.h"
+
+namespace layrz_ble::bench {
+  /// @brief Encode a value with flutter::StandardMessageCodec, or as it does when the bench is built with
+  /// the stand-in: a type byte per value, sizes as 1, 3 or 5 bytes, doubles aligned to 8 bytes
+  /// @param value
+  /// @param out the encoding is appended
+  void encodeStandard(const Value &value, std::vector<uint8_t> &out);
+} // namespace layrz_ble::bench
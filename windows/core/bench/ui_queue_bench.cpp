@@ -0,0 +1,239 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "mpsc_queue.hpp"
+
+namespace layrz_ble::bench {
+  namespace {
+    // Same slot layout as LayrzBlePluginUiThreadHandler
+    constexpr size_t kInlineTaskSize = 48;
+    constexpr size_t kQueueCapacity = 1024;
+
+    using Task = InplaceTask<kInlineTaskSize>;
+
+    struct QueuedTask {
+      Task task;
+      std::chrono::steady_clock::time_point postedAt;
+    };
+
+    using UiQueue = MpscQueue<QueuedTask, kQueueCapacity>;
+
+    /// @brief Stand-in for the message queue of the UI thread: every PostMessage queues one message and
+    /// wakes the thread
+    class MessageQueue {
+      public:
+        void post() {
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++pending_;
+            ++posted_;
+          }
+          wake_.notify_one();
+        }
+
+        void wait() {
+          std::unique_lock<std::mutex> lock(mutex_);
+          wake_.wait(lock, [this]() { return pending_ > 0; });
+          --pending_;
+        }
+
+        uint64_t Posted() {
+          std::lock_guard<std::mutex> lock(mutex_);
+          return posted_;
+        }
+
+      private:
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        uint64_t pending_ = 0;
+        uint64_t posted_ = 0;
+    }; // class MessageQueue
+
+    /// @brief The UI queue before the MPSC ring: a locked std::list of std::function, and one message
+    /// posted per task
+    class ListUiQueue {
+      public:
+        template <typename F>
+        void post(F &&func) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          funcs_.emplace_back(std::forward<F>(func));
+          messages_.post();
+        }
+
+        /// @brief Handle one message, as HandleWindowMessage did
+        void handle() {
+          messages_.wait();
+          std::list<std::function<void()>> funcs;
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(funcs_, funcs);
+          }
+          for (auto &func : funcs) func();
+        }
+
+        uint64_t Wakeups() { return messages_.Posted(); }
+
+      private:
+        MessageQueue messages_;
+        std::list<std::function<void()>> funcs_;
+        std::mutex mutex_;
+    }; // class ListUiQueue
+
+    /// @brief The queue of LayrzBlePluginUiThreadHandler: the MPSC ring with its locked overflow list, and
+    /// a message posted only when no drain is pending
+    class RingUiQueue {
+      public:
+        template <typename F>
+        void post(F &&func) {
+          QueuedTask task{Task(std::forward<F>(func)), std::chrono::steady_clock::now()};
+          if (overflowing_.load(std::memory_order_acquire) || !queue_->tryPush(task)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            overflowing_.store(true, std::memory_order_release);
+            overflow_.emplace_back(std::move(task));
+          }
+          if (!notifyPending_.exchange(true, std::memory_order_seq_cst))
+            messages_.post();
+        }
+
+        void handle() {
+          messages_.wait();
+          notifyPending_.store(false, std::memory_order_seq_cst);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          QueuedTask task;
+          while (queue_->tryPop(task)) {
+            task.task();
+            task.task.reset();
+          }
+
+          std::list<QueuedTask> overflow;
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(overflow_, overflow);
+            overflowing_.store(false, std::memory_order_release);
+          }
+          for (auto &queued : overflow) queued.task();
+        }
+
+        uint64_t Wakeups() { return messages_.Posted(); }
+
+      private:
+        MessageQueue messages_;
+        std::unique_ptr<UiQueue> queue_ = std::make_unique<UiQueue>();
+        std::atomic<bool> notifyPending_{false};
+        std::atomic<bool> overflowing_{false};
+        std::list<QueuedTask> overflow_;
+        std::mutex mutex_;
+    }; // class RingUiQueue
+
+    /// @brief range(0) producer threads post tasks to one UI thread, which runs them. Each task carries
+    /// 32 bytes of payload besides its target, the size of a scan event closure
+    template <typename Queue>
+    void contention(benchmark::State &state) {
+      constexpr uint64_t kTasksPerProducer = 20000;
+      auto producers = static_cast<size_t>(state.range(0));
+      uint64_t total = producers * kTasksPerProducer;
+      uint64_t events = 0;
+      uint64_t wakeups = 0;
+      std::atomic<uint64_t> allocations{0};
+
+      for (auto _ : state) {
+        Queue queue;
+        uint64_t consumed = 0;
+        std::thread ui([&queue, &consumed, total]() {
+          while (consumed < total) queue.handle();
+        });
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < producers; ++i) {
+          threads.emplace_back([&queue, &consumed, &allocations]() {
+            AllocationScope scope;
+            for (uint64_t j = 0; j < kTasksPerProducer; ++j) {
+              uint64_t payload[4] = {j, j, j, j};
+              queue.post([&consumed, payload]() { consumed += 1 + payload[0] - payload[3]; });
+            }
+            allocations.fetch_add(scope.count(), std::memory_order_relaxed);
+          });
+        }
+        for (auto &thread : threads) thread.join();
+        ui.join();
+        events += total;
+        wakeups += queue.Wakeups();
+      }
+      reportPerEvent(state, events, allocations.load());
+      state.counters["wakeups/event"] = static_cast<double>(wakeups) / static_cast<double>(events);
+    } // contention
+  } // namespace
+
+  /// @brief Post and run a closure that fits inline, the shape of the scan and notify events, in batches
+  /// as the UI thread drains them
+  void BM_UiQueuePostRun(benchmark::State &state) {
+    auto queue = std::make_unique<UiQueue>();
+    auto batch = static_cast<size_t>(state.range(0));
+    uint64_t sum = 0;
+    uint64_t events = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (size_t i = 0; i < batch; ++i) {
+        QueuedTask queued{Task([&sum, i]() { sum += i; }), std::chrono::steady_clock::now()};
+        queue->tryPush(queued);
+      }
+
+      QueuedTask queued;
+      while (queue->tryPop(queued)) {
+        queued.task();
+        queued.task.reset();
+      }
+      events += batch;
+    }
+    reportPerEvent(state, events, allocations.count());
+    benchmark::DoNotOptimize(sum);
+  }
+  BENCHMARK(BM_UiQueuePostRun)->Arg(1)->Arg(64)->Arg(1024);
+
+  /// @brief Post and run a closure larger than the inline slot, which the task keeps on the heap
+  void BM_UiQueuePostRunHeap(benchmark::State &state) {
+    auto queue = std::make_unique<UiQueue>();
+    auto batch = static_cast<size_t>(state.range(0));
+    uint64_t sum = 0;
+    uint64_t events = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      for (size_t i = 0; i < batch; ++i) {
+        uint64_t payload[8] = {i};
+        QueuedTask queued{Task([&sum, payload]() { sum += payload[0]; }), std::chrono::steady_clock::now()};
+        queue->tryPush(queued);
+      }
+
+      QueuedTask queued;
+      while (queue->tryPop(queued)) {
+        queued.task();
+        queued.task.reset();
+      }
+      events += batch;
+    }
+    reportPerEvent(state, events, allocations.count());
+    benchmark::DoNotOptimize(sum);
+  }
+  BENCHMARK(BM_UiQueuePostRunHeap)->Arg(64);
+
+  /// @brief Producer contention on the UI queue, the MPSC ring against the locked list it replaced
+  void BM_UiQueueContentionRing(benchmark::State &state) { contention<RingUiQueue>(state); }
+  BENCHMARK(BM_UiQueueContentionRing)->Arg(1)->Arg(8)->Arg(12)->Arg(16)->UseRealTime();
+
+  void BM_UiQueueContentionList(benchmark::State &state) { contention<ListUiQueue>(state); }
+  BENCHMARK(BM_UiQueueContentionList)->Arg(1)->Arg(8)->Arg(12)->Arg(16)->UseRealTime();
+} // namespace layrz_ble::bench
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+#include "alloc_counter.h"
+#include "bt_address.h"
+#include "legacy_conversions.h"
+#include "uuid.h"
+
+namespace layrz_ble::bench {
+  namespace {
+    constexpr const char *kUuid = "6E400001-B5A3-F393-E0A9-E50E24DCCA9E";
+    constexpr const char *kShortUuid = "180d";
+    constexpr const char *kAddress = "C8:2B:96:A1:07:5E";
+
+    const Uuid kParsedUuid = {{0x6e, 0x40, 0x00, 0x01, 0xb5, 0xa3, 0xf3, 0x93, 0xe0, 0xa9, 0xe5, 0x0e, 0x24, 0xdc, 0xca, 0x9e}};
+    const Guid kGuid = {0x6e400001, 0xb5a3, 0xf393, {0xe0, 0xa9, 0xe5, 0x0e, 0x24, 0xdc, 0xca, 0x9e}};
+  } // namespace
+
+  void BM_UuidParse(benchmark::State &state) {
+    std::string str = kUuid;
+    Uuid uuid{};
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(Uuid::parse(str, uuid));
+      benchmark::DoNotOptimize(uuid);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidParse);
+
+  void BM_UuidParseShort(benchmark::State &state) {
+    std::string str = kShortUuid;
+    Uuid uuid{};
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(Uuid::parse(str, uuid));
+      benchmark::DoNotOptimize(uuid);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidParseShort);
+
+  void BM_UuidFormat(benchmark::State &state) {
+    Uuid uuid = kParsedUuid;
+    char out[37];
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(uuid);
+      uuid.format(out);
+      benchmark::DoNotOptimize(out);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidFormat);
+
+  void BM_UuidToString(benchmark::State &state) {
+    Uuid uuid = kParsedUuid;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(uuid);
+      benchmark::DoNotOptimize(uuid.toString());
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidToString);
+
+  /// @brief The stringstream conversion Uuid::toString replaced, and the lowercasing every GATT key went
+  /// through
+  void BM_UuidToStringStream(benchmark::State &state) {
+    Guid guid = kGuid;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(guid);
+      auto str = streamGuidToString(guid);
+      std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+      benchmark::DoNotOptimize(str);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidToStringStream);
+
+  /// @brief The stringstream conversion Uuid::parse replaced
+  void BM_UuidParseStream(benchmark::State &state) {
+    std::string str = kUuid;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(streamStringToGuid(str));
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_UuidParseStream);
+
+  void BM_AddressParse(benchmark::State &state) {
+    std::string str = kAddress;
+    uint64_t address = 0;
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(parseBluetoothAddress(str, address));
+      benchmark::DoNotOptimize(address);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_AddressParse);
+
+  void BM_AddressFormat(benchmark::State &state) {
+    uint64_t address = 0xC82B96A1075EULL;
+    char out[18];
+
+    AllocationScope allocations;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(address);
+      formatBluetoothAddress(address, out);
+      benchmark::DoNotOptimize(out);
+    }
+    reportPerEvent(state, allocations.count());
+  }
+  BENCHMARK(BM_AddressFormat);
+} // namespace layrz_ble::bench
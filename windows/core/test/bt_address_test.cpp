@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "bt_address.h"
+
+namespace layrz_ble {
+  TEST(BtAddressTest, Parse) {
+    uint64_t address = 0;
+    EXPECT_TRUE(parseBluetoothAddress("C8:2B:96:A1:07:5E", address));
+    EXPECT_EQ(address, 0xC82B96A1075EULL);
+    EXPECT_TRUE(parseBluetoothAddress("c8-2b-96-a1-07-5e", address));
+    EXPECT_EQ(address, 0xC82B96A1075EULL);
+    EXPECT_TRUE(parseBluetoothAddress("00:00:00:00:00:00", address));
+    EXPECT_EQ(address, 0u);
+  }
+
+  TEST(BtAddressTest, ParseRejectsMalformedStrings) {
+    uint64_t address = 42;
+    EXPECT_FALSE(parseBluetoothAddress("", address));
+    EXPECT_FALSE(parseBluetoothAddress("C8:2B:96:A1:07", address));
+    EXPECT_FALSE(parseBluetoothAddress("C8:2B:96:A1:07:5E:00", address));
+    EXPECT_FALSE(parseBluetoothAddress("C8:2B:96:A1:07:5G", address));
+    EXPECT_FALSE(parseBluetoothAddress("C8.2B.96.A1.07.5E", address));
+    EXPECT_FALSE(parseBluetoothAddress("C82B:96A1:075E:00", address));
+    EXPECT_EQ(address, 42u);
+  }
+
+  TEST(BtAddressTest, FormatIsLowercaseAndZeroPadded) {
+    char out[18];
+    formatBluetoothAddress(0xC82B96A1075EULL, out);
+    EXPECT_STREQ(out, "c8:2b:96:a1:07:5e");
+    formatBluetoothAddress(0x000000000001ULL, out);
+    EXPECT_STREQ(out, "00:00:00:00:00:01");
+  }
+
+  TEST(BtAddressTest, FormatParseRoundTrip) {
+    char out[18];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 1000; ++i) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      uint64_t address = state & 0xFFFFFFFFFFFFULL;
+
+      formatBluetoothAddress(address, out);
+      uint64_t parsed = 0;
+      EXPECT_TRUE(parseBluetoothAddress(out, parsed));
+      EXPECT_EQ(parsed, address);
+    }
+  }
+} // namespace layrz_ble
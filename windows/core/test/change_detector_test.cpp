@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "change_detector.h"
+
+namespace layrz_ble {
+  namespace {
+    using Clock = ChangeDetector::Clock;
+    using std::chrono::seconds;
+  } // namespace
+
+  TEST(ChangeDetectorTest, DisabledSendsEverything) {
+    ScanStats stats;
+    ChangeDetector detector(&stats);
+    ChangeDetector::State state;
+    auto now = Clock::now();
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(detector.shouldEmit(state, 1, -60, now));
+    EXPECT_EQ(stats.emitted.load(), 10u);
+    EXPECT_EQ(stats.suppressed.load(), 0u);
+  }
+
+  TEST(ChangeDetectorTest, SuppressesUnchangedResults) {
+    ScanStats stats;
+    ChangeDetector detector(&stats);
+    detector.configure(true, 5, seconds(10));
+    EXPECT_TRUE(detector.enabled());
+
+    ChangeDetector::State state;
+    auto now = Clock::now();
+    EXPECT_TRUE(detector.shouldEmit(state, 1, -60, now));
+    EXPECT_FALSE(detector.shouldEmit(state, 1, -64, now));
+    // Content changed
+    EXPECT_TRUE(detector.shouldEmit(state, 2, -64, now));
+    // RSSI moved by the hysteresis from the last sent RSSI
+    EXPECT_TRUE(detector.shouldEmit(state, 2, -69, now));
+    EXPECT_FALSE(detector.shouldEmit(state, 2, -65, now));
+    // Silent for too long
+    EXPECT_TRUE(detector.shouldEmit(state, 2, -69, now + seconds(10)));
+
+    EXPECT_EQ(stats.emitted.load(), 4u);
+    EXPECT_EQ(stats.suppressed.load(), 2u);
+    stats.reset();
+    EXPECT_EQ(stats.emitted.load(), 0u);
+  }
+
+  TEST(ChangeDetectorTest, NoHysteresisStillSuppressesIdenticalResults) {
+    for (int64_t hysteresis : {0, -3}) {
+      ScanStats stats;
+      ChangeDetector detector(&stats);
+      detector.configure(true, hysteresis, seconds(10));
+
+      ChangeDetector::State state;
+      auto now = Clock::now();
+      EXPECT_TRUE(detector.shouldEmit(state, 1, -60, now));
+      // The same frame at the same RSSI, as a beacon repeats it
+      EXPECT_FALSE(detector.shouldEmit(state, 1, -60, now));
+      // Any RSSI change is worth sending
+      EXPECT_TRUE(detector.shouldEmit(state, 1, -61, now));
+      EXPECT_EQ(stats.suppressed.load(), 1u);
+    }
+  }
+
+  TEST(ChangeDetectorTest, ZeroSilenceHasNoHeartbeat) {
+    ChangeDetector detector;
+    detector.configure(true, 5, Clock::duration::zero());
+
+    ChangeDetector::State state;
+    auto now = Clock::now();
+    EXPECT_TRUE(detector.shouldEmit(state, 1, -60, now));
+    EXPECT_FALSE(detector.shouldEmit(state, 1, -61, now + seconds(3600)));
+  }
+
+  TEST(ChangeDetectorTest, ConfigureWhileChecking) {
+    ScanStats stats;
+    ChangeDetector detector(&stats);
+    std::atomic<bool> done{false};
+    std::thread ui([&detector, &done]() {
+      for (int i = 0; !done.load(); ++i)
+        detector.configure(i % 2 == 0, i % 10, seconds(i % 3));
+    });
+
+    ChangeDetector::State state;
+    auto now = Clock::now();
+    for (int i = 0; i < 100000; ++i) detector.shouldEmit(state, static_cast<uint64_t>(i % 7), -60 - i % 9, now);
+    done.store(true);
+    ui.join();
+    EXPECT_EQ(stats.emitted.load() + stats.suppressed.load(), 100000u);
+  }
+} // namespace layrz_ble
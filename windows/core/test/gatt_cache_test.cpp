@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "gatt_cache.h"
+#include "temporary_directory.h"
+
+namespace layrz_ble {
+  namespace {
+    constexpr uint64_t kAddress = 0xC82B96A1075EULL;
+    constexpr uint64_t kOtherAddress = 0xC82B96A1075FULL;
+
+    /// @brief Heart rate and battery services, with a database hash
+    GattLayout sensorLayout() {
+      GattLayout layout;
+      layout.hasDatabaseHash = true;
+      for (size_t i = 0; i < layout.databaseHash.size(); ++i) layout.databaseHash[i] = static_cast<uint8_t>(i * 17);
+
+      CachedService heartRate;
+      heartRate.uuid = Uuid::fromShort(0x180D);
+      heartRate.characteristics.push_back({Uuid::fromShort(0x2A37), 0x10});
+      heartRate.characteristics.push_back({Uuid::fromShort(0x2A38), 0x02});
+      layout.services.push_back(heartRate);
+
+      CachedService battery;
+      battery.uuid = Uuid::fromShort(0x180F);
+      battery.characteristics.push_back({Uuid::fromShort(0x2A19), 0x12});
+      layout.services.push_back(battery);
+      return layout;
+    }
+
+    /// @brief A UART service without a database hash, and an empty service
+    GattLayout uartLayout() {
+      GattLayout layout;
+      CachedService uart;
+      Uuid::parse("6e400001-b5a3-f393-e0a9-e50e24dcca9e", uart.uuid);
+      CachedCharacteristic rx;
+      Uuid::parse("6e400002-b5a3-f393-e0a9-e50e24dcca9e", rx.uuid);
+      rx.properties = 0x0C;
+      uart.characteristics.push_back(rx);
+      layout.services.push_back(uart);
+      layout.services.push_back(CachedService{Uuid::fromShort(0x1801), {}});
+      return layout;
+    }
+
+    void expectSameLayout(const GattLayout &actual, const GattLayout &expected) {
+      EXPECT_EQ(actual.hasDatabaseHash, expected.hasDatabaseHash);
+      EXPECT_EQ(actual.databaseHash, expected.databaseHash);
+      EXPECT_EQ(actual.services, expected.services);
+    }
+  } // namespace
+
+  using GattCacheFileTest = TemporaryDirectoryTest;
+
+  TEST(GattCacheTest, SerializeRoundTrip) {
+    GattCache::Layouts layouts;
+    layouts[kAddress] = sensorLayout();
+    layouts[kOtherAddress] = uartLayout();
+
+    auto bytes = GattCache::serialize(layouts);
+    GattCache::Layouts decoded;
+    ASSERT_TRUE(GattCache::deserialize(ByteView(bytes.data(), bytes.size()), decoded));
+    ASSERT_EQ(decoded.size(), 2u);
+    expectSameLayout(decoded[kAddress], layouts[kAddress]);
+    expectSameLayout(decoded[kOtherAddress], layouts[kOtherAddress]);
+  }
+
+  TEST(GattCacheTest, SerializeEmpty) {
+    auto bytes = GattCache::serialize({});
+    EXPECT_EQ(bytes.size(), 24u);
+
+    GattCache::Layouts decoded;
+    decoded[kAddress] = sensorLayout();
+    EXPECT_TRUE(GattCache::deserialize(ByteView(bytes.data(), bytes.size()), decoded));
+    EXPECT_TRUE(decoded.empty());
+  }
+
+  TEST(GattCacheTest, DeserializeRejectsCorruption) {
+    GattCache::Layouts layouts;
+    layouts[kAddress] = sensorLayout();
+    const auto bytes = GattCache::serialize(layouts);
+
+    auto rejected = [](const std::vector<uint8_t> &corrupted) {
+      GattCache::Layouts decoded;
+      decoded[kOtherAddress] = uartLayout();
+      bool ok = GattCache::deserialize(ByteView(corrupted.data(), corrupted.size()), decoded);
+      // A rejected file leaves nothing behind
+      return !ok && decoded.empty();
+    };
+
+    auto badMagic = bytes;
+    badMagic[0] ^= 0xFF;
+    EXPECT_TRUE(rejected(badMagic));
+
+    auto badVersion = bytes;
+    badVersion[4] = 0x7F;
+    EXPECT_TRUE(rejected(badVersion));
+
+    auto flippedBody = bytes;
+    flippedBody[30] ^= 0x01;
+    EXPECT_TRUE(rejected(flippedBody));
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    EXPECT_TRUE(rejected(truncated));
+
+    auto trailing = bytes;
+    trailing.push_back(0);
+    EXPECT_TRUE(rejected(trailing));
+
+    EXPECT_TRUE(rejected(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 10)));
+    EXPECT_TRUE(rejected({}));
+  }
+
+  TEST(GattCacheTest, StoreFindInvalidate) {
+    GattCache cache;
+    GattLayout layout;
+    EXPECT_FALSE(cache.find(kAddress, layout));
+
+    cache.store(kAddress, sensorLayout());
+    EXPECT_EQ(cache.size(), 1u);
+    ASSERT_TRUE(cache.find(kAddress, layout));
+    expectSameLayout(layout, sensorLayout());
+
+    cache.store(kAddress, uartLayout());
+    EXPECT_EQ(cache.size(), 1u);
+    ASSERT_TRUE(cache.find(kAddress, layout));
+    expectSameLayout(layout, uartLayout());
+
+    EXPECT_TRUE(cache.invalidate(kAddress));
+    EXPECT_FALSE(cache.invalidate(kAddress));
+    EXPECT_EQ(cache.size(), 0u);
+  }
+
+  TEST(GattCacheTest, SaveWithoutPathFails) {
+    GattCache cache;
+    cache.store(kAddress, sensorLayout());
+    EXPECT_FALSE(cache.save());
+    EXPECT_FALSE(cache.load());
+  }
+
+  TEST_F(GattCacheFileTest, SaveLoadRoundTrip) {
+    auto path = directory_ / "nested" / "gatt_cache.bin";
+    {
+      GattCache cache(path);
+      cache.store(kAddress, sensorLayout());
+      cache.store(kOtherAddress, uartLayout());
+      ASSERT_TRUE(cache.save());
+    }
+    EXPECT_TRUE(std::filesystem::exists(path));
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(path).concat(".tmp")));
+
+    GattCache reloaded;
+    reloaded.setPath(path);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.size(), 2u);
+
+    GattLayout layout;
+    ASSERT_TRUE(reloaded.find(kAddress, layout));
+    expectSameLayout(layout, sensorLayout());
+    ASSERT_TRUE(reloaded.find(kOtherAddress, layout));
+    expectSameLayout(layout, uartLayout());
+  }
+
+  TEST_F(GattCacheFileTest, SaveReplacesThePreviousFile) {
+    auto path = directory_ / "gatt_cache.bin";
+    GattCache cache(path);
+    cache.store(kAddress, sensorLayout());
+    cache.store(kOtherAddress, uartLayout());
+    ASSERT_TRUE(cache.save());
+
+    cache.invalidate(kOtherAddress);
+    ASSERT_TRUE(cache.save());
+
+    GattCache reloaded(path);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.size(), 1u);
+  }
+
+  TEST_F(GattCacheFileTest, LoadOfMissingOrEmptyFileEmptiesTheCache) {
+    auto path = directory_ / "gatt_cache.bin";
+    GattCache cache(path);
+    cache.store(kAddress, sensorLayout());
+    EXPECT_FALSE(cache.load());
+    EXPECT_EQ(cache.size(), 0u);
+
+    std::filesystem::create_directories(directory_);
+    { std::ofstream(path, std::ios::binary); }
+    cache.store(kAddress, sensorLayout());
+    EXPECT_FALSE(cache.load());
+    EXPECT_EQ(cache.size(), 0u);
+  }
+} // namespace layrz_ble
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "mapped_file.h"
+#include "temporary_directory.h"
+
+namespace layrz_ble {
+  using MappedFileTest = TemporaryDirectoryTest;
+
+  TEST_F(MappedFileTest, CreateWriteRead) {
+    auto path = directory_ / "data.bin";
+    const char text[] = "layrz ble mapped file";
+    {
+      MappedFile file;
+      ASSERT_TRUE(file.create(path, sizeof(text)));
+      EXPECT_TRUE(file.isOpen());
+      EXPECT_EQ(file.size(), sizeof(text));
+      ASSERT_NE(file.mutableData(), nullptr);
+      std::memcpy(file.mutableData(), text, sizeof(text));
+      EXPECT_TRUE(file.flush());
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(text));
+
+    MappedFile file;
+    ASSERT_TRUE(file.openRead(path));
+    EXPECT_EQ(file.size(), sizeof(text));
+    EXPECT_EQ(file.mutableData(), nullptr);
+    EXPECT_EQ(std::memcmp(file.data(), text, sizeof(text)), 0);
+  }
+
+  TEST_F(MappedFileTest, CreateTruncatesAnExistingFile) {
+    auto path = directory_ / "data.bin";
+    { std::ofstream(path, std::ios::binary) << std::string(4096, 'x'); }
+
+    MappedFile file;
+    ASSERT_TRUE(file.create(path, 8));
+    file.close();
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(std::filesystem::file_size(path), 8u);
+  }
+
+  TEST_F(MappedFileTest, OpenReadOfMissingFileFails) {
+    MappedFile file;
+    EXPECT_FALSE(file.openRead(directory_ / "missing.bin"));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(file.data(), nullptr);
+  }
+
+  TEST_F(MappedFileTest, OpenReadOfEmptyFile) {
+    auto path = directory_ / "empty.bin";
+    { std::ofstream(path, std::ios::binary); }
+
+    MappedFile file;
+    ASSERT_TRUE(file.openRead(path));
+    EXPECT_EQ(file.size(), 0u);
+  }
+
+  TEST_F(MappedFileTest, MoveTransfersTheMapping) {
+    auto path = directory_ / "data.bin";
+    MappedFile file;
+    ASSERT_TRUE(file.create(path, 4));
+    file.mutableData()[0] = 0x5A;
+
+    MappedFile moved(std::move(file));
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(file.data(), nullptr);
+    ASSERT_TRUE(moved.isOpen());
+    EXPECT_EQ(moved.data()[0], 0x5A);
+
+    MappedFile assigned;
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved.isOpen());
+    EXPECT_EQ(assigned.size(), 4u);
+    EXPECT_TRUE(assigned.flush());
+  }
+} // namespace layrz_ble
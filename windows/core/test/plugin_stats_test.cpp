@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "plugin_stats.h"
+
+namespace layrz_ble {
+  namespace {
+    std::map<std::string, uint64_t> report(const PluginStats &stats, size_t &visited) {
+      std::map<std::string, uint64_t> values;
+      visited = 0;
+      stats.visit([&values, &visited](const char *name, uint64_t value) {
+        values[name] = value;
+        ++visited;
+      });
+      return values;
+    }
+  } // namespace
+
+  TEST(PluginStatsTest, VisitsEveryNameOnce) {
+    PluginStats stats;
+    size_t visited = 0;
+    auto values = report(stats, visited);
+    EXPECT_EQ(values.size(), visited);
+
+    for (const char *name : {"scanEventsEmitted", "scanEventsSuppressed", "gattOperations", "gattOperationsTimedOut",
+                             "gattOperationsCancelled", "gattQueueWaitUs", "gattQueueWaitMaxUs", "gattServiceUs",
+                             "gattServiceMaxUs", "readCacheHits", "readsCoalesced"}) {
+      EXPECT_EQ(values.count(name), 1u) << name;
+    }
+  }
+
+  TEST(PluginStatsTest, ResetClearsEveryCounter) {
+    PluginStats stats;
+    stats.scan.emitted.fetch_add(3);
+    stats.scan.suppressed.fetch_add(2);
+    stats.operations.completed.fetch_add(1);
+    stats.operations.recordQueueWait(250);
+    stats.operations.recordService(900);
+    stats.reads.cacheHits.fetch_add(4);
+    stats.reads.coalesced.fetch_add(5);
+    stats.gatt(GattOperationKind::Read).record(GattOperationStatus::Succeeded, 1200);
+
+    size_t visited = 0;
+    auto values = report(stats, visited);
+    EXPECT_EQ(values["scanEventsEmitted"], 3u);
+    EXPECT_EQ(values["scanEventsSuppressed"], 2u);
+    EXPECT_EQ(values["gattOperations"], 1u);
+    EXPECT_EQ(values["gattQueueWaitMaxUs"], 250u);
+    EXPECT_EQ(values["gattServiceUs"], 900u);
+    EXPECT_EQ(values["readCacheHits"], 4u);
+    EXPECT_EQ(values["readsCoalesced"], 5u);
+    EXPECT_EQ(values["gattReadSucceeded"], 1u);
+
+    stats.reset();
+    for (const auto &[name, value] : report(stats, visited)) EXPECT_EQ(value, 0u) << name;
+  }
+} // namespace layrz_ble
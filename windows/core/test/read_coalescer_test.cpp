@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "read_coalescer.h"
+
+namespace layrz_ble {
+  namespace {
+    using Value = ReadCoalescer::Value;
+
+    const ReadPolicy kCached{ReadFreshness::Cached, std::chrono::milliseconds(0)};
+
+    /// @brief Waiter that counts its answers and keeps the last value
+    struct Answers {
+      int count = 0;
+      OperationEnd end = OperationEnd::Completed;
+      Value value;
+      bool hasValue = false;
+
+      ReadCoalescer::Waiter waiter() {
+        return [this](OperationEnd ended, const Value *answered) {
+          ++count;
+          end = ended;
+          hasValue = answered != nullptr;
+          if (answered != nullptr) value = *answered;
+        };
+      }
+    }; // struct Answers
+  } // namespace
+
+  TEST(ReadCoalescerTest, ConcurrentReadsShareOneRead) {
+    ReadCoalescer reads;
+    Answers first, second;
+    Value cached;
+    uint64_t ticket = 0, joined = 0;
+    ASSERT_EQ(reads.begin(3, kCached, first.waiter(), cached, ticket), ReadCoalescer::Start::Lead);
+    ASSERT_EQ(reads.begin(3, kCached, second.waiter(), cached, joined), ReadCoalescer::Start::Joined);
+
+    Value value = {1, 2, 3};
+    reads.complete(3, ticket, &value);
+    EXPECT_EQ(first.count, 1);
+    EXPECT_EQ(second.count, 1);
+    EXPECT_EQ(second.value, value);
+
+    Answers third;
+    ASSERT_EQ(reads.begin(3, kCached, third.waiter(), cached, ticket), ReadCoalescer::Start::Hit);
+    EXPECT_EQ(cached, value);
+    EXPECT_EQ(third.count, 0);
+  }
+
+  TEST(ReadCoalescerTest, ReadInFlightDuringAWriteIsNotCached) {
+    ReadCoalescer reads;
+    Answers lead;
+    Value cached;
+    uint64_t ticket = 0;
+    ASSERT_EQ(reads.begin(3, kCached, lead.waiter(), cached, ticket), ReadCoalescer::Start::Lead);
+
+    // A write runs next to the read, the read may return the value from before it
+    reads.invalidate(3);
+    Value stale = {0xAA};
+    reads.complete(3, ticket, &stale);
+    EXPECT_EQ(lead.count, 1);
+    EXPECT_EQ(lead.value, stale);
+
+    Answers next;
+    EXPECT_EQ(reads.begin(3, kCached, next.waiter(), cached, ticket), ReadCoalescer::Start::Lead);
+  }
+
+  TEST(ReadCoalescerTest, AbortIgnoresTheLateCompletion) {
+    ReadCoalescer reads;
+    Answers lead;
+    Value cached;
+    uint64_t ticket = 0;
+    ASSERT_EQ(reads.begin(3, kCached, lead.waiter(), cached, ticket), ReadCoalescer::Start::Lead);
+
+    reads.abort(3, ticket, OperationEnd::TimedOut);
+    EXPECT_EQ(lead.count, 1);
+    EXPECT_EQ(lead.end, OperationEnd::TimedOut);
+    EXPECT_FALSE(lead.hasValue);
+
+    Value late = {0x01};
+    reads.complete(3, ticket, &late);
+    EXPECT_EQ(lead.count, 1);
+
+    Answers next;
+    EXPECT_EQ(reads.begin(3, kCached, next.waiter(), cached, ticket), ReadCoalescer::Start::Lead);
+  }
+} // namespace layrz_ble
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "scan_capture.h"
+#include "simulated_advertiser.h"
+#include "temporary_directory.h"
+
+namespace layrz_ble {
+  namespace {
+    /// @brief An advertisement copied out of a sink call, whose buffers do not outlive it
+    struct Captured {
+      uint64_t address;
+      int64_t rssi;
+      bool hasTxPower;
+      int16_t txPower;
+      std::vector<uint8_t> raw;
+      std::vector<uint8_t> manufacturerData;
+
+      bool operator==(const Captured &other) const {
+        return address == other.address && rssi == other.rssi && hasTxPower == other.hasTxPower &&
+          txPower == other.txPower && raw == other.raw && manufacturerData == other.manufacturerData;
+      }
+    }; // struct Captured
+
+    Captured copy(const ReceivedAdvertisement &advertisement) {
+      Captured captured{
+        advertisement.address,
+        advertisement.rssi,
+        advertisement.hasTxPower,
+        advertisement.txPower,
+        std::vector<uint8_t>(advertisement.raw.begin(), advertisement.raw.end()),
+        {},
+      };
+      if (advertisement.parsed != nullptr && advertisement.parsed->manufacturerDataCount() > 0) {
+        const auto &data = advertisement.parsed->manufacturerData(0).data;
+        captured.manufacturerData.assign(data.begin(), data.end());
+      }
+      return captured;
+    }
+
+    /// @brief Capture count simulated advertisements, every third one with a txPower
+    std::vector<Captured> writeCapture(const std::filesystem::path &path, size_t count) {
+      SimulationConfig config;
+      config.advertisers = 200;
+      config.rate = 0;
+      SimulatedAdvertiser advertiser(config);
+
+      ScanCaptureWriter writer;
+      EXPECT_TRUE(writer.open(path));
+      std::vector<Captured> written;
+      advertiser.emit(count, [&writer, &written](const ReceivedAdvertisement &emitted) {
+        auto advertisement = emitted;
+        if (written.size() % 3 == 0) {
+          advertisement.hasTxPower = true;
+          advertisement.txPower = -12;
+        }
+        writer.append(advertisement);
+        written.push_back(copy(advertisement));
+      });
+      EXPECT_EQ(writer.Written(), count);
+      writer.close();
+      return written;
+    }
+
+    std::vector<Captured> replayAll(ScanCaptureReplay &replay) {
+      std::vector<Captured> replayed;
+      replay.replay([&replayed](const ReceivedAdvertisement &advertisement) { replayed.push_back(copy(advertisement)); });
+      return replayed;
+    }
+
+    bool waitStopped(const ScanBackend &backend) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (backend.running()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return true;
+    }
+  } // namespace
+
+  using ScanCaptureTest = TemporaryDirectoryTest;
+
+  TEST_F(ScanCaptureTest, ReplayGivesBackTheCapturedAdvertisements) {
+    auto path = directory_ / "scan.lbsc";
+    auto before = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    // Enough records to span several write blocks
+    auto written = writeCapture(path, 3000);
+
+    ScanCaptureReplay replay(ReplayConfig{path, 0});
+    ASSERT_TRUE(replay.open());
+    EXPECT_GE(replay.StartedAt(), static_cast<uint64_t>(before));
+
+    auto replayed = replayAll(replay);
+    ASSERT_EQ(replayed.size(), written.size());
+    for (size_t i = 0; i < written.size(); ++i) EXPECT_EQ(replayed[i], written[i]) << "record " << i;
+    EXPECT_EQ(replay.Replayed(), 3000u);
+    EXPECT_FALSE(replay.Truncated());
+  }
+
+  TEST_F(ScanCaptureTest, RssiAndTxPowerAreClamped) {
+    auto path = directory_ / "scan.lbsc";
+    ScanCaptureWriter writer;
+    ASSERT_TRUE(writer.open(path));
+
+    ReceivedAdvertisement advertisement;
+    advertisement.address = 0xC82B96A1075EULL;
+    advertisement.rssi = -200;
+    advertisement.hasTxPower = true;
+    advertisement.txPower = 300;
+    writer.append(advertisement);
+    writer.close();
+
+    ScanCaptureReplay replay(ReplayConfig{path, 0});
+    auto replayed = replayAll(replay);
+    ASSERT_EQ(replayed.size(), 1u);
+    EXPECT_EQ(replayed[0].address, 0xC82B96A1075EULL);
+    EXPECT_EQ(replayed[0].rssi, -128);
+    EXPECT_EQ(replayed[0].txPower, 127);
+    EXPECT_TRUE(replayed[0].raw.empty());
+  }
+
+  TEST_F(ScanCaptureTest, TruncatedFileStopsAtTheLastCompleteRecord) {
+    auto path = directory_ / "scan.lbsc";
+    auto written = writeCapture(path, 10);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+
+    ScanCaptureReplay replay(ReplayConfig{path, 0});
+    auto replayed = replayAll(replay);
+    ASSERT_EQ(replayed.size(), 9u);
+    EXPECT_EQ(replayed[8], written[8]);
+    EXPECT_TRUE(replay.Truncated());
+  }
+
+  TEST_F(ScanCaptureTest, HeaderOnlyCaptureIsEmpty) {
+    auto path = directory_ / "scan.lbsc";
+    writeCapture(path, 0);
+    EXPECT_EQ(std::filesystem::file_size(path), capture::kHeaderSize);
+
+    ScanCaptureReplay replay(ReplayConfig{path, 0});
+    EXPECT_TRUE(replayAll(replay).empty());
+    EXPECT_FALSE(replay.Truncated());
+  }
+
+  TEST_F(ScanCaptureTest, RejectsFilesThatAreNotCaptures) {
+    ScanCaptureReplay missing(ReplayConfig{directory_ / "missing.lbsc", 0});
+    EXPECT_FALSE(missing.open());
+    EXPECT_FALSE(missing.start([](const ReceivedAdvertisement &) {}));
+    EXPECT_FALSE(missing.running());
+
+    auto path = directory_ / "other.bin";
+    { std::ofstream(path, std::ios::binary) << "not a scan capture at all"; }
+    ScanCaptureReplay other(ReplayConfig{path, 0});
+    EXPECT_FALSE(other.open());
+    EXPECT_EQ(other.replay([](const ReceivedAdvertisement &) {}), 0u);
+  }
+
+  TEST_F(ScanCaptureTest, AppendAfterCloseIsDropped) {
+    ScanCaptureWriter writer;
+    ASSERT_TRUE(writer.open(directory_ / "scan.lbsc"));
+    writer.close();
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_FALSE(writer.flush());
+
+    writer.append(ReceivedAdvertisement{});
+    EXPECT_EQ(writer.Written(), 0u);
+    EXPECT_EQ(writer.Dropped(), 1u);
+  }
+
+  TEST_F(ScanCaptureTest, SpeedZeroReplaysTheWholeFileFromItsThread) {
+    auto path = directory_ / "scan.lbsc";
+    auto written = writeCapture(path, 500);
+
+    ScanCaptureReplay replay(ReplayConfig{path, 0});
+    std::vector<Captured> replayed;
+    ASSERT_TRUE(replay.start([&replayed](const ReceivedAdvertisement &advertisement) {
+      replayed.push_back(copy(advertisement));
+    }));
+    ASSERT_TRUE(waitStopped(replay));
+    replay.stop();
+
+    EXPECT_EQ(replayed, written);
+    EXPECT_EQ(replay.Replayed(), 500u);
+  }
+
+  TEST_F(ScanCaptureTest, ReplayKeepsTheCaptureTiming) {
+    auto path = directory_ / "scan.lbsc";
+    ScanCaptureWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    ReceivedAdvertisement advertisement;
+    advertisement.address = 1;
+    writer.append(advertisement);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    advertisement.address = 2;
+    writer.append(advertisement);
+    writer.close();
+
+    auto replayFor = [&path](double speed) {
+      ScanCaptureReplay replay(ReplayConfig{path, speed});
+      auto startedAt = std::chrono::steady_clock::now();
+      EXPECT_TRUE(replay.start([](const ReceivedAdvertisement &) {}));
+      EXPECT_TRUE(waitStopped(replay));
+      replay.stop();
+      EXPECT_EQ(replay.Replayed(), 2u);
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    };
+
+    auto captured = replayFor(1);
+    EXPECT_GE(captured, 0.05);
+    EXPECT_LT(replayFor(10), captured);
+  }
+} // namespace layrz_ble
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+#include "adv_parser.h"
+#include "scan_filter.h"
+
+namespace layrz_ble {
+  namespace {
+    constexpr uint64_t kAddress = 0xC82B96A1075EULL;
+    constexpr uint64_t kOtherAddress = 0xC82B96A1075FULL;
+
+    /// @brief Raw advertisement payload, kept alive next to its parsed view
+    class Advertisement {
+      public:
+        Advertisement &add(uint8_t type, std::initializer_list<uint8_t> value) {
+          bytes_.push_back(static_cast<uint8_t>(value.size() + 1));
+          bytes_.push_back(type);
+          bytes_.insert(bytes_.end(), value.begin(), value.end());
+          return *this;
+        }
+
+        Advertisement &name(std::string_view name) {
+          bytes_.push_back(static_cast<uint8_t>(name.size() + 1));
+          bytes_.push_back(AdType::CompleteLocalName);
+          bytes_.insert(bytes_.end(), name.begin(), name.end());
+          return *this;
+        }
+
+        const ParsedAdvertisement &parsed() {
+          parsed_.clear();
+          parseAdvertisement(ByteView(bytes_.data(), bytes_.size()), parsed_);
+          return parsed_;
+        }
+
+      private:
+        std::vector<uint8_t> bytes_;
+        ParsedAdvertisement parsed_;
+    }; // class Advertisement
+  } // namespace
+
+  TEST(ScanFilterTest, EmptyFilterMatchesEverything) {
+    ScanFilter filter;
+    EXPECT_TRUE(filter.empty());
+    filter.compile();
+
+    Advertisement advertisement;
+    EXPECT_EQ(filter.check(kAddress, -100, advertisement.parsed()), FilterMatch::Matched);
+  }
+
+  TEST(ScanFilterTest, RssiFloor) {
+    ScanFilter filter;
+    filter.setMinRssi(-70);
+    filter.compile();
+    EXPECT_FALSE(filter.empty());
+
+    Advertisement advertisement;
+    EXPECT_TRUE(filter.matches(kAddress, -70, advertisement.parsed()));
+    EXPECT_TRUE(filter.matches(kAddress, -40, advertisement.parsed()));
+    EXPECT_EQ(filter.check(kAddress, -71, advertisement.parsed()), FilterMatch::Rejected);
+  }
+
+  TEST(ScanFilterTest, AddressAllowlist) {
+    ScanFilter filter;
+    EXPECT_TRUE(filter.addAddress("C8:2B:96:A1:07:5E"));
+    EXPECT_FALSE(filter.addAddress("C8:2B:96:A1:07"));
+    EXPECT_FALSE(filter.addAddress("not an address"));
+    filter.compile();
+
+    Advertisement advertisement;
+    EXPECT_TRUE(filter.matches(kAddress, -60, advertisement.parsed()));
+    EXPECT_EQ(filter.check(kOtherAddress, -60, advertisement.parsed()), FilterMatch::Rejected);
+  }
+
+  TEST(ScanFilterTest, ServiceUuidInListOrServiceData) {
+    ScanFilter filter;
+    EXPECT_TRUE(filter.addServiceUuid("180F"));
+    EXPECT_TRUE(filter.addServiceUuid("6e400001-b5a3-f393-e0a9-e50e24dcca9e"));
+    EXPECT_FALSE(filter.addServiceUuid("18"));
+    filter.compile();
+
+    Advertisement list;
+    list.add(AdType::IncompleteServices16, {0x0A, 0x18, 0x0F, 0x18});
+    EXPECT_TRUE(filter.matches(kAddress, -60, list.parsed()));
+
+    Advertisement serviceData;
+    serviceData.add(AdType::ServiceData16, {0x0F, 0x18, 0x5A});
+    EXPECT_TRUE(filter.matches(kAddress, -60, serviceData.parsed()));
+
+    Advertisement wide;
+    wide.add(AdType::CompleteServices128, {
+      0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E,
+    });
+    EXPECT_TRUE(filter.matches(kAddress, -60, wide.parsed()));
+
+    Advertisement other;
+    other.add(AdType::CompleteServices16, {0x0D, 0x18});
+    EXPECT_EQ(filter.check(kAddress, -60, other.parsed()), FilterMatch::ContentMismatch);
+  }
+
+  TEST(ScanFilterTest, CompanyId) {
+    ScanFilter filter;
+    filter.addCompanyId(0x004C);
+    filter.addCompanyId(0x0059);
+    filter.compile();
+
+    Advertisement apple;
+    apple.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x02, 0x15});
+    EXPECT_TRUE(filter.matches(kAddress, -60, apple.parsed()));
+
+    Advertisement microsoft;
+    microsoft.add(AdType::ManufacturerSpecificData, {0x06, 0x00, 0x01});
+    EXPECT_FALSE(filter.matches(kAddress, -60, microsoft.parsed()));
+  }
+
+  TEST(ScanFilterTest, ManufacturerDataPattern) {
+    ScanFilter filter;
+    ManufacturerDataPattern ibeacon;
+    ibeacon.companyId = 0x004C;
+    ibeacon.data = {0x02, 0x15};
+    EXPECT_TRUE(filter.addManufacturerDataPattern(ibeacon));
+
+    // The high nibble of the second byte after the company ID
+    ManufacturerDataPattern masked;
+    masked.offset = 1;
+    masked.data = {0xA0};
+    masked.mask = {0xF0};
+    EXPECT_TRUE(filter.addManufacturerDataPattern(masked));
+
+    ManufacturerDataPattern empty;
+    EXPECT_FALSE(filter.addManufacturerDataPattern(empty));
+    ManufacturerDataPattern badMask;
+    badMask.data = {0x01, 0x02};
+    badMask.mask = {0xFF};
+    EXPECT_FALSE(filter.addManufacturerDataPattern(badMask));
+    filter.compile();
+
+    Advertisement beacon;
+    beacon.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x02, 0x15, 0x00});
+    EXPECT_TRUE(filter.matches(kAddress, -60, beacon.parsed()));
+
+    // Right bytes, wrong company
+    Advertisement otherCompany;
+    otherCompany.add(AdType::ManufacturerSpecificData, {0xFF, 0xFF, 0x02, 0x16});
+    EXPECT_FALSE(filter.matches(kAddress, -60, otherCompany.parsed()));
+
+    Advertisement maskedMatch;
+    maskedMatch.add(AdType::ManufacturerSpecificData, {0xFF, 0xFF, 0x00, 0xA7});
+    EXPECT_TRUE(filter.matches(kAddress, -60, maskedMatch.parsed()));
+
+    // Too short for the offset of the pattern
+    Advertisement shortData;
+    shortData.add(AdType::ManufacturerSpecificData, {0xFF, 0xFF, 0x00});
+    EXPECT_FALSE(filter.matches(kAddress, -60, shortData.parsed()));
+  }
+
+  TEST(ScanFilterTest, NamePrefix) {
+    ScanFilter filter;
+    filter.addNamePrefix("LAYRZ-");
+    filter.compile();
+
+    Advertisement named;
+    named.name("LAYRZ-TRACKER");
+    EXPECT_TRUE(filter.matches(kAddress, -60, named.parsed()));
+
+    Advertisement otherName;
+    otherName.name("LAYR");
+    EXPECT_FALSE(filter.matches(kAddress, -60, otherName.parsed()));
+
+    Advertisement unnamed;
+    EXPECT_FALSE(filter.matches(kAddress, -60, unnamed.parsed()));
+  }
+
+  TEST(ScanFilterTest, EveryCriterionMustMatch) {
+    ScanFilter filter;
+    filter.addCompanyId(0x004C);
+    filter.addNamePrefix("LAYRZ-");
+    filter.setMinRssi(-80);
+    filter.compile();
+
+    Advertisement both;
+    both.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01}).name("LAYRZ-1");
+    EXPECT_TRUE(filter.matches(kAddress, -60, both.parsed()));
+    EXPECT_EQ(filter.check(kAddress, -90, both.parsed()), FilterMatch::Rejected);
+
+    Advertisement companyOnly;
+    companyOnly.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01});
+    EXPECT_EQ(filter.check(kAddress, -60, companyOnly.parsed()), FilterMatch::ContentMismatch);
+  }
+
+  TEST(ScanFilterTest, MatchedBeforeOnlyLiftsTheContentCriteria) {
+    ScanFilter filter;
+    filter.addCompanyId(0x004C);
+    filter.setMinRssi(-80);
+    filter.compile();
+
+    // The scan response of a device whose advertisement matched
+    Advertisement scanResponse;
+    scanResponse.name("LAYRZ-1");
+    EXPECT_FALSE(filter.matches(kAddress, -60, scanResponse.parsed()));
+    EXPECT_TRUE(filter.matches(kAddress, -60, scanResponse.parsed(), true));
+
+    // The RSSI floor still applies
+    EXPECT_FALSE(filter.matches(kAddress, -90, scanResponse.parsed(), true));
+  }
+
+  TEST(ScanFilterTest, GenerationChangesOnEveryCompile) {
+    ScanFilter first;
+    EXPECT_EQ(first.Generation(), 0u);
+    first.compile();
+
+    ScanFilter second;
+    second.compile();
+    EXPECT_NE(first.Generation(), 0u);
+    EXPECT_GT(second.Generation(), first.Generation());
+  }
+} // namespace layrz_ble
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "adv_parser.h"
+#include "scan_pipeline.h"
+
+namespace layrz_ble {
+  namespace {
+    using std::chrono::seconds;
+
+    constexpr uint64_t kAddress = 0xC82B96A1075EULL;
+    constexpr uint64_t kOtherAddress = 0xC82B96A1075FULL;
+
+    /// @brief Raw advertisement payload, kept alive next to its parsed view
+    class Advertisement {
+      public:
+        Advertisement &add(uint8_t type, std::initializer_list<uint8_t> value) {
+          bytes_.push_back(static_cast<uint8_t>(value.size() + 1));
+          bytes_.push_back(type);
+          bytes_.insert(bytes_.end(), value.begin(), value.end());
+          return *this;
+        }
+
+        Advertisement &name(std::string_view name) {
+          bytes_.push_back(static_cast<uint8_t>(name.size() + 1));
+          bytes_.push_back(AdType::CompleteLocalName);
+          bytes_.insert(bytes_.end(), name.begin(), name.end());
+          return *this;
+        }
+
+        /// @brief Received form of the advertisement, valid until the next call
+        const ReceivedAdvertisement &received(uint64_t address, int64_t rssi) {
+          parsed_.clear();
+          parseAdvertisement(ByteView(bytes_.data(), bytes_.size()), parsed_);
+          received_ = ReceivedAdvertisement{};
+          received_.address = address;
+          received_.rssi = rssi;
+          received_.raw = ByteView(bytes_.data(), bytes_.size());
+          received_.parsed = &parsed_;
+          return received_;
+        }
+
+        const ReceivedAdvertisement &received(uint64_t address, int64_t rssi, int16_t txPower) {
+          received(address, rssi);
+          received_.hasTxPower = true;
+          received_.txPower = txPower;
+          return received_;
+        }
+
+      private:
+        std::vector<uint8_t> bytes_;
+        ParsedAdvertisement parsed_;
+        ReceivedAdvertisement received_;
+    }; // class Advertisement
+
+    /// @brief Collects what the pipeline sends and reports lost
+    struct Recorder {
+      std::vector<BleScanResult> emitted;
+      std::vector<uint64_t> lost;
+
+      auto emit() {
+        return [this](const BleScanResult &device) { emitted.push_back(device); };
+      }
+
+      auto onLost() {
+        return [this](const BleScanResult &device) { lost.push_back(device.Address()); };
+      }
+    }; // struct Recorder
+
+    std::shared_ptr<const ScanFilter> companyFilter(uint16_t companyId) {
+      auto filter = std::make_shared<ScanFilter>();
+      filter->addCompanyId(companyId);
+      filter->compile();
+      return filter;
+    }
+  } // namespace
+
+  TEST(ScanPipelineTest, NewDeviceTakesTheAdvertisementAsIs) {
+    ScanStats stats;
+    ScanPipeline pipeline(&stats);
+    Recorder recorder;
+
+    Advertisement advertisement;
+    advertisement.name("Sensor").add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01, 0x02});
+    EXPECT_TRUE(pipeline.handle(advertisement.received(kAddress, -60, -8), recorder.emit(), recorder.onLost()));
+
+    ASSERT_EQ(recorder.emitted.size(), 1u);
+    const auto &device = recorder.emitted[0];
+    EXPECT_EQ(device.DeviceId(), "c8:2b:96:a1:07:5e");
+    ASSERT_NE(device.Name(), nullptr);
+    EXPECT_EQ(*device.Name(), "Sensor");
+    EXPECT_EQ(device.Rssi(), -60);
+    EXPECT_EQ(static_cast<int16_t>(device.TxPower()), -8);
+    EXPECT_EQ(device.ManufacturerData()->size(), 1u);
+    EXPECT_EQ(stats.emitted.load(), 1u);
+  }
+
+  TEST(ScanPipelineTest, KnownDeviceTakesNameRssiAndTxPower) {
+    ScanPipeline pipeline;
+    Recorder recorder;
+
+    Advertisement first;
+    first.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01});
+    pipeline.handle(first.received(kAddress, -70), recorder.emit(), recorder.onLost());
+
+    Advertisement response;
+    response.name("Sensor");
+    pipeline.handle(response.received(kAddress, -55, 4), recorder.emit(), recorder.onLost());
+
+    auto device = pipeline.find(kAddress);
+    ASSERT_TRUE(device.has_value());
+    ASSERT_NE(device->Name(), nullptr);
+    EXPECT_EQ(*device->Name(), "Sensor");
+    EXPECT_EQ(device->Rssi(), -55);
+    EXPECT_EQ(device->TxPower(), 4u);
+    // The manufacturer data of the first advertisement is kept
+    EXPECT_EQ(device->ManufacturerData()->size(), 1u);
+    EXPECT_FALSE(pipeline.find(kOtherAddress).has_value());
+  }
+
+  TEST(ScanPipelineTest, SuppressesUnchangedDevices) {
+    ScanStats stats;
+    ScanPipeline pipeline(&stats);
+    pipeline.Changes().configure(true, 5, seconds(10));
+    Recorder recorder;
+
+    Advertisement advertisement;
+    advertisement.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01});
+    pipeline.handle(advertisement.received(kAddress, -60), recorder.emit(), recorder.onLost());
+    pipeline.handle(advertisement.received(kAddress, -62), recorder.emit(), recorder.onLost());
+    EXPECT_EQ(recorder.emitted.size(), 1u);
+
+    Advertisement changed;
+    changed.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x02});
+    pipeline.handle(changed.received(kAddress, -62), recorder.emit(), recorder.onLost());
+    EXPECT_EQ(recorder.emitted.size(), 2u);
+
+    EXPECT_EQ(stats.emitted.load(), 2u);
+    EXPECT_EQ(stats.suppressed.load(), 1u);
+  }
+
+  TEST(ScanPipelineTest, FilterRejectionIsCounted) {
+    ScanStats stats;
+    ScanPipeline pipeline(&stats);
+    pipeline.setFilter(companyFilter(0x004C));
+    Recorder recorder;
+
+    Advertisement advertisement;
+    advertisement.add(AdType::ManufacturerSpecificData, {0x59, 0x00, 0x01});
+    EXPECT_FALSE(pipeline.handle(advertisement.received(kAddress, -60), recorder.emit(), recorder.onLost()));
+    EXPECT_TRUE(recorder.emitted.empty());
+    EXPECT_FALSE(pipeline.find(kAddress).has_value());
+    EXPECT_EQ(stats.filtered.load(), 1u);
+  }
+
+  TEST(ScanPipelineTest, MatchedDeviceKeepsPassingUntilTheFilterChanges) {
+    ScanPipeline pipeline;
+    pipeline.setFilter(companyFilter(0x004C));
+    Recorder recorder;
+
+    Advertisement matching;
+    matching.add(AdType::ManufacturerSpecificData, {0x4C, 0x00, 0x01});
+    EXPECT_TRUE(pipeline.handle(matching.received(kAddress, -60), recorder.emit(), recorder.onLost()));
+
+    // The scan response of the device does not carry the manufacturer data
+    Advertisement response;
+    response.name("Sensor");
+    EXPECT_TRUE(pipeline.handle(response.received(kAddress, -60), recorder.emit(), recorder.onLost()));
+    EXPECT_FALSE(pipeline.handle(response.received(kOtherAddress, -60), recorder.emit(), recorder.onLost()));
+
+    // A new filter, even an identical one, needs a new match
+    pipeline.setFilter(companyFilter(0x004C));
+    EXPECT_FALSE(pipeline.handle(response.received(kAddress, -60), recorder.emit(), recorder.onLost()));
+  }
+
+  TEST(ScanPipelineTest, EvictedDevicesAreLost) {
+    ScanPipeline pipeline(nullptr, 1);
+    Recorder recorder;
+
+    Advertisement advertisement;
+    advertisement.name("Sensor");
+    pipeline.handle(advertisement.received(kAddress, -60), recorder.emit(), recorder.onLost());
+    pipeline.handle(advertisement.received(kOtherAddress, -60), recorder.emit(), recorder.onLost());
+    EXPECT_EQ(recorder.lost, std::vector<uint64_t>{kAddress});
+
+    EXPECT_EQ(pipeline.expire(ScanPipeline::Clock::now() + seconds(1), recorder.onLost()), 1u);
+    EXPECT_EQ(recorder.lost, (std::vector<uint64_t>{kAddress, kOtherAddress}));
+    EXPECT_FALSE(pipeline.find(kOtherAddress).has_value());
+  }
+
+  TEST(ScanPipelineTest, IgnoresResultsWithoutAddress) {
+    ScanPipeline pipeline;
+    Recorder recorder;
+    EXPECT_FALSE(pipeline.merge(BleScanResult(), 0, recorder.emit(), recorder.onLost()));
+    EXPECT_TRUE(recorder.emitted.empty());
+  }
+} // namespace layrz_ble
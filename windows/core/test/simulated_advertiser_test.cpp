@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "simulated_advertiser.h"
+
+namespace layrz_ble {
+  namespace {
+    struct Emitted {
+      uint64_t address;
+      int64_t rssi;
+      std::vector<uint8_t> raw;
+
+      bool operator==(const Emitted &other) const {
+        return address == other.address && rssi == other.rssi && raw == other.raw;
+      }
+    }; // struct Emitted
+
+    std::vector<Emitted> emitAll(const SimulationConfig &config, size_t count) {
+      SimulatedAdvertiser advertiser(config);
+      std::vector<Emitted> emitted;
+      advertiser.emit(count, [&emitted](const ReceivedAdvertisement &advertisement) {
+        emitted.push_back({
+          advertisement.address,
+          advertisement.rssi,
+          std::vector<uint8_t>(advertisement.raw.data, advertisement.raw.data + advertisement.raw.size),
+        });
+      });
+      return emitted;
+    }
+
+    SimulationConfig unpaced(size_t advertisers) {
+      SimulationConfig config;
+      config.advertisers = advertisers;
+      config.rate = 0;
+      return config;
+    }
+
+    /// @brief Wait for a backend to stop by itself, at most a few seconds
+    bool waitStopped(const SimulatedAdvertiser &advertiser) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (advertiser.running()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return true;
+    }
+  } // namespace
+
+  TEST(SimulatedAdvertiserTest, SameSeedSameAdvertisements) {
+    auto config = unpaced(100);
+    config.seed = 7;
+    auto first = emitAll(config, 1000);
+    EXPECT_EQ(first, emitAll(config, 1000));
+
+    config.seed = 8;
+    EXPECT_NE(first, emitAll(config, 1000));
+  }
+
+  TEST(SimulatedAdvertiserTest, AdvertisementShape) {
+    auto config = unpaced(50);
+    config.payloadSize = 30;
+    config.namedRatio = 1;
+
+    SimulatedAdvertiser advertiser(config);
+    size_t count = 0;
+    advertiser.emit(200, [&count](const ReceivedAdvertisement &advertisement) {
+      const auto &parsed = *advertisement.parsed;
+      EXPECT_EQ(advertisement.address >> 46, 0x3u);
+      EXPECT_LE(advertisement.rssi, -40);
+      EXPECT_GE(advertisement.rssi, -99);
+      EXPECT_EQ(std::string(parsed.Name()).rfind("SIM-", 0), 0u);
+      ASSERT_EQ(parsed.manufacturerDataCount(), 1u);
+      EXPECT_EQ(parsed.manufacturerData(0).companyId, SimulatedAdvertiser::kCompanyId);
+      EXPECT_EQ(parsed.manufacturerData(0).data.size, 30u);
+      ++count;
+    });
+    EXPECT_EQ(count, 200u);
+    EXPECT_EQ(advertiser.Emitted(), 200u);
+
+    config.namedRatio = 0;
+    SimulatedAdvertiser unnamed(config);
+    unnamed.emit(200, [](const ReceivedAdvertisement &advertisement) {
+      EXPECT_TRUE(advertisement.parsed->Name().empty());
+    });
+  }
+
+  TEST(SimulatedAdvertiserTest, ChangeRatio) {
+    // Advertisements whose payload differs from the previous one of their device, out of those that follow one
+    auto changes = [](double ratio, size_t &repeated) {
+      auto config = unpaced(20);
+      config.changeRatio = ratio;
+      std::unordered_map<uint64_t, std::vector<uint8_t>> last;
+      size_t changed = 0;
+      auto emitted = emitAll(config, 2000);
+      for (const auto &advertisement : emitted) {
+        auto it = last.find(advertisement.address);
+        if (it != last.end() && it->second != advertisement.raw) ++changed;
+        last[advertisement.address] = advertisement.raw;
+      }
+      repeated = emitted.size() - last.size();
+      return changed;
+    };
+
+    size_t repeated = 0;
+    EXPECT_EQ(changes(0, repeated), 0u);
+    EXPECT_EQ(changes(1, repeated), repeated);
+    EXPECT_GT(repeated, 0u);
+  }
+
+  TEST(SimulatedAdvertiserTest, LimitStopsTheBackend) {
+    auto config = unpaced(1000);
+    config.limit = 10000;
+    SimulatedAdvertiser advertiser(config);
+
+    std::atomic<uint64_t> received{0};
+    ASSERT_TRUE(advertiser.start([&received](const ReceivedAdvertisement &) { received.fetch_add(1); }));
+    EXPECT_FALSE(advertiser.start([](const ReceivedAdvertisement &) {}));
+    ASSERT_TRUE(waitStopped(advertiser));
+    advertiser.stop();
+
+    EXPECT_EQ(received.load(), 10000u);
+    EXPECT_EQ(advertiser.Emitted(), 10000u);
+  }
+
+  TEST(SimulatedAdvertiserTest, FinishedRunStartsAgainOnlyAfterStop) {
+    auto config = unpaced(100);
+    config.limit = 500;
+    SimulatedAdvertiser advertiser(config);
+
+    std::atomic<uint64_t> received{0};
+    auto sink = [&received](const ReceivedAdvertisement &) { received.fetch_add(1); };
+    ASSERT_TRUE(advertiser.start(sink));
+    ASSERT_TRUE(waitStopped(advertiser));
+    EXPECT_FALSE(advertiser.start(sink));
+    EXPECT_EQ(received.load(), 500u);
+
+    advertiser.stop();
+    ASSERT_TRUE(advertiser.start(sink));
+    ASSERT_TRUE(waitStopped(advertiser));
+    advertiser.stop();
+    EXPECT_EQ(received.load(), 1000u);
+  }
+
+  TEST(SimulatedAdvertiserTest, StopEndsTheSinkCalls) {
+    auto config = unpaced(100);
+    config.rate = 5000;
+    SimulatedAdvertiser advertiser(config);
+
+    std::atomic<uint64_t> received{0};
+    ASSERT_TRUE(advertiser.start([&received](const ReceivedAdvertisement &) { received.fetch_add(1); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    advertiser.stop();
+    EXPECT_FALSE(advertiser.running());
+
+    auto stoppedAt = received.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(received.load(), stoppedAt);
+  }
+
+  TEST(SimulatedAdvertiserTest, PacedRateIsNotExceeded) {
+    auto config = unpaced(100);
+    config.rate = 20000;
+    config.limit = 2000;
+    SimulatedAdvertiser advertiser(config);
+
+    auto startedAt = std::chrono::steady_clock::now();
+    ASSERT_TRUE(advertiser.start([](const ReceivedAdvertisement &) {}));
+    ASSERT_TRUE(waitStopped(advertiser));
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    advertiser.stop();
+
+    // 2000 advertisements at 20000/s take 100 ms, the first millisecond burst is emitted right away
+    EXPECT_GE(elapsed, 0.09);
+    EXPECT_EQ(advertiser.Emitted(), 2000u);
+  }
+
+  /// @brief The unpaced backend must sustain far more events per second than any radio delivers, so a
+  /// load test measures the pipeline behind it rather than the simulator
+  TEST(SimulatedAdvertiserTest, UnpacedThroughput) {
+    auto config = unpaced(10000);
+    config.limit = 200000;
+    SimulatedAdvertiser advertiser(config);
+
+    std::atomic<uint64_t> bytes{0};
+    auto startedAt = std::chrono::steady_clock::now();
+    ASSERT_TRUE(advertiser.start([&bytes](const ReceivedAdvertisement &advertisement) {
+      bytes.fetch_add(advertisement.raw.size, std::memory_order_relaxed);
+    }));
+    ASSERT_TRUE(waitStopped(advertiser));
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    advertiser.stop();
+
+    double eventsPerSecond = static_cast<double>(advertiser.Emitted()) / elapsed;
+    RecordProperty("events_per_second", std::to_string(static_cast<uint64_t>(eventsPerSecond)));
+    EXPECT_EQ(advertiser.Emitted(), 200000u);
+    EXPECT_GT(eventsPerSecond, 100000.0);
+  }
+} // namespace layrz_ble
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace layrz_ble {
+  /// @brief Fixture of the tests that write files, each test gets an empty directory of its own under the
+  /// system temporary directory, removed once it ends
+  class TemporaryDirectoryTest : public ::testing::Test {
+    protected:
+      void SetUp() override {
+        const auto *test = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory_ = std::filesystem::temp_directory_path() /
+          (std::string("layrz_ble_") + test->test_suite_name() + "_" + test->name());
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+        std::filesystem::create_directories(directory_);
+      }
+
+      void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+      }
+
+      std::filesystem::path directory_;
+  }; // class TemporaryDirectoryTest
+} // namespace layrz_ble
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "uuid.h"
+
+namespace layrz_ble {
+  namespace {
+    // 6e400001-b5a3-f393-e0a9-e50e24dcca9e, the Nordic UART service
+    constexpr Uuid kNordicUart = {{
+      0x6E, 0x40, 0x00, 0x01, 0xB5, 0xA3, 0xF3, 0x93, 0xE0, 0xA9, 0xE5, 0x0E, 0x24, 0xDC, 0xCA, 0x9E,
+    }};
+
+    Uuid parsed(const std::string &str) {
+      Uuid uuid{};
+      EXPECT_TRUE(Uuid::parse(str, uuid)) << str;
+      return uuid;
+    }
+  } // namespace
+
+  TEST(UuidTest, ParseFullForm) {
+    EXPECT_EQ(parsed("6e400001-b5a3-f393-e0a9-e50e24dcca9e"), kNordicUart);
+    EXPECT_EQ(parsed("6E400001-B5A3-F393-E0A9-E50E24DCCA9E"), kNordicUart);
+    EXPECT_EQ(parsed("6e400001b5a3f393e0a9e50e24dcca9e"), kNordicUart);
+    EXPECT_EQ(parsed("0x6e400001b5a3f393e0a9e50e24dcca9e"), kNordicUart);
+  }
+
+  TEST(UuidTest, ParseShortFormsExpandOverTheBaseUuid) {
+    EXPECT_EQ(parsed("180d").toString(), "0000180d-0000-1000-8000-00805f9b34fb");
+    EXPECT_EQ(parsed("0x180D"), Uuid::fromShort(0x180D));
+    EXPECT_EQ(parsed("12345678").toString(), "12345678-0000-1000-8000-00805f9b34fb");
+    EXPECT_EQ(parsed("0000180d-0000-1000-8000-00805f9b34fb"), Uuid::fromShort(0x180D));
+  }
+
+  TEST(UuidTest, ParseRejectsMalformedStrings) {
+    Uuid uuid = kNordicUart;
+    EXPECT_FALSE(Uuid::parse("", uuid));
+    EXPECT_FALSE(Uuid::parse("18", uuid));
+    EXPECT_FALSE(Uuid::parse("180", uuid));
+    EXPECT_FALSE(Uuid::parse("180g", uuid));
+    EXPECT_FALSE(Uuid::parse("123456", uuid));
+    EXPECT_FALSE(Uuid::parse("6e400001-b5a3-f393-e0a9-e50e24dcca9", uuid));
+    EXPECT_FALSE(Uuid::parse("6e400001-b5a3-f393-e0a9-e50e24dcca9e00", uuid));
+    EXPECT_FALSE(Uuid::parse("{6e400001-b5a3-f393-e0a9-e50e24dcca9e}", uuid));
+
+    // A failed parse leaves the output untouched
+    EXPECT_EQ(uuid, kNordicUart);
+  }
+
+  TEST(UuidTest, FormatIsLowercaseCanonical) {
+    char out[37];
+    kNordicUart.format(out);
+    EXPECT_STREQ(out, "6e400001-b5a3-f393-e0a9-e50e24dcca9e");
+    EXPECT_EQ(kNordicUart.toString(), "6e400001-b5a3-f393-e0a9-e50e24dcca9e");
+  }
+
+  TEST(UuidTest, FormatParseRoundTrip) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 1000; ++i) {
+      Uuid uuid{};
+      for (auto &byte : uuid.bytes) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<uint8_t>(state);
+      }
+      EXPECT_EQ(parsed(uuid.toString()), uuid);
+    }
+  }
+
+  TEST(UuidTest, FromLittleEndian) {
+    const uint8_t heartRate[] = {0x0D, 0x18};
+    EXPECT_EQ(Uuid::fromLittleEndian(heartRate, sizeof(heartRate)), Uuid::fromShort(0x180D));
+
+    const uint8_t wide[] = {0x78, 0x56, 0x34, 0x12};
+    EXPECT_EQ(Uuid::fromLittleEndian(wide, sizeof(wide)), Uuid::fromShort(0x12345678));
+
+    const uint8_t full[] = {
+      0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E,
+    };
+    EXPECT_EQ(Uuid::fromLittleEndian(full, sizeof(full)), kNordicUart);
+  }
+
+  TEST(UuidTest, ShortValue) {
+    EXPECT_TRUE(Uuid::fromShort(0x2A37).isShort());
+    EXPECT_EQ(Uuid::fromShort(0x2A37).shortValue(), 0x2A37u);
+    EXPECT_FALSE(kNordicUart.isShort());
+    EXPECT_EQ(kNordicUart.shortValue(), 0x6E400001u);
+  }
+
+  TEST(UuidTest, OrderingAndHash) {
+    Uuid low = Uuid::fromShort(0x180D);
+    Uuid high = Uuid::fromShort(0x180F);
+    EXPECT_LT(low, high);
+    EXPECT_FALSE(high < low);
+    EXPECT_FALSE(low < low);
+    EXPECT_NE(low, high);
+
+    std::unordered_set<Uuid, UuidHash> set = {low, high, kNordicUart};
+    EXPECT_EQ(set.size(), 3u);
+    EXPECT_EQ(set.count(parsed("180f")), 1u);
+    EXPECT_EQ(UuidHash()(low), UuidHash()(Uuid::fromShort(0x180D)));
+  }
+
+  TEST(UuidTest, ParseIsConstexpr) {
+    constexpr Uuid uuid = []() {
+      Uuid result{};
+      Uuid::parse("6e400001-b5a3-f393-e0a9-e50e24dcca9e", result);
+      return result;
+    }();
+    static_assert(uuid == kNordicUart, "Uuid::parse must be usable in constant expressions");
+    SUCCEED();
+  }
+} // namespace layrz_ble
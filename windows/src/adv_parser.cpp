@@ -0,0 +1,121 @@
+#include "adv_parser.h"
+
+namespace layrz_ble {
+  /// @brief Read the next structure
+  /// @param out
+  /// @return bool
+  bool AdStructureReader::next(AdStructure &out) {
+    while (offset_ < payload_.size) {
+      uint8_t length = payload_[offset_];
+      // A zero length marks the end of the significant part (the rest is padding)
+      if (length == 0) {
+        offset_ = payload_.size;
+        return false;
+      }
+
+      if (offset_ + 1 + length > payload_.size) {
+        malformed_ = true;
+        offset_ = payload_.size;
+        return false;
+      }
+
+      out.type = payload_[offset_ + 1];
+      out.value = payload_.sub(offset_ + 2, length - 1);
+      offset_ += 1 + length;
+      return true;
+    }
+    return false;
+  } // next
+
+  /// @brief Reset the view so it can be reused for the next advertisement
+  void ParsedAdvertisement::clear() {
+    hasFlags_ = false;
+    flags_ = 0;
+    name_ = std::string_view();
+    completeName_ = false;
+    hasTxPower_ = false;
+    txPower_ = 0;
+    manufacturerDataCount_ = 0;
+    serviceDataCount_ = 0;
+    serviceUuidListCount_ = 0;
+    skipped_ = 0;
+  } // clear
+
+  /// @brief Classify one AD structure into the typed fields
+  /// @param type
+  /// @param value
+  void ParsedAdvertisement::add(uint8_t type, ByteView value) {
+    switch (type) {
+      case AdType::Flags:
+        if (value.empty()) break;
+        hasFlags_ = true;
+        flags_ = value[0];
+        return;
+
+      case AdType::ShortenedLocalName:
+      case AdType::CompleteLocalName: {
+        bool complete = type == AdType::CompleteLocalName;
+        if (!name_.empty() && completeName_ && !complete) return;
+        name_ = std::string_view(reinterpret_cast<const char *>(value.data), value.size);
+        completeName_ = complete;
+        return;
+      }
+
+      case AdType::TxPowerLevel:
+        if (value.empty()) break;
+        hasTxPower_ = true;
+        txPower_ = static_cast<int8_t>(value[0]);
+        return;
+
+      case AdType::ManufacturerSpecificData:
+        if (value.size < 2 || manufacturerDataCount_ == kMaxManufacturerData) break;
+        manufacturerData_[manufacturerDataCount_++] = {
+          static_cast<uint16_t>(value[0] | (value[1] << 8)),
+          value.sub(2),
+        };
+        return;
+
+      case AdType::ServiceData16:
+      case AdType::ServiceData32:
+      case AdType::ServiceData128: {
+        size_t width = type == AdType::ServiceData16 ? 2 : (type == AdType::ServiceData32 ? 4 : 16);
+        if (value.size < width || serviceDataCount_ == kMaxServiceData) break;
+        serviceData_[serviceDataCount_++] = {value.sub(0, width), value.sub(width)};
+        return;
+      }
+
+      case AdType::IncompleteServices16:
+      case AdType::CompleteServices16:
+      case AdType::IncompleteServices32:
+      case AdType::CompleteServices32:
+      case AdType::IncompleteServices128:
+      case AdType::CompleteServices128: {
+        uint8_t width = type <= AdType::CompleteServices16 ? 2 : (type <= AdType::CompleteServices32 ? 4 : 16);
+        if (serviceUuidListCount_ == kMaxServiceUuidLists) break;
+        serviceUuidLists_[serviceUuidListCount_++] = {width, value.sub(0, value.size - value.size % width)};
+        return;
+      }
+
+      default:
+        // Not decoded, but not an error either
+        return;
+    }
+
+    ++skipped_;
+  } // add
+
+  /// @brief Parse a raw advertisement payload
+  /// @param payload
+  /// @param out
+  /// @return bool
+  bool parseAdvertisement(ByteView payload, ParsedAdvertisement &out) {
+    out.clear();
+    AdStructureReader reader(payload);
+    AdStructure structure;
+    while (reader.next(structure)) {
+      out.add(structure.type, structure.value);
+    }
+
+    return !reader.malformed();
+  } // parseAdvertisement
+} // namespace layrz_ble
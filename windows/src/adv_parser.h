@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace layrz_ble {
+  /// @brief Non-owning view over a contiguous run of bytes
+  struct ByteView {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+
+    constexpr ByteView() = default;
+    constexpr ByteView(const uint8_t *data, size_t size) : data(data), size(size) {}
+
+    constexpr bool empty() const { return size == 0; }
+    constexpr const uint8_t *begin() const { return data; }
+    constexpr const uint8_t *end() const { return data + size; }
+    constexpr uint8_t operator[](size_t index) const { return data[index]; }
+
+    /// @brief Get a view over a part of this view, clamped to its bounds
+    /// @param offset
+    /// @param count
+    /// @return ByteView
+    constexpr ByteView sub(size_t offset, size_t count = SIZE_MAX) const {
+      if (offset >= size) return ByteView(end(), 0);
+      size_t remaining = size - offset;
+      return ByteView(data + offset, count < remaining ? count : remaining);
+    }
+  }; // struct ByteView
+
+  /// @brief Advertising Data types, as assigned by the Bluetooth SIG
+  namespace AdType {
+    constexpr uint8_t Flags                    = 0x01;
+    constexpr uint8_t IncompleteServices16     = 0x02;
+    constexpr uint8_t CompleteServices16       = 0x03;
+    constexpr uint8_t IncompleteServices32     = 0x04;
+    constexpr uint8_t CompleteServices32       = 0x05;
+    constexpr uint8_t IncompleteServices128    = 0x06;
+    constexpr uint8_t CompleteServices128      = 0x07;
+    constexpr uint8_t ShortenedLocalName       = 0x08;
+    constexpr uint8_t CompleteLocalName        = 0x09;
+    constexpr uint8_t TxPowerLevel             = 0x0A;
+    constexpr uint8_t ServiceData16            = 0x16;
+    constexpr uint8_t ServiceData32            = 0x20;
+    constexpr uint8_t ServiceData128           = 0x21;
+    constexpr uint8_t ManufacturerSpecificData = 0xFF;
+  } // namespace AdType
+
+  /// @brief One length/type/value structure of an advertisement payload
+  struct AdStructure {
+    uint8_t type = 0;
+    ByteView value;
+  };
+
+  /// @brief Walks the raw length/type/value structures of an advertisement payload
+  class AdStructureReader {
+    public:
+      explicit AdStructureReader(ByteView payload) : payload_(payload) {}
+
+      /// @brief Read the next structure
+      /// @param out
+      /// @return false when the payload is exhausted or malformed
+      bool next(AdStructure &out);
+
+      /// @brief Whether the reader stopped on a structure that overflows the payload
+      bool malformed() const { return malformed_; }
+
+    private:
+      ByteView payload_;
+      size_t offset_ = 0;
+      bool malformed_ = false;
+  }; // class AdStructureReader
+
+  /// @brief Manufacturer specific data, split from its company identifier
+  struct ManufacturerDataView {
+    uint16_t companyId = 0;
+    ByteView data;
+  };
+
+  /// @brief Service data, split from its little-endian 16, 32 or 128-bit UUID
+  struct ServiceDataView {
+    ByteView uuid;
+    ByteView data;
+  };
+
+  /// @brief A list of advertised service UUIDs of the same width
+  struct ServiceUuidListView {
+    uint8_t width = 0;
+    ByteView uuids;
+
+    size_t count() const { return width ? uuids.size / width : 0; }
+    ByteView at(size_t index) const { return uuids.sub(index * width, width); }
+  };
+
+  /// @brief Decoded view of an advertisement, pointing into the buffers it was built from.
+  /// Holds no heap memory, so the caller must keep those buffers alive while it is used.
+  class ParsedAdvertisement {
+    public:
+      static constexpr size_t kMaxManufacturerData = 8;
+      static constexpr size_t kMaxServiceData = 8;
+      static constexpr size_t kMaxServiceUuidLists = 6;
+
+      /// @brief Reset the view so it can be reused for the next advertisement
+      void clear();
+
+      /// @brief Classify one AD structure into the typed fields
+      /// @param type
+      /// @param value
+      void add(uint8_t type, ByteView value);
+
+      bool hasFlags() const { return hasFlags_; }
+      uint8_t Flags() const { return flags_; }
+
+      /// @brief Get the local name, prefering the complete name over the shortened one
+      /// @return std::string_view, empty when not advertised
+      std::string_view Name() const { return name_; }
+
+      bool hasTxPower() const { return hasTxPower_; }
+      int8_t TxPower() const { return txPower_; }
+
+      size_t manufacturerDataCount() const { return manufacturerDataCount_; }
+      const ManufacturerDataView &manufacturerData(size_t index) const { return manufacturerData_[index]; }
+
+      size_t serviceDataCount() const { return serviceDataCount_; }
+      const ServiceDataView &serviceData(size_t index) const { return serviceData_[index]; }
+
+      size_t serviceUuidListCount() const { return serviceUuidListCount_; }
+      const ServiceUuidListView &serviceUuidList(size_t index) const { return serviceUuidLists_[index]; }
+
+      /// @brief Number of structures that did not fit into the fixed capacity or were too short
+      size_t skipped() const { return skipped_; }
+
+    private:
+      bool hasFlags_ = false;
+      uint8_t flags_ = 0;
+
+      std::string_view name_;
+      bool completeName_ = false;
+
+      bool hasTxPower_ = false;
+      int8_t txPower_ = 0;
+
+      ManufacturerDataView manufacturerData_[kMaxManufacturerData];
+      size_t manufacturerDataCount_ = 0;
+
+      ServiceDataView serviceData_[kMaxServiceData];
+      size_t serviceDataCount_ = 0;
+
+      ServiceUuidListView serviceUuidLists_[kMaxServiceUuidLists];
+      size_t serviceUuidListCount_ = 0;
+
+      size_t skipped_ = 0;
+  }; // class ParsedAdvertisement
+
+  /// @brief Parse a raw advertisement payload (or a concatenation of advertisement and scan response)
+  /// @param payload
+  /// @param out
+  /// @return false if the payload is malformed, in which case out holds the structures read before the error
+  bool parseAdvertisement(ByteView payload, ParsedAdvertisement &out);
+} // namespace layrz_ble
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <flutter/encodable_value.h>
+#include <flutter/method_result.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace layrz_ble {
+  /// @brief Method result of a batch of GATT operations, answered once every operation is answered.
+  ///
+  /// Each operation of the batch gets its own MethodResult from Item(), so it runs through the same code
+  /// as its single-operation method. Its answer is stored at its index of the result list, as
+  /// `{value}` on success or `{error, message}` on error, and the last answer sends the whole list.
+  class BatchReply : public std::enable_shared_from_this<BatchReply> {
+    public:
+      BatchReply(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result, size_t count) :
+        result_(std::move(result)),
+        items_(count),
+        pending_(count) {}
+
+      BatchReply(const BatchReply &) = delete;
+      BatchReply &operator=(const BatchReply &) = delete;
+
+      /// @brief Result of the operation at an index, answered with an error if destroyed unanswered
+      /// @param index
+      /// @return std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> Item(size_t index) {
+        return std::make_unique<ItemResult>(shared_from_this(), index);
+      }
+
+      void Success(size_t index, const flutter::EncodableValue &value) {
+        flutter::EncodableMap item;
+        item[flutter::EncodableValue("value")] = value;
+        set(index, std::move(item));
+      }
+
+      void Error(size_t index, const std::string &code, const std::string &message = "") {
+        flutter::EncodableMap item;
+        item[flutter::EncodableValue("error")] = flutter::EncodableValue(code);
+        if (!message.empty())
+          item[flutter::EncodableValue("message")] = flutter::EncodableValue(message);
+        set(index, std::move(item));
+      }
+
+    private:
+      class ItemResult : public flutter::MethodResult<flutter::EncodableValue> {
+        public:
+          ItemResult(std::shared_ptr<BatchReply> batch, size_t index) : batch_(std::move(batch)), index_(index) {}
+          ~ItemResult() override {
+            if (!answered_) batch_->Error(index_, "NO_RESULT", "The operation ended without a result");
+          }
+
+        protected:
+          void SuccessInternal(const flutter::EncodableValue *result) override {
+            answered_ = true;
+            batch_->Success(index_, result != nullptr ? *result : flutter::EncodableValue());
+          }
+
+          void ErrorInternal(
+            const std::string &code,
+            const std::string &message,
+            const flutter::EncodableValue *
+          ) override {
+            answered_ = true;
+            batch_->Error(index_, code, message);
+          }
+
+          void NotImplementedInternal() override {
+            answered_ = true;
+            batch_->Error(index_, "NOT_IMPLEMENTED");
+          }
+
+        private:
+          std::shared_ptr<BatchReply> batch_;
+          size_t index_;
+          bool answered_ = false;
+      }; // class ItemResult
+
+      void set(size_t index, flutter::EncodableMap &&item) {
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result;
+        flutter::EncodableList items;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (index >= items_.size() || !items_[index].IsNull() || pending_ == 0)
+            return;
+
+          items_[index] = flutter::EncodableValue(std::move(item));
+          if (--pending_ > 0)
+            return;
+
+          result = std::move(result_);
+          items = std::move(items_);
+        }
+
+        if (result) result->Success(flutter::EncodableValue(std::move(items)));
+      }
+
+      std::mutex mutex_;
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result_;
+      flutter::EncodableList items_;
+      size_t pending_;
+  }; // class BatchReply
+} // namespace layrz_ble
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace layrz_ble {
+  /// @brief Parse a 48-bit Bluetooth address written as six hex pairs, separated by ':' or '-'
+  /// @param str
+  /// @param address
+  /// @return false if the string is not a valid address
+  inline bool parseBluetoothAddress(std::string_view str, uint64_t &address) {
+    if (str.size() != 17) return false;
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+      char c = str[i];
+      if (i % 3 == 2) {
+        if (c != ':' && c != '-') return false;
+        continue;
+      }
+
+      uint8_t nibble;
+      if (c >= '0' && c <= '9') nibble = static_cast<uint8_t>(c - '0');
+      else if (c >= 'a' && c <= 'f') nibble = static_cast<uint8_t>(c - 'a' + 10);
+      else if (c >= 'A' && c <= 'F') nibble = static_cast<uint8_t>(c - 'A' + 10);
+      else return false;
+      result = (result << 4) | nibble;
+    }
+
+    address = result;
+    return true;
+  } // parseBluetoothAddress
+
+  /// @brief Format a 48-bit Bluetooth address as aa:bb:cc:dd:ee:ff, without allocating
+  /// @param address
+  /// @param out receives the 17 characters and a null terminator
+  inline void formatBluetoothAddress(uint64_t address, char (&out)[18]) {
+    constexpr char kHex[] = "0123456789abcdef";
+    for (int i = 0; i < 6; ++i) {
+      uint8_t byte = static_cast<uint8_t>(address >> (8 * (5 - i)));
+      out[i * 3] = kHex[byte >> 4];
+      out[i * 3 + 1] = kHex[byte & 0x0F];
+      out[i * 3 + 2] = i < 5 ? ':' : '\0';
+    }
+  } // formatBluetoothAddress
+} // namespace layrz_ble
@@ -0,0 +1,39 @@
+#include "change_detector.h"
+
+namespace layrz_ble {
+  /// @brief Set the suppression rules
+  /// @param enabled
+  /// @param rssiHysteresis minimum RSSI change, in dBm, that is worth sending. At least 1, an identical
+  /// result at the same RSSI is never worth sending again
+  /// @param maxSilence longest time a device may go without being sent
+  void ChangeDetector::configure(bool enabled, int64_t rssiHysteresis, Clock::duration maxSilence) {
+    rssiHysteresis_.store(rssiHysteresis > 1 ? rssiHysteresis : 1, std::memory_order_relaxed);
+    maxSilence_.store(maxSilence.count(), std::memory_order_relaxed);
+    enabled_.store(enabled, std::memory_order_relaxed);
+  } // configure
+
+  /// @brief Check a result against what was last sent for its device, and record it when it is sent
+  /// @param state
+  /// @param fingerprint
+  /// @param rssi
+  /// @param now
+  /// @return bool
+  bool ChangeDetector::shouldEmit(State &state, uint64_t fingerprint, int64_t rssi, Clock::time_point now) {
+    if (enabled_.load(std::memory_order_relaxed) && state.emitted && state.fingerprint == fingerprint) {
+      int64_t delta = rssi > state.rssi ? rssi - state.rssi : state.rssi - rssi;
+      Clock::duration maxSilence(maxSilence_.load(std::memory_order_relaxed));
+      bool heartbeat = maxSilence > Clock::duration::zero() && now - state.emittedAt >= maxSilence;
+      if (delta < rssiHysteresis_.load(std::memory_order_relaxed) && !heartbeat) {
+        if (stats_ != nullptr) stats_->suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+
+    state.fingerprint = fingerprint;
+    state.rssi = rssi;
+    state.emittedAt = now;
+    state.emitted = true;
+    if (stats_ != nullptr) stats_->emitted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  } // shouldEmit
+} // namespace layrz_ble
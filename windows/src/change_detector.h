@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "plugin_stats.h"
+
+namespace layrz_ble {
+  /// @brief 64-bit FNV-1a hash, used to tell whether the content of an advertisement changed
+  class Fingerprint {
+    public:
+      /// @brief Mix bytes into the hash
+      /// @param data
+      /// @param size
+      void add(const uint8_t *data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+          hash_ ^= data[i];
+          hash_ *= kPrime;
+        }
+      }
+
+      /// @brief Mix an integer into the hash, so that adjacent fields cannot shift into each other
+      /// @param value
+      void add(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+          hash_ ^= static_cast<uint8_t>(value >> (8 * i));
+          hash_ *= kPrime;
+        }
+      }
+
+      uint64_t value() const { return hash_; }
+
+    private:
+      static constexpr uint64_t kOffset = 0xCBF29CE484222325ULL;
+      static constexpr uint64_t kPrime = 0x100000001B3ULL;
+
+      uint64_t hash_ = kOffset;
+  }; // class Fingerprint
+
+  /// @brief Decides whether a scan result changed enough to be sent to Dart again.
+  ///
+  /// A result is sent when its content fingerprint changed, when its RSSI moved by at least the
+  /// hysteresis away from the last sent RSSI, or when nothing was sent for the maximum silence.
+  /// Everything else is suppressed. When disabled, every result is sent.
+  ///
+  /// The rules are atomics, so configure() may run on the UI thread while the scan threads call
+  /// shouldEmit(). A check racing a configure() may see some rules of each call, never a torn value.
+  /// The emitted and suppressed results are counted in the ScanStats given at construction, if any.
+  class ChangeDetector {
+    public:
+      using Clock = std::chrono::steady_clock;
+
+      ChangeDetector() = default;
+      explicit ChangeDetector(ScanStats *stats) : stats_(stats) {}
+
+      /// @brief What was last sent for a device
+      struct State {
+        uint64_t fingerprint = 0;
+        int64_t rssi = 0;
+        Clock::time_point emittedAt{};
+        bool emitted = false;
+      }; // struct State
+
+      void configure(bool enabled, int64_t rssiHysteresis, Clock::duration maxSilence);
+      bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+      bool shouldEmit(State &state, uint64_t fingerprint, int64_t rssi, Clock::time_point now);
+
+    private:
+      std::atomic<bool> enabled_{false};
+      std::atomic<int64_t> rssiHysteresis_{0};
+      /// @brief Clock::duration ticks, std::atomic<Clock::duration> is not lock-free everywhere
+      std::atomic<Clock::rep> maxSilence_{0};
+
+      ScanStats *stats_ = nullptr;
+  }; // class ChangeDetector
+} // namespace layrz_ble
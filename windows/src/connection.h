@@ -0,0 +1,151 @@
+#pragma once
+
+#include <winrt/Windows.Devices.Bluetooth.h>
+#include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "bt_address.h"
+#include "gatt.h"
+#include "gatt_scheduler.h"
+#include "read_coalescer.h"
+
+namespace layrz_ble {
+  using namespace winrt::Windows::Devices::Bluetooth;
+  using namespace winrt::Windows::Devices::Bluetooth::GenericAttributeProfile;
+
+  /// @brief A connected device: the WinRT device, its GATT session and its own characteristic table.
+  ///
+  /// The session is opened once at connect time with MaintainConnection, and its MTU is cached here
+  /// from MaxPduSizeChanged, so it is read without awaiting WinRT. Reads, writes and CCCD writes of
+  /// the device go through its own GattScheduler, and its reads are cached and shared by its ReadCoalescer.
+  ///
+  /// Connections are shared between the coroutines that use them, so a device that disconnects while a
+  /// GATT call is awaiting stays alive until the call returns. Those coroutines resume on any thread of the
+  /// pool, so the device, the session and the notify state of the table entries are guarded by Mutex().
+  /// A table is never changed once filled: a new discovery replaces it as a whole, and the coroutines
+  /// keep the table they resolved their characteristic in until they return.
+  class BleConnection {
+    public:
+      BleConnection(uint64_t address, const BluetoothLEDevice& device) : address_(address), device_(device) {
+        char formatted[18];
+        formatBluetoothAddress(address, formatted);
+        macAddress_ = formatted;
+      }
+      /// @brief Close the connection when nothing holds it anymore, so a connect that fails after opening the
+      /// session does not leave it maintained
+      ~BleConnection() { close(); }
+
+      BleConnection(const BleConnection &) = delete;
+      BleConnection &operator=(const BleConnection &) = delete;
+
+      uint64_t Address() const { return address_; }
+      /// @brief Address formatted as in the scan results, sent with every event of the device
+      const std::string& MacAddress() const { return macAddress_; }
+      /// @brief The WinRT device, nullptr once closed. Check it again after every co_await
+      BluetoothLEDevice Device() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return device_;
+      }
+      /// @brief Whether close() ran. Set under Mutex(), so it is stable while the caller holds it
+      bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+      GattSession Session() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return session_;
+      }
+      void setSession(const GattSession& session) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session_ = session;
+      }
+
+      /// @brief Held to read or change the notify state (token, subscription) of the entries of Gatt().
+      /// Never held across a co_await
+      std::mutex& Mutex() { return mutex_; }
+
+      /// @brief ATT MTU of the session, 23 until the exchange completes
+      uint16_t Mtu() const { return mtu_.load(std::memory_order_relaxed); }
+      void setMtu(uint16_t mtu) { mtu_.store(mtu, std::memory_order_relaxed); }
+
+      /// @brief Characteristic table of the last discovery
+      std::shared_ptr<GattTable> Gatt() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return gatt_;
+      }
+      /// @brief Table of Gatt() for a caller that already holds Mutex()
+      GattTable& LockedGatt() { return *gatt_; }
+
+      /// @brief Replace the table after a new discovery. The subscriptions of the old one are revoked, their
+      /// characteristics are gone with the services that changed
+      /// @param table
+      void replaceGatt(std::shared_ptr<GattTable> table) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        revokeNotifications();
+        gatt_ = std::move(table);
+      }
+
+      GattScheduler& Scheduler() { return scheduler_; }
+      ReadCoalescer& Reads() { return reads_; }
+
+      void setConnectionStatusToken(winrt::event_token token) { connectionStatusToken_ = token; }
+      void setServicesChangedToken(winrt::event_token token) { servicesChangedToken_ = token; }
+      void setMaxPduSizeToken(winrt::event_token token) { maxPduSizeToken_ = token; }
+      void setSessionStatusToken(winrt::event_token token) { sessionStatusToken_ = token; }
+
+      /// @brief Revoke every handler of the device and release it
+      void close() {
+        scheduler_.cancel();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!device_) return;
+        closed_.store(true, std::memory_order_release);
+
+        revokeNotifications();
+
+        if (connectionStatusToken_) device_.ConnectionStatusChanged(connectionStatusToken_);
+        if (servicesChangedToken_) device_.GattServicesChanged(servicesChangedToken_);
+        if (session_) {
+          if (maxPduSizeToken_) session_.MaxPduSizeChanged(maxPduSizeToken_);
+          if (sessionStatusToken_) session_.SessionStatusChanged(sessionStatusToken_);
+          session_.MaintainConnection(false);
+          session_.Close();
+        }
+        device_.Close();
+
+        session_ = nullptr;
+        device_ = nullptr;
+      }
+
+    private:
+      /// @brief Revoke the handlers of every subscription of the table, with mutex_ held
+      void revokeNotifications() {
+        for (auto &characteristic : gatt_->Characteristics()) {
+          if (!characteristic.isNotifying()) continue;
+          try {
+            characteristic.Characteristic().ValueChanged(characteristic.NotifyToken());
+          } catch (...) {
+            // The characteristic object may be invalidated by a services change, its handler goes with it
+          }
+        }
+        gatt_->clearNotifications();
+      }
+
+      uint64_t address_ = 0;
+      std::string macAddress_;
+      BluetoothLEDevice device_{nullptr};
+      GattSession session_{nullptr};
+      std::shared_ptr<GattTable> gatt_ = std::make_shared<GattTable>();
+      GattScheduler scheduler_{};
+      ReadCoalescer reads_{};
+      std::atomic<uint16_t> mtu_{23};
+      std::atomic<bool> closed_{false};
+      mutable std::mutex mutex_;
+      winrt::event_token connectionStatusToken_{};
+      winrt::event_token servicesChangedToken_{};
+      winrt::event_token maxPduSizeToken_{};
+      winrt::event_token sessionStatusToken_{};
+  }; // class BleConnection
+} // namespace layrz_ble
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace layrz_ble {
+  /// @brief Fixed-capacity table of devices keyed by their 48-bit Bluetooth address.
+  ///
+  /// Entries live in a dense array sized once to the device cap, and are found through an
+  /// open-addressed (linear probing) index of 32-bit entry numbers, so a lookup touches one small
+  /// array before the entry itself. Entries are chained in least-recently-seen order: inserting
+  /// into a full table evicts the oldest device, and evictExpired() drops devices not seen recently.
+  template <typename T>
+  class DeviceTable {
+    public:
+      using Clock = std::chrono::steady_clock;
+
+      explicit DeviceTable(size_t maxDevices = 2048) { reset(maxDevices); }
+
+      /// @brief Drop every device and resize the table for a new cap
+      /// @param maxDevices
+      void reset(size_t maxDevices) {
+        if (maxDevices == 0) maxDevices = 1;
+        size_t slotCount = 1;
+        while (slotCount < maxDevices * 2) slotCount <<= 1;
+
+        entries_.clear();
+        entries_.resize(maxDevices);
+        slots_.assign(slotCount, kNone);
+        mask_ = slotCount - 1;
+        size_ = 0;
+        head_ = kNone;
+        tail_ = kNone;
+
+        // Chain every entry into the free list
+        free_ = 0;
+        for (size_t i = 0; i < maxDevices; ++i)
+          entries_[i].next = i + 1 < maxDevices ? static_cast<uint32_t>(i + 1) : kNone;
+      }
+
+      /// @brief Drop every device, keeping the cap
+      void clear() { reset(entries_.size()); }
+
+      size_t size() const { return size_; }
+      size_t capacity() const { return entries_.size(); }
+
+      /// @brief Find a device, without refreshing it
+      /// @param address
+      /// @return T*, nullptr when not found
+      T *find(uint64_t address) {
+        size_t slot = findSlot(address);
+        return slot == kNotFound ? nullptr : &entries_[slots_[slot]].value;
+      }
+
+      /// @brief Find or insert a device and mark it as the most recently seen.
+      /// When the table is full, the least recently seen device is evicted first.
+      /// @param address
+      /// @param now
+      /// @param inserted set to true when the device was not in the table
+      /// @param onEvict called with the address and value of the evicted device, if any
+      /// @return T&
+      template <typename Evicted>
+      T &upsert(uint64_t address, Clock::time_point now, bool &inserted, Evicted &&onEvict) {
+        size_t slot = findSlot(address);
+        if (slot != kNotFound) {
+          uint32_t index = slots_[slot];
+          entries_[index].lastSeen = now;
+          unlink(index);
+          pushFront(index);
+          inserted = false;
+          return entries_[index].value;
+        }
+
+        if (free_ == kNone) {
+          Entry &oldest = entries_[tail_];
+          onEvict(oldest.address, oldest.value);
+          erase(oldest.address);
+        }
+
+        uint32_t index = free_;
+        free_ = entries_[index].next;
+
+        Entry &entry = entries_[index];
+        entry.address = address;
+        entry.lastSeen = now;
+        entry.value = T();
+        pushFront(index);
+
+        size_t probe = hash(address);
+        while (slots_[probe] != kNone) probe = (probe + 1) & mask_;
+        slots_[probe] = index;
+        ++size_;
+
+        inserted = true;
+        return entry.value;
+      }
+
+      /// @brief Remove a device
+      /// @param address
+      /// @return false when the device was not in the table
+      bool erase(uint64_t address) {
+        size_t slot = findSlot(address);
+        if (slot == kNotFound) return false;
+
+        uint32_t index = slots_[slot];
+        unlink(index);
+        entries_[index].value = T();
+        entries_[index].next = free_;
+        free_ = index;
+        --size_;
+
+        // Backward shift deletion, so probe chains stay intact without tombstones
+        size_t hole = slot;
+        size_t probe = (slot + 1) & mask_;
+        while (slots_[probe] != kNone) {
+          size_t home = hash(entries_[slots_[probe]].address);
+          bool movable = hole <= probe ? (home <= hole || home > probe) : (home <= hole && home > probe);
+          if (movable) {
+            slots_[hole] = slots_[probe];
+            hole = probe;
+          }
+          probe = (probe + 1) & mask_;
+        }
+        slots_[hole] = kNone;
+        return true;
+      }
+
+      /// @brief Evict every device last seen before the cutoff, oldest first
+      /// @param cutoff
+      /// @param onEvict called with the address and value of each evicted device
+      /// @return size_t number of evicted devices
+      template <typename Evicted>
+      size_t evictExpired(Clock::time_point cutoff, Evicted &&onEvict) {
+        size_t evicted = 0;
+        while (tail_ != kNone && entries_[tail_].lastSeen < cutoff) {
+          Entry &oldest = entries_[tail_];
+          onEvict(oldest.address, oldest.value);
+          erase(oldest.address);
+          ++evicted;
+        }
+        return evicted;
+      }
+
+    private:
+      static constexpr uint32_t kNone = UINT32_MAX;
+      static constexpr size_t kNotFound = SIZE_MAX;
+
+      struct Entry {
+        uint64_t address = 0;
+        Clock::time_point lastSeen{};
+        uint32_t prev = kNone;
+        uint32_t next = kNone;
+        T value{};
+      };
+
+      /// @brief Fibonacci hashing of the address, the high bits are the best mixed
+      size_t hash(uint64_t address) const {
+        return static_cast<size_t>((address * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+      }
+
+      size_t findSlot(uint64_t address) const {
+        size_t probe = hash(address);
+        while (slots_[probe] != kNone) {
+          if (entries_[slots_[probe]].address == address) return probe;
+          probe = (probe + 1) & mask_;
+        }
+        return kNotFound;
+      }
+
+      void unlink(uint32_t index) {
+        Entry &entry = entries_[index];
+        if (entry.prev != kNone) entries_[entry.prev].next = entry.next;
+        else head_ = entry.next;
+        if (entry.next != kNone) entries_[entry.next].prev = entry.prev;
+        else tail_ = entry.prev;
+        entry.prev = kNone;
+        entry.next = kNone;
+      }
+
+      void pushFront(uint32_t index) {
+        Entry &entry = entries_[index];
+        entry.prev = kNone;
+        entry.next = head_;
+        if (head_ != kNone) entries_[head_].prev = index;
+        head_ = index;
+        if (tail_ == kNone) tail_ = index;
+      }
+
+      std::vector<Entry> entries_;
+      std::vector<uint32_t> slots_;
+      size_t mask_ = 0;
+      size_t size_ = 0;
+      uint32_t head_ = kNone;
+      uint32_t tail_ = kNone;
+      uint32_t free_ = kNone;
+  }; // class DeviceTable
+} // namespace layrz_ble
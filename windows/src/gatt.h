@@ -1,7 +1,16 @@
 #pragma once
 
 #include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "utils.h"
+#include "uuid.h"
+#include "gatt_cache.h"
+#include "notify_subscription.h"
 
 namespace layrz_ble {
   using namespace winrt::Windows::Devices::Bluetooth::GenericAttributeProfile;
@@ -9,32 +18,193 @@ namespace layrz_ble {
   class BleCharacteristic {
     public:
       BleCharacteristic() = default;
-      explicit BleCharacteristic(const GattCharacteristic& characteristic) : characteristic_(characteristic) {}
+      BleCharacteristic(int64_t handle, const Uuid& serviceUuid, const GattCharacteristic& characteristic) :
+        handle_(handle),
+        serviceUuid_(serviceUuid),
+        uuid_(GuidToUuid(characteristic.Uuid())),
+        properties_(characteristic.CharacteristicProperties()),
+        characteristic_(characteristic) {}
       ~BleCharacteristic() {}
 
+      int64_t Handle() const { return handle_; }
+      const Uuid& ServiceUuid() const { return serviceUuid_; }
+      const Uuid& CharacteristicUuid() const { return uuid_; }
+      GattCharacteristicProperties Properties() const { return properties_; }
+      bool supports(GattCharacteristicProperties property) const { return (properties_ & property) == property; }
+
       void setCharacteristic(const GattCharacteristic& characteristic) { characteristic_ = characteristic; }
       GattCharacteristic Characteristic() const { return characteristic_; }
 
+      bool isNotifying() const { return notifying_; }
+      winrt::event_token NotifyToken() const { return notifyToken_; }
+      /// @brief Subscription of the active notifications, nullptr when not notifying
+      const std::shared_ptr<NotifySubscription>& Subscription() const { return subscription_; }
+      void setNotifyToken(winrt::event_token token, std::shared_ptr<NotifySubscription> subscription) {
+        notifyToken_ = token;
+        subscription_ = std::move(subscription);
+        notifying_ = true;
+      }
+      void clearNotifyToken() {
+        notifyToken_ = {};
+        subscription_ = nullptr;
+        notifying_ = false;
+      }
+
     private:
+      int64_t handle_ = -1;
+      Uuid serviceUuid_{};
+      Uuid uuid_{};
+      GattCharacteristicProperties properties_ = GattCharacteristicProperties::None;
       GattCharacteristic characteristic_{nullptr};
+      winrt::event_token notifyToken_{};
+      std::shared_ptr<NotifySubscription> subscription_;
+      bool notifying_ = false;
   }; // class BleCharacteristic
 
   class BleService {
     public:
       BleService() = default;
-      explicit BleService(const GattDeviceService& service) : service_(service) {}
+      explicit BleService(const GattDeviceService& service) : uuid_(GuidToUuid(service.Uuid())), service_(service) {}
       ~BleService() {}
 
+      const Uuid& ServiceUuid() const { return uuid_; }
+
       void setService(const GattDeviceService& service) { service_ = service; }
       GattDeviceService Service() const { return service_; }
 
-      void addCharacteristic(const BleCharacteristic characteristic) {
-        characteristics_[toLowercase(GuidToString(characteristic.Characteristic().Uuid()))] = characteristic;
-      }
-      const std::unordered_map<std::string, BleCharacteristic> Characteristics() const { return characteristics_; }
+      void addCharacteristic(int64_t handle) { handles_.push_back(handle); }
+      /// @brief Handles of the characteristics of the service, in discovery order
+      const std::vector<int64_t>& Characteristics() const { return handles_; }
 
     private:
+      Uuid uuid_{};
       GattDeviceService service_{nullptr};
-      std::unordered_map<std::string, BleCharacteristic> characteristics_;
+      std::vector<int64_t> handles_;
   }; // class BleService
-} // namespace layrz_ble
\ No newline at end of file
+
+  /// @brief Flat table of the characteristics of the connected device, built once at connect time.
+  ///
+  /// A characteristic handle is its index in the table, so the GATT calls that carry a handle resolve
+  /// it with one bounds check. Calls that still carry a (service, characteristic) UUID pair go through
+  /// a single hash lookup on both UUIDs, so equal characteristic UUIDs in two services do not collide.
+  /// A pair found twice in the same service is ambiguous, it is only reachable by handle.
+  ///
+  /// The table is marked stale when the services of the device change, its WinRT objects are then
+  /// invalid and it is replaced by the next discovery.
+  class GattTable {
+    public:
+      GattTable() = default;
+      GattTable(const GattTable &) = delete;
+      GattTable &operator=(const GattTable &) = delete;
+
+      void clear() {
+        services_.clear();
+        characteristics_.clear();
+        index_.clear();
+      }
+
+      bool empty() const { return characteristics_.empty(); }
+
+      void markStale() { stale_.store(true, std::memory_order_release); }
+      bool isStale() const { return stale_.load(std::memory_order_acquire); }
+
+      /// @brief Add a service, its characteristics are added with addCharacteristic()
+      /// @param service
+      /// @return size_t index of the service
+      size_t addService(const GattDeviceService& service) {
+        services_.emplace_back(service);
+        return services_.size() - 1;
+      }
+
+      /// @brief Add a characteristic to a service added before
+      /// @param serviceIndex
+      /// @param characteristic
+      /// @return int64_t handle of the characteristic
+      int64_t addCharacteristic(size_t serviceIndex, const GattCharacteristic& characteristic) {
+        auto &service = services_[serviceIndex];
+        int64_t handle = static_cast<int64_t>(characteristics_.size());
+        characteristics_.emplace_back(handle, service.ServiceUuid(), characteristic);
+        service.addCharacteristic(handle);
+        auto [it, inserted] = index_.emplace(Key{service.ServiceUuid(), characteristics_.back().CharacteristicUuid()}, handle);
+        if (!inserted) it->second = kAmbiguous;
+        return handle;
+      }
+
+      /// @brief Get a characteristic by handle
+      /// @param handle
+      /// @return BleCharacteristic*, nullptr when the handle is not valid
+      BleCharacteristic* at(int64_t handle) {
+        if (handle < 0 || handle >= static_cast<int64_t>(characteristics_.size())) return nullptr;
+        return &characteristics_[static_cast<size_t>(handle)];
+      }
+
+      /// @brief Get a characteristic by its service and characteristic UUIDs
+      /// @param serviceUuid
+      /// @param characteristicUuid
+      /// @return BleCharacteristic*, nullptr when not found or ambiguous
+      BleCharacteristic* find(const Uuid& serviceUuid, const Uuid& characteristicUuid) {
+        auto it = index_.find(Key{serviceUuid, characteristicUuid});
+        if (it == index_.end() || it->second == kAmbiguous) return nullptr;
+        return &characteristics_[static_cast<size_t>(it->second)];
+      }
+
+      /// @brief Whether the service has more than one characteristic with the UUID
+      /// @param serviceUuid
+      /// @param characteristicUuid
+      /// @return bool
+      bool isAmbiguous(const Uuid& serviceUuid, const Uuid& characteristicUuid) const {
+        auto it = index_.find(Key{serviceUuid, characteristicUuid});
+        return it != index_.end() && it->second == kAmbiguous;
+      }
+
+      /// @brief Services and characteristics of the table, without the WinRT objects, as stored in the GattCache
+      /// @return GattLayout
+      GattLayout Layout() const {
+        GattLayout layout;
+        layout.services.reserve(services_.size());
+        for (const auto &service : services_) {
+          CachedService cached;
+          cached.uuid = service.ServiceUuid();
+          cached.characteristics.reserve(service.Characteristics().size());
+          for (auto handle : service.Characteristics()) {
+            const auto &characteristic = characteristics_[static_cast<size_t>(handle)];
+            cached.characteristics.push_back({characteristic.CharacteristicUuid(), static_cast<uint32_t>(characteristic.Properties())});
+          }
+          layout.services.push_back(std::move(cached));
+        }
+        return layout;
+      }
+
+      const std::vector<BleService>& Services() const { return services_; }
+      std::vector<BleCharacteristic>& Characteristics() { return characteristics_; }
+
+      /// @brief Forget every notification subscription, their tokens are useless after a disconnection
+      void clearNotifications() {
+        for (auto &characteristic : characteristics_) characteristic.clearNotifyToken();
+      }
+
+    private:
+      static constexpr int64_t kAmbiguous = -1;
+
+      struct Key {
+        Uuid service;
+        Uuid characteristic;
+
+        bool operator==(const Key& other) const {
+          return service == other.service && characteristic == other.characteristic;
+        }
+      }; // struct Key
+
+      struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+          UuidHash hash;
+          return hash(key.service) ^ (hash(key.characteristic) * 0x9E3779B97F4A7C15ULL);
+        }
+      }; // struct KeyHash
+
+      std::vector<BleService> services_;
+      std::vector<BleCharacteristic> characteristics_;
+      std::unordered_map<Key, int64_t, KeyHash> index_;
+      std::atomic<bool> stale_{false};
+  }; // class GattTable
+} // namespace layrz_ble
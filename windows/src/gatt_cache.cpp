@@ -0,0 +1,240 @@
+#include "gatt_cache.h"
+#include "change_detector.h"
+#include "mapped_file.h"
+
+#include <cstring>
+#include <system_error>
+
+namespace layrz_ble {
+  namespace {
+    constexpr size_t kHeaderSize = 24;
+    constexpr size_t kRecordSize = 28;
+    constexpr size_t kServiceSize = 18;
+    constexpr size_t kCharacteristicSize = 20;
+
+    class Writer {
+      public:
+        explicit Writer(std::vector<uint8_t> &out) : out_(out) {}
+
+        void u8(uint8_t value) { out_.push_back(value); }
+        void u16(uint16_t value) { put(value, 2); }
+        void u32(uint32_t value) { put(value, 4); }
+        void u64(uint64_t value) { put(value, 8); }
+        void bytes(const uint8_t *data, size_t size) { out_.insert(out_.end(), data, data + size); }
+
+      private:
+        void put(uint64_t value, size_t size) {
+          for (size_t i = 0; i < size; ++i) out_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        std::vector<uint8_t> &out_;
+    }; // class Writer
+
+    class Reader {
+      public:
+        explicit Reader(ByteView bytes) : bytes_(bytes) {}
+
+        bool has(size_t size) const { return bytes_.size - position_ >= size; }
+        uint8_t u8() { return static_cast<uint8_t>(get(1)); }
+        uint16_t u16() { return static_cast<uint16_t>(get(2)); }
+        uint32_t u32() { return static_cast<uint32_t>(get(4)); }
+        uint64_t u64() { return get(8); }
+        void bytes(uint8_t *out, size_t size) {
+          std::memcpy(out, bytes_.data + position_, size);
+          position_ += size;
+        }
+        size_t position() const { return position_; }
+
+      private:
+        uint64_t get(size_t size) {
+          uint64_t value = 0;
+          for (size_t i = 0; i < size; ++i) value |= static_cast<uint64_t>(bytes_[position_ + i]) << (8 * i);
+          position_ += size;
+          return value;
+        }
+
+        ByteView bytes_;
+        size_t position_ = 0;
+    }; // class Reader
+
+    uint64_t checksum(ByteView body) {
+      Fingerprint fingerprint;
+      fingerprint.add(body.data, body.size);
+      return fingerprint.value();
+    } // checksum
+  } // namespace
+
+  /// @brief Set the file of the cache, the layouts in memory are kept
+  /// @param path
+  void GattCache::setPath(std::filesystem::path path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = std::move(path);
+  } // setPath
+
+  /// @brief Replace the layouts in memory with the ones of the file
+  /// @return false if the file is missing or not valid, the cache is then empty
+  bool GattCache::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    layouts_.clear();
+
+    MappedFile file;
+    if (path_.empty() || !file.openRead(path_)) return false;
+    return deserialize(ByteView(file.data(), file.size()), layouts_);
+  } // load
+
+  /// @brief Write every layout to the file
+  /// @return false if the file could not be written
+  bool GattCache::save() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty()) return false;
+
+    auto bytes = serialize(layouts_);
+    auto temporary = path_;
+    temporary += ".tmp";
+
+    std::error_code error;
+    std::filesystem::create_directories(path_.parent_path(), error);
+
+    {
+      MappedFile file;
+      if (!file.create(temporary, bytes.size())) return false;
+      std::memcpy(file.mutableData(), bytes.data(), bytes.size());
+      if (!file.flush()) return false;
+    }
+
+    std::filesystem::rename(temporary, path_, error);
+    return !error;
+  } // save
+
+  /// @brief Get the cached layout of a device
+  /// @param address
+  /// @param layout receives a copy of the layout
+  /// @return false if the device is not cached
+  bool GattCache::find(uint64_t address, GattLayout &layout) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = layouts_.find(address);
+    if (it == layouts_.end()) return false;
+    layout = it->second;
+    return true;
+  } // find
+
+  /// @brief Cache the layout of a device, replacing the previous one
+  /// @param address
+  /// @param layout
+  void GattCache::store(uint64_t address, GattLayout layout) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    layouts_[address] = std::move(layout);
+  } // store
+
+  /// @brief Forget the layout of a device
+  /// @param address
+  /// @return false if the device was not cached
+  bool GattCache::invalidate(uint64_t address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return layouts_.erase(address) > 0;
+  } // invalidate
+
+  /// @brief Number of cached devices
+  /// @return size_t
+  size_t GattCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return layouts_.size();
+  } // size
+
+  /// @brief Encode the layouts in the file format
+  /// @param layouts
+  /// @return std::vector<uint8_t>
+  std::vector<uint8_t> GattCache::serialize(const Layouts &layouts) {
+    std::vector<uint8_t> bytes(kHeaderSize, 0);
+    Writer writer(bytes);
+
+    uint32_t records = 0;
+    for (const auto &[address, layout] : layouts) {
+      if (layout.services.size() > UINT16_MAX) continue;
+
+      writer.u64(address);
+      writer.u8(layout.hasDatabaseHash ? 1 : 0);
+      writer.u8(0);
+      writer.u16(static_cast<uint16_t>(layout.services.size()));
+      writer.bytes(layout.databaseHash.data(), layout.databaseHash.size());
+
+      for (const auto &service : layout.services) {
+        auto count = service.characteristics.size() > UINT16_MAX ? UINT16_MAX : service.characteristics.size();
+        writer.bytes(service.uuid.bytes, sizeof(service.uuid.bytes));
+        writer.u16(static_cast<uint16_t>(count));
+        for (size_t i = 0; i < count; ++i) {
+          const auto &characteristic = service.characteristics[i];
+          writer.bytes(characteristic.uuid.bytes, sizeof(characteristic.uuid.bytes));
+          writer.u32(characteristic.properties);
+        }
+      }
+      ++records;
+    }
+
+    auto bodySize = bytes.size() - kHeaderSize;
+    std::vector<uint8_t> header;
+    header.reserve(kHeaderSize);
+    Writer headerWriter(header);
+    headerWriter.u32(kMagic);
+    headerWriter.u16(kVersion);
+    headerWriter.u16(0);
+    headerWriter.u32(records);
+    headerWriter.u32(static_cast<uint32_t>(bodySize));
+    headerWriter.u64(checksum(ByteView(bytes.data() + kHeaderSize, bodySize)));
+    std::memcpy(bytes.data(), header.data(), kHeaderSize);
+    return bytes;
+  } // serialize
+
+  /// @brief Decode the layouts from the file format
+  /// @param bytes
+  /// @param layouts receives the layouts, left empty when the bytes are not valid
+  /// @return bool
+  bool GattCache::deserialize(ByteView bytes, Layouts &layouts) {
+    layouts.clear();
+
+    Reader header(bytes);
+    if (!header.has(kHeaderSize)) return false;
+    if (header.u32() != kMagic || header.u16() != kVersion) return false;
+    header.u16();
+    uint32_t records = header.u32();
+    uint32_t bodySize = header.u32();
+    uint64_t expected = header.u64();
+
+    if (bytes.size - kHeaderSize != bodySize) return false;
+    ByteView body = bytes.sub(kHeaderSize, bodySize);
+    if (checksum(body) != expected) return false;
+
+    Reader reader(body);
+    Layouts parsed;
+    for (uint32_t r = 0; r < records; ++r) {
+      if (!reader.has(kRecordSize)) return false;
+
+      uint64_t address = reader.u64();
+      GattLayout layout;
+      layout.hasDatabaseHash = (reader.u8() & 0x01) != 0;
+      reader.u8();
+      uint16_t services = reader.u16();
+      reader.bytes(layout.databaseHash.data(), layout.databaseHash.size());
+
+      layout.services.resize(services);
+      for (auto &service : layout.services) {
+        if (!reader.has(kServiceSize)) return false;
+        reader.bytes(service.uuid.bytes, sizeof(service.uuid.bytes));
+        uint16_t characteristics = reader.u16();
+
+        if (!reader.has(static_cast<size_t>(characteristics) * kCharacteristicSize)) return false;
+        service.characteristics.resize(characteristics);
+        for (auto &characteristic : service.characteristics) {
+          reader.bytes(characteristic.uuid.bytes, sizeof(characteristic.uuid.bytes));
+          characteristic.properties = reader.u32();
+        }
+      }
+
+      parsed[address] = std::move(layout);
+    }
+
+    if (reader.position() != body.size) return false;
+    layouts = std::move(parsed);
+    return true;
+  } // deserialize
+} // namespace layrz_ble
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "adv_parser.h"
+#include "uuid.h"
+
+namespace layrz_ble {
+  struct CachedCharacteristic {
+    Uuid uuid{};
+    /// @brief GattCharacteristicProperties bits
+    uint32_t properties = 0;
+
+    bool operator==(const CachedCharacteristic &other) const {
+      return uuid == other.uuid && properties == other.properties;
+    }
+  }; // struct CachedCharacteristic
+
+  struct CachedService {
+    Uuid uuid{};
+    std::vector<CachedCharacteristic> characteristics;
+
+    bool operator==(const CachedService &other) const {
+      return uuid == other.uuid && characteristics == other.characteristics;
+    }
+  }; // struct CachedService
+
+  /// @brief GATT layout of a device, as seen by the last full discovery
+  struct GattLayout {
+    /// @brief Value of the Database Hash characteristic (0x2B2A), when the device has one
+    bool hasDatabaseHash = false;
+    std::array<uint8_t, 16> databaseHash{};
+    std::vector<CachedService> services;
+  }; // struct GattLayout
+
+  /// @brief Persistent cache of GATT layouts keyed by device address.
+  ///
+  /// The cache is a single memory-mapped file, read once by load() and rewritten as a whole by
+  /// save() through a temporary file, so a crash never leaves a half-written cache. Layout of the file,
+  /// every integer little-endian:
+  ///
+  ///   header    magic "LBGC" u32 | version u16 | reserved u16 | record count u32 | body size u32 | FNV-1a of the body u64
+  ///   record    address u64 | flags u8 (bit 0: has database hash) | reserved u8 | service count u16 | database hash [16]
+  ///   service   uuid [16] | characteristic count u16
+  ///   char.     uuid [16] | properties u32
+  ///
+  /// A file with a bad magic, version, checksum or size is ignored as a whole.
+  class GattCache {
+    public:
+      using Layouts = std::unordered_map<uint64_t, GattLayout>;
+
+      static constexpr uint32_t kMagic = 0x4347424C; // "LBGC"
+      static constexpr uint16_t kVersion = 1;
+
+      GattCache() = default;
+      explicit GattCache(std::filesystem::path path) : path_(std::move(path)) {}
+
+      void setPath(std::filesystem::path path);
+      bool load();
+      bool save();
+
+      bool find(uint64_t address, GattLayout &layout) const;
+      void store(uint64_t address, GattLayout layout);
+      bool invalidate(uint64_t address);
+      size_t size() const;
+
+      static std::vector<uint8_t> serialize(const Layouts &layouts);
+      static bool deserialize(ByteView bytes, Layouts &layouts);
+
+    private:
+      mutable std::mutex mutex_;
+      std::filesystem::path path_;
+      Layouts layouts_;
+  }; // class GattCache
+} // namespace layrz_ble
@@ -0,0 +1,197 @@
+#include "gatt_scheduler.h"
+
+namespace layrz_ble {
+  /// @brief Queue an operation, or start it right away when a slot is free
+  /// @param request
+  /// @param resume called with the id when a queued operation starts, or after onAbort when it is
+  /// aborted before starting. Not called for an operation started right away
+  /// @param id receives the id of the operation
+  /// @return true when the operation started right away
+  bool GattScheduler::submit(Request &&request, Resume resume, uint64_t &id) {
+    auto now = Clock::now();
+    auto deadline = request.deadline;
+    bool started = false;
+    std::function<void(Clock::time_point)> hook;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      id = nextId_++;
+
+      bool waiting = false;
+      for (const auto &queue : queues_) waiting = waiting || !queue.empty();
+
+      if (!waiting && running_.size() < maxConcurrent_) {
+        running_.push_back({id, request.tag, request.deadline, std::move(request.onAbort), now});
+        if (stats_ != nullptr) stats_->recordQueueWait(0);
+        started = true;
+      } else {
+        auto priority = static_cast<size_t>(request.priority);
+        queues_[priority < 3 ? priority : 2].push_back({id, std::move(request), std::move(resume), now});
+      }
+
+      if (deadline != Clock::time_point::max()) hook = timerHook_;
+    }
+
+    if (hook) hook(deadline);
+    return started;
+  } // submit
+
+  /// @brief End a running operation and start the next queued ones. Ignored for an aborted operation
+  /// @param id
+  void GattScheduler::finish(uint64_t id) {
+    Actions actions;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto now = Clock::now();
+      for (auto it = running_.begin(); it != running_.end(); ++it) {
+        if (it->id != id) continue;
+        if (stats_ != nullptr) stats_->recordService(micros(now - it->startedAt));
+        running_.erase(it);
+        record(OperationEnd::Completed);
+        break;
+      }
+      pump(now, actions);
+    }
+
+    for (auto &action : actions) action();
+  } // finish
+
+  /// @brief Abort the queued and running operations of a tag
+  /// @param tag 0 to abort every operation
+  /// @return size_t number of aborted operations
+  size_t GattScheduler::cancel(int64_t tag) {
+    Actions actions;
+    size_t count;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count = abortIf([tag](int64_t operationTag, Clock::time_point) { return tag == 0 || operationTag == tag; },
+        OperationEnd::Cancelled, actions);
+      pump(Clock::now(), actions);
+    }
+
+    for (auto &action : actions) action();
+    return count;
+  } // cancel
+
+  /// @brief Abort the operations past their deadline
+  /// @param now
+  /// @return size_t number of aborted operations
+  size_t GattScheduler::expire(Clock::time_point now) {
+    Actions actions;
+    size_t count;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count = abortIf([now](int64_t, Clock::time_point deadline) { return deadline <= now; },
+        OperationEnd::TimedOut, actions);
+      pump(now, actions);
+    }
+
+    for (auto &action : actions) action();
+    return count;
+  } // expire
+
+  /// @brief Set the number of operations that run at once
+  /// @param maxConcurrent
+  void GattScheduler::setMaxConcurrent(size_t maxConcurrent) {
+    Actions actions;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      maxConcurrent_ = maxConcurrent > 0 ? maxConcurrent : 1;
+      pump(Clock::now(), actions);
+    }
+
+    for (auto &action : actions) action();
+  } // setMaxConcurrent
+
+  void GattScheduler::setStats(SchedulerStats *stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = stats;
+  } // setStats
+
+  void GattScheduler::setTimerHook(std::function<void(Clock::time_point)> hook) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timerHook_ = std::move(hook);
+  } // setTimerHook
+
+  size_t GattScheduler::Queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto &queue : queues_) count += queue.size();
+    return count;
+  } // Queued
+
+  size_t GattScheduler::Running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_.size();
+  } // Running
+
+  /// @brief Start queued operations while slots are free, the resumes are run by the caller after unlocking
+  /// @param now
+  /// @param actions
+  void GattScheduler::pump(Clock::time_point now, Actions &actions) {
+    for (auto &queue : queues_) {
+      while (!queue.empty() && running_.size() < maxConcurrent_) {
+        auto next = std::move(queue.front());
+        queue.pop_front();
+
+        if (stats_ != nullptr) stats_->recordQueueWait(micros(now - next.queuedAt));
+        running_.push_back({next.id, next.request.tag, next.request.deadline, std::move(next.request.onAbort), now});
+        actions.push_back([resume = std::move(next.resume), id = next.id]() { resume(id, OperationEnd::Completed); });
+      }
+    }
+  } // pump
+
+  /// @brief Abort the queued and running operations matching a predicate on their tag and deadline
+  /// @param match
+  /// @param end
+  /// @param actions receives the onAbort calls, and the resumes of the queued operations
+  /// @return size_t
+  template <typename Match>
+  size_t GattScheduler::abortIf(Match &&match, OperationEnd end, Actions &actions) {
+    size_t count = 0;
+    for (auto &queue : queues_) {
+      for (auto it = queue.begin(); it != queue.end();) {
+        if (!match(it->request.tag, it->request.deadline)) {
+          ++it;
+          continue;
+        }
+
+        actions.push_back([onAbort = std::move(it->request.onAbort), resume = std::move(it->resume), id = it->id, end]() {
+          if (onAbort) onAbort(end);
+          resume(id, end);
+        });
+        it = queue.erase(it);
+        record(end);
+        ++count;
+      }
+    }
+
+    for (auto it = running_.begin(); it != running_.end();) {
+      if (!match(it->tag, it->deadline)) {
+        ++it;
+        continue;
+      }
+
+      actions.push_back([onAbort = std::move(it->onAbort), end]() {
+        if (onAbort) onAbort(end);
+      });
+      it = running_.erase(it);
+      record(end);
+      ++count;
+    }
+    return count;
+  } // abortIf
+
+  void GattScheduler::record(OperationEnd end) {
+    if (stats_ == nullptr) return;
+    switch (end) {
+      case OperationEnd::Completed: stats_->completed.fetch_add(1, std::memory_order_relaxed); break;
+      case OperationEnd::TimedOut: stats_->timedOut.fetch_add(1, std::memory_order_relaxed); break;
+      case OperationEnd::Cancelled: stats_->cancelled.fetch_add(1, std::memory_order_relaxed); break;
+    }
+  } // record
+
+  uint64_t GattScheduler::micros(Clock::duration duration) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+  } // micros
+} // namespace layrz_ble
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "plugin_stats.h"
+
+namespace layrz_ble {
+  /// @brief Order in which queued GATT operations of a device are started
+  enum class OperationPriority : uint8_t {
+    /// @brief Short control writes and CCCD writes, started before anything else
+    Control = 0,
+    Normal = 1,
+    /// @brief Long writes and polling reads, started when nothing else is waiting
+    Bulk = 2,
+  };
+
+  /// @brief How an operation left the scheduler
+  enum class OperationEnd : uint8_t {
+    Completed,
+    TimedOut,
+    Cancelled,
+  };
+
+  /// @brief Admission queue of the GATT operations of one device.
+  ///
+  /// An operation waits for a slot, at most maxConcurrent operations run at once, and the queued ones
+  /// start by priority then submission order. An operation past its deadline, or cancelled, is aborted
+  /// whether it is queued or running: its onAbort callback answers the caller right away, and a
+  /// running operation gives its slot back, the late end of its WinRT call being ignored.
+  ///
+  /// Coroutines wait for their slot with `co_await scheduler.acquire(request)`, which gives a Slot
+  /// that ends the operation when destroyed. The scheduler has no timer of its own, the timer hook is
+  /// called with each deadline and must call expire() once it is reached.
+  class GattScheduler {
+    public:
+      using Clock = std::chrono::steady_clock;
+
+      struct Request {
+        OperationPriority priority = OperationPriority::Normal;
+        /// @brief Caller-chosen tag for cancel(), 0 when the operation has none
+        int64_t tag = 0;
+        Clock::time_point deadline = Clock::time_point::max();
+        /// @brief Answers the caller of an aborted operation, called once, outside of the scheduler lock
+        std::function<void(OperationEnd)> onAbort;
+      }; // struct Request
+
+      /// @brief Running operation held by a coroutine, ended when destroyed
+      class Slot {
+        public:
+          Slot(GattScheduler *scheduler, uint64_t id, OperationEnd end) : scheduler_(scheduler), id_(id), end_(end) {}
+          Slot(Slot &&other) noexcept : scheduler_(other.scheduler_), id_(other.id_), end_(other.end_) { other.scheduler_ = nullptr; }
+          Slot &operator=(Slot &&) = delete;
+          Slot(const Slot &) = delete;
+          Slot &operator=(const Slot &) = delete;
+          ~Slot() {
+            if (scheduler_ != nullptr) scheduler_->finish(id_);
+          }
+
+          /// @brief false when the operation was aborted before it started
+          explicit operator bool() const { return end_ == OperationEnd::Completed; }
+          OperationEnd End() const { return end_; }
+
+        private:
+          GattScheduler *scheduler_;
+          uint64_t id_;
+          OperationEnd end_;
+      }; // class Slot
+
+      /// @brief Awaitable of acquire(), resumes the coroutine when its operation starts or is aborted
+      class Acquire {
+        public:
+          Acquire(GattScheduler &scheduler, Request &&request) : scheduler_(scheduler), request_(std::move(request)) {}
+
+          bool await_ready() const noexcept { return false; }
+
+          template <typename Handle>
+          bool await_suspend(Handle handle) {
+            // The callback is owned by the scheduler, not by the coroutine frame that resuming may destroy
+            bool started = scheduler_.submit(std::move(request_), [this, handle](uint64_t id, OperationEnd end) mutable {
+              id_ = id;
+              end_ = end;
+              handle.resume();
+            }, id_);
+            return !started;
+          }
+
+          Slot await_resume() {
+            return Slot(end_ == OperationEnd::Completed ? &scheduler_ : nullptr, id_, end_);
+          }
+
+        private:
+          GattScheduler &scheduler_;
+          Request request_;
+          uint64_t id_ = 0;
+          OperationEnd end_ = OperationEnd::Completed;
+      }; // class Acquire
+
+      using Resume = std::function<void(uint64_t, OperationEnd)>;
+
+      explicit GattScheduler(size_t maxConcurrent = 1) : maxConcurrent_(maxConcurrent > 0 ? maxConcurrent : 1) {}
+
+      GattScheduler(const GattScheduler &) = delete;
+      GattScheduler &operator=(const GattScheduler &) = delete;
+
+      Acquire acquire(Request request) { return Acquire(*this, std::move(request)); }
+
+      bool submit(Request &&request, Resume resume, uint64_t &id);
+      void finish(uint64_t id);
+      size_t cancel(int64_t tag = 0);
+      size_t expire(Clock::time_point now);
+
+      void setMaxConcurrent(size_t maxConcurrent);
+      void setStats(SchedulerStats *stats);
+      void setTimerHook(std::function<void(Clock::time_point)> hook);
+
+      size_t Queued() const;
+      size_t Running() const;
+
+    private:
+      struct Waiting {
+        uint64_t id;
+        Request request;
+        Resume resume;
+        Clock::time_point queuedAt;
+      }; // struct Waiting
+
+      struct Active {
+        uint64_t id;
+        int64_t tag;
+        Clock::time_point deadline;
+        std::function<void(OperationEnd)> onAbort;
+        Clock::time_point startedAt;
+      }; // struct Active
+
+      using Actions = std::vector<std::function<void()>>;
+
+      void pump(Clock::time_point now, Actions &actions);
+      template <typename Match>
+      size_t abortIf(Match &&match, OperationEnd end, Actions &actions);
+      void record(OperationEnd end);
+      static uint64_t micros(Clock::duration duration);
+
+      mutable std::mutex mutex_;
+      std::deque<Waiting> queues_[3];
+      std::vector<Active> running_;
+      size_t maxConcurrent_;
+      uint64_t nextId_ = 1;
+      SchedulerStats *stats_ = nullptr;
+      std::function<void(Clock::time_point)> timerHook_;
+  }; // class GattScheduler
+} // namespace layrz_ble
@@ -0,0 +1,89 @@
+#include "latency_histogram.h"
+
+namespace layrz_ble {
+  /// @brief Count a latency, values past 2^40 us are counted in the last bucket
+  /// @param us
+  void LatencyHistogram::record(uint64_t us) {
+    buckets_[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (us > current && !max_.compare_exchange_weak(current, us, std::memory_order_relaxed)) {}
+  } // record
+
+  /// @brief Get the count, mean, maximum and percentiles. Concurrent records may be half counted, the
+  /// percentiles are computed from the buckets alone so they stay consistent with each other
+  /// @return Snapshot
+  LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snapshot;
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      counts[i] = buckets_[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+
+    snapshot.count = total;
+    snapshot.sumUs = sum_.load(std::memory_order_relaxed);
+    snapshot.maxUs = max_.load(std::memory_order_relaxed);
+    if (total == 0) return snapshot;
+
+    // Rank of each percentile, rounded up so that p50 of one value is that value
+    const uint64_t ranks[4] = {
+      (total * 500 + 999) / 1000,
+      (total * 900 + 999) / 1000,
+      (total * 990 + 999) / 1000,
+      (total * 999 + 999) / 1000,
+    };
+    uint64_t *values[4] = {&snapshot.p50Us, &snapshot.p90Us, &snapshot.p99Us, &snapshot.p999Us};
+
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount && next < 4; ++i) {
+      seen += counts[i];
+      for (; next < 4 && seen >= ranks[next]; ++next) {
+        uint64_t highest = highestOf(i);
+        *values[next] = highest < snapshot.maxUs ? highest : snapshot.maxUs;
+      }
+    }
+    return snapshot;
+  } // snapshot
+
+  /// @brief Forget every recorded value
+  void LatencyHistogram::reset() {
+    for (auto &bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  } // reset
+
+  /// @brief Index of the bucket of a value: the magnitude (position of the highest bit) picks the group
+  /// of kSubBuckets buckets, the next kSubBucketBits bits pick the bucket in it
+  /// @param us
+  /// @return size_t
+  size_t LatencyHistogram::bucketOf(uint64_t us) {
+    if (us < kSubBuckets) return static_cast<size_t>(us);
+
+    size_t magnitude = 0;
+    for (size_t shift = 32; shift > 0; shift /= 2) {
+      if (us >> (magnitude + shift)) magnitude += shift;
+    }
+    if (magnitude > kMaxMagnitude) return kBucketCount - 1;
+
+    size_t sub = static_cast<size_t>(us >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+    return kSubBuckets * (magnitude - kSubBucketBits + 1) + sub;
+  } // bucketOf
+
+  /// @brief Highest value counted by a bucket
+  /// @param bucket
+  /// @return uint64_t
+  uint64_t LatencyHistogram::highestOf(size_t bucket) {
+    if (bucket < kSubBuckets) return bucket;
+
+    size_t magnitude = bucket / kSubBuckets + kSubBucketBits - 1;
+    uint64_t sub = bucket % kSubBuckets;
+    uint64_t width = uint64_t(1) << (magnitude - kSubBucketBits);
+    return (uint64_t(1) << magnitude) + (sub + 1) * width - 1;
+  } // highestOf
+} // namespace layrz_ble
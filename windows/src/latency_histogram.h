@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace layrz_ble {
+  /// @brief Lock-free histogram of latencies in microseconds, with HDR-style log-linear buckets.
+  ///
+  /// Values below 8 us have a bucket each, above that every power of two is split in 8 buckets, so a
+  /// percentile is within 12.5% of the recorded value whatever its magnitude, up to 2^40 us. Recording
+  /// is one relaxed increment per counter, so it can be called from any thread on the hot path.
+  class LatencyHistogram {
+    public:
+      static constexpr size_t kSubBucketBits = 3;
+      static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+      static constexpr size_t kMaxMagnitude = 40;
+      static constexpr size_t kBucketCount = kSubBuckets * (kMaxMagnitude - kSubBucketBits + 2);
+
+      struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sumUs = 0;
+        uint64_t maxUs = 0;
+        uint64_t p50Us = 0;
+        uint64_t p90Us = 0;
+        uint64_t p99Us = 0;
+        uint64_t p999Us = 0;
+
+        uint64_t meanUs() const { return count > 0 ? sumUs / count : 0; }
+      }; // struct Snapshot
+
+      LatencyHistogram() = default;
+      LatencyHistogram(const LatencyHistogram &) = delete;
+      LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+      void record(uint64_t us);
+      Snapshot snapshot() const;
+      void reset();
+
+      uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+
+    private:
+      static size_t bucketOf(uint64_t us);
+      static uint64_t highestOf(size_t bucket);
+
+      std::atomic<uint64_t> buckets_[kBucketCount] = {};
+      std::atomic<uint64_t> count_{0};
+      std::atomic<uint64_t> sum_{0};
+      std::atomic<uint64_t> max_{0};
+  }; // class LatencyHistogram
+} // namespace layrz_ble
@@ -1,5 +1,102 @@
 #include "layrz_ble_plugin.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
 namespace layrz_ble {
+  namespace {
+    /// @brief Whether a table of methods is sorted by name, checked at compile time
+    template <typename Method, size_t Size>
+    constexpr bool isSortedByName(const Method (&methods)[Size]) {
+      for (size_t i = 1; i < Size; ++i)
+        if (!(methods[i - 1].name < methods[i].name))
+          return false;
+      return true;
+    }
+
+    /// @brief Keys of the startScan arguments
+    namespace scanKeys {
+      const flutter::EncodableValue kServicesUuids{"servicesUuids"};
+      const flutter::EncodableValue kFilter{"filter"};
+      const flutter::EncodableValue kMacAddresses{"macAddresses"};
+      const flutter::EncodableValue kCompanyIds{"companyIds"};
+      const flutter::EncodableValue kNamePrefixes{"namePrefixes"};
+      const flutter::EncodableValue kMinRssi{"minRssi"};
+      const flutter::EncodableValue kManufacturerData{"manufacturerData"};
+      const flutter::EncodableValue kCompanyId{"companyId"};
+      const flutter::EncodableValue kOffset{"offset"};
+      const flutter::EncodableValue kData{"data"};
+      const flutter::EncodableValue kMask{"mask"};
+      const flutter::EncodableValue kBatchInterval{"batchInterval"};
+      const flutter::EncodableValue kMaxBatchSize{"maxBatchSize"};
+      const flutter::EncodableValue kMaxDevices{"maxDevices"};
+      const flutter::EncodableValue kDeviceTtl{"deviceTtl"};
+      const flutter::EncodableValue kSuppression{"suppression"};
+      const flutter::EncodableValue kRssiHysteresis{"rssiHysteresis"};
+      const flutter::EncodableValue kMaxSilence{"maxSilence"};
+      const flutter::EncodableValue kCapturePath{"capturePath"};
+      const flutter::EncodableValue kSimulation{"simulation"};
+      const flutter::EncodableValue kAdvertisers{"advertisers"};
+      const flutter::EncodableValue kRate{"rate"};
+      const flutter::EncodableValue kPayloadSize{"payloadSize"};
+      const flutter::EncodableValue kChurn{"churn"};
+      const flutter::EncodableValue kChangeRatio{"changeRatio"};
+      const flutter::EncodableValue kNamedRatio{"namedRatio"};
+      const flutter::EncodableValue kSeed{"seed"};
+      const flutter::EncodableValue kLimit{"limit"};
+      const flutter::EncodableValue kReplay{"replay"};
+      const flutter::EncodableValue kPath{"path"};
+      const flutter::EncodableValue kSpeed{"speed"};
+    } // namespace scanKeys
+
+    /// @brief Find the first startScan argument given with a type the scan does not read. The configure
+    /// functions skip such values, this check turns them into an error instead of a silent default
+    /// @param arguments
+    /// @return const char*, name of the argument, nullptr when every one is valid
+    const char *invalidScanArgument(const ArgumentMap &arguments) {
+      if (arguments.isMistyped<std::string>(keys::kMacAddress)) return "macAddress";
+      if (arguments.isMistyped<flutter::EncodableList>(scanKeys::kServicesUuids)) return "servicesUuids";
+      if (arguments.isMistyped<bool>(keys::kPacked)) return "packed";
+      if (arguments.isMistypedInteger(scanKeys::kBatchInterval)) return "batchInterval";
+      if (arguments.isMistypedInteger(scanKeys::kMaxBatchSize)) return "maxBatchSize";
+      if (arguments.isMistypedInteger(scanKeys::kMaxDevices)) return "maxDevices";
+      if (arguments.isMistypedInteger(scanKeys::kDeviceTtl)) return "deviceTtl";
+      if (arguments.isMistyped<std::string>(scanKeys::kCapturePath)) return "capturePath";
+
+      if (arguments.isMistyped<flutter::EncodableMap>(scanKeys::kFilter)) return "filter";
+      auto filter = arguments.map(scanKeys::kFilter);
+      if (filter.isMistyped<flutter::EncodableList>(scanKeys::kMacAddresses)) return "filter.macAddresses";
+      if (filter.isMistyped<flutter::EncodableList>(scanKeys::kServicesUuids)) return "filter.servicesUuids";
+      if (filter.isMistyped<flutter::EncodableList>(scanKeys::kCompanyIds)) return "filter.companyIds";
+      if (filter.isMistyped<flutter::EncodableList>(scanKeys::kNamePrefixes)) return "filter.namePrefixes";
+      if (filter.isMistypedInteger(scanKeys::kMinRssi)) return "filter.minRssi";
+      if (filter.isMistyped<flutter::EncodableList>(scanKeys::kManufacturerData)) return "filter.manufacturerData";
+
+      if (arguments.isMistyped<flutter::EncodableMap>(scanKeys::kSuppression)) return "suppression";
+      auto suppression = arguments.map(scanKeys::kSuppression);
+      if (suppression.isMistypedInteger(scanKeys::kRssiHysteresis)) return "suppression.rssiHysteresis";
+      if (suppression.isMistypedInteger(scanKeys::kMaxSilence)) return "suppression.maxSilence";
+
+      if (arguments.isMistyped<flutter::EncodableMap>(scanKeys::kSimulation)) return "simulation";
+      auto simulation = arguments.map(scanKeys::kSimulation);
+      if (simulation.isMistypedInteger(scanKeys::kAdvertisers)) return "simulation.advertisers";
+      if (simulation.isMistypedNumber(scanKeys::kRate)) return "simulation.rate";
+      if (simulation.isMistypedInteger(scanKeys::kPayloadSize)) return "simulation.payloadSize";
+      if (simulation.isMistypedNumber(scanKeys::kChurn)) return "simulation.churn";
+      if (simulation.isMistypedNumber(scanKeys::kChangeRatio)) return "simulation.changeRatio";
+      if (simulation.isMistypedNumber(scanKeys::kNamedRatio)) return "simulation.namedRatio";
+      if (simulation.isMistypedInteger(scanKeys::kSeed)) return "simulation.seed";
+      if (simulation.isMistypedInteger(scanKeys::kLimit)) return "simulation.limit";
+
+      if (arguments.isMistyped<flutter::EncodableMap>(scanKeys::kReplay)) return "replay";
+      auto replay = arguments.map(scanKeys::kReplay);
+      if (replay.isMistyped<std::string>(scanKeys::kPath)) return "replay.path";
+      if (replay.isMistypedNumber(scanKeys::kSpeed)) return "replay.speed";
+      return nullptr;
+    }
+  } // namespace
+
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::checkCapabilitiesChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::startScanChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::stopScanChannel = nullptr;
@@ -8,13 +105,19 @@ namespace layrz_ble {
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::discoverServicesChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::setMtuChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::writeCharacteristicChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::writeLongCharacteristicChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::readCharacteristicChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::startNotifyChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::stopNotifyChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::getStatsChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::resetStatsChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::setLogLevelChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::getNotifyStatsChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::configureOperationsChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::cancelOperationsChannel = nullptr;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::batchChannel = nullptr;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>LayrzBlePlugin::eventsChannel = nullptr;
-
-  std::string LayrzBlePlugin::filteredDeviceId = std::string("");
-  std::unique_ptr<BleScanResult> LayrzBlePlugin::connectedDevice = nullptr;
+  flutter::BinaryMessenger *LayrzBlePlugin::eventsMessenger = nullptr;
 
   /// @brief Register the plugin with the registrar
   /// @param registrar
@@ -61,6 +164,11 @@ namespace layrz_ble {
       "com.layrz.ble.writeCharacteristic",
       &flutter::StandardMethodCodec::GetInstance()
     );
+    writeLongCharacteristicChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.writeLongCharacteristic",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
     readCharacteristicChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
       registrar->messenger(),
       "com.layrz.ble.readCharacteristic",
@@ -76,11 +184,47 @@ namespace layrz_ble {
       "com.layrz.ble.stopNotify",
       &flutter::StandardMethodCodec::GetInstance()
     );
+    getStatsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.getStats",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    resetStatsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.resetStats",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    setLogLevelChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.setLogLevel",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    getNotifyStatsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.getNotifyStats",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    configureOperationsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.configureOperations",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    cancelOperationsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.cancelOperations",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
+    batchChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+      registrar->messenger(),
+      "com.layrz.ble.batch",
+      &flutter::StandardMethodCodec::GetInstance()
+    );
     eventsChannel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
       registrar->messenger(),
-      "com.layrz.ble.events",
+      kEventsChannelName,
       &flutter::StandardMethodCodec::GetInstance()
     );
+    eventsMessenger = registrar->messenger();
     checkCapabilitiesChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
       plugin_pointer->HandleMethodCall(call, std::move(result));
     });
@@ -105,6 +249,9 @@ namespace layrz_ble {
     writeCharacteristicChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
       plugin_pointer->HandleMethodCall(call, std::move(result));
     });
+    writeLongCharacteristicChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
     readCharacteristicChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
       plugin_pointer->HandleMethodCall(call, std::move(result));
     });
@@ -114,20 +261,59 @@ namespace layrz_ble {
     stopNotifyChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
       plugin_pointer->HandleMethodCall(call, std::move(result));
     });
+    getStatsChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    resetStatsChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    setLogLevelChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    getNotifyStatsChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    configureOperationsChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    cancelOperationsChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
+    batchChannel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
+      plugin_pointer->HandleMethodCall(call, std::move(result));
+    });
 
     registrar->AddPlugin(std::move(plugin));
   } // RegisterWithRegistrar
 
   /// @brief Construct a new LayrzBlePlugin object
   /// @param registrar
-  LayrzBlePlugin::LayrzBlePlugin(flutter::PluginRegistrarWindows *registrar) : uiThreadHandler_(registrar) {
+  LayrzBlePlugin::LayrzBlePlugin(flutter::PluginRegistrarWindows *registrar) : uiThreadHandler_(registrar, &stats.ui) {
+    Logger::instance().start();
+    if (auto localAppData = std::getenv("LOCALAPPDATA")) {
+      gattCache.setPath(std::filesystem::path(localAppData) / "layrz_ble" / "gatt_cache.bin");
+      if (gattCache.load())
+        Log(LogLevel::Info, "Loaded {} cached GATT layouts", gattCache.size());
+    }
     GetRadios();
   }
 
-  /// @brief Destroy the LayrzBlePlugin object
-  LayrzBlePlugin::~LayrzBlePlugin() {}
+  /// @brief Destroy the LayrzBlePlugin object. Nothing may call back into the plugin once its members are
+  /// torn down, so the sources of scan results are stopped first, then the timers, waiting for their ticks
+  LayrzBlePlugin::~LayrzBlePlugin() {
+    if (btScanner != nullptr)
+    {
+      btScanner.Stop();
+      btScanner = nullptr;
+    }
+    stopScanBackend();
+    stopScanBatching();
+    stopDeviceExpiry();
+    stopScanCapture();
+    Logger::instance().stop();
+  }
 
-  /// @brief Handle the method call
+  /// @brief Handle the method call, through a table of the methods sorted by name
   /// @param method_call
   /// @param result
   /// @return void
@@ -135,33 +321,91 @@ namespace layrz_ble {
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
   ) {
-    Log("Handling method call: " + method_call.method_name());
-    auto method = method_call.method_name();
-
-    if (method.compare("checkCapabilities") == 0)
-      checkCapabilities(std::move(result));
-    else if (method.compare("startScan") == 0)
-      startScan(method_call, std::move(result));
-    else if (method.compare("stopScan") == 0)
-      stopScan(method_call, std::move(result));
-    else if (method.compare("connect") == 0)
-      connect(method_call, std::move(result));
-    else if (method.compare("disconnect") == 0)
-      disconnect(method_call, std::move(result));
-    else if (method.compare("discoverServices") == 0)
-      discoverServices(method_call, std::move(result));
-    else if (method.compare("setMtu") == 0)
-      setMtu(method_call, std::move(result));
-    else if (method.compare("readCharacteristic") == 0)
-      readCharacteristic(method_call, std::move(result));
-    else if (method.compare("writeCharacteristic") == 0)
-      writeCharacteristic(method_call, std::move(result));
-    else if (method.compare("startNotify") == 0)
-      startNotify(method_call, std::move(result));
-    else if (method.compare("stopNotify") == 0)
-      stopNotify(method_call, std::move(result));
-    else
+    using Call = flutter::MethodCall<flutter::EncodableValue>;
+    using Result = std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>;
+    struct Method {
+      std::string_view name;
+      void (*handler)(LayrzBlePlugin &plugin, const Call &call, Result result);
+    };
+
+    // The GATT methods decode their arguments here, by reference into the method call
+    static constexpr Method kMethods[] = {
+      {"batch", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.batch(call, std::move(result));
+      }},
+      {"cancelOperations", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.cancelOperations(call, std::move(result));
+      }},
+      {"checkCapabilities", [](LayrzBlePlugin &plugin, const Call &, Result result) {
+        plugin.checkCapabilities(std::move(result));
+      }},
+      {"configureOperations", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.configureOperations(call, std::move(result));
+      }},
+      {"connect", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.connect(call, std::move(result));
+      }},
+      {"disconnect", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.disconnect(call, std::move(result));
+      }},
+      {"discoverServices", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.discoverServices(call, std::move(result));
+      }},
+      {"getNotifyStats", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.getNotifyStats(call, std::move(result));
+      }},
+      {"getStats", [](LayrzBlePlugin &plugin, const Call &, Result result) {
+        plugin.getStats(std::move(result));
+      }},
+      {"readCharacteristic", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        auto reply = std::make_shared<OperationReply>(std::move(result), &plugin.stats.gatt(GattOperationKind::Read));
+        plugin.readCharacteristic(decodeRead(ArgumentMap(call.arguments())), std::move(reply));
+      }},
+      {"resetStats", [](LayrzBlePlugin &plugin, const Call &, Result result) {
+        plugin.resetStats(std::move(result));
+      }},
+      {"setLogLevel", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.setLogLevel(call, std::move(result));
+      }},
+      {"setMtu", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.setMtu(call, std::move(result));
+      }},
+      {"startNotify", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        auto reply = std::make_shared<OperationReply>(std::move(result), &plugin.stats.gatt(GattOperationKind::StartNotify));
+        plugin.startNotify(decodeNotify(ArgumentMap(call.arguments())), std::move(reply));
+      }},
+      {"startScan", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.startScan(call, std::move(result));
+      }},
+      {"stopNotify", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        auto reply = std::make_shared<OperationReply>(std::move(result), &plugin.stats.gatt(GattOperationKind::StopNotify));
+        plugin.stopNotify(decodeGattCall(ArgumentMap(call.arguments())), std::move(reply));
+      }},
+      {"stopScan", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        plugin.stopScan(call, std::move(result));
+      }},
+      {"writeCharacteristic", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        auto reply = std::make_shared<OperationReply>(std::move(result), &plugin.stats.gatt(GattOperationKind::Write));
+        plugin.writeCharacteristic(decodeWrite(ArgumentMap(call.arguments())), std::move(reply));
+      }},
+      {"writeLongCharacteristic", [](LayrzBlePlugin &plugin, const Call &call, Result result) {
+        auto reply = std::make_shared<OperationReply>(std::move(result), &plugin.stats.gatt(GattOperationKind::WriteLong));
+        plugin.writeLongCharacteristic(decodeWrite(ArgumentMap(call.arguments())), std::move(reply));
+      }},
+    };
+    static_assert(isSortedByName(kMethods), "kMethods must be sorted by name");
+
+    Log(LogLevel::Debug, "Handling method call: {}", method_call.method_name());
+    std::string_view name = method_call.method_name();
+    auto method = std::lower_bound(std::begin(kMethods), std::end(kMethods), name, [](const Method &entry, std::string_view key) {
+      return entry.name < key;
+    });
+
+    if (method == std::end(kMethods) || method->name != name) {
       result->NotImplemented();
+      return;
+    }
+    method->handler(*this, method_call, std::move(result));
   } // HandleMethodCall
 
   /// @brief Get the Radios object
@@ -171,13 +415,13 @@ namespace layrz_ble {
     for(auto radio : radios)
       if(radio.Kind() == RadioKind::Bluetooth)
       {
-        Log("Bluetooth radio found");
+        Log(LogLevel::Info, "Bluetooth radio found");
         btRadio = radio;
         break;
       }
 
     if(!btRadio)
-      Log("No Bluetooth radio found");
+      Log(LogLevel::Warning, "No Bluetooth radio found");
   } // GetRadiosAync
 
   // ===============
@@ -199,6 +443,168 @@ namespace layrz_ble {
     result->Success(response);
   } // checkCapabilities
 
+  /// @brief Get the plugin counters, and the count, mean, percentiles and maximum of every latency histogram
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::getStats(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    flutter::EncodableMap response;
+    stats.visit([&response](const char *name, uint64_t value) {
+      response[flutter::EncodableValue(name)] = flutter::EncodableValue(static_cast<int64_t>(value));
+    });
+    // The logger is a process-wide singleton, its counter is not part of the plugin stats
+    response[flutter::EncodableValue("logDropped")] = flutter::EncodableValue(static_cast<int64_t>(Logger::instance().Dropped()));
+
+    result->Success(response);
+  } // getStats
+
+  /// @brief Clear the counters and latency histograms reported by getStats
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::resetStats(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    stats.reset();
+    result->Success(true);
+  } // resetStats
+
+  /// @brief Set the lowest level written by the logger, the levels below it cost nothing
+  /// @param method_call
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::setLogLevel(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+  ) {
+    const auto *level = std::get_if<std::string>(method_call.arguments());
+    LogLevel parsed;
+    if (level == nullptr || !Logger::parseLevel(*level, parsed)) {
+      Log(LogLevel::Warning, "Invalid log level");
+      result->Success(false);
+      return;
+    }
+
+    Logger::setLevel(parsed);
+    result->Success(true);
+  } // setLogLevel
+
+  /// @brief Get the counters of the notification rings of every active subscription
+  /// @param method_call optional macAddress of the only device to report
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::getNotifyStats(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+  ) {
+    ArgumentMap arguments(method_call.arguments());
+    if (arguments.isMistyped<std::string>(keys::kMacAddress)) {
+      result->Error("INVALID_ARGUMENT", "macAddress must be a string");
+      return;
+    }
+
+    bool filtered = false;
+    uint64_t address = 0;
+    if (auto macAddress = arguments.get<std::string>(keys::kMacAddress))
+      filtered = parseBluetoothAddress(*macAddress, address);
+
+    std::vector<std::shared_ptr<BleConnection>> active;
+    {
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      for (const auto &[connected, connection] : connections) {
+        if (!filtered || connected == address) active.push_back(connection);
+      }
+    }
+
+    // Subscriptions are taken under the lock of each connection, their counters are read without it
+    std::vector<std::shared_ptr<NotifySubscription>> subscriptions;
+    for (const auto &connection : active) {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      for (const auto &characteristic : connection->LockedGatt().Characteristics()) {
+        if (characteristic.Subscription() != nullptr)
+          subscriptions.push_back(characteristic.Subscription());
+      }
+    }
+
+    flutter::EncodableList response;
+    for (const auto &subscription : subscriptions) {
+      const auto &pending = subscription->Pending();
+      flutter::EncodableMap entry;
+      entry[flutter::EncodableValue("macAddress")]         = flutter::EncodableValue(subscription->MacAddress());
+      entry[flutter::EncodableValue("serviceUuid")]        = flutter::EncodableValue(subscription->ServiceUuid().toString());
+      entry[flutter::EncodableValue("characteristicUuid")] = flutter::EncodableValue(subscription->CharacteristicUuid().toString());
+      entry[flutter::EncodableValue("capacity")]           = flutter::EncodableValue(static_cast<int64_t>(pending.capacity()));
+      entry[flutter::EncodableValue("delivered")]          = flutter::EncodableValue(static_cast<int64_t>(pending.Delivered()));
+      entry[flutter::EncodableValue("dropped")]            = flutter::EncodableValue(static_cast<int64_t>(pending.Dropped()));
+      entry[flutter::EncodableValue("peakDepth")]          = flutter::EncodableValue(static_cast<int64_t>(pending.PeakDepth()));
+      response.push_back(flutter::EncodableValue(std::move(entry)));
+    }
+
+    result->Success(flutter::EncodableValue(std::move(response)));
+  } // getNotifyStats
+
+  /// @brief Set the concurrency limit and the default timeout of the GATT operations
+  /// @param method_call
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::configureOperations(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+  ) {
+    static const flutter::EncodableValue kMaxConcurrent{"maxConcurrent"};
+    static const flutter::EncodableValue kDefaultTimeout{"defaultTimeout"};
+
+    ArgumentMap arguments(method_call.arguments());
+    if (arguments.isMistypedInteger(kMaxConcurrent) || arguments.isMistypedInteger(kDefaultTimeout)) {
+      result->Error("INVALID_ARGUMENT", "maxConcurrent and defaultTimeout must be integers");
+      return;
+    }
+
+    if (auto maxConcurrent = arguments.integer(kMaxConcurrent))
+      maxConcurrentOperations = static_cast<size_t>(*maxConcurrent > 0 ? *maxConcurrent : 1);
+
+    if (auto timeout = arguments.integer(kDefaultTimeout))
+      operationTimeoutMs = *timeout;
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (auto &entry : connections)
+      entry.second->Scheduler().setMaxConcurrent(maxConcurrentOperations);
+
+    result->Success(flutter::EncodableValue(true));
+  } // configureOperations
+
+  /// @brief Abort the queued and running GATT operations of a device, or of every device
+  /// @param method_call optional macAddress and tag of the operations to abort
+  /// @param result number of aborted operations
+  /// @return void
+  void LayrzBlePlugin::cancelOperations(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+  ) {
+    ArgumentMap arguments(method_call.arguments());
+    if (arguments.isMistypedInteger(keys::kTag) || arguments.isMistyped<std::string>(keys::kMacAddress)) {
+      result->Error("INVALID_ARGUMENT", "tag must be an integer and macAddress a string");
+      return;
+    }
+
+    int64_t tag = arguments.integer(keys::kTag).value_or(0);
+    bool filtered = false;
+    uint64_t address = 0;
+    if (auto macAddress = arguments.get<std::string>(keys::kMacAddress))
+      filtered = parseBluetoothAddress(*macAddress, address);
+
+    std::vector<std::shared_ptr<BleConnection>> active;
+    {
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      for (const auto &[connected, connection] : connections) {
+        if (!filtered || connected == address) active.push_back(connection);
+      }
+    }
+
+    // The aborted operations are answered outside of the connections lock
+    size_t cancelled = 0;
+    for (auto &connection : active)
+      cancelled += connection->Scheduler().cancel(tag);
+
+    result->Success(flutter::EncodableValue(static_cast<int64_t>(cancelled)));
+  } // cancelOperations
+
   /// @brief Start the scan
   /// @param method_call
   /// @param result
@@ -207,52 +613,100 @@ namespace layrz_ble {
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
   ) {
-    filteredDeviceId = std::string("");
+    ArgumentMap arguments(method_call.arguments());
+    // Checked before anything is configured, a rejected call leaves the running scan as it was
+    if (auto invalid = invalidScanArgument(arguments)) {
+      result->Error("INVALID_ARGUMENT", std::string("Invalid type of the startScan argument ") + invalid);
+      return;
+    }
 
-    // Get macAddress from arguments
-    auto arguments = std::get<flutter::EncodableMap>(*method_call.arguments());
-    auto macAddressFind = arguments.find(flutter::EncodableValue("macAddress"));
-    if(macAddressFind != arguments.end())
+    configureScanFilter(arguments);
+    scanPacked = arguments.boolean(keys::kPacked).value_or(false);
+
+    auto simulation = arguments.map(scanKeys::kSimulation);
+    auto replay = arguments.map(scanKeys::kReplay);
+    auto source = ScanSource::Radio;
+    if (simulation.isMap())
+      source = ScanSource::Simulation;
+    else if (replay.isMap())
+      source = ScanSource::Replay;
+
+    // Check if the radio is on, simulated advertisers and replays do not need it
+    if(source != ScanSource::Radio || (btRadio && btRadio.State() == RadioState::On))
     {
-      try {
-        Log("Filtering by macAddress");
-        auto macAddress = std::get<std::string>(macAddressFind->second);
-        Log("Casting");
-        filteredDeviceId = toLowercase(macAddress);
-        Log("Filtered by macAddress: " + filteredDeviceId);
-      } catch (...) {
-        Log("Error filtering by macAddress");
-        filteredDeviceId = std::string("");
+      configureScanBatching(arguments);
+      configureDeviceTable(arguments);
+      configureScanSuppression(arguments);
+      configureScanCapture(arguments);
+
+      // A scan does not switch between the radio, the simulation and the replay while running
+      if (scanBackend != nullptr && scanSource != source)
+        stopScanBackend();
+
+      if (source != ScanSource::Radio)
+      {
+        // A simulation that reached its limit, or a replay that reached the end of its file, is started again
+        if (scanBackend == nullptr || !scanBackend->running())
+        {
+          stopScanBackend();
+          if (source == ScanSource::Simulation)
+          {
+            auto config = simulationConfig(simulation);
+            Log(LogLevel::Info, "Starting {} simulated advertisers", config.advertisers);
+            scanBackend = std::make_unique<SimulatedAdvertiser>(config);
+          }
+          else
+          {
+            auto config = replayConfig(replay);
+            Log(LogLevel::Info, "Replaying the capture {}", config.path.string());
+            scanBackend = std::make_unique<ScanCaptureReplay>(config);
+          }
+          scanSource = source;
+
+          if (!startScanBackend())
+          {
+            Log(LogLevel::Error, "Scan backend could not start");
+            stopScanBackend();
+            result->Success(false);
+            return;
+          }
+        }
+        else
+          Log(LogLevel::Debug, "Scan backend already started");
+        result->Success(true);
+        return;
       }
-    }
 
-    // Check if the radio is on
-    if(btRadio && btRadio.State() == RadioState::On)
-    {
-      Log("Setting up the device watcher");
+      Log(LogLevel::Debug, "Setting up the device watcher");
       setupWatcher();
-      Log("Device watcher set up");
+      Log(LogLevel::Debug, "Device watcher set up");
       // Start the scan
       if(btScanner.Status() != DeviceWatcherStatus::Started)
       {
-        Log("Starting Bluetooth(Classic) watcher");
+        Log(LogLevel::Info, "Starting Bluetooth(Classic) watcher");
         btScanner.Start();
       }
       else
-        Log("Bluetooth(Classic) watcher already started");
+        Log(LogLevel::Debug, "Bluetooth(Classic) watcher already started");
       // Start the scan
-      if(leScanner.Status() != BluetoothLEAdvertisementWatcherStatus::Started)
+      if(scanBackend == nullptr || !scanBackend->running())
       {
-        Log("Starting Bluetooth LE watcher");
-        leScanner.Start();
+        Log(LogLevel::Info, "Starting Bluetooth LE watcher");
+        if (scanBackend == nullptr)
+          scanBackend = std::make_unique<WinRtScanBackend>();
+        scanSource = ScanSource::Radio;
+        startScanBackend();
       }
       else
-        Log("Bluetooth LE watcher already started");
+      {
+        Log(LogLevel::Debug, "Bluetooth LE watcher already started");
+        scanBackend->keepRaw(scanCapture != nullptr);
+      }
       result->Success(true);
     }
     else
     {
-      Log("Bluetooth radio is off");
+      Log(LogLevel::Warning, "Bluetooth radio is off");
       result->Success(false);
     }
   } // startScan
@@ -268,24 +722,255 @@ namespace layrz_ble {
     // Stop the scan
     if(btScanner != nullptr)
     {
-      Log("Stopping Bluetooth(Classic) watcher");
+      Log(LogLevel::Info, "Stopping Bluetooth(Classic) watcher");
       btScanner.Stop();
       btScanner = nullptr;
     }
     else
-      Log("Bluetooth(Classic) watcher is not running");
+      Log(LogLevel::Debug, "Bluetooth(Classic) watcher is not running");
     // Stopping the scan
-    if(leScanner != nullptr)
+    if(scanBackend != nullptr)
     {
-      Log("Stopping Bluetooth LE watcher");
-      leScanner.Stop();
-      leScanner = nullptr;
+      Log(LogLevel::Info, "Stopping Bluetooth LE watcher");
+      stopScanBackend();
     }
     else
-      Log("Bluetooth LE watcher is not running");
+      Log(LogLevel::Debug, "Bluetooth LE watcher is not running");
+    stopScanCapture();
+    stopScanBatching();
+    stopDeviceExpiry();
     result->Success(true);
   } // stopScan
 
+  /// @brief Configure the onScanBatch mode from the startScan arguments
+  /// @param arguments
+  /// @return void
+  void LayrzBlePlugin::configureScanBatching(const ArgumentMap &arguments) {
+    stopScanBatching();
+
+    int64_t batchInterval = arguments.integer(scanKeys::kBatchInterval).value_or(0);
+    if (batchInterval <= 0)
+      return;
+
+    int64_t maxBatchSize = arguments.integer(scanKeys::kMaxBatchSize).value_or(256);
+
+    Log(LogLevel::Info, "Batching scan results every {}ms, up to {} devices", batchInterval, maxBatchSize);
+    scanBatcher.setMaxBatchSize(static_cast<size_t>(maxBatchSize > 0 ? maxBatchSize : 1));
+    scanBatching = true;
+    scanBatchTimer.start([this]() { flushScanBatch(); }, std::chrono::milliseconds(batchInterval));
+  } // configureScanBatching
+
+  /// @brief Stop the onScanBatch mode, flushing the pending results
+  /// @return void
+  void LayrzBlePlugin::stopScanBatching() {
+    scanBatchTimer.cancel();
+
+    if (scanBatching.exchange(false))
+      flushScanBatch();
+  } // stopScanBatching
+
+  /// @brief Send the pending scan results to Dart as a single list
+  /// @return void
+  void LayrzBlePlugin::flushScanBatch() {
+    auto batch = scanBatcher.drain();
+    if (batch.empty() || eventsChannel == nullptr)
+      return;
+
+    if (std::holds_alternative<std::vector<uint8_t>>(batch.front())) {
+      // Packed records are self-delimiting, the batch is sent as one buffer
+      size_t size = 0;
+      for (const auto &record : batch) {
+        if (auto bytes = std::get_if<std::vector<uint8_t>>(&record)) size += bytes->size();
+      }
+
+      std::vector<uint8_t> packed;
+      packed.reserve(size);
+      for (const auto &record : batch) {
+        if (auto bytes = std::get_if<std::vector<uint8_t>>(&record)) packed.insert(packed.end(), bytes->begin(), bytes->end());
+      }
+
+      uiThreadHandler_.Post([this, packed = std::move(packed)]() mutable {
+        eventsChannel->InvokeMethod(
+          "onScanBatchPacked",
+          std::make_unique<flutter::EncodableValue>(std::move(packed))
+        );
+      });
+      return;
+    }
+
+    uiThreadHandler_.Post([this, batch = std::move(batch)]() mutable {
+      eventsChannel->InvokeMethod(
+        "onScanBatch",
+        std::make_unique<flutter::EncodableValue>(flutter::EncodableList(std::move(batch)))
+      );
+    });
+  } // flushScanBatch
+
+  /// @brief Configure the device cap and the device TTL from the startScan arguments
+  /// @param arguments
+  /// @return void
+  void LayrzBlePlugin::configureDeviceTable(const ArgumentMap &arguments) {
+    stopDeviceExpiry();
+
+    int64_t maxDevices = arguments.integer(scanKeys::kMaxDevices).value_or(ScanPipeline::kDefaultMaxDevices);
+    if (maxDevices <= 0)
+      maxDevices = ScanPipeline::kDefaultMaxDevices;
+    scanPipeline.setMaxDevices(static_cast<size_t>(maxDevices));
+
+    int64_t ttl = arguments.integer(scanKeys::kDeviceTtl).value_or(0);
+    if (ttl <= 0)
+      return;
+
+    // Check a few times per TTL, but not more often than needed for a human-scale timeout
+    auto period = std::chrono::milliseconds(std::clamp<int64_t>(ttl / 4, 100, 1000));
+    Log(LogLevel::Info, "Forgetting devices not seen for {}ms", ttl);
+    deviceExpiryTimer.start([this, ttl]() { expireDevices(std::chrono::milliseconds(ttl)); }, period);
+  } // configureDeviceTable
+
+  /// @brief Configure the suppression of unchanged scan results from the startScan arguments
+  /// @param arguments
+  /// @return void
+  void LayrzBlePlugin::configureScanSuppression(const ArgumentMap &arguments) {
+    auto suppression = arguments.map(scanKeys::kSuppression);
+    if (!suppression.isMap())
+    {
+      scanPipeline.Changes().configure(false, 0, ChangeDetector::Clock::duration::zero());
+      return;
+    }
+
+    int64_t rssiHysteresis = suppression.integer(scanKeys::kRssiHysteresis).value_or(5);
+    int64_t maxSilence = suppression.integer(scanKeys::kMaxSilence).value_or(5000);
+
+    Log(LogLevel::Info, "Suppressing unchanged scan results, RSSI hysteresis {}dBm, heartbeat every {}ms", rssiHysteresis, maxSilence);
+    scanPipeline.Changes().configure(true, rssiHysteresis, std::chrono::milliseconds(maxSilence));
+  } // configureScanSuppression
+
+  /// @brief Stop evicting devices by TTL
+  /// @return void
+  void LayrzBlePlugin::stopDeviceExpiry() {
+    deviceExpiryTimer.cancel();
+  } // stopDeviceExpiry
+
+  /// @brief Evict the devices not seen within the TTL
+  /// @param ttl
+  /// @return void
+  void LayrzBlePlugin::expireDevices(std::chrono::milliseconds ttl) {
+    scanPipeline.expire(ScanPipeline::Clock::now() - ttl, [this](const BleScanResult &lost) { notifyScanLost(lost.DeviceId()); });
+  } // expireDevices
+
+  /// @brief Tell Dart that a device left the visible devices
+  /// @param macAddress
+  /// @return void
+  void LayrzBlePlugin::notifyScanLost(const std::string &macAddress) {
+    if (eventsChannel == nullptr)
+      return;
+
+    uiThreadHandler_.Post([macAddress]() {
+      eventsChannel->InvokeMethod(
+        "onScanLost",
+        std::make_unique<flutter::EncodableValue>(macAddress)
+      );
+    });
+  } // notifyScanLost
+
+  /// @brief Compile the scan filter from the startScan arguments
+  /// @param arguments
+  /// @return void
+  void LayrzBlePlugin::configureScanFilter(const ArgumentMap &arguments) {
+    auto compiled = std::make_shared<ScanFilter>();
+
+    if (auto macAddress = arguments.get<std::string>(keys::kMacAddress))
+    {
+      if (compiled->addAddress(*macAddress))
+        Log(LogLevel::Debug, "Filtered by macAddress: {}", *macAddress);
+      else
+        Log(LogLevel::Warning, "Error filtering by macAddress");
+    }
+
+    if (auto servicesUuids = arguments.get<flutter::EncodableList>(scanKeys::kServicesUuids))
+    {
+      for (const auto &rawUuid : *servicesUuids)
+      {
+        auto uuid = std::get_if<std::string>(&rawUuid);
+        if (!uuid || !compiled->addServiceUuid(*uuid))
+          Log(LogLevel::Warning, "Invalid service UUID on the scan filter");
+      }
+    }
+
+    auto filter = arguments.map(scanKeys::kFilter);
+    if (filter.isMap())
+    {
+      if (auto macAddresses = filter.get<flutter::EncodableList>(scanKeys::kMacAddresses))
+      {
+        for (const auto &rawMacAddress : *macAddresses)
+        {
+          auto macAddress = std::get_if<std::string>(&rawMacAddress);
+          if (!macAddress || !compiled->addAddress(*macAddress))
+            Log(LogLevel::Warning, "Invalid macAddress on the scan filter");
+        }
+      }
+
+      if (auto services = filter.get<flutter::EncodableList>(scanKeys::kServicesUuids))
+      {
+        for (const auto &rawUuid : *services)
+        {
+          auto uuid = std::get_if<std::string>(&rawUuid);
+          if (!uuid || !compiled->addServiceUuid(*uuid))
+            Log(LogLevel::Warning, "Invalid service UUID on the scan filter");
+        }
+      }
+
+      if (auto companyIds = filter.get<flutter::EncodableList>(scanKeys::kCompanyIds))
+      {
+        for (const auto &rawCompanyId : *companyIds)
+        {
+          if (auto companyId = std::get_if<int32_t>(&rawCompanyId))
+            compiled->addCompanyId(static_cast<uint16_t>(*companyId));
+          else
+            Log(LogLevel::Warning, "Invalid company ID on the scan filter");
+        }
+      }
+
+      if (auto namePrefixes = filter.get<flutter::EncodableList>(scanKeys::kNamePrefixes))
+      {
+        for (const auto &rawPrefix : *namePrefixes)
+        {
+          if (auto prefix = std::get_if<std::string>(&rawPrefix))
+            compiled->addNamePrefix(*prefix);
+        }
+      }
+
+      if (auto minRssi = filter.integer(scanKeys::kMinRssi))
+        compiled->setMinRssi(*minRssi);
+
+      if (auto patterns = filter.get<flutter::EncodableList>(scanKeys::kManufacturerData))
+      {
+        for (const auto &rawPattern : *patterns)
+        {
+          ArgumentMap patternMap(&rawPattern);
+          if (!patternMap.isMap())
+            continue;
+
+          ManufacturerDataPattern pattern;
+          if (auto companyId = patternMap.integer(scanKeys::kCompanyId))
+            pattern.companyId = static_cast<uint16_t>(*companyId);
+          if (auto offset = patternMap.integer(scanKeys::kOffset))
+            pattern.offset = static_cast<size_t>(*offset);
+          if (auto data = patternMap.get<std::vector<uint8_t>>(scanKeys::kData))
+            pattern.data = *data;
+          if (auto mask = patternMap.get<std::vector<uint8_t>>(scanKeys::kMask))
+            pattern.mask = *mask;
+
+          if (!compiled->addManufacturerDataPattern(std::move(pattern)))
+            Log(LogLevel::Warning, "Invalid manufacturer data pattern on the scan filter");
+        }
+      }
+    } // if (filter)
+
+    compiled->compile();
+    scanPipeline.setFilter(std::move(compiled));
+  } // configureScanFilter
+
   /// @brief Setup the watcher
   /// @return void
   void LayrzBlePlugin::setupWatcher() {
@@ -322,107 +1007,129 @@ namespace layrz_ble {
         }
       );
     } // if (btScanner == nullptr)
+  } // setupWatcher
+
+  /// @brief Start the backend of the scan, asking for raw advertisements while capturing
+  /// @return bool false when the backend could not start
+  bool LayrzBlePlugin::startScanBackend() {
+    scanBackend->keepRaw(scanCapture != nullptr);
+    return scanBackend->start([this](const ReceivedAdvertisement &advertisement) { handleAdvertisement(advertisement); });
+  } // startScanBackend
+
+  /// @brief Stop the backend of the scan and release it
+  /// @return void
+  void LayrzBlePlugin::stopScanBackend() {
+    if (scanBackend == nullptr)
+      return;
+
+    scanBackend->stop();
+    scanBackend = nullptr;
+    scanSource = ScanSource::Radio;
+  } // stopScanBackend
+
+  /// @brief Open, keep or close the capture file from the startScan capturePath argument
+  /// @param arguments
+  /// @return void
+  void LayrzBlePlugin::configureScanCapture(const ArgumentMap &arguments) {
+    std::filesystem::path path;
+    if (auto capturePath = arguments.get<std::string>(scanKeys::kCapturePath))
+      path = std::filesystem::u8path(*capturePath);
 
-    if (leScanner == nullptr) 
+    // A scan started again with the same file keeps appending to it
+    if (!path.empty() && scanCapture != nullptr && scanCapture->Path() == path && scanCapture->isOpen())
+      return;
+
+    stopScanCapture();
+    if (path.empty())
+      return;
+
+    auto capture = std::make_shared<ScanCaptureWriter>();
+    if (!capture->open(path))
     {
-      leScanner = BluetoothLEAdvertisementWatcher();
-      leScanner.ScanningMode(BluetoothLEScanningMode::Active);
-      // Subscribe to the Received event
-      leScanner.Received([this](BluetoothLEAdvertisementWatcher const&, BluetoothLEAdvertisementReceivedEventArgs const& args)
-        {
-          auto macAddress = toLowercase(formatBluetoothAddress(args.BluetoothAddress()));
+      Log(LogLevel::Error, "Could not create the capture file {}", path.string());
+      return;
+    }
 
-          BleScanResult deviceInfo(macAddress);
-          deviceInfo.setAddress(args.BluetoothAddress());
+    Log(LogLevel::Info, "Capturing the advertisements to {}", path.string());
+    std::atomic_store(&scanCapture, capture);
+  } // configureScanCapture
 
-          if (args.Advertisement() != nullptr)
-          {
-            auto manufacturerItems = args.Advertisement().ManufacturerData();
-            for (const auto &item : manufacturerItems) 
-            {
-              // Append the Company ID to manufacturerData
-              // Extract additional data from the IBuffer
-              auto dataBuffer = item.Data();
-              if (dataBuffer && dataBuffer.Length() > 0) 
-              {
-                std::vector<uint8_t> manufacturerData;
-                auto reader = winrt::Windows::Storage::Streams::DataReader::FromBuffer(dataBuffer);
-                std::vector<uint8_t> additionalData(dataBuffer.Length());
-                reader.ReadBytes(winrt::array_view<uint8_t>(additionalData));
-                // Append the additional data to manufacturerData
-                manufacturerData.insert(manufacturerData.end(), additionalData.begin(), additionalData.end());
-
-                deviceInfo.appendManufacturerData(
-                  item.CompanyId(),
-                  manufacturerData
-                );
-              } // if (dataBuffer && dataBuffer.Length() > 0)
-            } // for (const auto &item : manufacturerItems)
-
-            flutter::EncodableList serviceData = flutter::EncodableList();
-            auto serviceItems = args.Advertisement().DataSections();
-            for (const auto& section : serviceItems) 
-            {
-              auto dataType = section.DataType();
-              if (
-                  dataType == BluetoothLEAdvertisementDataTypes::ServiceData16BitUuids() ||
-                  dataType == BluetoothLEAdvertisementDataTypes::ServiceData32BitUuids() ||
-                  dataType == BluetoothLEAdvertisementDataTypes::ServiceData128BitUuids() ) 
-              {
-                auto dataBuffer = section.Data();
-                if (dataBuffer && dataBuffer.Length() > 0) 
-                {
-                  auto reader = winrt::Windows::Storage::Streams::DataReader::FromBuffer(dataBuffer);
-                  std::vector<uint8_t> additionalData(dataBuffer.Length());
-                  reader.ReadBytes(winrt::array_view<uint8_t>(additionalData));
-
-                  // Separate UUID from additional data
-                  size_t uuidLength = 0;
-
-                  if (dataType == BluetoothLEAdvertisementDataTypes::ServiceData16BitUuids())  { // 16-bit UUID
-                    uuidLength = 2;
-                  } else if (dataType == BluetoothLEAdvertisementDataTypes::ServiceData32BitUuids())  { // 32-bit UUID
-                    uuidLength = 4;
-                  } else if (dataType == BluetoothLEAdvertisementDataTypes::ServiceData128BitUuids())  { // 128-bit UUID
-                    uuidLength = 16;
-                  }
-
-                  std::vector<uint8_t> uuidBytes(additionalData.begin(), additionalData.begin() + uuidLength);
-                  uint16_t uuid = (uuidBytes[1] << 8) | uuidBytes[0];
-                  std::vector<uint8_t> valueBytes(additionalData.begin() + uuidLength, additionalData.end());
-
-
-                  deviceInfo.appendServiceData(uuid, valueBytes);
-                } // if (dataBuffer && dataBuffer.Length() > 0)
-              } // if (dataType == BluetoothLEAdvertisementDataTypes::ServiceData16BitUuids() || ...)
-            } // for (const auto& section : serviceItems)
-
-            auto name = HStringToString(args.Advertisement().LocalName());
-            if (!name.empty()) 
-              deviceInfo.setName(name);
-            else
-            {
-              auto it = deviceWatcherDevices.find(macAddress);
-              if (it != deviceWatcherDevices.end()) 
-                deviceInfo.setName(HStringToString(it->second.Name()));
-            } // if (!name.empty())
-          } // if (args.Advertisement() != nullptr)
-
-          auto rssi = args.RawSignalStrengthInDBm();
-          if (rssi)
-            deviceInfo.setRssi(rssi);
-
-          // Get the txPower
-          if (args.TransmitPowerLevelInDBm()) {
-            auto txPower = args.TransmitPowerLevelInDBm().Value();
-            deviceInfo.setTxPower(static_cast<int16_t>(txPower));
-          }
+  /// @brief Close the capture file, once the advertisements being handled are written
+  /// @return void
+  void LayrzBlePlugin::stopScanCapture() {
+    auto capture = std::atomic_exchange(&scanCapture, std::shared_ptr<ScanCaptureWriter>());
+    if (capture == nullptr)
+      return;
 
-          handleBleScanResult(deviceInfo);
-        }
-      );
-    } // if (leScanner == nullptr)
-  } // setupWatcher
+    Log(LogLevel::Info, "Captured {} advertisements to {}", capture->Written(), capture->Path().string());
+    capture->close();
+  } // stopScanCapture
+
+  /// @brief Get the replay of the startScan replay argument
+  /// @param replay
+  /// @return ReplayConfig
+  ReplayConfig LayrzBlePlugin::replayConfig(const ArgumentMap &replay) {
+    ReplayConfig config;
+
+    if (auto path = replay.get<std::string>(scanKeys::kPath))
+      config.path = std::filesystem::u8path(*path);
+    if (auto speed = replay.number(scanKeys::kSpeed))
+      config.speed = *speed;
+
+    return config;
+  } // replayConfig
+
+  /// @brief Get the simulated advertisers of the startScan simulation argument
+  /// @param simulation
+  /// @return SimulationConfig
+  SimulationConfig LayrzBlePlugin::simulationConfig(const ArgumentMap &simulation) {
+    SimulationConfig config;
+
+    if (auto advertisers = simulation.integer(scanKeys::kAdvertisers))
+      config.advertisers = static_cast<size_t>(*advertisers);
+    if (auto rate = simulation.number(scanKeys::kRate))
+      config.rate = *rate;
+    if (auto payloadSize = simulation.integer(scanKeys::kPayloadSize))
+      config.payloadSize = static_cast<size_t>(*payloadSize);
+    if (auto churn = simulation.number(scanKeys::kChurn))
+      config.churn = *churn;
+    if (auto changeRatio = simulation.number(scanKeys::kChangeRatio))
+      config.changeRatio = *changeRatio;
+    if (auto namedRatio = simulation.number(scanKeys::kNamedRatio))
+      config.namedRatio = *namedRatio;
+    if (auto seed = simulation.integer(scanKeys::kSeed))
+      config.seed = static_cast<uint64_t>(*seed);
+    if (auto limit = simulation.integer(scanKeys::kLimit))
+      config.limit = static_cast<uint64_t>(*limit);
+
+    return config;
+  } // simulationConfig
+
+  /// @brief Handle an advertisement of the scan backend, called from its threads
+  /// @param advertisement
+  /// @return void
+  void LayrzBlePlugin::handleAdvertisement(const ReceivedAdvertisement &advertisement) {
+    auto startedAt = std::chrono::steady_clock::now();
+
+    // Every received advertisement is captured, before the filter
+    if (auto capture = std::atomic_load(&scanCapture))
+      capture->append(advertisement);
+
+    bool packed = scanPacked;
+    std::optional<flutter::EncodableValue> event;
+    scanPipeline.handle(
+      advertisement,
+      [this, packed, &event](const BleScanResult &device) { event = scanResultEvent(device, packed); },
+      [this](const BleScanResult &lost) { notifyScanLost(lost.DeviceId()); }
+    );
+    if (event)
+      sendScanEvent(advertisement.address, std::move(*event), packed);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startedAt);
+    stats.scan.received.fetch_add(1, std::memory_order_relaxed);
+    stats.scan.processingNs.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+    stats.scan.processing.record(static_cast<uint64_t>(elapsed.count()) / 1000);
+  } // handleAdvertisement
 
   /// @brief Handle the scan result
   /// @param device 
@@ -432,68 +1139,62 @@ namespace layrz_ble {
 
     auto bluetoothAddressPropertyValue = properties.Lookup(L"System.Devices.Aep.DeviceAddress").as<IPropertyValue>();
     std::string macAddress = toLowercase(HStringToString(bluetoothAddressPropertyValue.GetString()));
+    std::string name = device.Name().empty() ? std::string() : HStringToString(device.Name());
 
-    auto result = BleScanResult(macAddress);
-    if(!device.Name().empty())
-      result.setName(HStringToString(device.Name()));
-
+    int64_t rssi = 0;
     if(properties.HasKey(L"System.Devices.Aep.SignalStrength"))
     {
       auto signalStrength = properties.Lookup(L"System.Devices.Aep.SignalStrength").as<IPropertyValue>();
-      result.setRssi(signalStrength.GetInt64());
+      rssi = signalStrength.GetInt64();
     }
 
-    handleBleScanResult(result);
-  } // handleScanResult
-
-  /// @brief Handle the BLE scan result
-  /// @param result
-  /// @return void
-  void LayrzBlePlugin::handleBleScanResult(BleScanResult &result) {
-    if(result.DeviceId().empty())
+    uint64_t address = 0;
+    if (!parseBluetoothAddress(macAddress, address))
     {
-      Log("Empty Mac Address");
+      Log(LogLevel::Warning, "Invalid Mac Address: {}", macAddress);
       return;
     }
 
-    if(filteredDeviceId.length() > 0 && result.DeviceId() != filteredDeviceId)
-      return;
-
-    // Check if the result.deviceId is inside of visibleDevices
-    auto it = visibleDevices.find(result.DeviceId());
-
-    if(it != visibleDevices.end()) {
-      // Update the existing device
-      // Check if the name is not empty to update it
-      auto &device = it->second;
-      if(result.Name()) {
-        device.setName(*result.Name());
-      }
-
-      if(result.Rssi()) {
-        device.setRssi(result.Rssi());
-      }
-
-      if (!result.ServiceData()->empty()) {
-        for (const auto &serviceData : *result.ServiceData()) {
-          device.appendServiceData(serviceData.first, serviceData.second);
-        }
-      }
+    auto filter = scanPipeline.Filter();
+    if (!filter->empty())
+    {
+      // Classic devices only carry their name, so it is the only content the filter can see
+      ParsedAdvertisement parsed;
+      if (!name.empty())
+        parsed.add(AdType::CompleteLocalName, ByteView(reinterpret_cast<const uint8_t *>(name.data()), name.size()));
+      if (!scanPipeline.passes(*filter, address, rssi, parsed))
+        return;
+    }
 
-      if (!result.ManufacturerData()->empty()) {
-        for (const auto &mfd : *result.ManufacturerData()) {
-          device.appendManufacturerData(mfd.first, mfd.second);
-        }
-      }
+    auto result = BleScanResult(macAddress);
+    result.setAddress(address);
+    if(!name.empty())
+      result.setName(name);
+
+    if(rssi)
+      result.setRssi(rssi);
+
+    bool packed = scanPacked;
+    std::optional<flutter::EncodableValue> event;
+    scanPipeline.merge(
+      std::move(result),
+      filter->Generation(),
+      [this, packed, &event](const BleScanResult &device) { event = scanResultEvent(device, packed); },
+      [this](const BleScanResult &lost) { notifyScanLost(lost.DeviceId()); }
+    );
+    if (event)
+      sendScanEvent(address, std::move(*event), packed);
+  } // handleScanResult
 
-      visibleDevices.insert_or_assign(result.DeviceId(), device);
-    } else {
-      visibleDevices.insert_or_assign(result.DeviceId(), result);
-    }
+  /// @brief Build the event of a scan result, with the lock of the visible devices held
+  /// @param device
+  /// @param packed whether the scan sends packed records instead of maps
+  /// @return flutter::EncodableValue
+  flutter::EncodableValue LayrzBlePlugin::scanResultEvent(const BleScanResult &device, bool packed) const {
+    if (packed)
+      return flutter::EncodableValue(packScanResult(device));
 
-    const auto &device = visibleDevices[result.DeviceId()];
     flutter::EncodableMap response;
-
     response[flutter::EncodableValue("macAddress")]       = flutter::EncodableValue(device.DeviceId());
     response[flutter::EncodableValue("name")]             = flutter::EncodableValue(device.Name() ? *device.Name() : "Unknown");
     response[flutter::EncodableValue("rssi")]             = flutter::EncodableValue(device.Rssi());
@@ -507,35 +1208,86 @@ namespace layrz_ble {
         flutter::EncodableMap mfdMap = flutter::EncodableMap();
         mfdMap[flutter::EncodableValue("companyId")] = flutter::EncodableValue(mfd.first);
         mfdMap[flutter::EncodableValue("data")] = flutter::EncodableValue(mfd.second);
-        
+
         manufacturerDataList.push_back(mfdMap);
       }
 
       response[flutter::EncodableValue("manufacturerData")] = flutter::EncodableValue(manufacturerDataList);
     }
-    
+
     if (device.ServiceData() != nullptr) {
       flutter::EncodableList serviceDataList;
       for (const auto &serviceData : *device.ServiceData()) {
         flutter::EncodableMap serviceDataMap = flutter::EncodableMap();
-        serviceDataMap[flutter::EncodableValue("uuid")] = flutter::EncodableValue(serviceData.first);
+        // "uuid" keeps the 16-bit form sent by the other platforms, "fullUuid" is never truncated
+        const auto &uuid = serviceData.first;
+        serviceDataMap[flutter::EncodableValue("uuid")] = flutter::EncodableValue((uuid.bytes[2] << 8) | uuid.bytes[3]);
+        serviceDataMap[flutter::EncodableValue("fullUuid")] = flutter::EncodableValue(uuid.toString());
         serviceDataMap[flutter::EncodableValue("data")] = flutter::EncodableValue(serviceData.second);
-        
+
         serviceDataList.push_back(serviceDataMap);
       }
 
       response[flutter::EncodableValue("serviceData")] = flutter::EncodableValue(serviceDataList);
     }
-    
-    if(eventsChannel != nullptr) {
-      uiThreadHandler_.Post([this, response]() {
-        eventsChannel->InvokeMethod(
-          "onScan",
-          std::make_unique<flutter::EncodableValue>(response)
-        );
-      });
+
+    return flutter::EncodableValue(std::move(response));
+  } // scanResultEvent
+
+  /// @brief Send the event of a scan result to Dart, or add it to the pending batch
+  /// @param address
+  /// @param event
+  /// @param packed whether the event is a packed record
+  /// @return void
+  void LayrzBlePlugin::sendScanEvent(uint64_t address, flutter::EncodableValue &&event, bool packed) {
+    if (scanBatching) {
+      // Latest wins: a device seen again in the same window replaces its pending result
+      if (scanBatcher.push(address, std::move(event)))
+        flushScanBatch();
+      return;
     }
-  } // handleBleScanResult
+
+    if (eventsChannel == nullptr)
+      return;
+
+    uiThreadHandler_.Post([this, event = std::move(event), packed]() mutable {
+      eventsChannel->InvokeMethod(
+        packed ? "onScanPacked" : "onScan",
+        std::make_unique<flutter::EncodableValue>(std::move(event))
+      );
+    });
+  } // sendScanEvent
+
+  /// @brief Encode a scan result as a packed scan record
+  /// @param device
+  /// @return std::vector<uint8_t>
+  std::vector<uint8_t> LayrzBlePlugin::packScanResult(const BleScanResult &device) const {
+    std::vector<uint8_t> record;
+    std::string_view name;
+    if (device.Name() != nullptr) name = *device.Name();
+    uint16_t txPower = device.TxPower();
+
+    packed::ScanRecordWriter writer(
+      record,
+      device.Address(),
+      device.Rssi(),
+      txPower ? &txPower : nullptr,
+      device.Name() != nullptr ? &name : nullptr
+    );
+
+    if (device.ManufacturerData() != nullptr) {
+      for (const auto &mfd : *device.ManufacturerData())
+        writer.addManufacturerData(mfd.first, mfd.second.data(), mfd.second.size());
+    }
+
+    if (device.ServiceData() != nullptr) {
+      for (const auto &serviceData : *device.ServiceData())
+        writer.addServiceData(serviceData.first, serviceData.second.data(), serviceData.second.size());
+    }
+
+    writer.finish();
+    return record;
+  } // packScanResult
 
   /// @brief Connect to the device
   /// @param method_call
@@ -545,33 +1297,56 @@ namespace layrz_ble {
       const flutter::MethodCall<flutter::EncodableValue> &method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
   ) {
-    if (connectedDevice != nullptr) 
-    {
-      Log("Already connected to a device");
-      result->Success(flutter::EncodableValue(false));
+    auto macAddressArgument = std::get_if<std::string>(method_call.arguments());
+    if (macAddressArgument == nullptr) {
+      result->Error("INVALID_ARGUMENT", "connect expects the macAddress as a string");
       co_return;
     }
+    auto macAddress = *macAddressArgument;
+    Log(LogLevel::Debug, "MacAddress casted to {}", macAddress);
+    std::optional<BleScanResult> found;
+    uint64_t address = 0;
+    if (parseBluetoothAddress(macAddress, address))
+      found = scanPipeline.find(address);
 
-    auto macAddress = std::get<std::string>(*method_call.arguments());
-    Log("MacAddress casted to " + macAddress);
-    auto it = visibleDevices.find(toLowercase(macAddress));
-    if (it == visibleDevices.end()) {
-      Log("Device not found");
+    if (!found) {
+      Log(LogLevel::Warning, "Device not found");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
+    {
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      if (connections.count(address) > 0 || !pendingConnections.insert(address).second) {
+        Log(LogLevel::Info, "Already connected to the device");
+        result->Success(flutter::EncodableValue(false));
+        co_return;
+      }
+    }
+
+    // Forget the pending connection on every way out of the coroutine
+    struct PendingConnection {
+      LayrzBlePlugin *plugin;
+      uint64_t address;
+      ~PendingConnection() {
+        std::lock_guard<std::mutex> lock(plugin->connectionsMutex);
+        plugin->pendingConnections.erase(address);
+      }
+    } pendingConnection{this, address};
+
     if(btScanner != nullptr){
-      Log("Stopping Bluetooth(Classic) watcher");
+      Log(LogLevel::Info, "Stopping Bluetooth(Classic) watcher");
       btScanner.Stop();
       btScanner = nullptr;
     }
 
     // Stopping the scan
-    if(leScanner != nullptr){
-      Log("Stopping Bluetooth LE watcher");
-      leScanner.Stop();
-      leScanner = nullptr;
+    if(scanBackend != nullptr){
+      Log(LogLevel::Info, "Stopping Bluetooth LE watcher");
+      stopScanBackend();
+      stopScanCapture();
+      stopScanBatching();
+      stopDeviceExpiry();
 
       if (eventsChannel != nullptr) {
         eventsChannel->InvokeMethod(
@@ -581,58 +1356,182 @@ namespace layrz_ble {
       }
     }
 
-    Log("Device found, attempting to get");
-    auto device = it->second;
+    Log(LogLevel::Debug, "Device found, attempting to get");
+    auto device = std::move(*found);
 
+    using Clock = std::chrono::steady_clock;
+    auto elapsedUs = [](Clock::time_point from, Clock::time_point to) {
+      return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    };
+
+    stats.connect.attempts.fetch_add(1, std::memory_order_relaxed);
+    auto connectStart = Clock::now();
     auto connDevice = co_await BluetoothLEDevice::FromBluetoothAddressAsync(device.Address());
+    auto addressResolved = Clock::now();
     if (!connDevice) {
-      Log("Failed to connect to the device");
+      Log(LogLevel::Error, "Failed to connect to the device");
+      stats.connect.failed.fetch_add(1, std::memory_order_relaxed);
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    servicesAndCharacteristics.clear();
-    servicesNotifying.clear();
-    device.setDevice(connDevice);
+    auto connection = std::make_shared<BleConnection>(address, connDevice);
+    auto gattTable = std::make_shared<GattTable>();
+    setupScheduler(connection);
 
-    Log("Device found, attempting to get GATT services");
-    auto servicesResult = co_await connDevice.GetGattServicesAsync((BluetoothCacheMode::Uncached));
-    auto status = servicesResult.Status();
-    if (status != GattCommunicationStatus::Success) {
-      Log("Failed to get GATT services");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
+    // One session for the whole connection, it keeps the link up and tracks the MTU
+    auto session = co_await GattSession::FromDeviceIdAsync(connDevice.BluetoothDeviceId());
+    if (session) {
+      session.MaintainConnection(true);
+      connection->setSession(session);
+      connection->setMtu(session.MaxPduSize());
+
+      std::weak_ptr<BleConnection> weakConnection = connection;
+      connection->setMaxPduSizeToken(session.MaxPduSizeChanged([this, weakConnection](GattSession const &sender, IInspectable const &) {
+        if (auto current = weakConnection.lock()) {
+          current->setMtu(sender.MaxPduSize());
+          notifyMtuChanged(current->MacAddress(), sender.MaxPduSize());
+        }
+      }));
+      connection->setSessionStatusToken(session.SessionStatusChanged([this, weakConnection](GattSession const &, GattSessionStatusChangedEventArgs const &args) {
+        if (auto current = weakConnection.lock())
+          notifySessionStatus(current->MacAddress(), args.Status() == GattSessionStatus::Active, args.Error());
+      }));
+    } else {
+      Log(LogLevel::Warning, "Failed to get GATT session, the MTU will not be tracked");
+    }
+
+    // The layout cached for the device is only trusted while its Database Hash is unchanged. When it is,
+    // the discovery is answered from the Windows cache, without walking the GATT server again.
+    GattLayout cachedLayout;
+    bool useCache = false;
+    std::array<uint8_t, 16> databaseHash{};
+    bool hasDatabaseHash = false;
+    if (gattCache.find(address, cachedLayout)) {
+      auto hashValue = co_await readDatabaseHash(connDevice);
+      hasDatabaseHash = hashValue != nullptr && hashValue.Length() == databaseHash.size();
+      if (hasDatabaseHash)
+        std::memcpy(databaseHash.data(), hashValue.data(), databaseHash.size());
+
+      useCache = hasDatabaseHash == cachedLayout.hasDatabaseHash && (!hasDatabaseHash || databaseHash == cachedLayout.databaseHash);
+      if (!useCache) {
+        Log(LogLevel::Info, "Database hash changed, dropping the cached GATT layout");
+        gattCache.invalidate(address);
+      }
     }
+    auto hashRead = Clock::now();
 
-    for (auto service : servicesResult.Services()) {
-      auto serviceUuid = toLowercase(GuidToString(service.Uuid()));
-      servicesAndCharacteristics[serviceUuid] = BleService(service);
+    Clock::time_point servicesEnumerated;
+    while (true) {
+      auto cacheMode = useCache ? BluetoothCacheMode::Cached : BluetoothCacheMode::Uncached;
+      gattTable->clear();
 
-      auto characteristics = co_await service.GetCharacteristicsAsync(BluetoothCacheMode::Uncached);
-      for (auto characteristic : characteristics.Characteristics()) {
-        auto characteristicUuid = toLowercase(GuidToString(characteristic.Uuid()));
-        servicesAndCharacteristics[serviceUuid].addCharacteristic(BleCharacteristic(characteristic));
+      Log(LogLevel::Debug, "Device found, attempting to get GATT services");
+      auto servicesResult = co_await connDevice.GetGattServicesAsync(cacheMode);
+      servicesEnumerated = Clock::now();
+      if (servicesResult.Status() != GattCommunicationStatus::Success) {
+        if (useCache) {
+          useCache = false;
+          continue;
+        }
+        Log(LogLevel::Error, "Failed to get GATT services");
+        stats.connect.failed.fetch_add(1, std::memory_order_relaxed);
+        result->Success(flutter::EncodableValue(false));
+        co_return;
       }
-    }
 
-    connDevice.ConnectionStatusChanged({this, &LayrzBlePlugin::onConnectionStatusChanged});
+      co_await discoverCharacteristics(servicesResult.Services(), cacheMode, gattTable);
+
+      // The Windows cache may still hold an older layout than ours, discover again from the device
+      if (useCache && gattTable->Layout().services != cachedLayout.services) {
+        Log(LogLevel::Info, "Cached GATT layout does not match the device, discovering again");
+        useCache = false;
+        continue;
+      }
+      break;
+    }
+    auto characteristicsEnumerated = Clock::now();
+    connection->replaceGatt(gattTable);
+
+    connection->setConnectionStatusToken(connDevice.ConnectionStatusChanged({this, &LayrzBlePlugin::onConnectionStatusChanged}));
+    // The handles of the table point to the services that changed, every call by handle fails until
+    // discoverServices builds a new table
+    std::weak_ptr<BleConnection> servicesConnection = connection;
+    connection->setServicesChangedToken(connDevice.GattServicesChanged([this, address, servicesConnection](BluetoothLEDevice const &, IInspectable const &) {
+      Log(LogLevel::Info, "GATT services changed, dropping the cached GATT layout");
+      if (auto current = servicesConnection.lock()) {
+        current->Gatt()->markStale();
+        current->Reads().clear();
+      }
+      if (gattCache.invalidate(address))
+        gattCache.save();
+    }));
 
-    Log("GATT Services discovered");
-    connectedDevice = std::make_unique<BleScanResult>(device);
-    result->Success(flutter::EncodableValue(true));
+    Log(LogLevel::Info, "GATT Services discovered");
+    {
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      connections[address] = connection;
+      lastConnectedAddress = address;
+    }
+
+    flutter::EncodableMap timings;
+    timings[flutter::EncodableValue("addressResolveUs")]            = flutter::EncodableValue(elapsedUs(connectStart, addressResolved));
+    timings[flutter::EncodableValue("databaseHashUs")]              = flutter::EncodableValue(elapsedUs(addressResolved, hashRead));
+    timings[flutter::EncodableValue("serviceEnumerationUs")]        = flutter::EncodableValue(elapsedUs(hashRead, servicesEnumerated));
+    timings[flutter::EncodableValue("characteristicEnumerationUs")] = flutter::EncodableValue(elapsedUs(servicesEnumerated, characteristicsEnumerated));
+    timings[flutter::EncodableValue("totalUs")]                     = flutter::EncodableValue(elapsedUs(connectStart, characteristicsEnumerated));
+    timings[flutter::EncodableValue("cacheHit")]                    = flutter::EncodableValue(useCache);
+    stats.connect.addressResolve.record(elapsedUs(connectStart, addressResolved));
+    stats.connect.databaseHash.record(elapsedUs(addressResolved, hashRead));
+    stats.connect.serviceEnumeration.record(elapsedUs(hashRead, servicesEnumerated));
+    stats.connect.characteristicEnumeration.record(elapsedUs(servicesEnumerated, characteristicsEnumerated));
+    stats.connect.total.record(elapsedUs(connectStart, characteristicsEnumerated));
+    Log(LogLevel::Info, "Connected in {}us", elapsedUs(connectStart, characteristicsEnumerated));
 
-    if (eventsChannel != nullptr) {
-      uiThreadHandler_.Post([this]() {
-        eventsChannel->InvokeMethod(
-          "onEvent",
-          std::make_unique<flutter::EncodableValue>("CONNECTED")
-        ); 
-      });
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("connected")] = flutter::EncodableValue(true);
+    response[flutter::EncodableValue("timings")]   = flutter::EncodableValue(timings);
+    response[flutter::EncodableValue("mtu")]       = flutter::EncodableValue(static_cast<int32_t>(connection->Mtu()));
+    result->Success(flutter::EncodableValue(response));
+
+    if (!useCache) {
+      auto layout = gattTable->Layout();
+      if (!hasDatabaseHash) {
+        auto hashCharacteristic = gattTable->find(Uuid::fromShort(0x1801), Uuid::fromShort(0x2B2A));
+        if (hashCharacteristic != nullptr) {
+          // The connection is already answered, so Dart may have queued calls: the read takes a slot like them
+          GattScheduler::Request request;
+          request.priority = OperationPriority::Control;
+          if (int64_t timeout = operationTimeoutMs.load(); timeout > 0)
+            request.deadline = GattScheduler::Clock::now() + std::chrono::milliseconds(timeout);
+
+          auto characteristic = hashCharacteristic->Characteristic();
+          auto slot = co_await connection->Scheduler().acquire(std::move(request));
+          if (slot && !connection->isClosed()) {
+            try {
+              auto hashValue = co_await characteristic.ReadValueAsync(BluetoothCacheMode::Uncached);
+              hasDatabaseHash = hashValue.Status() == GattCommunicationStatus::Success && hashValue.Value().Length() == databaseHash.size();
+              if (hasDatabaseHash)
+                std::memcpy(databaseHash.data(), hashValue.Value().data(), databaseHash.size());
+            } catch (...) {
+              Log(LogLevel::Warning, "Failed to read the Database Hash");
+            }
+          }
+        }
+      }
+      layout.hasDatabaseHash = hasDatabaseHash;
+      layout.databaseHash = databaseHash;
+      gattCache.store(address, std::move(layout));
+      gattCache.save();
     }
+
+    // The device may have disconnected while its Database Hash was read
+    if (!connection->isClosed())
+      notifyDeviceEvent(connection->MacAddress(), "CONNECTED");
     co_return;
   } // connect
 
-  /// @brief Disconnect from the device
+  /// @brief Disconnect from a device, or from every device when no address is given
   /// @param method_call 
   /// @param result 
   /// @return void
@@ -640,32 +1539,34 @@ namespace layrz_ble {
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
   ) {
-    if (connectedDevice == nullptr) 
-    {
-      Log("Not connected to a device");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
+    std::vector<std::shared_ptr<BleConnection>> closing;
+    auto macAddress = method_call.arguments() != nullptr ? std::get_if<std::string>(method_call.arguments()) : nullptr;
+    if (macAddress != nullptr) {
+      uint64_t address = 0;
+      if (parseBluetoothAddress(*macAddress, address)) {
+        if (auto connection = takeConnection(address))
+          closing.push_back(std::move(connection));
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      for (auto &entry : connections)
+        closing.push_back(std::move(entry.second));
+      connections.clear();
     }
-    
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
+
+    if (closing.empty()) 
+    {
+      Log(LogLevel::Warning, "Not connected to a device");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    device->Close();
-    connectedDevice = nullptr;
-    servicesNotifying.clear();
-    servicesAndCharacteristics.clear();
+    for (auto &connection : closing) {
+      connection->close();
+      notifyDeviceEvent(connection->MacAddress(), "DISCONNECTED");
+    }
 
     result->Success(flutter::EncodableValue(true));
-    if (eventsChannel != nullptr) {
-      eventsChannel->InvokeMethod(
-        "onEvent",
-        std::make_unique<flutter::EncodableValue>("DISCONNECTED")
-      ); 
-    }
     co_return;
   } // disconnect
 
@@ -677,40 +1578,52 @@ namespace layrz_ble {
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
   ) {
-    if (connectedDevice == nullptr)
-    {
-      Log("Not connected to a device");
+    auto connection = findConnection(method_call.arguments());
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue());
       co_return;
     }
 
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
-      result->Success(flutter::EncodableValue());
-      co_return;
-    }
+    // The services changed since the last discovery, the table is built again from the device
+    auto gattTable = connection->Gatt();
+    if (gattTable->isStale()) {
+      auto device = connection->Device();
+      if (!device) {
+        result->Success(flutter::EncodableValue());
+        co_return;
+      }
 
-    auto gatt = co_await GattSession::FromDeviceIdAsync(device->BluetoothDeviceId());
-    if (!gatt) {
-      Log("Failed to get GATT session");
-      result->Success(flutter::EncodableValue());
-      co_return;
-    }
+      auto table = std::make_shared<GattTable>();
+      try {
+        auto servicesResult = co_await device.GetGattServicesAsync(BluetoothCacheMode::Uncached);
+        if (servicesResult.Status() != GattCommunicationStatus::Success) {
+          result->Error("SERVICES_CHANGED", "Failed to discover the changed GATT services of the device");
+          co_return;
+        }
+        co_await discoverCharacteristics(servicesResult.Services(), BluetoothCacheMode::Uncached, table);
+      } catch (...) {
+        result->Error("SERVICES_CHANGED", "Failed to discover the changed GATT services of the device");
+        co_return;
+      }
 
+      connection->replaceGatt(table);
+      connection->Reads().clear();
+      gattTable = table;
+      Log(LogLevel::Info, "Discovered the changed GATT services of {}", connection->MacAddress());
+    }
 
     flutter::EncodableList output = {};
-    for (auto [serviceUuid, service] : servicesAndCharacteristics) {
+    for (const auto &service : gattTable->Services()) {
 
       flutter::EncodableList characteristicsOutput = {};
-      for (auto [characteristicUuid, characteristicItm] : service.Characteristics()) {
-        auto characteristic = characteristicItm.Characteristic();
+      for (auto handle : service.Characteristics()) {
+        auto characteristicItm = gattTable->at(handle);
         flutter::EncodableMap characteristicObj = {};
         flutter::EncodableList propertiesList = {};
 
         std::vector<std::string> propertiesToStore = {};
 
-        auto properties = characteristic.CharacteristicProperties();
+        auto properties = characteristicItm->Properties();
         if ((properties & GattCharacteristicProperties::Read) == GattCharacteristicProperties::Read) {
           propertiesList.push_back(flutter::EncodableValue("READ"));
           propertiesToStore.push_back("READ");
@@ -751,22 +1664,24 @@ namespace layrz_ble {
           propertiesToStore.push_back("WRITE_WO_RSP");
         }
 
-        characteristicObj[flutter::EncodableValue("uuid")] = flutter::EncodableValue(characteristicUuid);
+        characteristicObj[flutter::EncodableValue("uuid")] = flutter::EncodableValue(characteristicItm->CharacteristicUuid().toString());
+        characteristicObj[flutter::EncodableValue("handle")] = flutter::EncodableValue(handle);
         characteristicObj[flutter::EncodableValue("properties")] = propertiesList;
 
         characteristicsOutput.push_back(characteristicObj);
       }
 
       flutter::EncodableMap serviceMap = {};
-      serviceMap[flutter::EncodableValue("uuid")] = flutter::EncodableValue(serviceUuid);
+      serviceMap[flutter::EncodableValue("uuid")] = flutter::EncodableValue(service.ServiceUuid().toString());
       serviceMap[flutter::EncodableValue("characteristics")] = characteristicsOutput;
       output.push_back(serviceMap);
     }
 
     result->Success(output);
+    co_return;
   } // discoverServices
 
-  /// @brief Set the MTU (Only return the current MTU, do not negotiate)
+  /// @brief Set the MTU (Only return the MTU cached from the session, do not negotiate)
   /// @param method_call
   /// @param result
   /// @return void
@@ -774,315 +1689,398 @@ namespace layrz_ble {
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
   ) {
-    if (connectedDevice == nullptr)
-    {
-      Log("Not connected to a device");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
-
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
-
-    auto gatt = co_await GattSession::FromDeviceIdAsync(device->BluetoothDeviceId());
-    if (!gatt) {
-      Log("Failed to get GATT session");
+    auto connection = findConnection(method_call.arguments());
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto mtu = gatt.MaxPduSize();
-    result->Success(flutter::EncodableValue(mtu));
+    result->Success(flutter::EncodableValue(static_cast<int32_t>(connection->Mtu())));
     co_return;
   } // setMtu
   
-  /// @brief Read the characteristic
-  /// @param method_call
+  /// @brief Read the characteristic. The value may come from the cache of the connection, depending on the
+  /// cacheMode argument, and concurrent reads of the same characteristic share one read from the device
+  /// @param arguments
   /// @param result 
   /// @return void
-  winrt::fire_and_forget LayrzBlePlugin::readCharacteristic(
-    const flutter::MethodCall<flutter::EncodableValue> &method_call,
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
-  ) {
-    if (connectedDevice == nullptr) {
-      Log("Not connected to a device");
+  winrt::fire_and_forget LayrzBlePlugin::readCharacteristic(ReadArguments arguments, std::shared_ptr<OperationReply> result) {
+    auto connection = findConnection(arguments.macAddress);
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue());
       co_return;
     }
 
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
+    // Held for the whole call, the entry stays valid even if a new discovery replaces the table
+    auto gatt = connection->Gatt();
+    auto entry = resolveCharacteristic(*gatt, arguments, *result);
+    if (entry == nullptr) {
       result->Success(flutter::EncodableValue());
       co_return;
     }
 
-    // Log("Casting arguments");
-    auto arguments = std::get<flutter::EncodableMap>(*method_call.arguments());
-    // Log("Getting service UUID");
-    auto rawServiceUuid = arguments.find(flutter::EncodableValue("serviceUuid"));
-    if (rawServiceUuid == arguments.end()) {
-      Log("Service UUID not provided");
+    bool notifying = false;
+    {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      notifying = entry->isNotifying();
+    }
+    if (notifying) {
+      Log(LogLevel::Warning, "This characteristic {} is notifying, so we can't read it", entry->CharacteristicUuid().toString());
       result->Success(flutter::EncodableValue());
       co_return;
     }
-    // Log("Casting service UUID");
-    auto serviceUuid = toLowercase(std::get<std::string>(rawServiceUuid->second));
 
-    // Log("Casting characteristic UUID");
-    auto rawCharacteristicUuid = arguments.find(flutter::EncodableValue("characteristicUuid"));
-    if (rawCharacteristicUuid == arguments.end()) {
-      Log("Characteristic UUID not provided");
-      result->Success(flutter::EncodableValue());
+    if (!entry->supports(GattCharacteristicProperties::Read)) {
+      Log(LogLevel::Warning, "Characteristic does not support reading");
+      result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    // Log("Casting characteristic UUID");
-    auto characteristicUuid = toLowercase(std::get<std::string>(rawCharacteristicUuid->second));
 
-    if (servicesNotifying.find(characteristicUuid) != servicesNotifying.end()) {
-      Log("This characteristic " + characteristicUuid + " is notifying, so we can't read it");
-      result->Success(flutter::EncodableValue());
+    // The entry may go away while awaiting, keep the characteristic itself
+    auto characteristic = entry->Characteristic();
+    auto handle = entry->Handle();
+
+    std::vector<uint8_t> cached;
+    uint64_t ticket = 0;
+    auto start = connection->Reads().begin(handle, arguments.policy, [result](OperationEnd end, const std::vector<uint8_t> *value) {
+      if (end != OperationEnd::Completed)
+        answerAborted(*result, end);
+      else if (value == nullptr)
+        result->Success(flutter::EncodableValue());
+      else
+        result->Success(flutter::EncodableValue(*value));
+    }, cached, ticket);
+
+    if (start == ReadCoalescer::Start::Hit) {
+      stats.reads.cacheHits.fetch_add(1, std::memory_order_relaxed);
+      result->Success(flutter::EncodableValue(cached));
       co_return;
     }
 
-    // Log("Getting service from GATT " + serviceUuid);
-    auto serviceSearch = servicesAndCharacteristics.find(serviceUuid);
-    if (serviceSearch == servicesAndCharacteristics.end()) {
-      Log("Service " + serviceUuid + " not found");
-      result->Success(flutter::EncodableValue());
+    if (start == ReadCoalescer::Start::Joined) {
+      stats.reads.coalesced.fetch_add(1, std::memory_order_relaxed);
       co_return;
     }
 
-    auto service = serviceSearch->second;
+    // This read is shared, its timeout or cancellation answers every caller waiting for it
+    auto request = operationRequest(arguments, result, OperationPriority::Normal);
+    request.onAbort = [weakConnection = std::weak_ptr<BleConnection>(connection), handle, ticket](OperationEnd end) {
+      if (auto aborted = weakConnection.lock())
+        aborted->Reads().abort(handle, ticket, end);
+    };
 
-    auto characteristics = service.Characteristics();
-    // Log("Getting characteristic from service " + serviceUuid);
-    auto characteristicSearch = characteristics.find(characteristicUuid);
-    if (characteristicSearch == characteristics.end()) {
-      Log("Characteristic " + characteristicUuid + " not found in service " + serviceUuid);
-      result->Success(flutter::EncodableValue());
+    auto slot = co_await connection->Scheduler().acquire(std::move(request));
+    if (!slot)
       co_return;
-    }
-
-    auto characteristic = characteristicSearch->second.Characteristic();
 
-    auto properties = characteristic.CharacteristicProperties();
-    if ((properties & GattCharacteristicProperties::Read) != GattCharacteristicProperties::Read) {
-      Log("Characteristic does not support writing");
-      result->Success(flutter::EncodableValue(false));
+    if (connection->isClosed()) {
+      Log(LogLevel::Warning, "Device disconnected while the read was queued");
+      connection->Reads().complete(handle, ticket, nullptr);
       co_return;
     }
 
     try {
-      auto data = co_await characteristic.ReadValueAsync();
+      auto data = co_await characteristic.ReadValueAsync(BluetoothCacheMode::Uncached);
       if (data.Status() != GattCommunicationStatus::Success) {
-        Log("Failed to read characteristic value");
-        result->Success(flutter::EncodableValue());
+        Log(LogLevel::Error, "Failed to read characteristic value");
+        connection->Reads().complete(handle, ticket, nullptr);
         co_return;
       }
 
       auto value = IBufferToVector(data.Value());
-      result->Success(flutter::EncodableValue(value));
+      connection->Reads().complete(handle, ticket, &value);
     } catch (...) {
-      Log("Failed to read characteristic value");
-      result->Success(flutter::EncodableValue());
+      Log(LogLevel::Error, "Failed to read characteristic value");
+      connection->Reads().complete(handle, ticket, nullptr);
     }
   } // readCharacteristic
 
   /// @brief Write to the characteristic
-  /// @param method_call 
+  /// @param arguments
   /// @param result 
   /// @return 
-  winrt::fire_and_forget LayrzBlePlugin::writeCharacteristic(
-    const flutter::MethodCall<flutter::EncodableValue> &method_call,
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
-  ) {
-    if (connectedDevice == nullptr) {
-      Log("Not connected to a device");
+  winrt::fire_and_forget LayrzBlePlugin::writeCharacteristic(WriteArguments arguments, std::shared_ptr<OperationReply> result) {
+    auto connection = findConnection(arguments.macAddress);
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
+    auto device = connection->Device();
+    if (device == nullptr || device.ConnectionStatus() != BluetoothConnectionStatus::Connected) {
+      Log(LogLevel::Warning, "Device not connected");
+      if (auto closing = takeConnection(connection->Address())) {
+        closing->close();
+        notifyDeviceEvent(closing->MacAddress(), "DISCONNECTED");
+      }
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto connStatus = device->ConnectionStatus();
-    if (connStatus != BluetoothConnectionStatus::Connected) {
-      Log("Device not connected");
-      disconnect(method_call, std::move(result));
+    // Held for the whole call, the entry stays valid even if a new discovery replaces the table
+    auto gatt = connection->Gatt();
+    auto entry = resolveCharacteristic(*gatt, arguments, *result);
+    if (entry == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    // Log("Casting arguments");
-    auto arguments = std::get<flutter::EncodableMap>(*method_call.arguments());
-    // Log("Getting service UUID");
-    auto rawServiceUuid = arguments.find(flutter::EncodableValue("serviceUuid"));
-    if (rawServiceUuid == arguments.end()) {
-      Log("Service UUID not provided");
+    if (arguments.payload == nullptr) {
+      Log(LogLevel::Warning, "Payload not provided");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    // Log("Casting service UUID");
-    auto serviceUuid = toLowercase(std::get<std::string>(rawServiceUuid->second));
 
-    // Log("Casting characteristic UUID");
-    auto rawCharacteristicUuid = arguments.find(flutter::EncodableValue("characteristicUuid"));
-    if (rawCharacteristicUuid == arguments.end()) {
-      Log("Characteristic UUID not provided");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
-    // Log("Casting characteristic UUID");
-    auto characteristicUuid = toLowercase(std::get<std::string>(rawCharacteristicUuid->second));
+    bool withResponse = arguments.withResponse.value_or(false);
+    Log(LogLevel::Debug, "With response: {}", withResponse);
 
-    // Log("Getting payload");
-    auto rawPayload = arguments.find(flutter::EncodableValue("payload"));
-    if (rawPayload == arguments.end()) {
-      Log("Payload not provided");
+    if (!entry->supports(GattCharacteristicProperties::Write)) {
+      Log(LogLevel::Warning, "Characteristic does not support writing");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    auto payload = std::get<std::vector<uint8_t>>(rawPayload->second);
 
-    // Log("Getting withResponse");
-    auto rawWithResponse = arguments.find(flutter::EncodableValue("withResponse"));
-    bool withResponse = false;
-    if (rawWithResponse != arguments.end()) {
-      withResponse = std::get<bool>(rawWithResponse->second);
-    }
+    // The entry may go away while awaiting, keep what is needed from it
+    auto characteristic = entry->Characteristic();
+    auto handle = entry->Handle();
+    auto serviceUuid = entry->ServiceUuid();
+    auto characteristicUuid = entry->CharacteristicUuid();
 
-    Log("With response: " + std::to_string(withResponse));
+    // The only copy of the payload, the method call is gone once this coroutine suspends
+    auto payload = winrt::make<PayloadBuffer>(*arguments.payload);
 
-    // Log("Getting service from GATT " + serviceUuid);
-    auto serviceSearch = servicesAndCharacteristics.find(serviceUuid);
-    if (serviceSearch == servicesAndCharacteristics.end()) {
-      Log("Service " + serviceUuid + " not found");
-      result->Success(flutter::EncodableValue(false));
+    auto slot = co_await connection->Scheduler().acquire(operationRequest(arguments, result, OperationPriority::Control));
+    if (!slot)
       co_return;
-    }
 
-    auto service = serviceSearch->second;
-    auto characteristics = service.Characteristics();
-
-    auto characteristicsSearch = characteristics.find(characteristicUuid);
-    if (characteristicsSearch == characteristics.end()) {
-      Log("Characteristic " + characteristicUuid + " not found in service " + serviceUuid);
+    if (connection->isClosed()) {
+      Log(LogLevel::Warning, "Device disconnected while the write was queued");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto characteristic = characteristicsSearch->second.Characteristic();
-    auto properties = characteristic.CharacteristicProperties();
-    if ((properties & GattCharacteristicProperties::Write) != GattCharacteristicProperties::Write) {
-      Log("Characteristic does not support writing");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
+    // The cached value is stale whether or not the write succeeds
+    connection->Reads().invalidate(handle);
 
-    // Log("Writing to characteristic " + characteristicUuid + " from service " + serviceUuid);
+    // Log("Writing to characteristic " + characteristicUuid.toString() + " from service " + serviceUuid.toString());
     auto writeType = withResponse ? GattWriteOption::WriteWithResponse : GattWriteOption::WriteWithoutResponse;
     try {
-      auto status = co_await characteristic.WriteValueAsync(VectorToIBuffer(payload), writeType);
+      auto status = co_await characteristic.WriteValueAsync(payload, writeType);
       if (status != GattCommunicationStatus::Success) {
-        Log("Failed to write characteristic value");
+        Log(LogLevel::Error, "Failed to write characteristic value");
         result->Success(flutter::EncodableValue(false));
         co_return;
       }
 
-      Log("Successfully wrote to characteristic " + characteristicUuid + " from service " + serviceUuid);
+      Log(LogLevel::Debug, "Successfully wrote to characteristic {} from service {}", characteristicUuid.toString(), serviceUuid.toString());
       result->Success(flutter::EncodableValue(true));
       co_return;
     } catch (...) {
-      Log("Failed to write characteristic value");
+      Log(LogLevel::Error, "Failed to write characteristic value");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
   } // writeCharacteristic
 
-  /// @brief Start notifications for the characteristic
-  /// @param method_call 
-  /// @param result 
-  /// @return 
-  winrt::fire_and_forget LayrzBlePlugin::startNotify(
-    const flutter::MethodCall<flutter::EncodableValue> &method_call,
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
-  ) {
-    if (connectedDevice == nullptr) {
-      Log("Not connected to a device");
+  /// @brief Write a payload of any size to the characteristic, split in fragments of the negotiated ATT payload
+  /// size that are sent back to back. The progress is sent through onWriteProgress, the last event carries the
+  /// final status.
+  /// @param arguments
+  /// @param result
+  /// @return void
+  winrt::fire_and_forget LayrzBlePlugin::writeLongCharacteristic(WriteArguments arguments, std::shared_ptr<OperationReply> result) {
+    auto connection = findConnection(arguments.macAddress);
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
+    // Held for the whole call, the entry stays valid even if a new discovery replaces the table
+    auto gatt = connection->Gatt();
+    auto entry = resolveCharacteristic(*gatt, arguments, *result);
+    if (entry == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    // Log("Casting arguments");
-    auto arguments = std::get<flutter::EncodableMap>(*method_call.arguments());
-    // Log("Getting service UUID");
-    auto rawServiceUuid = arguments.find(flutter::EncodableValue("serviceUuid"));
-    if (rawServiceUuid == arguments.end()) {
-      Log("Service UUID not provided");
+    if (arguments.payload == nullptr) {
+      Log(LogLevel::Warning, "Payload not provided");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    // Log("Casting service UUID");
-    auto serviceUuid = toLowercase(std::get<std::string>(rawServiceUuid->second));
 
-    // Log("Casting characteristic UUID");
-    auto rawCharacteristicUuid = arguments.find(flutter::EncodableValue("characteristicUuid"));
-    if (rawCharacteristicUuid == arguments.end()) {
-      Log("Characteristic UUID not provided");
+    bool withResponse = arguments.withResponse.value_or(true);
+
+    auto property = withResponse ? GattCharacteristicProperties::Write : GattCharacteristicProperties::WriteWithoutResponse;
+    if (!entry->supports(property)) {
+      Log(LogLevel::Warning, "Characteristic does not support writing {} response", withResponse ? "with" : "without");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    // Log("Casting characteristic UUID");
-    auto characteristicUuid = toLowercase(std::get<std::string>(rawCharacteristicUuid->second));
 
-    if (servicesNotifying.find(characteristicUuid) != servicesNotifying.end()) {
-      Log("Already subscribed to characteristic notifications");
-      result->Success(flutter::EncodableValue(true));
+    // Every fragment must fit in one ATT write, so it is at most the MTU minus the write header
+    uint32_t mtu = connection->Mtu();
+    size_t fragmentSize = mtu > kAttWriteHeaderSize ? mtu - kAttWriteHeaderSize : kDefaultAttMtu - kAttWriteHeaderSize;
+
+    if (auto requested = arguments.fragmentSize; requested && *requested > 0 && static_cast<size_t>(*requested) < fragmentSize)
+      fragmentSize = static_cast<size_t>(*requested);
+
+    auto characteristic = entry->Characteristic();
+    auto handle = entry->Handle();
+    auto serviceUuid = entry->ServiceUuid().toString();
+    auto characteristicUuid = entry->CharacteristicUuid().toString();
+    auto macAddress = connection->MacAddress();
+    auto total = arguments.payload->size();
+
+    // The only copy of the payload, the method call is gone once this coroutine suspends. Each fragment is
+    // a slice of it, moved once the write of the previous one is done
+    auto payload = winrt::make_self<PayloadBuffer>(*arguments.payload);
+    winrt::Windows::Storage::Streams::IBuffer fragment = payload.as<winrt::Windows::Storage::Streams::IBuffer>();
+
+    auto notifyProgress = [&](size_t written, bool done, bool success) {
+      if (eventsChannel == nullptr)
+        return;
+
+      flutter::EncodableMap response = {};
+      response[flutter::EncodableValue("macAddress")] = flutter::EncodableValue(macAddress);
+      response[flutter::EncodableValue("serviceUuid")] = flutter::EncodableValue(serviceUuid);
+      response[flutter::EncodableValue("characteristicUuid")] = flutter::EncodableValue(characteristicUuid);
+      response[flutter::EncodableValue("written")] = flutter::EncodableValue(static_cast<int64_t>(written));
+      response[flutter::EncodableValue("total")] = flutter::EncodableValue(static_cast<int64_t>(total));
+      response[flutter::EncodableValue("done")] = flutter::EncodableValue(done);
+      if (done)
+        response[flutter::EncodableValue("success")] = flutter::EncodableValue(success);
+
+      uiThreadHandler_.Post([this, response]() {
+        eventsChannel->InvokeMethod(
+          "onWriteProgress",
+          std::make_unique<flutter::EncodableValue>(response)
+        );
+      });
+    };
+
+    // The fragments are written as one operation, nothing else of the device is interleaved
+    auto slot = co_await connection->Scheduler().acquire(operationRequest(arguments, result, OperationPriority::Bulk));
+    if (!slot)
+      co_return;
+
+    if (connection->isClosed()) {
+      Log(LogLevel::Warning, "Device disconnected while the write was queued");
+      notifyProgress(0, true, false);
+      result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto serviceSearch = servicesAndCharacteristics.find(serviceUuid);
-    if (serviceSearch == servicesAndCharacteristics.end()) {
-      Log("Service " + serviceUuid + " not found");
+    connection->Reads().invalidate(handle);
+
+    auto writeType = withResponse ? GattWriteOption::WriteWithResponse : GattWriteOption::WriteWithoutResponse;
+    size_t written = 0;
+    size_t lastPercent = 0;
+    bool success = true;
+
+    Log(LogLevel::Debug, "Writing {} bytes in fragments of {} bytes", total, fragmentSize);
+    try {
+      do {
+        auto size = total - written < fragmentSize ? total - written : fragmentSize;
+        payload->slice(written, size);
+
+        auto status = co_await characteristic.WriteValueAsync(fragment, writeType);
+        if (status != GattCommunicationStatus::Success) {
+          Log(LogLevel::Error, "Failed to write fragment at offset {}", written);
+          success = false;
+          break;
+        }
+        written += size;
+
+        // The device may have disconnected while the fragment was written
+        if (written < total && connection->isClosed()) {
+          Log(LogLevel::Warning, "Device disconnected after {} of {} bytes", written, total);
+          success = false;
+          break;
+        }
+
+        // Progress is reported on every whole percent, not on every fragment
+        if (written < total && written * 100 / total != lastPercent) {
+          lastPercent = written * 100 / total;
+          notifyProgress(written, false, false);
+        }
+      } while (written < total);
+    } catch (...) {
+      Log(LogLevel::Error, "Failed to write characteristic value");
+      success = false;
+    }
+
+    notifyProgress(written, true, success);
+    result->Success(flutter::EncodableValue(success));
+    co_return;
+  } // writeLongCharacteristic
+
+  /// @brief Start notifications for the characteristic
+  /// @param arguments
+  /// @param result 
+  /// @return 
+  winrt::fire_and_forget LayrzBlePlugin::startNotify(NotifyArguments arguments, std::shared_ptr<OperationReply> result) {
+    auto connection = findConnection(arguments.macAddress);
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    auto service = serviceSearch->second;
-    auto characteristics = service.Characteristics();
 
-    auto characteristicsSearch = characteristics.find(characteristicUuid);
-    if (characteristicsSearch == characteristics.end()) {
-      Log("Characteristic " + characteristicUuid + " not found in service " + serviceUuid);
+    // Held for the whole call, the entry stays valid even if a new discovery replaces the table
+    auto gatt = connection->Gatt();
+    auto entry = resolveCharacteristic(*gatt, arguments, *result);
+    if (entry == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    auto characteristic = characteristicsSearch->second.Characteristic();
+    // Ring of the pending notifications, see NotifyBuffer
+    int64_t bufferCapacity = arguments.bufferCapacity.value_or(NotifySubscription::kDefaultBufferCapacity);
+    if (bufferCapacity <= 0)
+      bufferCapacity = NotifySubscription::kDefaultBufferCapacity;
+
+    bool notifying = false;
+    {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      notifying = entry->isNotifying();
+    }
+    if (notifying) {
+      Log(LogLevel::Debug, "Already subscribed to characteristic notifications");
+      result->Success(flutter::EncodableValue(true));
+      co_return;
+    }
 
-    auto properties = characteristic.CharacteristicProperties();
-    if ((properties & GattCharacteristicProperties::Notify) != GattCharacteristicProperties::Notify) {
+    if (!entry->supports(GattCharacteristicProperties::Notify)) {
       // Log("Characteristic does not support notifications");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    // Log("Subscribing to characteristic " + characteristicUuid + " from service " + serviceUuid);
+    // The device may disconnect while awaiting, the entry is looked up again by handle afterwards
+    auto handle = entry->Handle();
+    auto characteristic = entry->Characteristic();
+    auto serviceUuid = entry->ServiceUuid();
+    auto characteristicUuid = entry->CharacteristicUuid();
+
+    auto slot = co_await connection->Scheduler().acquire(operationRequest(arguments, result, OperationPriority::Control));
+    if (!slot)
+      co_return;
+
+    // A startNotify of the same characteristic may have run while this one was queued
+    {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      if (connection->isClosed()) {
+        result->Success(flutter::EncodableValue(false));
+        co_return;
+      }
+
+      if (auto queued = connection->LockedGatt().at(handle); queued != nullptr && queued->isNotifying()) {
+        result->Success(flutter::EncodableValue(true));
+        co_return;
+      }
+    }
+
+    // Log("Subscribing to characteristic " + characteristicUuid.toString() + " from service " + serviceUuid.toString());
     auto descriptor = GattClientCharacteristicConfigurationDescriptorValue::Notify;
 
     try {
@@ -1093,13 +2091,36 @@ namespace layrz_ble {
         co_return;
       }
 
-      servicesNotifying[characteristicUuid] = {0};
-      characteristic.ValueChanged(servicesNotifying[characteristicUuid]);
-      auto token = characteristic.ValueChanged({this, &LayrzBlePlugin::onCharacteristicValueChanged});
-      servicesNotifying[characteristicUuid] = token;
-      Log("Successfully subscribed to characteristic " + characteristicUuid + " from service " + serviceUuid);
+      auto subscription = std::make_shared<NotifySubscription>(
+        connection->Address(),
+        connection->MacAddress(),
+        serviceUuid,
+        characteristicUuid,
+        arguments.packed,
+        static_cast<size_t>(bufferCapacity),
+        arguments.overflow
+      );
+      auto token = characteristic.ValueChanged([this, subscription](GattCharacteristic const &, GattValueChangedEventArgs const &args) {
+        onCharacteristicValueChanged(subscription, args);
+      });
+      // Checked and stored under one lock, so a close() either sees the token and revokes it, or runs first
+      std::unique_lock<std::mutex> lock(connection->Mutex());
+      auto current = connection->LockedGatt().at(handle);
+      if (current == nullptr || current->Characteristic() != characteristic || connection->isClosed()) {
+        lock.unlock();
+        Log(LogLevel::Warning, "Device disconnected while subscribing to characteristic {}", characteristicUuid.toString());
+        characteristic.ValueChanged(token);
+        result->Success(flutter::EncodableValue(false));
+        co_return;
+      }
+
+      current->setNotifyToken(token, subscription);
+      lock.unlock();
+      // Notified values are not cached, the last read value is stale once notifications start
+      connection->Reads().invalidate(handle);
+      Log(LogLevel::Info, "Successfully subscribed to characteristic {} from service {}", characteristicUuid.toString(), serviceUuid.toString());
     } catch (...) {
-      Log("Failed to subscribe to characteristic notifications");
+      Log(LogLevel::Error, "Failed to subscribe to characteristic notifications");
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
@@ -1109,97 +2130,98 @@ namespace layrz_ble {
   } // startNotify
 
   /// @brief Stop notifications for the characteristic
-  /// @param method_call 
+  /// @param arguments
   /// @param result 
   /// @return 
-  winrt::fire_and_forget LayrzBlePlugin::stopNotify(
-    const flutter::MethodCall<flutter::EncodableValue> &method_call,
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue> > result
-  ) {
-    if (connectedDevice == nullptr) {
-      Log("Not connected to a device");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
-
-    auto device = connectedDevice.get()->Device();
-    if (!device) {
-      Log("Device not found");
+  winrt::fire_and_forget LayrzBlePlugin::stopNotify(GattCallArguments arguments, std::shared_ptr<OperationReply> result) {
+    auto connection = findConnection(arguments.macAddress);
+    if (connection == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
 
-    // Log("Casting arguments");
-    auto arguments = std::get<flutter::EncodableMap>(*method_call.arguments());
-    // Log("Getting service UUID");
-    auto rawServiceUuid = arguments.find(flutter::EncodableValue("serviceUuid"));
-    if (rawServiceUuid == arguments.end()) {
-      Log("Service UUID not provided");
+    // Held for the whole call, the entry stays valid even if a new discovery replaces the table
+    auto gatt = connection->Gatt();
+    auto entry = resolveCharacteristic(*gatt, arguments, *result);
+    if (entry == nullptr) {
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
-    // Log("Casting service UUID");
-    auto serviceUuid = toLowercase(std::get<std::string>(rawServiceUuid->second));
 
-    // Log("Casting characteristic UUID");
-    auto rawCharacteristicUuid = arguments.find(flutter::EncodableValue("characteristicUuid"));
-    if (rawCharacteristicUuid == arguments.end()) {
-      Log("Characteristic UUID not provided");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
+    bool notifying = false;
+    {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      notifying = entry->isNotifying();
     }
-    // Log("Casting characteristic UUID");
-    auto characteristicUuid = toLowercase(std::get<std::string>(rawCharacteristicUuid->second));
-
-    if (servicesNotifying.find(characteristicUuid) == servicesNotifying.end()) {
-      Log("Already not subscribed to characteristic notifications");
+    if (!notifying) {
+      Log(LogLevel::Debug, "Already not subscribed to characteristic notifications");
       result->Success(flutter::EncodableValue(true));
       co_return;
     }
 
-    auto serviceSearch = servicesAndCharacteristics.find(serviceUuid);
-    if (serviceSearch == servicesAndCharacteristics.end()) {
-      Log("Service " + serviceUuid + " not found");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
-    }
-    auto service = serviceSearch->second;
-
-    auto characteristics = service.Characteristics();
+    // The device may disconnect while awaiting, the entry is looked up again by handle afterwards
+    auto handle = entry->Handle();
+    auto characteristic = entry->Characteristic();
+    auto serviceUuid = entry->ServiceUuid();
+    auto characteristicUuid = entry->CharacteristicUuid();
 
-    auto characteristicsSearch = characteristics.find(characteristicUuid);
-    if (characteristicsSearch == characteristics.end()) {
-      Log("Characteristic " + characteristicUuid + " not found in service " + serviceUuid);
-      result->Success(flutter::EncodableValue(false));
+    // Nothing is revoked before the slot is granted: a timed out or cancelled stopNotify leaves the
+    // subscription as it was, so a retry still writes the descriptor
+    auto slot = co_await connection->Scheduler().acquire(operationRequest(arguments, result, OperationPriority::Control));
+    if (!slot)
       co_return;
-    }
 
-    auto characteristic = characteristicsSearch->second.Characteristic();
+    // A stopNotify of the same characteristic, or a disconnection, may have ended the subscription while queued
+    std::shared_ptr<NotifySubscription> subscription;
+    {
+      std::lock_guard<std::mutex> lock(connection->Mutex());
+      auto current = connection->LockedGatt().at(handle);
+      if (current == nullptr || current->Characteristic() != characteristic || !current->isNotifying()) {
+        result->Success(flutter::EncodableValue(true));
+        co_return;
+      }
 
-    auto properties = characteristic.CharacteristicProperties();
-    if ((properties & GattCharacteristicProperties::Notify) != GattCharacteristicProperties::Notify) {
-      // Log("Characteristic does not support notifications");
-      result->Success(flutter::EncodableValue(false));
-      co_return;
+      // Unsubscribe locally before writing the descriptor, so no notification is delivered after stopNotify
+      subscription = current->Subscription();
+      characteristic.ValueChanged(current->NotifyToken());
+      current->clearNotifyToken();
     }
 
-    // Log("Subscribing to characteristic " + characteristicUuid + " from service " + serviceUuid);
+    // The descriptor still enables notifications when its write fails, keep delivering them so that the
+    // characteristic is still reported as notifying and a retry unsubscribes again
+    auto resubscribe = [this, connection, handle, characteristic, subscription]() {
+      try {
+        // Nothing is restored on a closed connection, close() would not revoke it
+        std::lock_guard<std::mutex> lock(connection->Mutex());
+        auto restored = connection->LockedGatt().at(handle);
+        if (restored == nullptr || restored->Characteristic() != characteristic || restored->isNotifying() || connection->isClosed())
+          return;
+
+        auto token = characteristic.ValueChanged([this, subscription](GattCharacteristic const &, GattValueChangedEventArgs const &args) {
+          onCharacteristicValueChanged(subscription, args);
+        });
+        restored->setNotifyToken(token, subscription);
+      } catch (...) {
+        Log(LogLevel::Error, "Failed to restore the characteristic notifications");
+      }
+    };
+
+    // Log("Unsubscribing from characteristic " + characteristicUuid.toString() + " from service " + serviceUuid.toString());
     auto descriptor = GattClientCharacteristicConfigurationDescriptorValue::None;
 
     try {
       auto status = co_await characteristic.WriteClientCharacteristicConfigurationDescriptorAsync(descriptor);
       if (status != GattCommunicationStatus::Success) {
-        // Log("Failed to subscribe to characteristic notifications");
+        // Log("Failed to unsubscribe to characteristic notifications");
+        resubscribe();
         result->Success(flutter::EncodableValue(false));
         co_return;
       }
 
-      servicesNotifying[characteristicUuid] = {0};
-      characteristic.ValueChanged(servicesNotifying[characteristicUuid]);
-      servicesNotifying.erase(characteristicUuid);
-      Log("Successfully unsubscribed to characteristic " + characteristicUuid + " from service " + serviceUuid);
+      Log(LogLevel::Info, "Successfully unsubscribed to characteristic {} from service {}", characteristicUuid.toString(), serviceUuid.toString());
     } catch (...) {
-      Log("Failed to unsubscribe to characteristic notifications");
+      Log(LogLevel::Error, "Failed to unsubscribe to characteristic notifications");
+      resubscribe();
       result->Success(flutter::EncodableValue(false));
       co_return;
     }
@@ -1208,32 +2230,178 @@ namespace layrz_ble {
     co_return;
   } // stopNotify
 
-  /// @brief When the characteristic value changed
-  /// @param sender 
+  /// @brief Run a list of GATT operations with a single method call. Every operation goes through the same code
+  /// as its own method with its own result, and they are all submitted to the scheduler of their device at once,
+  /// so they run back to back, or in parallel up to the maxConcurrent of configureOperations. The batch is
+  /// answered with the list of the results, in the order of the operations, when the last one ends.
+  ///
+  /// The macAddress, timeout and operation arguments of the batch apply to the operations without their own.
+  /// Operations without their own priority keep the order of the list.
+  /// @param method_call
+  /// @param result
+  /// @return void
+  void LayrzBlePlugin::batch(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+  ) {
+    ArgumentMap arguments(method_call.arguments());
+    auto operations = arguments.get<flutter::EncodableList>(keys::kOperations);
+    if (operations == nullptr) {
+      if (arguments.isMap())
+        Log(LogLevel::Warning, "Operations not provided");
+      result->Success(flutter::EncodableValue(flutter::EncodableList()));
+      return;
+    }
+
+    if (operations->empty()) {
+      result->Success(flutter::EncodableValue(flutter::EncodableList()));
+      return;
+    }
+
+    // Only the macAddress, timeout and operation of the batch are inherited, with a normal priority by default
+    auto defaults = decodeGattCall(arguments);
+    defaults.hasOperation = true;
+    if (!defaults.priority)
+      defaults.priority = OperationPriority::Normal;
+
+    auto reply = std::make_shared<BatchReply>(std::move(result), operations->size());
+    for (size_t i = 0; i < operations->size(); ++i) {
+      ArgumentMap operation(&(*operations)[i]);
+      auto type = operation.get<std::string>(keys::kType);
+      if (type == nullptr) {
+        reply->Error(i, "INVALID_OPERATION", "The operation has no type");
+        continue;
+      }
+
+      auto operationReply = [&reply, i, this](GattOperationKind kind) {
+        return std::make_shared<OperationReply>(reply->Item(i), &stats.gatt(kind));
+      };
+
+      // The arguments of the operation win over the defaults of the batch. They point into the method call,
+      // which the operations only use until they are queued
+      if (*type == "READ") {
+        auto read = decodeRead(operation);
+        read.inherit(defaults);
+        readCharacteristic(std::move(read), operationReply(GattOperationKind::Read));
+      } else if (*type == "WRITE") {
+        auto write = decodeWrite(operation);
+        write.inherit(defaults);
+        writeCharacteristic(std::move(write), operationReply(GattOperationKind::Write));
+      } else if (*type == "START_NOTIFY") {
+        auto notify = decodeNotify(operation);
+        notify.inherit(defaults);
+        startNotify(std::move(notify), operationReply(GattOperationKind::StartNotify));
+      } else if (*type == "STOP_NOTIFY") {
+        auto call = decodeGattCall(operation);
+        call.inherit(defaults);
+        stopNotify(std::move(call), operationReply(GattOperationKind::StopNotify));
+      } else {
+        reply->Error(i, "INVALID_OPERATION", "Unknown operation type " + *type);
+      }
+    }
+  } // batch
+
+  /// @brief When the characteristic value changed. Runs for every notification, so it only encodes the value
+  /// behind the precomputed onNotify call (or packed header) of the subscription into its ring, and wakes
+  /// the UI thread only when the ring was idle. deliverNotifications sends them from the UI thread.
+  /// @param subscription
   /// @param args 
-  void LayrzBlePlugin::onCharacteristicValueChanged(GattCharacteristic sender, GattValueChangedEventArgs args) {
-    Log("Received characteristic value changed event");
-    auto characteristicUuid = toLowercase(GuidToString(sender.Uuid()));
-    Log("Characteristic UUID: " + characteristicUuid);
-    auto serviceUuid = toLowercase(GuidToString(sender.Service().Uuid()));
-    Log("Service UUID: " + serviceUuid);
-    auto value = IBufferToVector(args.CharacteristicValue());
-    Log("Data size: " + std::to_string(value.size()));
+  void LayrzBlePlugin::onCharacteristicValueChanged(
+    const std::shared_ptr<NotifySubscription> &subscription,
+    const GattValueChangedEventArgs &args
+  ) {
+    if (eventsChannel == nullptr)
+      return;
 
-    flutter::EncodableMap response = {};
-    response[flutter::EncodableValue("serviceUuid")] = flutter::EncodableValue(serviceUuid);
-    response[flutter::EncodableValue("characteristicUuid")] = flutter::EncodableValue(characteristicUuid);
-    response[flutter::EncodableValue("value")] = flutter::EncodableValue(value);
+    auto buffer = args.CharacteristicValue();
+    auto value = subscription->Packed()
+      ? subscription->Record(buffer.data(), buffer.Length())
+      : subscription->Message(buffer.data(), buffer.Length());
+    if (!subscription->Pending().push(std::move(value)))
+      return;
 
-    if (eventsChannel != nullptr) {
-      uiThreadHandler_.Post([this, response]() {
+    uiThreadHandler_.Post([this, subscription]() { deliverNotifications(subscription); });
+  } // onCharacteristicValueChanged
+
+  /// @brief Send every pending notification of a subscription to Dart, on the UI thread
+  /// @param subscription
+  void LayrzBlePlugin::deliverNotifications(const std::shared_ptr<NotifySubscription> &subscription) {
+    // Send takes the channel as a std::string, built once instead of per message
+    static const std::string eventsChannelName(kEventsChannelName);
+    subscription->Pending().drain([this, &subscription](std::vector<uint8_t> &&value) {
+      if (subscription->Packed()) {
         eventsChannel->InvokeMethod(
-          "onNotify",
-          std::make_unique<flutter::EncodableValue>(response)
+          "onNotifyPacked",
+          std::make_unique<flutter::EncodableValue>(std::move(value))
         );
-      });
+        return;
+      }
+
+      // Already an encoded onNotify call, sent as InvokeMethod would send it without a result handler
+      eventsMessenger->Send(eventsChannelName, value.data(), value.size());
+    });
+  } // deliverNotifications
+
+  /// @brief Add services and their characteristics to a table. The characteristics of up to
+  /// kMaxConcurrentDiscoveries services are discovered at once: operations are started ahead in a sliding
+  /// window and awaited in service order, so handles stay in discovery order
+  /// @param serviceList
+  /// @param cacheMode
+  /// @param table
+  /// @return IAsyncAction
+  IAsyncAction LayrzBlePlugin::discoverCharacteristics(
+    IVectorView<GattDeviceService> serviceList,
+    BluetoothCacheMode cacheMode,
+    std::shared_ptr<GattTable> table
+  ) {
+    std::vector<GattDeviceService> services(serviceList.Size(), nullptr);
+    serviceList.GetMany(0, services);
+
+    std::vector<IAsyncOperation<GattCharacteristicsResult>> pending;
+    pending.reserve(services.size());
+    for (size_t i = 0; i < services.size(); ++i) {
+      while (pending.size() < services.size() && pending.size() - i < kMaxConcurrentDiscoveries)
+        pending.push_back(services[pending.size()].GetCharacteristicsAsync(cacheMode));
+
+      auto serviceIndex = table->addService(services[i]);
+      auto characteristics = co_await pending[i];
+      pending[i] = nullptr;
+      if (characteristics.Status() != GattCommunicationStatus::Success) {
+        Log(LogLevel::Warning, "Failed to get the characteristics of service {}", GuidToString(services[i].Uuid()));
+        continue;
+      }
+
+      auto serviceUuid = GuidToUuid(services[i].Uuid());
+      for (auto characteristic : characteristics.Characteristics()) {
+        table->addCharacteristic(serviceIndex, characteristic);
+        auto characteristicUuid = GuidToUuid(characteristic.Uuid());
+        if (table->isAmbiguous(serviceUuid, characteristicUuid))
+          Log(LogLevel::Warning, "Characteristic {} appears more than once in service {}, it is only reachable by handle",
+            characteristicUuid.toString(), serviceUuid.toString());
+      }
     }
-  } // onCharacteristicValueChanged
+  } // discoverCharacteristics
+
+  /// @brief Read the Database Hash characteristic (0x2B2A) of the Generic Attribute service (0x1801)
+  /// @param device
+  /// @return IBuffer with the hash, nullptr when the device does not expose it
+  IAsyncOperation<winrt::Windows::Storage::Streams::IBuffer> LayrzBlePlugin::readDatabaseHash(BluetoothLEDevice device) {
+    auto services = co_await device.GetGattServicesForUuidAsync(UuidToGuid(Uuid::fromShort(0x1801)), BluetoothCacheMode::Uncached);
+    if (services.Status() != GattCommunicationStatus::Success || services.Services().Size() == 0)
+      co_return nullptr;
+
+    auto characteristics = co_await services.Services().GetAt(0).GetCharacteristicsForUuidAsync(
+      UuidToGuid(Uuid::fromShort(0x2B2A)),
+      BluetoothCacheMode::Uncached
+    );
+    if (characteristics.Status() != GattCommunicationStatus::Success || characteristics.Characteristics().Size() == 0)
+      co_return nullptr;
+
+    auto value = co_await characteristics.Characteristics().GetAt(0).ReadValueAsync(BluetoothCacheMode::Uncached);
+    if (value.Status() != GattCommunicationStatus::Success)
+      co_return nullptr;
+    co_return value.Value();
+  } // readDatabaseHash
 
   /// @brief When the connection status changed
   /// @param device 
@@ -1241,30 +2409,223 @@ namespace layrz_ble {
   void LayrzBlePlugin::onConnectionStatusChanged(BluetoothLEDevice device, IInspectable args) {
     auto status = device.ConnectionStatus();
     if (status == BluetoothConnectionStatus::Disconnected) {
-      connectedDevice = nullptr;
-      servicesNotifying.clear();
+      auto connection = takeConnection(device.BluetoothAddress());
+      if (connection == nullptr)
+        return;
 
-      if (eventsChannel != nullptr) {
-        uiThreadHandler_.Post([this]() {
-          eventsChannel->InvokeMethod(
-            "onEvent",
-            std::make_unique<flutter::EncodableValue>("DISCONNECTED")
-          );
-        });
-      }
+      connection->close();
+      notifyDeviceEvent(connection->MacAddress(), "DISCONNECTED");
     } else if (status == BluetoothConnectionStatus::Connected) {
-      if (eventsChannel != nullptr) {
-        uiThreadHandler_.Post([this]() {
-          eventsChannel->InvokeMethod(
-            "onEvent",
-            std::make_unique<flutter::EncodableValue>("CONNECTED")
-          );
-        });
-      }
+      char macAddress[18];
+      formatBluetoothAddress(device.BluetoothAddress(), macAddress);
+      notifyDeviceEvent(macAddress, "CONNECTED");
     }
   } // onConnectionStatusChanged
 
-  std::string LayrzBlePlugin::standarizeServiceUuid(std::string rawUuid) {
-    return rawUuid.substr(2,2) + rawUuid.substr(0,2);
-  }
+  /// @brief Send the new MTU of a device to Dart
+  /// @param macAddress
+  /// @param mtu
+  void LayrzBlePlugin::notifyMtuChanged(const std::string &macAddress, uint16_t mtu) {
+    Log(LogLevel::Info, "MTU of {} changed to {}", macAddress, mtu);
+    if (eventsChannel == nullptr)
+      return;
+
+    flutter::EncodableMap response = {};
+    response[flutter::EncodableValue("macAddress")] = flutter::EncodableValue(macAddress);
+    response[flutter::EncodableValue("mtu")] = flutter::EncodableValue(static_cast<int32_t>(mtu));
+    uiThreadHandler_.Post([this, response]() {
+      eventsChannel->InvokeMethod(
+        "onMtuChanged",
+        std::make_unique<flutter::EncodableValue>(response)
+      );
+    });
+  } // notifyMtuChanged
+
+  /// @brief Send the new status of the GATT session of a device to Dart
+  /// @param macAddress
+  /// @param active
+  /// @param error BluetoothError of the change
+  void LayrzBlePlugin::notifySessionStatus(const std::string &macAddress, bool active, BluetoothError error) {
+    Log(LogLevel::Info, "GATT session of {} is {}", macAddress, active ? "active" : "closed");
+    if (eventsChannel == nullptr)
+      return;
+
+    flutter::EncodableMap response = {};
+    response[flutter::EncodableValue("macAddress")] = flutter::EncodableValue(macAddress);
+    response[flutter::EncodableValue("active")] = flutter::EncodableValue(active);
+    response[flutter::EncodableValue("error")] = flutter::EncodableValue(static_cast<int32_t>(error));
+    uiThreadHandler_.Post([this, response]() {
+      eventsChannel->InvokeMethod(
+        "onSessionStatus",
+        std::make_unique<flutter::EncodableValue>(response)
+      );
+    });
+  } // notifySessionStatus
+
+  /// @brief Send a connection event of a device to Dart
+  /// @param macAddress
+  /// @param event CONNECTED or DISCONNECTED
+  void LayrzBlePlugin::notifyDeviceEvent(const std::string &macAddress, const char *event) {
+    if (eventsChannel == nullptr)
+      return;
+
+    flutter::EncodableMap response = {};
+    response[flutter::EncodableValue("event")] = flutter::EncodableValue(event);
+    response[flutter::EncodableValue("macAddress")] = flutter::EncodableValue(macAddress);
+    uiThreadHandler_.Post([this, response]() {
+      eventsChannel->InvokeMethod(
+        "onEvent",
+        std::make_unique<flutter::EncodableValue>(response)
+      );
+    });
+  } // notifyDeviceEvent
+
+  /// @brief Find the target device of a method call
+  /// @param arguments a map with an optional macAddress, or the address itself
+  /// @return std::shared_ptr<BleConnection>, nullptr when the device is not connected.
+  /// Without an address the last connected device is used, or the only one when it is gone.
+  std::shared_ptr<BleConnection> LayrzBlePlugin::findConnection(const flutter::EncodableValue *arguments) {
+    if (auto macAddress = arguments != nullptr ? std::get_if<std::string>(arguments) : nullptr)
+      return findConnection(macAddress);
+    return findConnection(ArgumentMap(arguments).get<std::string>(keys::kMacAddress));
+  } // findConnection
+
+  /// @brief Find the target device of a GATT call
+  /// @param macAddress nullptr for the last connected device, or the only one when it is gone
+  /// @return std::shared_ptr<BleConnection>, nullptr when the device is not connected
+  std::shared_ptr<BleConnection> LayrzBlePlugin::findConnection(const std::string *macAddress) {
+    uint64_t address = 0;
+    if (macAddress != nullptr && !parseBluetoothAddress(*macAddress, address)) {
+      Log(LogLevel::Warning, "Invalid MAC address {}", *macAddress);
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    auto it = connections.find(macAddress != nullptr ? address : lastConnectedAddress);
+    if (it != connections.end())
+      return it->second;
+    if (macAddress == nullptr && connections.size() == 1)
+      return connections.begin()->second;
+
+    Log(LogLevel::Warning, "Not connected to the device");
+    return nullptr;
+  } // findConnection
+
+  /// @brief Apply the operation settings to the scheduler of a new connection, and arm a timer for each deadline
+  /// @param connection
+  void LayrzBlePlugin::setupScheduler(const std::shared_ptr<BleConnection> &connection) {
+    auto &scheduler = connection->Scheduler();
+    scheduler.setStats(&stats.operations);
+    scheduler.setMaxConcurrent(maxConcurrentOperations);
+
+    std::weak_ptr<BleConnection> weakConnection = connection;
+    scheduler.setTimerHook([weakConnection](GattScheduler::Clock::time_point deadline) {
+      auto delay = deadline - GattScheduler::Clock::now();
+      if (delay < GattScheduler::Clock::duration::zero())
+        delay = GattScheduler::Clock::duration::zero();
+
+      // Rounded up, a timer that fires before the deadline would expire nothing
+      ThreadPoolTimer::CreateTimer(
+        [weakConnection](ThreadPoolTimer const&) {
+          if (auto current = weakConnection.lock())
+            current->Scheduler().expire(GattScheduler::Clock::now());
+        },
+        std::chrono::ceil<TimeSpan>(delay) + std::chrono::milliseconds(1)
+      );
+    });
+  } // setupScheduler
+
+  /// @brief Scheduling of a GATT operation, from its optional "timeout" (in seconds) and "operation" arguments
+  /// @param arguments
+  /// @param result answered with a TIMEOUT or CANCELLED error when the operation is aborted
+  /// @param priority used when the argument does not set one
+  /// @return GattScheduler::Request
+  GattScheduler::Request LayrzBlePlugin::operationRequest(
+    const GattCallArguments &arguments,
+    const std::shared_ptr<OperationReply> &result,
+    OperationPriority priority
+  ) {
+    GattScheduler::Request request;
+    request.priority = arguments.priority.value_or(priority);
+    if (arguments.tag)
+      request.tag = *arguments.tag;
+
+    int64_t timeout = arguments.timeoutMs.value_or(operationTimeoutMs);
+    if (timeout > 0)
+      request.deadline = GattScheduler::Clock::now() + std::chrono::milliseconds(timeout);
+
+    request.onAbort = [result](OperationEnd end) { answerAborted(*result, end); };
+    return request;
+  } // operationRequest
+
+  /// @brief Answer an operation that timed out or was cancelled
+  /// @param result
+  /// @param end
+  void LayrzBlePlugin::answerAborted(OperationReply &result, OperationEnd end) {
+    if (end == OperationEnd::TimedOut)
+      result.Error("TIMEOUT", "The GATT operation did not complete in time");
+    else
+      result.Error("CANCELLED", "The GATT operation was cancelled");
+  } // answerAborted
+
+  /// @brief Remove a device from the connection table
+  /// @param address
+  /// @return std::shared_ptr<BleConnection>, nullptr when the device was not connected
+  std::shared_ptr<BleConnection> LayrzBlePlugin::takeConnection(uint64_t address) {
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    auto it = connections.find(address);
+    if (it == connections.end())
+      return nullptr;
+
+    auto connection = std::move(it->second);
+    connections.erase(it);
+    return connection;
+  } // takeConnection
+
+  /// @brief Find the characteristic of a GATT call, by its handle or by its service and characteristic UUIDs
+  /// @param table characteristic table of the target device
+  /// @param arguments
+  /// @param result answered with SERVICES_CHANGED while the table is stale, the later answer of the caller is dropped
+  /// @return BleCharacteristic*, nullptr when not found
+  BleCharacteristic *LayrzBlePlugin::resolveCharacteristic(GattTable &table, const GattCallArguments &arguments, OperationReply &result) {
+    if (table.isStale()) {
+      Log(LogLevel::Warning, "The GATT services changed since the last discovery");
+      result.Error("SERVICES_CHANGED", "The GATT services of the device changed, call discoverServices again");
+      return nullptr;
+    }
+
+    if (arguments.handle) {
+      auto characteristic = table.at(*arguments.handle);
+      if (characteristic == nullptr)
+        Log(LogLevel::Warning, "Characteristic handle {} not found", *arguments.handle);
+      return characteristic;
+    }
+
+    if (!arguments.serviceUuid) {
+      Log(LogLevel::Warning, "Service UUID not provided or invalid");
+      return nullptr;
+    }
+
+    if (!arguments.characteristicUuid) {
+      Log(LogLevel::Warning, "Characteristic UUID not provided or invalid");
+      return nullptr;
+    }
+
+    auto characteristic = table.find(*arguments.serviceUuid, *arguments.characteristicUuid);
+    if (characteristic == nullptr && table.isAmbiguous(*arguments.serviceUuid, *arguments.characteristicUuid))
+      Log(
+        LogLevel::Warning,
+        "Characteristic {} appears more than once in service {}, use its handle",
+        arguments.characteristicUuid->toString(),
+        arguments.serviceUuid->toString()
+      );
+    else if (characteristic == nullptr)
+      Log(
+        LogLevel::Warning,
+        "Characteristic {} not found in service {}",
+        arguments.characteristicUuid->toString(),
+        arguments.serviceUuid->toString()
+      );
+    return characteristic;
+  } // resolveCharacteristic
 } // namespace layrz_ble
@@ -17,12 +17,39 @@
 #include <winrt/Windows.Devices.Bluetooth.h>
 #include <winrt/Windows.Devices.Bluetooth.Advertisement.h>
 #include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+#include <winrt/Windows.System.Threading.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include "gatt.h"
+#include "gatt_cache.h"
+#include "connection.h"
+#include "notify_subscription.h"
+#include "operation_reply.h"
+#include "method_arguments.h"
+#include "payload_buffer.h"
+#include "plugin_stats.h"
+#include "batch_reply.h"
+#include "packed_events.h"
 #include "utils.h"
 #include "scan_result.h"
+#include "scan_filter.h"
+#include "scan_backend.h"
+#include "simulated_advertiser.h"
+#include "scan_capture.h"
+#include "winrt_scan_backend.h"
+#include "bt_address.h"
+#include "scan_batcher.h"
+#include "periodic_timer.h"
+#include "scan_pipeline.h"
 #include "thread_handler.hpp"
 
 
@@ -36,6 +63,15 @@ namespace layrz_ble
   using namespace winrt::Windows::Devices::Bluetooth;
   using namespace winrt::Windows::Devices::Bluetooth::Advertisement;
   using namespace winrt::Windows::Devices::Bluetooth::GenericAttributeProfile;
+  using namespace winrt::Windows::System::Threading;
+
+  /// @brief Where the advertisements of the scan come from
+  enum class ScanSource {
+    Radio,
+    Simulation,
+    /// @brief A capture file played back
+    Replay,
+  };
 
   class LayrzBlePlugin : public flutter::Plugin
   {
@@ -63,30 +99,94 @@ namespace layrz_ble
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> discoverServicesChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> setMtuChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> writeCharacteristicChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> writeLongCharacteristicChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> readCharacteristicChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> startNotifyChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> stopNotifyChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> getStatsChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> resetStatsChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> setLogLevelChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> getNotifyStatsChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> configureOperationsChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> cancelOperationsChannel;
+      static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> batchChannel;
       static std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> eventsChannel;
-      static std::string filteredDeviceId;
+      /// @brief Messenger of eventsChannel, for the onNotify calls NotifySubscription encodes itself
+      static flutter::BinaryMessenger *eventsMessenger;
+      static constexpr const char *kEventsChannelName = "com.layrz.ble.events";
 
-      std::unordered_map<std::string, BleService> servicesAndCharacteristics{};
-      std::unordered_map<std::string, winrt::event_token> servicesNotifying{};
+      // GATT layouts of the devices connected before, stored in %LOCALAPPDATA%\layrz_ble
+      GattCache gattCache{};
 
       Radio btRadio{nullptr};
       DeviceWatcher btScanner{nullptr};
-      BluetoothLEAdvertisementWatcher leScanner{nullptr};
+      // Capture of every received advertisement, written from the threads of the backend
+      std::shared_ptr<ScanCaptureWriter> scanCapture;
+      // Source of the BLE advertisements: the WinRT watcher, the simulated advertisers or the replay of a
+      // capture file, as asked by startScan
+      std::unique_ptr<ScanBackend> scanBackend;
+      ScanSource scanSource = ScanSource::Radio;
       std::unordered_map<std::string, DeviceInformation> deviceWatcherDevices{};
-      std::unordered_map<std::string, BleScanResult> visibleDevices{};
+      // Scan filter, devices seen during the scan (capped and evicted by least recently seen) and suppression
+      // of unchanged scan results
+      ScanPipeline scanPipeline{&stats.scan};
+
+      PeriodicTimer deviceExpiryTimer{};
+
+      // onScanBatch mode
+      std::atomic<bool> scanBatching{false};
+      ScanBatcher<uint64_t, flutter::EncodableValue> scanBatcher{};
+      PeriodicTimer scanBatchTimer{};
+
+      // Scan results sent as packed records (onScanPacked / onScanBatchPacked) instead of maps
+      std::atomic<bool> scanPacked{false};
+
+      // Connected devices, keyed by address. GATT calls without a macAddress go to the last connected one
+      std::unordered_map<uint64_t, std::shared_ptr<BleConnection>> connections{};
+      std::unordered_set<uint64_t> pendingConnections{};
+      uint64_t lastConnectedAddress = 0;
+      std::mutex connectionsMutex;
 
-      static std::unique_ptr<BleScanResult> connectedDevice;
+      // GATT operation scheduling, applied to the scheduler of every connection
+      std::atomic<size_t> maxConcurrentOperations{1};
+      std::atomic<int64_t> operationTimeoutMs{kDefaultOperationTimeoutMs};
+
+      // Number of services whose characteristics are discovered at once while connecting
+      static constexpr size_t kMaxConcurrentDiscoveries = 4;
+
+      // ATT MTU before any exchange, and the ATT header of a write that the fragments leave room for
+      static constexpr uint16_t kDefaultAttMtu = 23;
+      static constexpr uint16_t kAttWriteHeaderSize = 3;
+      static constexpr int64_t kDefaultOperationTimeoutMs = 30000;
 
       winrt::fire_and_forget GetRadios();
 
+      // Counters and latency histograms of getStats, declared before the UI thread handler that records into them
+      PluginStats stats{};
+
       // Thread handling
       LayrzBlePluginUiThreadHandler uiThreadHandler_;
 
     private:
       void checkCapabilities(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+      void getStats(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+      void resetStats(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+      void setLogLevel(
+        const flutter::MethodCall<flutter::EncodableValue> &method_call,
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+      );
+      void getNotifyStats(
+        const flutter::MethodCall<flutter::EncodableValue> &method_call,
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+      );
+      void configureOperations(
+        const flutter::MethodCall<flutter::EncodableValue> &method_call,
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+      );
+      void cancelOperations(
+        const flutter::MethodCall<flutter::EncodableValue> &method_call,
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+      );
       void startScan(
         const flutter::MethodCall<flutter::EncodableValue> &method_call,
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
@@ -95,11 +195,28 @@ namespace layrz_ble
         const flutter::MethodCall<flutter::EncodableValue> &method_call,
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
       );
+      void configureScanFilter(const ArgumentMap &arguments);
+      void configureScanBatching(const ArgumentMap &arguments);
+      void stopScanBatching();
+      void flushScanBatch();
+      void configureDeviceTable(const ArgumentMap &arguments);
+      void configureScanSuppression(const ArgumentMap &arguments);
+      void stopDeviceExpiry();
+      void expireDevices(std::chrono::milliseconds ttl);
+      void notifyScanLost(const std::string &macAddress);
       void setupWatcher();
       void handleScanResult(DeviceInformation device);
-      void handleBleScanResult(BleScanResult& result);
+      void handleAdvertisement(const ReceivedAdvertisement &advertisement);
+      flutter::EncodableValue scanResultEvent(const BleScanResult &device, bool packed) const;
+      void sendScanEvent(uint64_t address, flutter::EncodableValue &&event, bool packed);
+      SimulationConfig simulationConfig(const ArgumentMap &simulation);
+      ReplayConfig replayConfig(const ArgumentMap &replay);
+      bool startScanBackend();
+      void stopScanBackend();
+      void configureScanCapture(const ArgumentMap &arguments);
+      void stopScanCapture();
+      std::vector<uint8_t> packScanResult(const BleScanResult& device) const;
 
-      //Pancho
       winrt::fire_and_forget connect(
         const flutter::MethodCall<flutter::EncodableValue> &method_call,
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
@@ -120,30 +237,49 @@ namespace layrz_ble
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
       );
 
-      winrt::fire_and_forget readCharacteristic(
-        const flutter::MethodCall<flutter::EncodableValue> &method_call,
-        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
-      );
+      winrt::fire_and_forget readCharacteristic(ReadArguments arguments, std::shared_ptr<OperationReply> result);
 
-      winrt::fire_and_forget writeCharacteristic(
-        const flutter::MethodCall<flutter::EncodableValue> &method_call,
-        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
-      );
+      winrt::fire_and_forget writeCharacteristic(WriteArguments arguments, std::shared_ptr<OperationReply> result);
+
+      winrt::fire_and_forget writeLongCharacteristic(WriteArguments arguments, std::shared_ptr<OperationReply> result);
+
+      winrt::fire_and_forget startNotify(NotifyArguments arguments, std::shared_ptr<OperationReply> result);
+
+      winrt::fire_and_forget stopNotify(GattCallArguments arguments, std::shared_ptr<OperationReply> result);
 
-      winrt::fire_and_forget startNotify(
+      void batch(
         const flutter::MethodCall<flutter::EncodableValue> &method_call,
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
       );
 
-      winrt::fire_and_forget stopNotify(
-        const flutter::MethodCall<flutter::EncodableValue> &method_call,
-        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result
+      IAsyncAction discoverCharacteristics(
+        IVectorView<GattDeviceService> serviceList,
+        BluetoothCacheMode cacheMode,
+        std::shared_ptr<GattTable> table
       );
+      IAsyncOperation<winrt::Windows::Storage::Streams::IBuffer> readDatabaseHash(BluetoothLEDevice device);
 
-      void onCharacteristicValueChanged(GattCharacteristic sender, GattValueChangedEventArgs args);
+      void onCharacteristicValueChanged(
+        const std::shared_ptr<NotifySubscription> &subscription,
+        const GattValueChangedEventArgs &args
+      );
+      void deliverNotifications(const std::shared_ptr<NotifySubscription> &subscription);
       void onConnectionStatusChanged(BluetoothLEDevice device, IInspectable args);
+      void notifyDeviceEvent(const std::string &macAddress, const char *event);
+      void notifyMtuChanged(const std::string &macAddress, uint16_t mtu);
+      void notifySessionStatus(const std::string &macAddress, bool active, BluetoothError error);
 
-      std::string standarizeServiceUuid(std::string uuid);
+      std::shared_ptr<BleConnection> findConnection(const flutter::EncodableValue *arguments);
+      std::shared_ptr<BleConnection> findConnection(const std::string *macAddress);
+      std::shared_ptr<BleConnection> takeConnection(uint64_t address);
+      void setupScheduler(const std::shared_ptr<BleConnection> &connection);
+      GattScheduler::Request operationRequest(
+        const GattCallArguments &arguments,
+        const std::shared_ptr<OperationReply> &result,
+        OperationPriority priority
+      );
+      static void answerAborted(OperationReply &result, OperationEnd end);
+      BleCharacteristic *resolveCharacteristic(GattTable &table, const GattCallArguments &arguments, OperationReply &result);
   }; // class LayrzBlePlugin
 } // namespace layrz_ble
 
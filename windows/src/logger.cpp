@@ -0,0 +1,181 @@
+#include "logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace layrz_ble {
+  std::atomic<LogLevel> Logger::level_{Logger::kDefaultLevel};
+
+  /// @brief Copy a text argument into the arena, truncated to the room left
+  /// @param value
+  void LogRecord::add(std::string_view value) {
+    if (argCount == kMaxArgs) return;
+    size_t size = value.size() < kTextSize - textSize ? value.size() : kTextSize - textSize;
+    std::memcpy(text + textSize, value.data(), size);
+
+    auto &arg = args[argCount++];
+    arg.kind = LogArg::Kind::Text;
+    arg.text.offset = textSize;
+    arg.text.size = static_cast<uint16_t>(size);
+    textSize = static_cast<uint16_t>(textSize + size);
+  } // add
+
+  void LogRecord::add(bool value) {
+    if (argCount == kMaxArgs) return;
+    auto &arg = args[argCount++];
+    arg.kind = LogArg::Kind::Bool;
+    arg.b = value;
+  } // add
+
+  void LogRecord::add(double value) {
+    if (argCount == kMaxArgs) return;
+    auto &arg = args[argCount++];
+    arg.kind = LogArg::Kind::Double;
+    arg.d = value;
+  } // add
+
+  void LogRecord::formatTo(std::string &out) const {
+    size_t next = 0;
+    for (const char *cursor = format; *cursor != '\0'; ++cursor) {
+      if (cursor[0] != '{' || cursor[1] != '}' || next == argCount) {
+        out.push_back(*cursor);
+        continue;
+      }
+
+      const auto &arg = args[next++];
+      char number[32];
+      switch (arg.kind) {
+        case LogArg::Kind::Signed:
+          out.append(number, std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i)));
+          break;
+        case LogArg::Kind::Unsigned:
+          out.append(number, std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u)));
+          break;
+        case LogArg::Kind::Double:
+          out.append(number, std::snprintf(number, sizeof(number), "%g", arg.d));
+          break;
+        case LogArg::Kind::Bool:
+          out.append(arg.b ? "true" : "false");
+          break;
+        case LogArg::Kind::Text:
+          out.append(text + arg.text.offset, arg.text.size);
+          break;
+      }
+      ++cursor;
+    }
+  } // formatTo
+
+  Logger &Logger::instance() {
+    static Logger logger;
+    return logger;
+  } // instance
+
+  Logger::Logger() : startedAt_(std::chrono::steady_clock::now()) {}
+
+  Logger::~Logger() { stop(); }
+
+  void Logger::setSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    sink_ = std::move(sink);
+  } // setSink
+
+  /// @brief Start the thread that writes the records
+  void Logger::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable()) return;
+    stopping_ = false;
+    thread_ = std::thread(&Logger::run, this);
+  } // start
+
+  /// @brief Stop the thread, once every pending record is written
+  void Logger::stop() {
+    std::thread thread;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      thread = std::move(thread_);
+    }
+    wake_.notify_all();
+    if (thread.joinable()) thread.join();
+    drain();
+  } // stop
+
+  /// @brief Queue a record, never blocking. Dropped when the ring is full
+  /// @param record
+  void Logger::push(LogRecord &record) {
+    if (!ring_.tryPush(record)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (record.level >= LogLevel::Error) wake_.notify_one();
+  } // push
+
+  void Logger::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    std::string line;
+    LogRecord record;
+    bool wrote = false;
+    while (ring_.tryPop(record)) {
+      write(record, line);
+      wrote = true;
+    }
+    if (wrote && !sink_) std::fflush(stdout);
+  } // drain
+
+  void Logger::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      wake_.wait_for(lock, kDrainInterval);
+      lock.unlock();
+      drain();
+      lock.lock();
+    }
+  } // run
+
+  /// @brief Format a record and hand it to the sink
+  /// @param record
+  /// @param line reused buffer
+  void Logger::write(const LogRecord &record, std::string &line) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(record.at - startedAt_).count();
+    char prefix[64];
+    int size = std::snprintf(prefix, sizeof(prefix), "LayrzBlePlugin/Windows: [%10.6f] %s ",
+      static_cast<double>(us) / 1e6, levelName(record.level));
+
+    line.assign(prefix, size > 0 ? static_cast<size_t>(size) : 0);
+    record.formatTo(line);
+
+    if (sink_) {
+      sink_(record.level, line);
+    } else {
+      line.push_back('\n');
+      std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+  } // write
+
+  const char *Logger::levelName(LogLevel level) {
+    switch (level) {
+      case LogLevel::Trace: return "TRACE";
+      case LogLevel::Debug: return "DEBUG";
+      case LogLevel::Info: return "INFO";
+      case LogLevel::Warning: return "WARNING";
+      case LogLevel::Error: return "ERROR";
+      case LogLevel::Off: return "OFF";
+    }
+    return "INFO";
+  } // levelName
+
+  /// @brief Parse the name of a level, as given by levelName
+  /// @param name
+  /// @param level
+  /// @return false if the name is unknown, level is then unchanged
+  bool Logger::parseLevel(std::string_view name, LogLevel &level) {
+    for (auto candidate : {LogLevel::Trace, LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error, LogLevel::Off}) {
+      if (name == levelName(candidate)) {
+        level = candidate;
+        return true;
+      }
+    }
+    return false;
+  } // parseLevel
+} // namespace layrz_ble
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include "mpsc_queue.hpp"
+
+namespace layrz_ble {
+  enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4,
+    /// @brief Disables every level
+    Off = 5,
+  };
+
+  /// @brief Argument of a log record, copied by value so it can be formatted later on another thread
+  struct LogArg {
+    enum class Kind : uint8_t { Signed, Unsigned, Double, Bool, Text };
+
+    Kind kind = Kind::Signed;
+    union {
+      int64_t i;
+      uint64_t u;
+      double d;
+      bool b;
+      /// @brief Slice of the text arena of the record
+      struct {
+        uint16_t offset;
+        uint16_t size;
+      } text;
+    };
+
+    LogArg() : i(0) {}
+  }; // struct LogArg
+
+  /// @brief Unformatted log line: the format, its arguments and a copy of their text, in a fixed-size,
+  /// trivially copyable record that fits a slot of the ring
+  struct LogRecord {
+    static constexpr size_t kMaxArgs = 6;
+    static constexpr size_t kTextSize = 192;
+
+    LogLevel level = LogLevel::Info;
+    uint8_t argCount = 0;
+    uint16_t textSize = 0;
+    /// @brief String literal with a {} placeholder per argument, never copied
+    const char *format = nullptr;
+    std::chrono::steady_clock::time_point at;
+    LogArg args[kMaxArgs];
+    char text[kTextSize];
+
+    void add(std::string_view value);
+    void add(const std::string &value) { add(std::string_view(value)); }
+    void add(const char *value) { add(value != nullptr ? std::string_view(value) : std::string_view("(null)")); }
+    void add(bool value);
+    void add(double value);
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    void add(T value) {
+      if (argCount == kMaxArgs) return;
+      auto &arg = args[argCount++];
+      if constexpr (std::is_signed_v<T>) {
+        arg.kind = LogArg::Kind::Signed;
+        arg.i = static_cast<int64_t>(value);
+      } else {
+        arg.kind = LogArg::Kind::Unsigned;
+        arg.u = static_cast<uint64_t>(value);
+      }
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    void add(T value) { add(static_cast<double>(value)); }
+
+    /// @brief Replace each {} of the format by its argument
+    /// @param out
+    void formatTo(std::string &out) const;
+  }; // struct LogRecord
+
+  /// @brief Asynchronous leveled logger of the plugin.
+  ///
+  /// A disabled level costs one relaxed load. An enabled record is copied into a lock-free ring without
+  /// formatting it, and a background thread formats the pending records and writes them to the sink
+  /// with one flush per drain, so neither the WinRT callbacks nor the UI thread wait on the console.
+  /// Records pushed while the ring is full are dropped and counted. Records pushed before start() wait
+  /// in the ring, stop() writes every pending record before returning.
+  class Logger {
+    public:
+      static constexpr size_t kCapacity = 512;
+      /// @brief Longest time a record waits in the ring, errors are written right away
+      static constexpr std::chrono::milliseconds kDrainInterval{20};
+      static constexpr LogLevel kDefaultLevel = LogLevel::Info;
+
+      /// @brief Receives each formatted line, without its trailing new line, then a flush after each drain
+      using Sink = std::function<void(LogLevel level, std::string_view line)>;
+
+      static Logger &instance();
+
+      static bool enabled(LogLevel level) {
+        return level >= level_.load(std::memory_order_relaxed);
+      }
+
+      Logger(const Logger &) = delete;
+      Logger &operator=(const Logger &) = delete;
+      ~Logger();
+
+      static void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+      static LogLevel Level() { return level_.load(std::memory_order_relaxed); }
+
+      /// @brief Replace the sink, nullptr to write to the standard output. Not to be called while running
+      /// @param sink
+      void setSink(Sink sink);
+
+      void start();
+      void stop();
+      /// @brief Write the pending records on the calling thread
+      void drain();
+
+      void push(LogRecord &record);
+
+      uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+      static const char *levelName(LogLevel level);
+      static bool parseLevel(std::string_view name, LogLevel &level);
+
+    private:
+      Logger();
+
+      void run();
+      void write(const LogRecord &record, std::string &line);
+
+      // Static so that the check of a disabled level does not go through the guard of instance()
+      static std::atomic<LogLevel> level_;
+      MpscQueue<LogRecord, kCapacity> ring_;
+      std::atomic<uint64_t> dropped_{0};
+      std::chrono::steady_clock::time_point startedAt_;
+
+      std::mutex drainMutex_;
+      Sink sink_;
+
+      std::mutex mutex_;
+      std::condition_variable wake_;
+      bool stopping_ = false;
+      std::thread thread_;
+  }; // class Logger
+
+  /// @brief Log a line if its level is enabled, formatting it on the thread of the logger. The format
+  /// must be a string literal, with a {} placeholder for each argument (integers, floating points,
+  /// booleans and strings, copied at the call)
+  /// @param level
+  /// @param format
+  /// @param args
+  template <typename... Args>
+  inline void Log(LogLevel level, const char *format, const Args &...args) {
+    static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "Too many log arguments");
+    if (!Logger::enabled(level)) return;
+
+    LogRecord record;
+    record.level = level;
+    record.format = format;
+    record.at = std::chrono::steady_clock::now();
+    (record.add(args), ...);
+    Logger::instance().push(record);
+  }
+} // namespace layrz_ble
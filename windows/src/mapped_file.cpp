@@ -0,0 +1,200 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace layrz_ble {
+  MappedFile::~MappedFile() {
+    close();
+  }
+
+  MappedFile::MappedFile(MappedFile &&other) noexcept {
+    moveFrom(other);
+  }
+
+  MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      close();
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  void MappedFile::moveFrom(MappedFile &other) noexcept {
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    writable_ = std::exchange(other.writable_, false);
+    open_ = std::exchange(other.open_, false);
+#ifdef _WIN32
+    file_ = std::exchange(other.file_, nullptr);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+    fd_ = std::exchange(other.fd_, -1);
+#endif
+  }
+
+#ifdef _WIN32
+  /// @brief Map an existing file read-only
+  /// @param path
+  /// @return false if the file cannot be opened or mapped
+  bool MappedFile::openRead(const std::filesystem::path &path) {
+    close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    open_ = true;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      close();
+      return false;
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) return true;
+
+    mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+      close();
+      return false;
+    }
+
+    data_ = static_cast<uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+      close();
+      return false;
+    }
+    return true;
+  } // openRead
+
+  /// @brief Create (or truncate) a file of the given size and map it read-write
+  /// @param path
+  /// @param size must not be zero
+  /// @return false if the file cannot be created or mapped
+  bool MappedFile::create(const std::filesystem::path &path, size_t size) {
+    close();
+    if (size == 0) return false;
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    open_ = true;
+
+    LARGE_INTEGER length;
+    length.QuadPart = static_cast<LONGLONG>(size);
+    mapping_ = CreateFileMappingW(file, nullptr, PAGE_READWRITE, length.HighPart, length.LowPart, nullptr);
+    if (mapping_ == nullptr) {
+      close();
+      return false;
+    }
+
+    data_ = static_cast<uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, size));
+    if (data_ == nullptr) {
+      close();
+      return false;
+    }
+    size_ = size;
+    writable_ = true;
+    return true;
+  } // create
+
+  /// @brief Write the mapped pages back to the file
+  /// @return bool
+  bool MappedFile::flush() {
+    if (!writable_ || data_ == nullptr) return false;
+    return FlushViewOfFile(data_, size_) && FlushFileBuffers(static_cast<HANDLE>(file_));
+  } // flush
+
+  /// @brief Release the mapping and the file
+  void MappedFile::close() {
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mapping_ != nullptr) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_ != nullptr) CloseHandle(static_cast<HANDLE>(file_));
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+    writable_ = false;
+    open_ = false;
+  } // close
+#else
+  /// @brief Map an existing file read-only
+  /// @param path
+  /// @return false if the file cannot be opened or mapped
+  bool MappedFile::openRead(const std::filesystem::path &path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+    open_ = true;
+
+    struct stat info;
+    if (fstat(fd_, &info) != 0) {
+      close();
+      return false;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) return true;
+
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+    data_ = static_cast<uint8_t *>(data);
+    return true;
+  } // openRead
+
+  /// @brief Create (or truncate) a file of the given size and map it read-write
+  /// @param path
+  /// @param size must not be zero
+  /// @return false if the file cannot be created or mapped
+  bool MappedFile::create(const std::filesystem::path &path, size_t size) {
+    close();
+    if (size == 0) return false;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+    open_ = true;
+
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      close();
+      return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+    data_ = static_cast<uint8_t *>(data);
+    size_ = size;
+    writable_ = true;
+    return true;
+  } // create
+
+  /// @brief Write the mapped pages back to the file
+  /// @return bool
+  bool MappedFile::flush() {
+    if (!writable_ || data_ == nullptr) return false;
+    return msync(data_, size_, MS_SYNC) == 0;
+  } // flush
+
+  /// @brief Release the mapping and the file
+  void MappedFile::close() {
+    if (data_ != nullptr) munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+    writable_ = false;
+    open_ = false;
+  } // close
+#endif
+} // namespace layrz_ble
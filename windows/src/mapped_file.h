@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace layrz_ble {
+  /// @brief A whole file mapped in memory, either read-only or created read-write with a fixed size.
+  /// Move-only, the mapping is released when the object is destroyed.
+  class MappedFile {
+    public:
+      MappedFile() = default;
+      ~MappedFile();
+
+      MappedFile(MappedFile &&other) noexcept;
+      MappedFile &operator=(MappedFile &&other) noexcept;
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      bool openRead(const std::filesystem::path &path);
+      bool create(const std::filesystem::path &path, size_t size);
+      bool flush();
+      void close();
+
+      bool isOpen() const { return open_; }
+      const uint8_t *data() const { return data_; }
+      /// @brief Writable view of a file mapped by create(), nullptr for a read-only mapping
+      uint8_t *mutableData() { return writable_ ? data_ : nullptr; }
+      size_t size() const { return size_; }
+
+    private:
+      void moveFrom(MappedFile &other) noexcept;
+
+      uint8_t *data_ = nullptr;
+      size_t size_ = 0;
+      bool writable_ = false;
+      bool open_ = false;
+
+#ifdef _WIN32
+      void *file_ = nullptr;
+      void *mapping_ = nullptr;
+#else
+      int fd_ = -1;
+#endif
+  }; // class MappedFile
+} // namespace layrz_ble
@@ -0,0 +1,148 @@
+#include "method_arguments.h"
+
+namespace layrz_ble {
+  namespace {
+    std::optional<Uuid> uuidOf(const ArgumentMap &arguments, const flutter::EncodableValue &key) {
+      Uuid uuid;
+      auto str = arguments.get<std::string>(key);
+      if (str == nullptr || !Uuid::parse(*str, uuid))
+        return std::nullopt;
+      return uuid;
+    }
+
+    void decodeInto(const ArgumentMap &arguments, GattCallArguments &call) {
+      call.macAddress = arguments.get<std::string>(keys::kMacAddress);
+      call.handle = arguments.integer(keys::kHandle);
+      if (!call.handle) {
+        call.serviceUuid = uuidOf(arguments, keys::kServiceUuid);
+        call.characteristicUuid = uuidOf(arguments, keys::kCharacteristicUuid);
+      }
+
+      // The timeout is given in seconds
+      if (auto timeout = arguments.integer(keys::kTimeout))
+        call.timeoutMs = *timeout * 1000;
+
+      auto operation = arguments.map(keys::kOperation);
+      call.hasOperation = operation.isMap();
+      if (!call.hasOperation)
+        return;
+
+      if (auto name = operation.get<std::string>(keys::kPriority)) {
+        if (*name == "CONTROL") call.priority = OperationPriority::Control;
+        else if (*name == "NORMAL") call.priority = OperationPriority::Normal;
+        else if (*name == "BULK") call.priority = OperationPriority::Bulk;
+      }
+      call.tag = operation.integer(keys::kTag);
+    }
+  } // namespace
+
+  /// @brief Find a value of the map
+  /// @param key
+  /// @return const flutter::EncodableValue*, nullptr when missing or null
+  const flutter::EncodableValue *ArgumentMap::find(const flutter::EncodableValue &key) const {
+    if (map_ == nullptr)
+      return nullptr;
+
+    auto it = map_->find(key);
+    if (it == map_->end() || it->second.IsNull())
+      return nullptr;
+    return &it->second;
+  } // find
+
+  /// @brief Get an integer, the codec sends it as 32 or 64 bits depending on its value
+  /// @param key
+  /// @return std::optional<int64_t>
+  std::optional<int64_t> ArgumentMap::integer(const flutter::EncodableValue &key) const {
+    auto value = find(key);
+    if (value == nullptr)
+      return std::nullopt;
+    if (auto small = std::get_if<int32_t>(value))
+      return *small;
+    if (auto large = std::get_if<int64_t>(value))
+      return *large;
+    return std::nullopt;
+  } // integer
+
+  /// @brief Get a number, an integer is accepted too since a Dart num may hold either
+  /// @param key
+  /// @return std::optional<double>
+  std::optional<double> ArgumentMap::number(const flutter::EncodableValue &key) const {
+    if (auto value = get<double>(key))
+      return *value;
+    if (auto value = integer(key))
+      return static_cast<double>(*value);
+    return std::nullopt;
+  } // number
+
+  std::optional<bool> ArgumentMap::boolean(const flutter::EncodableValue &key) const {
+    auto value = get<bool>(key);
+    if (value == nullptr)
+      return std::nullopt;
+    return *value;
+  } // boolean
+
+  void GattCallArguments::inherit(const GattCallArguments &defaults) {
+    if (macAddress == nullptr)
+      macAddress = defaults.macAddress;
+    if (!timeoutMs)
+      timeoutMs = defaults.timeoutMs;
+    if (!hasOperation) {
+      hasOperation = defaults.hasOperation;
+      priority = defaults.priority;
+      tag = defaults.tag;
+    }
+  } // inherit
+
+  GattCallArguments decodeGattCall(const ArgumentMap &arguments) {
+    GattCallArguments call;
+    decodeInto(arguments, call);
+    return call;
+  } // decodeGattCall
+
+  /// @brief Decode a read, its freshness coming from the cacheMode (UNCACHED, CACHED or MAX_AGE) and maxAge
+  /// (ms) arguments, uncached when not provided
+  /// @param arguments
+  /// @return ReadArguments
+  ReadArguments decodeRead(const ArgumentMap &arguments) {
+    ReadArguments read;
+    decodeInto(arguments, read);
+
+    if (auto maxAge = arguments.integer(keys::kMaxAge)) {
+      read.policy.freshness = ReadFreshness::MaxAge;
+      read.policy.maxAge = std::chrono::milliseconds(*maxAge);
+    }
+
+    if (auto name = arguments.get<std::string>(keys::kCacheMode)) {
+      if (*name == "UNCACHED") read.policy.freshness = ReadFreshness::Uncached;
+      else if (*name == "CACHED") read.policy.freshness = ReadFreshness::Cached;
+      else if (*name == "MAX_AGE") read.policy.freshness = ReadFreshness::MaxAge;
+    }
+    return read;
+  } // decodeRead
+
+  WriteArguments decodeWrite(const ArgumentMap &arguments) {
+    WriteArguments write;
+    decodeInto(arguments, write);
+    write.payload = arguments.get<std::vector<uint8_t>>(keys::kPayload);
+    write.withResponse = arguments.boolean(keys::kWithResponse);
+    write.fragmentSize = arguments.integer(keys::kFragmentSize);
+    return write;
+  } // decodeWrite
+
+  /// @brief Decode a subscription, with the ring of its pending notifications, see NotifyBuffer
+  /// @param arguments
+  /// @return NotifyArguments
+  NotifyArguments decodeNotify(const ArgumentMap &arguments) {
+    NotifyArguments notify;
+    decodeInto(arguments, notify);
+    notify.packed = arguments.boolean(keys::kPacked).value_or(false);
+
+    auto buffer = arguments.map(keys::kBuffer);
+    notify.bufferCapacity = buffer.integer(keys::kCapacity);
+    if (auto name = buffer.get<std::string>(keys::kOverflow)) {
+      if (*name == "DROP_NEWEST") notify.overflow = NotifyOverflow::DropNewest;
+      else if (*name == "COALESCE_LATEST") notify.overflow = NotifyOverflow::CoalesceLatest;
+    }
+    return notify;
+  } // decodeNotify
+} // namespace layrz_ble
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <flutter/encodable_value.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gatt_scheduler.h"
+#include "notify_buffer.hpp"
+#include "read_coalescer.h"
+#include "uuid.h"
+
+namespace layrz_ble {
+  /// @brief Keys of the method arguments, built once instead of on every lookup
+  namespace keys {
+    inline const flutter::EncodableValue kMacAddress{"macAddress"};
+    inline const flutter::EncodableValue kHandle{"handle"};
+    inline const flutter::EncodableValue kServiceUuid{"serviceUuid"};
+    inline const flutter::EncodableValue kCharacteristicUuid{"characteristicUuid"};
+    inline const flutter::EncodableValue kTimeout{"timeout"};
+    inline const flutter::EncodableValue kOperation{"operation"};
+    inline const flutter::EncodableValue kOperations{"operations"};
+    inline const flutter::EncodableValue kPriority{"priority"};
+    inline const flutter::EncodableValue kTag{"tag"};
+    inline const flutter::EncodableValue kType{"type"};
+    inline const flutter::EncodableValue kCacheMode{"cacheMode"};
+    inline const flutter::EncodableValue kMaxAge{"maxAge"};
+    inline const flutter::EncodableValue kPayload{"payload"};
+    inline const flutter::EncodableValue kWithResponse{"withResponse"};
+    inline const flutter::EncodableValue kFragmentSize{"fragmentSize"};
+    inline const flutter::EncodableValue kPacked{"packed"};
+    inline const flutter::EncodableValue kBuffer{"buffer"};
+    inline const flutter::EncodableValue kCapacity{"capacity"};
+    inline const flutter::EncodableValue kOverflow{"overflow"};
+  } // namespace keys
+
+  /// @brief Read-only view of the argument map of a method call, nothing is copied. A missing map reads as
+  /// empty, and a null value or a value of another type reads as missing.
+  class ArgumentMap {
+    public:
+      ArgumentMap() = default;
+      explicit ArgumentMap(const flutter::EncodableValue *arguments)
+        : map_(arguments != nullptr ? std::get_if<flutter::EncodableMap>(arguments) : nullptr) {}
+      explicit ArgumentMap(const flutter::EncodableMap *map) : map_(map) {}
+
+      bool isMap() const { return map_ != nullptr; }
+
+      const flutter::EncodableValue *find(const flutter::EncodableValue &key) const;
+
+      template <typename T>
+      const T *get(const flutter::EncodableValue &key) const {
+        auto value = find(key);
+        return value != nullptr ? std::get_if<T>(value) : nullptr;
+      }
+
+      std::optional<int64_t> integer(const flutter::EncodableValue &key) const;
+      std::optional<double> number(const flutter::EncodableValue &key) const;
+      std::optional<bool> boolean(const flutter::EncodableValue &key) const;
+
+      /// @brief Whether the key holds a value of none of the types. A missing or null value is not mistyped
+      /// @param key
+      /// @return bool
+      template <typename... T>
+      bool isMistyped(const flutter::EncodableValue &key) const {
+        auto value = find(key);
+        return value != nullptr && !(std::holds_alternative<T>(*value) || ...);
+      }
+      bool isMistypedInteger(const flutter::EncodableValue &key) const { return isMistyped<int32_t, int64_t>(key); }
+      bool isMistypedNumber(const flutter::EncodableValue &key) const { return isMistyped<double, int32_t, int64_t>(key); }
+      ArgumentMap map(const flutter::EncodableValue &key) const { return ArgumentMap(get<flutter::EncodableMap>(key)); }
+
+    private:
+      const flutter::EncodableMap *map_ = nullptr;
+  }; // class ArgumentMap
+
+  /// @brief Arguments shared by every GATT method: the target characteristic and the scheduling of the
+  /// operation, decoded once from the method call.
+  ///
+  /// macAddress and payload point into the method call, they are only valid until the handler first
+  /// suspends, everything else is held by value.
+  struct GattCallArguments {
+    /// @brief nullptr to target the last connected device
+    const std::string *macAddress = nullptr;
+    /// @brief Characteristic handle, used instead of the UUIDs when given
+    std::optional<int64_t> handle;
+    /// @brief Empty when missing or invalid
+    std::optional<Uuid> serviceUuid;
+    std::optional<Uuid> characteristicUuid;
+
+    std::optional<int64_t> timeoutMs;
+    /// @brief Whether an operation map was given, a batch only applies its own to the calls without one
+    bool hasOperation = false;
+    std::optional<OperationPriority> priority;
+    std::optional<int64_t> tag;
+
+    /// @brief Take the macAddress, timeout and operation of a batch where this call has none
+    /// @param defaults
+    void inherit(const GattCallArguments &defaults);
+  }; // struct GattCallArguments
+
+  struct ReadArguments : GattCallArguments {
+    ReadPolicy policy;
+  }; // struct ReadArguments
+
+  struct WriteArguments : GattCallArguments {
+    /// @brief Bytes decoded by the codec, nullptr when missing
+    const std::vector<uint8_t> *payload = nullptr;
+    std::optional<bool> withResponse;
+    std::optional<int64_t> fragmentSize;
+  }; // struct WriteArguments
+
+  struct NotifyArguments : GattCallArguments {
+    bool packed = false;
+    std::optional<int64_t> bufferCapacity;
+    NotifyOverflow overflow = NotifyOverflow::DropOldest;
+  }; // struct NotifyArguments
+
+  GattCallArguments decodeGattCall(const ArgumentMap &arguments);
+  ReadArguments decodeRead(const ArgumentMap &arguments);
+  WriteArguments decodeWrite(const ArgumentMap &arguments);
+  NotifyArguments decodeNotify(const ArgumentMap &arguments);
+} // namespace layrz_ble
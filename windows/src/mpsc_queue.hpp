@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace layrz_ble {
+  /// @brief Move-only `void()` callable that stores small closures in place, and larger ones on the heap
+  template <size_t InlineSize>
+  class InplaceTask {
+    public:
+      InplaceTask() = default;
+
+      template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceTask>>>
+      InplaceTask(F &&func) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fitsInline<Fn>()) {
+          new (&storage_) Fn(std::forward<F>(func));
+          ops_ = &inlineOps<Fn>;
+        } else {
+          new (&storage_) Fn *(new Fn(std::forward<F>(func)));
+          ops_ = &heapOps<Fn>;
+        }
+      }
+
+      InplaceTask(InplaceTask &&other) noexcept { moveFrom(other); }
+
+      InplaceTask &operator=(InplaceTask &&other) noexcept {
+        if (this != &other) {
+          reset();
+          moveFrom(other);
+        }
+        return *this;
+      }
+
+      InplaceTask(const InplaceTask &) = delete;
+      InplaceTask &operator=(const InplaceTask &) = delete;
+
+      ~InplaceTask() { reset(); }
+
+      explicit operator bool() const { return ops_ != nullptr; }
+
+      void operator()() { ops_->invoke(&storage_); }
+
+      /// @brief Destroy the stored callable
+      void reset() {
+        if (ops_ != nullptr) {
+          ops_->destroy(&storage_);
+          ops_ = nullptr;
+        }
+      }
+
+    private:
+      struct Ops {
+        void (*invoke)(void *storage);
+        void (*move)(void *from, void *to);
+        void (*destroy)(void *storage);
+      };
+
+      template <typename Fn>
+      static constexpr bool fitsInline() {
+        return sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+          std::is_nothrow_move_constructible_v<Fn>;
+      }
+
+      template <typename Fn>
+      static constexpr Ops inlineOps = {
+        [](void *storage) { (*static_cast<Fn *>(storage))(); },
+        [](void *from, void *to) {
+          new (to) Fn(std::move(*static_cast<Fn *>(from)));
+          static_cast<Fn *>(from)->~Fn();
+        },
+        [](void *storage) { static_cast<Fn *>(storage)->~Fn(); },
+      };
+
+      template <typename Fn>
+      static constexpr Ops heapOps = {
+        [](void *storage) { (**static_cast<Fn **>(storage))(); },
+        [](void *from, void *to) { new (to) Fn *(*static_cast<Fn **>(from)); },
+        [](void *storage) { delete *static_cast<Fn **>(storage); },
+      };
+
+      void moveFrom(InplaceTask &other) noexcept {
+        if (other.ops_ != nullptr) {
+          other.ops_->move(&other.storage_, &storage_);
+          ops_ = other.ops_;
+          other.ops_ = nullptr;
+        }
+      }
+
+      std::aligned_storage_t<InlineSize, alignof(std::max_align_t)> storage_;
+      const Ops *ops_ = nullptr;
+  }; // class InplaceTask
+
+  /// @brief Bounded lock-free queue for many producers and a single consumer.
+  /// Each cell carries a sequence number that tells producers and the consumer whose turn it is
+  /// (Dmitry Vyukov's bounded queue), so a push is one CAS on the tail plus one release store.
+  template <typename T, size_t Capacity>
+  class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+      MpscQueue() {
+        for (size_t i = 0; i < Capacity; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+
+      ~MpscQueue() {
+        T value;
+        while (tryPop(value)) {}
+      }
+
+      MpscQueue(const MpscQueue &) = delete;
+      MpscQueue &operator=(const MpscQueue &) = delete;
+
+      /// @brief Push a value, safe to call from any thread
+      /// @param value moved from only when the push succeeds
+      /// @return false when the queue is full
+      bool tryPush(T &value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+          cell = &cells_[position & (Capacity - 1)];
+          size_t sequence = cell->sequence.load(std::memory_order_acquire);
+          intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+          if (diff == 0) {
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+          } else if (diff < 0) {
+            return false;
+          } else {
+            position = tail_.load(std::memory_order_relaxed);
+          }
+        }
+
+        new (&cell->storage) T(std::move(value));
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// @brief Pop a value, must only be called from the consumer thread
+      /// @param value
+      /// @return false when the queue is empty
+      bool tryPop(T &value) {
+        Cell &cell = cells_[head_ & (Capacity - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != head_ + 1) return false;
+
+        T *stored = std::launder(reinterpret_cast<T *>(&cell.storage));
+        value = std::move(*stored);
+        stored->~T();
+        cell.sequence.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return true;
+      }
+
+    private:
+      struct Cell {
+        std::atomic<size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+      };
+
+      Cell cells_[Capacity];
+      alignas(64) std::atomic<size_t> tail_{0};
+      alignas(64) size_t head_ = 0;
+  }; // class MpscQueue
+} // namespace layrz_ble
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace layrz_ble {
+  /// @brief What a full NotifyBuffer does with a new value
+  enum class NotifyOverflow {
+    /// @brief The oldest pending value is dropped to make room
+    DropOldest,
+    /// @brief The new value is dropped
+    DropNewest,
+    /// @brief The newest pending value is replaced, so the latest value is always delivered
+    CoalesceLatest,
+  };
+
+  /// @brief Fixed-capacity ring of the pending values of one notification subscription.
+  ///
+  /// The producer pushes from the WinRT callback thread and asks for a drain only when the ring goes
+  /// from idle to pending, so the UI thread queue holds at most one task per subscription however fast
+  /// the device notifies. Overload is bounded by the capacity and counted instead of growing memory.
+  template <typename T>
+  class NotifyBuffer {
+    public:
+      explicit NotifyBuffer(size_t capacity = 64, NotifyOverflow overflow = NotifyOverflow::DropOldest) :
+        slots_(capacity > 0 ? capacity : 1),
+        overflow_(overflow) {}
+
+      NotifyBuffer(const NotifyBuffer &) = delete;
+      NotifyBuffer &operator=(const NotifyBuffer &) = delete;
+
+      /// @brief Queue a value, applying the overflow policy when the ring is full
+      /// @param value
+      /// @return true when a drain must be scheduled
+      bool push(T &&value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == slots_.size()) {
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          switch (overflow_) {
+            case NotifyOverflow::DropNewest:
+              return false;
+            case NotifyOverflow::CoalesceLatest:
+              slots_[(head_ + size_ - 1) % slots_.size()] = std::move(value);
+              return false;
+            case NotifyOverflow::DropOldest:
+              slots_[head_] = T{};
+              head_ = (head_ + 1) % slots_.size();
+              --size_;
+              break;
+          }
+        }
+
+        slots_[(head_ + size_) % slots_.size()] = std::move(value);
+        ++size_;
+        if (size_ > peak_.load(std::memory_order_relaxed)) peak_.store(size_, std::memory_order_relaxed);
+
+        if (scheduled_) return false;
+        scheduled_ = true;
+        return true;
+      }
+
+      /// @brief Take every pending value and hand them to a callback, outside of the lock
+      /// @param deliver called with each value, oldest first
+      /// @return size_t number of delivered values
+      template <typename F>
+      size_t drain(F &&deliver) {
+        std::vector<T> batch;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          batch.reserve(size_);
+          for (; size_ > 0; --size_) {
+            batch.push_back(std::move(slots_[head_]));
+            slots_[head_] = T{};
+            head_ = (head_ + 1) % slots_.size();
+          }
+          head_ = 0;
+          scheduled_ = false;
+        }
+
+        for (auto &value : batch) deliver(std::move(value));
+        delivered_.fetch_add(batch.size(), std::memory_order_relaxed);
+        return batch.size();
+      }
+
+      size_t capacity() const { return slots_.size(); }
+      NotifyOverflow Overflow() const { return overflow_; }
+
+      uint64_t Delivered() const { return delivered_.load(std::memory_order_relaxed); }
+      uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+      /// @brief Largest number of values pending at once
+      size_t PeakDepth() const { return peak_.load(std::memory_order_relaxed); }
+
+    private:
+      std::mutex mutex_;
+      std::vector<T> slots_;
+      size_t head_ = 0;
+      size_t size_ = 0;
+      bool scheduled_ = false;
+      NotifyOverflow overflow_;
+
+      std::atomic<uint64_t> delivered_{0};
+      std::atomic<uint64_t> dropped_{0};
+      std::atomic<size_t> peak_{0};
+  }; // class NotifyBuffer
+} // namespace layrz_ble
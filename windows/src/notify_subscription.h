@@ -0,0 +1,121 @@
+#pragma once
+
+#include <flutter/encodable_value.h>
+#include <flutter/method_call.h>
+#include <flutter/standard_method_codec.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "notify_buffer.hpp"
+#include "packed_events.h"
+#include "uuid.h"
+
+namespace layrz_ble {
+  /// @brief What a notification of one subscription needs to reach Dart, computed once by startNotify.
+  ///
+  /// The onNotify call is encoded here once with an empty value. The value is the last entry of the map,
+  /// so the ValueChanged handler builds each message by appending the size and bytes of its value, and
+  /// the UI thread sends it as is. No map, string or EncodableValue is built per notification. A packed
+  /// subscription keeps the header of its onNotifyPacked records instead.
+  ///
+  /// Pending values wait in the bounded ring of the subscription until the UI thread drains them, so a
+  /// stalled UI thread drops notifications by the overflow policy instead of queueing them without bound.
+  class NotifySubscription {
+    public:
+      NotifySubscription(
+        uint64_t address,
+        const std::string& macAddress,
+        const Uuid& serviceUuid,
+        const Uuid& characteristicUuid,
+        bool packed = false,
+        size_t bufferCapacity = kDefaultBufferCapacity,
+        NotifyOverflow overflow = NotifyOverflow::DropOldest
+      ) :
+        macAddress_(macAddress),
+        serviceUuid_(serviceUuid),
+        characteristicUuid_(characteristicUuid),
+        packed_(packed),
+        pending_(bufferCapacity, overflow) {
+        if (packed_) {
+          header_ = packed::notifyHeader(address, serviceUuid, characteristicUuid);
+          return;
+        }
+
+        flutter::EncodableMap event;
+        event[flutter::EncodableValue("macAddress")] = flutter::EncodableValue(macAddress);
+        event[flutter::EncodableValue("serviceUuid")] = flutter::EncodableValue(serviceUuid.toString());
+        event[flutter::EncodableValue("characteristicUuid")] = flutter::EncodableValue(characteristicUuid.toString());
+        event[flutter::EncodableValue("value")] = flutter::EncodableValue(std::vector<uint8_t>());
+        flutter::MethodCall<flutter::EncodableValue> call(
+          "onNotify",
+          std::make_unique<flutter::EncodableValue>(std::move(event))
+        );
+
+        // "value" sorts last, the encoding ends with its empty Uint8List: a type byte and a size of 0
+        auto encoded = flutter::StandardMethodCodec::GetInstance().EncodeMethodCall(call);
+        message_.assign(encoded->begin(), encoded->end() - 1);
+      }
+
+      static constexpr size_t kDefaultBufferCapacity = 64;
+
+      const std::string& MacAddress() const { return macAddress_; }
+      const Uuid& ServiceUuid() const { return serviceUuid_; }
+      const Uuid& CharacteristicUuid() const { return characteristicUuid_; }
+      bool Packed() const { return packed_; }
+
+      /// @brief Encoded onNotify calls (or packed records) waiting for the UI thread
+      NotifyBuffer<std::vector<uint8_t>>& Pending() { return pending_; }
+      const NotifyBuffer<std::vector<uint8_t>>& Pending() const { return pending_; }
+
+      /// @brief Build the encoded onNotify method call of a value, ready for the messenger of the events channel
+      /// @param value
+      /// @param size
+      /// @return std::vector<uint8_t>
+      std::vector<uint8_t> Message(const uint8_t* value, size_t size) const {
+        std::vector<uint8_t> message;
+        message.reserve(message_.size() + 5 + size);
+        message.assign(message_.begin(), message_.end());
+
+        // Sizes of the standard codec: one byte below 254, else a marker and 2 or 4 bytes in host order
+        uint8_t bytes[4];
+        if (size < 254) {
+          message.push_back(static_cast<uint8_t>(size));
+        } else if (size <= 0xFFFF) {
+          auto small = static_cast<uint16_t>(size);
+          std::memcpy(bytes, &small, sizeof(small));
+          message.push_back(254);
+          message.insert(message.end(), bytes, bytes + sizeof(small));
+        } else {
+          auto large = static_cast<uint32_t>(size);
+          std::memcpy(bytes, &large, sizeof(large));
+          message.push_back(255);
+          message.insert(message.end(), bytes, bytes + sizeof(large));
+        }
+
+        message.insert(message.end(), value, value + size);
+        return message;
+      }
+
+      /// @brief Build the onNotifyPacked record of a value, straight from the notification buffer
+      /// @param value
+      /// @param size
+      /// @return std::vector<uint8_t>
+      std::vector<uint8_t> Record(const uint8_t* value, size_t size) const {
+        return packed::notifyRecord(header_, value, size);
+      }
+
+    private:
+      std::string macAddress_;
+      Uuid serviceUuid_{};
+      Uuid characteristicUuid_{};
+      bool packed_ = false;
+      NotifyBuffer<std::vector<uint8_t>> pending_;
+      /// @brief onNotify call of an empty value, without the size of the value
+      std::vector<uint8_t> message_;
+      std::vector<uint8_t> header_;
+  }; // class NotifySubscription
+} // namespace layrz_ble
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <flutter/encodable_value.h>
+#include <flutter/method_result.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "plugin_stats.h"
+
+namespace layrz_ble {
+  /// @brief Method result of a scheduled GATT operation, answered once.
+  ///
+  /// An operation that times out or is cancelled is answered by the scheduler while its coroutine may
+  /// still be awaiting WinRT, so both hold this reply and the first answer wins, the late one is dropped.
+  /// The first answer is also the one counted: its latency from the call and its status, a null or false
+  /// success being how the characteristic methods report a failure.
+  class OperationReply {
+    public:
+      using Clock = std::chrono::steady_clock;
+
+      explicit OperationReply(
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+        GattOperationStats *stats = nullptr
+      ) : result_(std::move(result)), stats_(stats), startedAt_(Clock::now()) {}
+
+      OperationReply(const OperationReply &) = delete;
+      OperationReply &operator=(const OperationReply &) = delete;
+
+      void Success(const flutter::EncodableValue &value = flutter::EncodableValue()) {
+        auto result = take();
+        if (!result) return;
+
+        auto flag = std::get_if<bool>(&value);
+        auto failed = value.IsNull() || (flag != nullptr && !*flag);
+        record(failed ? GattOperationStatus::Failed : GattOperationStatus::Succeeded);
+        result->Success(value);
+      }
+
+      void Error(const std::string &code, const std::string &message = "") {
+        auto result = take();
+        if (!result) return;
+
+        if (code == "TIMEOUT") record(GattOperationStatus::TimedOut);
+        else if (code == "CANCELLED") record(GattOperationStatus::Cancelled);
+        else record(GattOperationStatus::Failed);
+        result->Error(code, message);
+      }
+
+      bool Answered() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return result_ == nullptr;
+      }
+
+    private:
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::move(result_);
+      }
+
+      void record(GattOperationStatus status) {
+        if (stats_ == nullptr) return;
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startedAt_).count();
+        stats_->record(status, us > 0 ? static_cast<uint64_t>(us) : 0);
+      }
+
+      mutable std::mutex mutex_;
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result_;
+      GattOperationStats *stats_;
+      Clock::time_point startedAt_;
+  }; // class OperationReply
+} // namespace layrz_ble
@@ -0,0 +1,118 @@
+#include "packed_events.h"
+
+#include <cstring>
+
+namespace layrz_ble {
+  namespace packed {
+    namespace {
+      void put(uint8_t *out, uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+      }
+
+      void append(std::vector<uint8_t> &out, uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+      }
+
+      int16_t clampInt16(int64_t value) {
+        if (value < INT16_MIN) return INT16_MIN;
+        if (value > INT16_MAX) return INT16_MAX;
+        return static_cast<int16_t>(value);
+      }
+    } // namespace
+
+    /// @brief Start a scan record at the end of a buffer
+    /// @param out
+    /// @param address
+    /// @param rssi
+    /// @param txPower nullptr when the advertisement has none
+    /// @param name nullptr when the device has no name, truncated to 255 bytes
+    ScanRecordWriter::ScanRecordWriter(
+      std::vector<uint8_t> &out,
+      uint64_t address,
+      int64_t rssi,
+      const uint16_t *txPower,
+      const std::string_view *name
+    ) : out_(out), start_(out.size()) {
+      size_t nameSize = name != nullptr ? (name->size() > UINT8_MAX ? UINT8_MAX : name->size()) : 0;
+      uint8_t flags = (name != nullptr ? kHasName : 0) | (txPower != nullptr ? kHasTxPower : 0);
+
+      out_.resize(start_ + kScanHeaderSize);
+      uint8_t *header = out_.data() + start_;
+      put(header, 0, 2);
+      header[2] = kScanRecord;
+      header[3] = flags;
+      put(header + 4, address, 6);
+      put(header + 10, static_cast<uint16_t>(clampInt16(rssi)), 2);
+      put(header + 12, txPower != nullptr ? *txPower : 0, 2);
+      header[14] = static_cast<uint8_t>(nameSize);
+      header[15] = 0;
+      header[16] = 0;
+      header[17] = 0;
+
+      if (nameSize > 0) {
+        auto bytes = reinterpret_cast<const uint8_t *>(name->data());
+        out_.insert(out_.end(), bytes, bytes + nameSize);
+      }
+    } // ScanRecordWriter
+
+    /// @brief Check that a field still fits in the record
+    /// @param size
+    /// @return bool
+    bool ScanRecordWriter::fits(size_t size) const {
+      return out_.size() - start_ + size <= kMaxRecordSize;
+    } // fits
+
+    /// @brief Append one manufacturer data entry, left out when the record is full
+    /// @param companyId
+    /// @param data
+    /// @param size
+    void ScanRecordWriter::addManufacturerData(uint16_t companyId, const uint8_t *data, size_t size) {
+      if (manufacturerCount_ == UINT8_MAX || !fits(4 + size)) return;
+      append(out_, companyId, 2);
+      append(out_, size, 2);
+      out_.insert(out_.end(), data, data + size);
+      ++manufacturerCount_;
+    } // addManufacturerData
+
+    /// @brief Append one service data entry, left out when the record is full
+    /// @param uuid
+    /// @param data
+    /// @param size
+    void ScanRecordWriter::addServiceData(const Uuid &uuid, const uint8_t *data, size_t size) {
+      if (serviceDataCount_ == UINT8_MAX || !fits(sizeof(uuid.bytes) + 2 + size)) return;
+      out_.insert(out_.end(), uuid.bytes, uuid.bytes + sizeof(uuid.bytes));
+      append(out_, size, 2);
+      out_.insert(out_.end(), data, data + size);
+      ++serviceDataCount_;
+    } // addServiceData
+
+    /// @brief Write the size and the entry counts in the header
+    void ScanRecordWriter::finish() {
+      uint8_t *header = out_.data() + start_;
+      put(header, out_.size() - start_, 2);
+      header[15] = manufacturerCount_;
+      header[16] = serviceDataCount_;
+    } // finish
+
+    std::vector<uint8_t> notifyHeader(uint64_t address, const Uuid &serviceUuid, const Uuid &characteristicUuid) {
+      std::vector<uint8_t> header(kNotifyHeaderSize, 0);
+      header[2] = kNotifyRecord;
+      put(header.data() + 4, address, 6);
+      std::memcpy(header.data() + 10, serviceUuid.bytes, sizeof(serviceUuid.bytes));
+      std::memcpy(header.data() + 26, characteristicUuid.bytes, sizeof(characteristicUuid.bytes));
+      return header;
+    } // notifyHeader
+
+    std::vector<uint8_t> notifyRecord(const std::vector<uint8_t> &header, const uint8_t *value, size_t size) {
+      if (size > kMaxRecordSize - kNotifyHeaderSize) size = kMaxRecordSize - kNotifyHeaderSize;
+
+      std::vector<uint8_t> record;
+      record.reserve(kNotifyHeaderSize + size);
+      record.insert(record.end(), header.begin(), header.end());
+      record.insert(record.end(), value, value + size);
+      put(record.data(), record.size(), 2);
+      put(record.data() + kNotifyHeaderSize - 2, size, 2);
+      return record;
+    } // notifyRecord
+  } // namespace packed
+} // namespace layrz_ble
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "uuid.h"
+
+namespace layrz_ble {
+  /// @brief Binary form of the onScan and onNotify events, sent as a single Uint8List instead of a map.
+  ///
+  /// Records are self-delimiting, so a batch is just records written back to back. Every integer is
+  /// little-endian, UUIDs are the 16 bytes of Uuid::bytes and addresses are 48-bit:
+  ///
+  ///   scan      size u16 | kind u8 = 1 | flags u8 (bit 0: has name, bit 1: has txPower) | address u48
+  ///             | rssi i16 | txPower i16 | name length u8 | manufacturer count u8 | service data count u8
+  ///             | reserved u8 | name [name length]
+  ///             | manufacturer data (companyId u16 | length u16 | data) * manufacturer count
+  ///             | service data (uuid [16] | length u16 | data) * service data count
+  ///   notify    size u16 | kind u8 = 2 | reserved u8 | address u48 | service uuid [16]
+  ///             | characteristic uuid [16] | length u16 | value [length]
+  ///
+  /// size is the length of the whole record, header included.
+  namespace packed {
+    constexpr uint8_t kScanRecord = 1;
+    constexpr uint8_t kNotifyRecord = 2;
+
+    constexpr uint8_t kHasName = 0x01;
+    constexpr uint8_t kHasTxPower = 0x02;
+
+    constexpr size_t kScanHeaderSize = 18;
+    constexpr size_t kNotifyHeaderSize = 44;
+    constexpr size_t kMaxRecordSize = UINT16_MAX;
+
+    /// @brief Appends one scan record to a buffer. Fields that would overflow the record are left out,
+    /// so a record is always valid once finish() returns.
+    class ScanRecordWriter {
+      public:
+        ScanRecordWriter(
+          std::vector<uint8_t> &out,
+          uint64_t address,
+          int64_t rssi,
+          const uint16_t *txPower,
+          const std::string_view *name
+        );
+
+        void addManufacturerData(uint16_t companyId, const uint8_t *data, size_t size);
+        void addServiceData(const Uuid &uuid, const uint8_t *data, size_t size);
+        void finish();
+
+      private:
+        bool fits(size_t size) const;
+
+        std::vector<uint8_t> &out_;
+        size_t start_;
+        uint8_t manufacturerCount_ = 0;
+        uint8_t serviceDataCount_ = 0;
+    }; // class ScanRecordWriter
+
+    /// @brief Header of the notify records of one subscription, written once by startNotify
+    /// @param address
+    /// @param serviceUuid
+    /// @param characteristicUuid
+    /// @return std::vector<uint8_t> with the kNotifyHeaderSize bytes before the value, size and length left at 0
+    std::vector<uint8_t> notifyHeader(uint64_t address, const Uuid &serviceUuid, const Uuid &characteristicUuid);
+
+    /// @brief Build a notify record from its precomputed header
+    /// @param header
+    /// @param value
+    /// @param size truncated to fit in a record
+    /// @return std::vector<uint8_t>
+    std::vector<uint8_t> notifyRecord(const std::vector<uint8_t> &header, const uint8_t *value, size_t size);
+  } // namespace packed
+} // namespace layrz_ble
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <robuffer.h>
+#include <winrt/base.h>
+#include <winrt/Windows.Storage.Streams.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace layrz_ble {
+  /// @brief IBuffer over a slice of a payload owned by the plugin, handed to WinRT without copying it.
+  ///
+  /// A write copies its payload once out of the method call, which is gone when the handler first
+  /// suspends, and every write of it reads from that copy: the whole payload for writeCharacteristic, one
+  /// fragment after the other for writeLongCharacteristic. The slice may be moved with slice() once the
+  /// write reading it has completed.
+  struct PayloadBuffer : winrt::implements<
+    PayloadBuffer,
+    winrt::Windows::Storage::Streams::IBuffer,
+    ::Windows::Storage::Streams::IBufferByteAccess
+  > {
+    explicit PayloadBuffer(std::vector<uint8_t> bytes)
+      : bytes_(std::move(bytes)), capacity_(static_cast<uint32_t>(bytes_.size())), length_(capacity_) {}
+
+    /// @brief Point the buffer at another part of the payload, within its size
+    /// @param offset
+    /// @param length
+    void slice(size_t offset, size_t length) {
+      offset_ = offset;
+      capacity_ = static_cast<uint32_t>(length);
+      length_ = capacity_;
+    }
+
+    uint32_t Capacity() const { return capacity_; }
+    uint32_t Length() const { return length_; }
+
+    void Length(uint32_t value) {
+      if (value > capacity_)
+        throw winrt::hresult_invalid_argument();
+      length_ = value;
+    }
+
+    HRESULT __stdcall Buffer(uint8_t **value) final {
+      *value = bytes_.data() + offset_;
+      return S_OK;
+    }
+
+    private:
+      std::vector<uint8_t> bytes_;
+      size_t offset_ = 0;
+      uint32_t capacity_;
+      uint32_t length_;
+  }; // struct PayloadBuffer
+} // namespace layrz_ble
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.System.Threading.h>
+
+#include <future>
+#include <memory>
+#include <utility>
+
+namespace layrz_ble {
+  /// @brief Periodic thread pool timer whose cancel() waits for the callback in flight, so the callback
+  /// never runs against an object being torn down.
+  ///
+  /// ThreadPoolTimer::Cancel() only prevents the next ticks, a tick already running keeps going. The
+  /// destroyed handler of the timer runs once it is cancelled and its last tick returned, cancel()
+  /// waits for it.
+  class PeriodicTimer {
+    public:
+      PeriodicTimer() = default;
+      ~PeriodicTimer() { cancel(); }
+
+      PeriodicTimer(const PeriodicTimer &) = delete;
+      PeriodicTimer &operator=(const PeriodicTimer &) = delete;
+
+      /// @brief Call the callback every period, from the thread pool, replacing the running timer if any
+      /// @param callback
+      /// @param period
+      template <typename F>
+      void start(F &&callback, winrt::Windows::Foundation::TimeSpan period) {
+        using winrt::Windows::System::Threading::ThreadPoolTimer;
+        cancel();
+
+        auto destroyed = std::make_shared<std::promise<void>>();
+        destroyed_ = destroyed->get_future();
+        timer_ = ThreadPoolTimer::CreatePeriodicTimer(
+          [callback = std::forward<F>(callback)](ThreadPoolTimer const &) mutable { callback(); },
+          period,
+          [destroyed](ThreadPoolTimer const &) { destroyed->set_value(); }
+        );
+      }
+
+      bool running() const { return timer_ != nullptr; }
+
+      /// @brief Stop the timer and wait for the tick in flight to return. Must not be called from the callback
+      void cancel() {
+        if (timer_ == nullptr)
+          return;
+
+        timer_.Cancel();
+        timer_ = nullptr;
+        destroyed_.wait();
+      }
+
+    private:
+      winrt::Windows::System::Threading::ThreadPoolTimer timer_{nullptr};
+      std::future<void> destroyed_;
+  }; // class PeriodicTimer
+} // namespace layrz_ble
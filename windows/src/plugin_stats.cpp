@@ -0,0 +1,155 @@
+#include "plugin_stats.h"
+
+#include <string>
+
+namespace layrz_ble {
+  namespace {
+    void visitHistogram(const PluginStats::Visitor &visitor, const std::string &name, const LatencyHistogram &histogram) {
+      auto snapshot = histogram.snapshot();
+      visitor((name + "Count").c_str(), snapshot.count);
+      visitor((name + "MeanUs").c_str(), snapshot.meanUs());
+      visitor((name + "P50Us").c_str(), snapshot.p50Us);
+      visitor((name + "P90Us").c_str(), snapshot.p90Us);
+      visitor((name + "P99Us").c_str(), snapshot.p99Us);
+      visitor((name + "P999Us").c_str(), snapshot.p999Us);
+      visitor((name + "MaxUs").c_str(), snapshot.maxUs);
+    }
+
+    uint64_t load(const std::atomic<uint64_t> &value) { return value.load(std::memory_order_relaxed); }
+  } // namespace
+
+  void ScanStats::reset() {
+    received.store(0, std::memory_order_relaxed);
+    filtered.store(0, std::memory_order_relaxed);
+    emitted.store(0, std::memory_order_relaxed);
+    suppressed.store(0, std::memory_order_relaxed);
+    processingNs.store(0, std::memory_order_relaxed);
+    processing.reset();
+  } // reset
+
+  /// @brief Count a posted task and raise the peak depth
+  /// @param overflow whether the task went to the overflow list
+  void UiQueueStats::recordPost(bool overflow) {
+    uint64_t total = posted.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64_t done = executed.load(std::memory_order_relaxed);
+    uint64_t depth = total > done ? total - done : 0;
+    if (overflow) overflowed.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = maxDepth.load(std::memory_order_relaxed);
+    while (depth > current && !maxDepth.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+  } // recordPost
+
+  /// @brief Count a task run by the UI thread
+  /// @param waitUs time since its post
+  void UiQueueStats::recordRun(uint64_t waitUs) {
+    executed.fetch_add(1, std::memory_order_relaxed);
+    wait.record(waitUs);
+  } // recordRun
+
+  /// @brief Number of tasks posted and not run yet
+  /// @return uint64_t
+  uint64_t UiQueueStats::Depth() const {
+    uint64_t done = executed.load(std::memory_order_relaxed);
+    uint64_t total = posted.load(std::memory_order_relaxed);
+    return total > done ? total - done : 0;
+  } // Depth
+
+  /// @brief Clear the counters, the depth is kept as the tasks still queued will run
+  void UiQueueStats::reset() {
+    uint64_t depth = Depth();
+    executed.store(0, std::memory_order_relaxed);
+    posted.store(depth, std::memory_order_relaxed);
+    overflowed.store(0, std::memory_order_relaxed);
+    maxDepth.store(depth, std::memory_order_relaxed);
+    wait.reset();
+  } // reset
+
+  void ConnectStats::reset() {
+    attempts.store(0, std::memory_order_relaxed);
+    failed.store(0, std::memory_order_relaxed);
+    addressResolve.reset();
+    databaseHash.reset();
+    serviceEnumeration.reset();
+    characteristicEnumeration.reset();
+    total.reset();
+  } // reset
+
+  void GattOperationStats::record(GattOperationStatus status, uint64_t latencyUs) {
+    switch (status) {
+      case GattOperationStatus::Succeeded: succeeded.fetch_add(1, std::memory_order_relaxed); break;
+      case GattOperationStatus::Failed: failed.fetch_add(1, std::memory_order_relaxed); break;
+      case GattOperationStatus::TimedOut: timedOut.fetch_add(1, std::memory_order_relaxed); break;
+      case GattOperationStatus::Cancelled: cancelled.fetch_add(1, std::memory_order_relaxed); break;
+    }
+    latency.record(latencyUs);
+  } // record
+
+  void GattOperationStats::reset() {
+    succeeded.store(0, std::memory_order_relaxed);
+    failed.store(0, std::memory_order_relaxed);
+    timedOut.store(0, std::memory_order_relaxed);
+    cancelled.store(0, std::memory_order_relaxed);
+    latency.reset();
+  } // reset
+
+  void ReadStats::reset() {
+    cacheHits.store(0, std::memory_order_relaxed);
+    coalesced.store(0, std::memory_order_relaxed);
+  } // reset
+
+  /// @brief Report every counter and histogram
+  /// @param visitor
+  void PluginStats::visit(const Visitor &visitor) const {
+    visitor("scanAdvertisements", load(scan.received));
+    visitor("scanFiltered", load(scan.filtered));
+    visitor("scanEventsEmitted", load(scan.emitted));
+    visitor("scanEventsSuppressed", load(scan.suppressed));
+    visitor("scanProcessingUs", load(scan.processingNs) / 1000);
+    visitHistogram(visitor, "scanLatency", scan.processing);
+
+    visitor("uiPosted", load(ui.posted));
+    visitor("uiExecuted", load(ui.executed));
+    visitor("uiOverflowed", load(ui.overflowed));
+    visitor("uiDepth", ui.Depth());
+    visitor("uiMaxDepth", load(ui.maxDepth));
+    visitHistogram(visitor, "uiWait", ui.wait);
+
+    visitor("connectAttempts", load(connect.attempts));
+    visitor("connectFailed", load(connect.failed));
+    visitHistogram(visitor, "connectAddressResolve", connect.addressResolve);
+    visitHistogram(visitor, "connectDatabaseHash", connect.databaseHash);
+    visitHistogram(visitor, "connectServiceEnumeration", connect.serviceEnumeration);
+    visitHistogram(visitor, "connectCharacteristicEnumeration", connect.characteristicEnumeration);
+    visitHistogram(visitor, "connectTotal", connect.total);
+
+    static const char *kinds[kGattOperationKinds] = {"gattRead", "gattWrite", "gattWriteLong", "gattStartNotify", "gattStopNotify"};
+    for (size_t i = 0; i < kGattOperationKinds; ++i) {
+      std::string name = kinds[i];
+      visitor((name + "Succeeded").c_str(), load(gatt_[i].succeeded));
+      visitor((name + "Failed").c_str(), load(gatt_[i].failed));
+      visitor((name + "TimedOut").c_str(), load(gatt_[i].timedOut));
+      visitor((name + "Cancelled").c_str(), load(gatt_[i].cancelled));
+      visitHistogram(visitor, name + "Latency", gatt_[i].latency);
+    }
+
+    visitor("gattOperations", load(operations.completed));
+    visitor("gattOperationsTimedOut", load(operations.timedOut));
+    visitor("gattOperationsCancelled", load(operations.cancelled));
+    visitor("gattQueueWaitUs", load(operations.queueWaitUs));
+    visitor("gattQueueWaitMaxUs", load(operations.queueWaitMaxUs));
+    visitor("gattServiceUs", load(operations.serviceUs));
+    visitor("gattServiceMaxUs", load(operations.serviceMaxUs));
+
+    visitor("readCacheHits", load(reads.cacheHits));
+    visitor("readsCoalesced", load(reads.coalesced));
+  } // visit
+
+  void PluginStats::reset() {
+    scan.reset();
+    ui.reset();
+    connect.reset();
+    for (auto &gatt : gatt_) gatt.reset();
+    operations.reset();
+    reads.reset();
+  } // reset
+} // namespace layrz_ble
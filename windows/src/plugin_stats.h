@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+
+#include "latency_histogram.h"
+
+namespace layrz_ble {
+  /// @brief Advertisements through the scan pipeline
+  struct ScanStats {
+    std::atomic<uint64_t> received{0};
+    /// @brief Advertisements rejected by the scan filter
+    std::atomic<uint64_t> filtered{0};
+    /// @brief Scan results sent to Dart, and repeated ones suppressed, counted by the ChangeDetector
+    std::atomic<uint64_t> emitted{0};
+    std::atomic<uint64_t> suppressed{0};
+    std::atomic<uint64_t> processingNs{0};
+    /// @brief Time from the backend to the event sent or suppressed
+    LatencyHistogram processing;
+
+    void reset();
+  }; // struct ScanStats
+
+  /// @brief Tasks posted to the UI thread
+  struct UiQueueStats {
+    std::atomic<uint64_t> posted{0};
+    std::atomic<uint64_t> executed{0};
+    /// @brief Tasks that did not fit in the ring and went to the locked overflow list
+    std::atomic<uint64_t> overflowed{0};
+    std::atomic<uint64_t> maxDepth{0};
+    /// @brief Time between the post of a task and its execution
+    LatencyHistogram wait;
+
+    void recordPost(bool overflow);
+    void recordRun(uint64_t waitUs);
+    uint64_t Depth() const;
+    void reset();
+  }; // struct UiQueueStats
+
+  /// @brief Connections, and the time spent in each phase of the successful ones
+  struct ConnectStats {
+    std::atomic<uint64_t> attempts{0};
+    std::atomic<uint64_t> failed{0};
+    LatencyHistogram addressResolve;
+    LatencyHistogram databaseHash;
+    LatencyHistogram serviceEnumeration;
+    LatencyHistogram characteristicEnumeration;
+    LatencyHistogram total;
+
+    void reset();
+  }; // struct ConnectStats
+
+  enum class GattOperationKind : uint8_t {
+    Read,
+    Write,
+    WriteLong,
+    StartNotify,
+    StopNotify,
+  };
+
+  /// @brief How a GATT operation was answered
+  enum class GattOperationStatus : uint8_t {
+    Succeeded,
+    Failed,
+    TimedOut,
+    Cancelled,
+  };
+
+  /// @brief GATT operations of one kind, from the call to the answer
+  struct GattOperationStats {
+    std::atomic<uint64_t> succeeded{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> timedOut{0};
+    std::atomic<uint64_t> cancelled{0};
+    LatencyHistogram latency;
+
+    void record(GattOperationStatus status, uint64_t latencyUs);
+    void reset();
+  }; // struct GattOperationStats
+
+  /// @brief Counters of the GATT operations of every device, shared by the schedulers of all connections
+  struct SchedulerStats {
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> timedOut{0};
+    std::atomic<uint64_t> cancelled{0};
+    /// @brief Time between the submission of an operation and its start
+    std::atomic<uint64_t> queueWaitUs{0};
+    std::atomic<uint64_t> queueWaitMaxUs{0};
+    /// @brief Time between the start of an operation and its end
+    std::atomic<uint64_t> serviceUs{0};
+    std::atomic<uint64_t> serviceMaxUs{0};
+
+    void recordQueueWait(uint64_t us) {
+      queueWaitUs.fetch_add(us, std::memory_order_relaxed);
+      raise(queueWaitMaxUs, us);
+    }
+
+    void recordService(uint64_t us) {
+      serviceUs.fetch_add(us, std::memory_order_relaxed);
+      raise(serviceMaxUs, us);
+    }
+
+    void reset() {
+      for (auto *counter : {&completed, &timedOut, &cancelled, &queueWaitUs, &queueWaitMaxUs, &serviceUs, &serviceMaxUs})
+        counter->store(0, std::memory_order_relaxed);
+    }
+
+    private:
+      static void raise(std::atomic<uint64_t> &max, uint64_t value) {
+        uint64_t current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+      }
+  }; // struct SchedulerStats
+
+  /// @brief Reads answered by the ReadCoalescer of their device without reading it themselves
+  struct ReadStats {
+    /// @brief Reads answered from the value cached by the plugin
+    std::atomic<uint64_t> cacheHits{0};
+    /// @brief Reads that joined a read of the same characteristic already in flight
+    std::atomic<uint64_t> coalesced{0};
+
+    void reset();
+  }; // struct ReadStats
+
+  /// @brief Counters and latency histograms of the plugin, reported by getStats and cleared by resetStats.
+  ///
+  /// Every field is an atomic updated with relaxed increments by the thread doing the work, so recording
+  /// costs no lock. A report is not a consistent snapshot: counters recorded during it may be half seen.
+  class PluginStats {
+    public:
+      static constexpr size_t kGattOperationKinds = 5;
+
+      /// @brief Called with the name of every counter and its value, histograms being flattened into
+      /// <name>Count, <name>MeanUs, <name>P50Us, <name>P90Us, <name>P99Us, <name>P999Us and <name>MaxUs
+      using Visitor = std::function<void(const char *name, uint64_t value)>;
+
+      ScanStats scan;
+      UiQueueStats ui;
+      ConnectStats connect;
+      SchedulerStats operations;
+      ReadStats reads;
+
+      GattOperationStats &gatt(GattOperationKind kind) { return gatt_[static_cast<size_t>(kind)]; }
+
+      void visit(const Visitor &visitor) const;
+      void reset();
+
+    private:
+      GattOperationStats gatt_[kGattOperationKinds];
+  }; // class PluginStats
+} // namespace layrz_ble
@@ -0,0 +1,96 @@
+#include "read_coalescer.h"
+
+namespace layrz_ble {
+  /// @brief Start a read of a characteristic
+  /// @param handle
+  /// @param policy
+  /// @param waiter answers the read when it joins or leads, not kept on a hit
+  /// @param value receives the cached value on a hit
+  /// @param ticket receives the ticket of the read to lead
+  /// @return Start
+  ReadCoalescer::Start ReadCoalescer::begin(
+    int64_t handle,
+    const ReadPolicy &policy,
+    Waiter waiter,
+    Value &value,
+    uint64_t &ticket
+  ) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = entries_[handle];
+
+    if (entry.valid) {
+      bool fresh = policy.freshness == ReadFreshness::Cached ||
+        (policy.freshness == ReadFreshness::MaxAge && Clock::now() - entry.readAt <= policy.maxAge);
+      if (fresh) {
+        value = entry.value;
+        return Start::Hit;
+      }
+    }
+
+    entry.waiters.push_back(std::move(waiter));
+    if (entry.ticket != 0)
+      return Start::Joined;
+
+    entry.ticket = nextTicket_++;
+    entry.readGeneration = entry.generation;
+    ticket = entry.ticket;
+    return Start::Lead;
+  } // begin
+
+  /// @brief End a read led with a ticket, caching its value and answering its waiters
+  /// @param handle
+  /// @param ticket
+  /// @param value nullptr when the read failed, the cached value is kept
+  void ReadCoalescer::complete(int64_t handle, uint64_t ticket, const Value *value) {
+    auto waiters = take(handle, ticket, value);
+    for (auto &waiter : waiters) waiter(OperationEnd::Completed, value);
+  } // complete
+
+  /// @brief End a read led with a ticket that timed out or was cancelled, its late completion is ignored
+  /// @param handle
+  /// @param ticket
+  /// @param end
+  void ReadCoalescer::abort(int64_t handle, uint64_t ticket, OperationEnd end) {
+    auto waiters = take(handle, ticket, nullptr);
+    for (auto &waiter : waiters) waiter(end, nullptr);
+  } // abort
+
+  /// @brief Forget the cached value of a characteristic, after it was written. A read already in flight
+  /// may have read the value from before the write, it still answers its waiters but is not cached
+  /// @param handle
+  void ReadCoalescer::invalidate(int64_t handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(handle);
+    if (it != entries_.end()) {
+      it->second.valid = false;
+      it->second.value.clear();
+      ++it->second.generation;
+    }
+  } // invalidate
+
+  /// @brief Forget every cached value, the reads in flight are still answered but not cached
+  void ReadCoalescer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &entry : entries_) {
+      entry.second.valid = false;
+      entry.second.value.clear();
+      ++entry.second.generation;
+    }
+  } // clear
+
+  std::vector<ReadCoalescer::Waiter> ReadCoalescer::take(int64_t handle, uint64_t ticket, const Value *value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(handle);
+    if (it == entries_.end() || it->second.ticket != ticket)
+      return {};
+
+    auto &entry = it->second;
+    if (value != nullptr && entry.readGeneration == entry.generation) {
+      entry.value = *value;
+      entry.readAt = Clock::now();
+      entry.valid = true;
+    }
+    entry.ticket = 0;
+    return std::move(entry.waiters);
+  } // take
+} // namespace layrz_ble
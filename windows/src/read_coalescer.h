@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "gatt_scheduler.h"
+
+namespace layrz_ble {
+  /// @brief How fresh the value returned by a characteristic read must be
+  enum class ReadFreshness : uint8_t {
+    /// @brief Always read from the device
+    Uncached,
+    /// @brief Return the last value read from the device, read it when there is none
+    Cached,
+    /// @brief Return the last value read from the device when it is not older than the max age
+    MaxAge,
+  };
+
+  struct ReadPolicy {
+    ReadFreshness freshness = ReadFreshness::Uncached;
+    std::chrono::milliseconds maxAge{0};
+  }; // struct ReadPolicy
+
+  /// @brief Value cache and in-flight reads of the characteristics of one device, keyed by handle.
+  ///
+  /// A read either gets a cached value that satisfies its policy, joins the read of the same
+  /// characteristic already queued or in flight, or leads a new read. The leader reads from the
+  /// device and ends the read with complete() or abort(), which answers every waiter at once, so
+  /// concurrent callers share one over-the-air read. The cache replaces the value cache of Windows,
+  /// the leader always reads uncached.
+  class ReadCoalescer {
+    public:
+      using Clock = std::chrono::steady_clock;
+      using Value = std::vector<uint8_t>;
+      /// @brief Answers a read, value is nullptr when the read failed or was aborted
+      using Waiter = std::function<void(OperationEnd end, const Value *value)>;
+
+      enum class Start : uint8_t {
+        /// @brief The cached value satisfies the policy, the waiter is not kept
+        Hit,
+        /// @brief The waiter joined the read in flight
+        Joined,
+        /// @brief The caller must read from the device and end the read with its ticket
+        Lead,
+      };
+
+      ReadCoalescer() = default;
+      ReadCoalescer(const ReadCoalescer &) = delete;
+      ReadCoalescer &operator=(const ReadCoalescer &) = delete;
+
+      Start begin(int64_t handle, const ReadPolicy &policy, Waiter waiter, Value &value, uint64_t &ticket);
+      void complete(int64_t handle, uint64_t ticket, const Value *value);
+      void abort(int64_t handle, uint64_t ticket, OperationEnd end);
+
+      void invalidate(int64_t handle);
+      void clear();
+
+    private:
+      struct Entry {
+        Value value;
+        Clock::time_point readAt{};
+        bool valid = false;
+        /// @brief Ticket of the read in flight, 0 when there is none
+        uint64_t ticket = 0;
+        /// @brief Bumped by every invalidation, a read started before one does not cache its value
+        uint64_t generation = 0;
+        /// @brief Generation when the read in flight started
+        uint64_t readGeneration = 0;
+        std::vector<Waiter> waiters;
+      }; // struct Entry
+
+      std::vector<Waiter> take(int64_t handle, uint64_t ticket, const Value *value);
+
+      std::mutex mutex_;
+      std::unordered_map<int64_t, Entry> entries_;
+      uint64_t nextTicket_ = 1;
+  }; // class ReadCoalescer
+} // namespace layrz_ble
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "adv_parser.h"
+
+namespace layrz_ble {
+  /// @brief One advertisement received by a ScanBackend
+  struct ReceivedAdvertisement {
+    uint64_t address = 0;
+    int64_t rssi = 0;
+    bool hasTxPower = false;
+    int16_t txPower = 0;
+    /// @brief Raw length/type/value structures of the advertisement and its scan response, empty when the
+    /// backend does not keep them, see ScanBackend::keepRaw
+    ByteView raw;
+    /// @brief Sections of the advertisement, pointing into buffers that are only valid during the sink call
+    const ParsedAdvertisement *parsed = nullptr;
+  }; // struct ReceivedAdvertisement
+
+  /// @brief Source of the advertisements of a BLE scan.
+  ///
+  /// The scan pipeline of the plugin only sees this interface, so it runs the same behind the WinRT
+  /// advertisement watcher and behind the SimulatedAdvertiser. The sink is called from the threads of
+  /// the backend, one advertisement at a time per thread.
+  class ScanBackend {
+    public:
+      using Sink = std::function<void(const ReceivedAdvertisement &)>;
+
+      virtual ~ScanBackend() = default;
+
+      /// @brief Start delivering advertisements to a sink
+      /// @param sink
+      /// @return false when the backend could not start
+      virtual bool start(Sink sink) = 0;
+
+      /// @brief Stop delivering advertisements
+      virtual void stop() = 0;
+
+      virtual bool running() const = 0;
+
+      /// @brief Ask for the raw AD structures of every advertisement, to capture them. Backends that
+      /// build their advertisements from raw bytes always fill them and ignore this
+      /// @param keep
+      virtual void keepRaw(bool keep) { (void)keep; }
+  }; // class ScanBackend
+} // namespace layrz_ble
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace layrz_ble {
+  /// @brief Collects scan events between flushes, keeping only the latest event of each device.
+  /// Events keep the order in which their device was first seen in the window.
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class ScanBatcher {
+    public:
+      /// @brief Set the number of devices that forces a flush
+      /// @param maxBatchSize
+      void setMaxBatchSize(size_t maxBatchSize) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxBatchSize_ = maxBatchSize > 0 ? maxBatchSize : 1;
+      }
+
+      /// @brief Add an event, replacing the pending one of the same device
+      /// @param key
+      /// @param value
+      /// @return true when the batch is full and should be flushed right away
+      bool push(const Key &key, Value &&value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+          pending_[it->second] = std::move(value);
+          return false;
+        }
+
+        index_.emplace(key, pending_.size());
+        pending_.push_back(std::move(value));
+        return pending_.size() >= maxBatchSize_;
+      }
+
+      /// @brief Take every pending event, leaving the batcher empty
+      /// @return std::vector<Value>
+      std::vector<Value> drain() {
+        std::vector<Value> batch;
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(pending_);
+        index_.clear();
+        pending_.reserve(batch.size());
+        return batch;
+      }
+
+      /// @brief Drop every pending event
+      void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+        index_.clear();
+      }
+
+    private:
+      std::mutex mutex_;
+      std::unordered_map<Key, size_t, Hash> index_;
+      std::vector<Value> pending_;
+      size_t maxBatchSize_ = 256;
+  }; // class ScanBatcher
+} // namespace layrz_ble
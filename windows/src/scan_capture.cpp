@@ -0,0 +1,266 @@
+#include "scan_capture.h"
+
+#include <utility>
+
+namespace layrz_ble {
+  namespace {
+    void put(std::vector<uint8_t> &out, uint64_t value, size_t size) {
+      for (size_t i = 0; i < size; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    uint64_t get(const uint8_t *data, size_t size) {
+      uint64_t value = 0;
+      for (size_t i = 0; i < size; ++i) value |= static_cast<uint64_t>(data[i]) << (8 * i);
+      return value;
+    }
+
+    int8_t clampInt8(int64_t value) {
+      if (value < INT8_MIN) return INT8_MIN;
+      if (value > INT8_MAX) return INT8_MAX;
+      return static_cast<int8_t>(value);
+    }
+
+    uint64_t micros(std::chrono::steady_clock::duration duration) {
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+      return us > 0 ? static_cast<uint64_t>(us) : 0;
+    }
+  } // namespace
+
+  ScanCaptureWriter::~ScanCaptureWriter() { close(); }
+
+  /// @brief Create (or truncate) a capture file and write its header
+  /// @param path
+  /// @return false if the file cannot be created
+  bool ScanCaptureWriter::open(const std::filesystem::path &path) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::error_code error;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) return false;
+
+    path_ = path;
+    startedAt_ = Clock::now();
+    written_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+
+    auto unixUs = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+
+    block_.clear();
+    block_.reserve(kBlockSize + capture::kMaxRecordSize);
+    put(block_, capture::kMagic, 4);
+    put(block_, capture::kVersion, 2);
+    put(block_, capture::kHeaderSize, 2);
+    put(block_, static_cast<uint64_t>(unixUs), 8);
+    return writeBlock();
+  } // open
+
+  /// @brief Append an advertisement, timestamped now. Its AD structures are cut at the record size limit
+  /// @param advertisement
+  void ScanCaptureWriter::append(const ReceivedAdvertisement &advertisement) {
+    auto timestamp = micros(Clock::now() - startedAt_);
+    size_t rawSize = advertisement.raw.size;
+    if (rawSize > capture::kMaxRecordSize - capture::kRecordHeaderSize)
+      rawSize = capture::kMaxRecordSize - capture::kRecordHeaderSize;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    put(block_, capture::kRecordHeaderSize + rawSize, 2);
+    block_.push_back(advertisement.hasTxPower ? capture::kHasTxPower : 0);
+    block_.push_back(static_cast<uint8_t>(clampInt8(advertisement.rssi)));
+    block_.push_back(static_cast<uint8_t>(clampInt8(advertisement.txPower)));
+    block_.push_back(0);
+    put(block_, advertisement.address, 6);
+    put(block_, timestamp, 8);
+    if (rawSize > 0) block_.insert(block_.end(), advertisement.raw.data, advertisement.raw.data + rawSize);
+    written_.fetch_add(1, std::memory_order_relaxed);
+
+    if (block_.size() >= kBlockSize) writeBlock();
+  } // append
+
+  /// @brief Write the pending records to the file
+  /// @return false if the capture is closed or the write failed
+  bool ScanCaptureWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return false;
+    return writeBlock();
+  } // flush
+
+  /// @brief Write the pending records and close the file
+  void ScanCaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    writeBlock();
+    file_.close();
+  } // close
+
+  bool ScanCaptureWriter::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.is_open();
+  } // isOpen
+
+  /// @brief Write the block to the file, called with the lock held
+  /// @return false if the write failed, the file is then closed
+  bool ScanCaptureWriter::writeBlock() {
+    if (!block_.empty())
+      file_.write(reinterpret_cast<const char *>(block_.data()), static_cast<std::streamsize>(block_.size()));
+    block_.clear();
+    file_.flush();
+
+    if (file_.good()) return true;
+    file_.close();
+    return false;
+  } // writeBlock
+
+  ScanCaptureReplay::ScanCaptureReplay(const ReplayConfig &config) : config_(config) {
+    if (config_.speed < 0) config_.speed = 0;
+  } // ScanCaptureReplay
+
+  ScanCaptureReplay::~ScanCaptureReplay() { stop(); }
+
+  /// @brief Map the capture file and check its header
+  /// @return false if the file is missing or is not a capture
+  bool ScanCaptureReplay::open() {
+    if (!file_.openRead(config_.path)) return false;
+
+    const uint8_t *data = file_.data();
+    if (file_.size() < capture::kHeaderSize
+      || get(data, 4) != capture::kMagic
+      || get(data + 4, 2) != capture::kVersion
+      || get(data + 6, 2) < capture::kHeaderSize
+      || get(data + 6, 2) > file_.size()) {
+      file_.close();
+      return false;
+    }
+
+    startedAt_ = get(data + 8, 8);
+    return true;
+  } // open
+
+  /// @brief Start replaying from a thread of the replay, opening the file when needed
+  /// @param sink
+  /// @return false when already started, even when the replay reached its end, or when the file is not a capture
+  bool ScanCaptureReplay::start(Sink sink) {
+    if (started_.exchange(true, std::memory_order_acq_rel))
+      return false;
+
+    if (thread_.joinable()) thread_.join();
+    if (!file_.isOpen() && !open()) {
+      started_.store(false, std::memory_order_release);
+      return false;
+    }
+    finished_.store(false, std::memory_order_release);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = false;
+    }
+    thread_ = std::thread(&ScanCaptureReplay::run, this, std::move(sink));
+    return true;
+  } // start
+
+  /// @brief Stop replaying, the sink is not called anymore once this returns
+  void ScanCaptureReplay::stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
+      thread_.join();
+    started_.store(false, std::memory_order_release);
+  } // stop
+
+  size_t ScanCaptureReplay::replay(const Sink &sink) {
+    if (!file_.isOpen() && !open()) return 0;
+
+    size_t count = 0;
+    size_t offset = static_cast<size_t>(get(file_.data() + 6, 2));
+    Record record;
+    while (next(offset, record)) {
+      replayed_.fetch_add(1, std::memory_order_relaxed);
+      sink(record.advertisement);
+      ++count;
+    }
+    return count;
+  } // replay
+
+  /// @brief Replay every record at its capture time divided by the speed. The timing is kept from the
+  /// first record, and the records already due after a wait are sent back to back
+  /// @param sink
+  void ScanCaptureReplay::run(Sink sink) {
+    using Clock = std::chrono::steady_clock;
+    auto startedAt = Clock::now();
+    size_t offset = static_cast<size_t>(get(file_.data() + 6, 2));
+    bool first = true;
+    uint64_t base = 0;
+    Record record;
+
+    while (next(offset, record)) {
+      if (first) {
+        base = record.timestamp;
+        first = false;
+      }
+
+      if (config_.speed > 0) {
+        auto delay = std::chrono::duration<double, std::micro>(
+          static_cast<double>(record.timestamp > base ? record.timestamp - base : 0) / config_.speed
+        );
+        auto due = startedAt + std::chrono::duration_cast<Clock::duration>(delay);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (Clock::now() < due)
+          wake_.wait_until(lock, due, [this]() { return stopping_; });
+        if (stopping_) break;
+      } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) break;
+      }
+
+      replayed_.fetch_add(1, std::memory_order_relaxed);
+      sink(record.advertisement);
+    }
+
+    finished_.store(true, std::memory_order_release);
+  } // run
+
+  /// @brief Read the record at an offset, its advertisement pointing into the mapping
+  /// @param offset moved past the record
+  /// @param record
+  /// @return false at the end of the file, or on a truncated record
+  bool ScanCaptureReplay::next(size_t &offset, Record &record) {
+    size_t size = file_.size();
+    if (offset >= size) return false;
+
+    const uint8_t *data = file_.data() + offset;
+    size_t recordSize = size - offset >= 2 ? static_cast<size_t>(get(data, 2)) : 0;
+    if (recordSize < capture::kRecordHeaderSize || recordSize > size - offset) {
+      truncated_.store(true, std::memory_order_relaxed);
+      return false;
+    }
+
+    ByteView raw(data + capture::kRecordHeaderSize, recordSize - capture::kRecordHeaderSize);
+    parsed_.clear();
+    parseAdvertisement(raw, parsed_);
+
+    auto &advertisement = record.advertisement;
+    advertisement.hasTxPower = (data[2] & capture::kHasTxPower) != 0;
+    advertisement.rssi = static_cast<int8_t>(data[3]);
+    advertisement.txPower = static_cast<int8_t>(data[4]);
+    advertisement.address = get(data + 6, 6);
+    advertisement.raw = raw;
+    advertisement.parsed = &parsed_;
+    record.timestamp = get(data + 12, 8);
+
+    offset += recordSize;
+    return true;
+  } // next
+} // namespace layrz_ble
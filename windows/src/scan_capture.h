@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "adv_parser.h"
+#include "mapped_file.h"
+#include "scan_backend.h"
+
+namespace layrz_ble {
+  /// @brief Binary log of the advertisements received by a scan, written by ScanCaptureWriter and played
+  /// back by ScanCaptureReplay. Every integer is little-endian and addresses are 48-bit:
+  ///
+  ///   header    magic "LBSC" u32 | version u16 | header size u16 | started at u64 (Unix time, us)
+  ///   record    size u16 | flags u8 (bit 0: has txPower) | rssi i8 | txPower i8 | reserved u8
+  ///             | address u48 | timestamp u64 (us since the start) | AD structures [size - 20]
+  ///
+  /// The AD structures are the raw length/type/value sections of the advertisement and its scan
+  /// response, so a replay parses them with parseAdvertisement like a live backend would.
+  namespace capture {
+    constexpr uint32_t kMagic = 0x4353424C; // "LBSC"
+    constexpr uint16_t kVersion = 1;
+
+    constexpr uint8_t kHasTxPower = 0x01;
+
+    constexpr size_t kHeaderSize = 16;
+    constexpr size_t kRecordHeaderSize = 20;
+    constexpr size_t kMaxRecordSize = UINT16_MAX;
+  } // namespace capture
+
+  /// @brief Appends the advertisements of a scan to a capture file.
+  ///
+  /// Records are built in memory and written in blocks, so append() only takes a lock and copies a few
+  /// dozen bytes. Safe to call from the threads of any backend. A write error closes the capture, the
+  /// advertisements after it are dropped and counted.
+  class ScanCaptureWriter {
+    public:
+      using Clock = std::chrono::steady_clock;
+
+      static constexpr size_t kBlockSize = 64 * 1024;
+
+      ScanCaptureWriter() = default;
+      ~ScanCaptureWriter();
+
+      ScanCaptureWriter(const ScanCaptureWriter &) = delete;
+      ScanCaptureWriter &operator=(const ScanCaptureWriter &) = delete;
+
+      bool open(const std::filesystem::path &path);
+      void append(const ReceivedAdvertisement &advertisement);
+      bool flush();
+      void close();
+
+      bool isOpen() const;
+      const std::filesystem::path &Path() const { return path_; }
+      uint64_t Written() const { return written_.load(std::memory_order_relaxed); }
+      uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+      bool writeBlock();
+
+      mutable std::mutex mutex_;
+      std::filesystem::path path_;
+      std::ofstream file_;
+      std::vector<uint8_t> block_;
+      Clock::time_point startedAt_;
+
+      std::atomic<uint64_t> written_{0};
+      std::atomic<uint64_t> dropped_{0};
+  }; // class ScanCaptureWriter
+
+  struct ReplayConfig {
+    std::filesystem::path path;
+    /// @brief Playback speed, 1 for the timing of the capture, 10 for ten times faster, 0 to replay as
+    /// fast as possible
+    double speed = 1;
+  }; // struct ReplayConfig
+
+  /// @brief ScanBackend that plays a capture file back, at the speed it was captured or faster.
+  ///
+  /// The file is memory-mapped and its AD structures are parsed in place, so a replay costs no copy and
+  /// no allocation per advertisement, and what the scan pipeline sees is what the radio delivered. The
+  /// backend stops at the end of the file, or at the first truncated record.
+  class ScanCaptureReplay : public ScanBackend {
+    public:
+      explicit ScanCaptureReplay(const ReplayConfig &config);
+      ~ScanCaptureReplay() override;
+
+      ScanCaptureReplay(const ScanCaptureReplay &) = delete;
+      ScanCaptureReplay &operator=(const ScanCaptureReplay &) = delete;
+
+      bool open();
+      bool start(Sink sink) override;
+      void stop() override;
+      /// @brief Whether the replay is sending records. A replay that reached the end of its file stays
+      /// started, so start() fails until stop() is called
+      bool running() const override {
+        return started_.load(std::memory_order_acquire) && !finished_.load(std::memory_order_acquire);
+      }
+
+      /// @brief Replay the whole file on the calling thread, without pacing. Not to be called while running
+      /// @param sink
+      /// @return size_t number of replayed advertisements
+      size_t replay(const Sink &sink);
+
+      const ReplayConfig &Config() const { return config_; }
+      /// @brief Unix time of the start of the capture, in microseconds
+      uint64_t StartedAt() const { return startedAt_; }
+      uint64_t Replayed() const { return replayed_.load(std::memory_order_relaxed); }
+      /// @brief Whether the replay stopped on a truncated or malformed record
+      bool Truncated() const { return truncated_.load(std::memory_order_relaxed); }
+
+    private:
+      struct Record {
+        uint64_t timestamp = 0;
+        ReceivedAdvertisement advertisement;
+      }; // struct Record
+
+      void run(Sink sink);
+      bool next(size_t &offset, Record &record);
+
+      ReplayConfig config_;
+      MappedFile file_;
+      uint64_t startedAt_ = 0;
+      ParsedAdvertisement parsed_;
+
+      std::atomic<uint64_t> replayed_{0};
+      std::atomic<bool> truncated_{false};
+      /// @brief Set by start() and cleared by stop() only
+      std::atomic<bool> started_{false};
+      /// @brief Set by the thread once it returns
+      std::atomic<bool> finished_{false};
+      bool stopping_ = false;
+      std::mutex mutex_;
+      std::condition_variable wake_;
+      std::thread thread_;
+  }; // class ScanCaptureReplay
+} // namespace layrz_ble
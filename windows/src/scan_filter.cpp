@@ -0,0 +1,175 @@
+#include "scan_filter.h"
+#include "bt_address.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace layrz_ble {
+  namespace {
+    std::atomic<uint64_t> lastGeneration{0};
+  } // namespace
+
+  /// @brief Check if the filter has no criteria, so every advertisement passes
+  /// @return bool
+  bool ScanFilter::empty() const {
+    return addresses_.empty() && serviceUuids_.empty() && companyIds_.empty() &&
+      namePrefixes_.empty() && !minRssi_ && patterns_.empty();
+  } // empty
+
+  /// @brief Allow a device address
+  /// @param address
+  void ScanFilter::addAddress(uint64_t address) {
+    addresses_.push_back(address);
+  } // addAddress
+
+  /// @brief Allow a device address, written as aa:bb:cc:dd:ee:ff
+  /// @param address
+  /// @return false if the address is not valid
+  bool ScanFilter::addAddress(std::string_view address) {
+    uint64_t parsed;
+    if (!parseBluetoothAddress(address, parsed)) return false;
+    addresses_.push_back(parsed);
+    return true;
+  } // addAddress
+
+  /// @brief Allow devices advertising a service, either in the service list or with service data
+  /// @param uuid
+  /// @return false if the UUID is not valid
+  bool ScanFilter::addServiceUuid(std::string_view uuid) {
+    Uuid parsed;
+    if (!Uuid::parse(uuid, parsed)) return false;
+    serviceUuids_.push_back(parsed);
+    return true;
+  } // addServiceUuid
+
+  /// @brief Allow devices advertising manufacturer data of a company
+  /// @param companyId
+  void ScanFilter::addCompanyId(uint16_t companyId) {
+    companyIds_.push_back(companyId);
+  } // addCompanyId
+
+  /// @brief Allow devices whose local name starts with the prefix
+  /// @param prefix
+  void ScanFilter::addNamePrefix(std::string_view prefix) {
+    namePrefixes_.emplace_back(prefix);
+  } // addNamePrefix
+
+  /// @brief Reject advertisements received below the RSSI
+  /// @param minRssi
+  void ScanFilter::setMinRssi(int64_t minRssi) {
+    minRssi_ = minRssi;
+  } // setMinRssi
+
+  /// @brief Allow devices whose manufacturer data matches the pattern
+  /// @param pattern
+  /// @return false if the pattern is empty or its mask does not have the same length
+  bool ScanFilter::addManufacturerDataPattern(ManufacturerDataPattern pattern) {
+    if (pattern.data.empty()) return false;
+    if (!pattern.mask.empty() && pattern.mask.size() != pattern.data.size()) return false;
+    patterns_.push_back(std::move(pattern));
+    return true;
+  } // addManufacturerDataPattern
+
+  /// @brief Sort and pre-mask the criteria
+  void ScanFilter::compile() {
+    std::sort(addresses_.begin(), addresses_.end());
+    addresses_.erase(std::unique(addresses_.begin(), addresses_.end()), addresses_.end());
+
+    std::sort(serviceUuids_.begin(), serviceUuids_.end());
+    serviceUuids_.erase(std::unique(serviceUuids_.begin(), serviceUuids_.end()), serviceUuids_.end());
+
+    std::sort(companyIds_.begin(), companyIds_.end());
+    companyIds_.erase(std::unique(companyIds_.begin(), companyIds_.end()), companyIds_.end());
+
+    for (auto &pattern : patterns_) {
+      if (pattern.mask.empty()) pattern.mask.assign(pattern.data.size(), 0xFF);
+      for (size_t i = 0; i < pattern.data.size(); ++i) pattern.data[i] &= pattern.mask[i];
+    }
+
+    hasContentCriteria_ = !serviceUuids_.empty() || !companyIds_.empty() || !patterns_.empty() ||
+      !namePrefixes_.empty();
+    generation_ = lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+  } // compile
+
+  /// @brief Check the advertisement against the criteria, cheapest criteria first
+  /// @param address
+  /// @param rssi
+  /// @param advertisement
+  /// @return FilterMatch
+  FilterMatch ScanFilter::check(uint64_t address, int64_t rssi, const ParsedAdvertisement &advertisement) const {
+    if (minRssi_ && rssi < *minRssi_) return FilterMatch::Rejected;
+
+    if (!addresses_.empty() && !std::binary_search(addresses_.begin(), addresses_.end(), address))
+      return FilterMatch::Rejected;
+
+    if (!hasContentCriteria_) return FilterMatch::Matched;
+
+    if (!companyIds_.empty() && !matchesCompanies(advertisement)) return FilterMatch::ContentMismatch;
+    if (!patterns_.empty() && !matchesPatterns(advertisement)) return FilterMatch::ContentMismatch;
+    if (!serviceUuids_.empty() && !matchesServices(advertisement)) return FilterMatch::ContentMismatch;
+    if (!namePrefixes_.empty() && !matchesName(advertisement.Name())) return FilterMatch::ContentMismatch;
+    return FilterMatch::Matched;
+  } // check
+
+  /// @brief Check the advertised service lists and service data UUIDs
+  /// @param advertisement
+  /// @return bool
+  bool ScanFilter::matchesServices(const ParsedAdvertisement &advertisement) const {
+    auto known = [this](ByteView uuid) {
+      return std::binary_search(serviceUuids_.begin(), serviceUuids_.end(), Uuid::fromLittleEndian(uuid.data, uuid.size));
+    };
+
+    for (size_t i = 0; i < advertisement.serviceUuidListCount(); ++i) {
+      const auto &list = advertisement.serviceUuidList(i);
+      for (size_t j = 0; j < list.count(); ++j) {
+        if (known(list.at(j))) return true;
+      }
+    }
+
+    for (size_t i = 0; i < advertisement.serviceDataCount(); ++i) {
+      if (known(advertisement.serviceData(i).uuid)) return true;
+    }
+    return false;
+  } // matchesServices
+
+  /// @brief Check the company IDs of the manufacturer data
+  /// @param advertisement
+  /// @return bool
+  bool ScanFilter::matchesCompanies(const ParsedAdvertisement &advertisement) const {
+    for (size_t i = 0; i < advertisement.manufacturerDataCount(); ++i) {
+      auto companyId = advertisement.manufacturerData(i).companyId;
+      if (std::binary_search(companyIds_.begin(), companyIds_.end(), companyId)) return true;
+    }
+    return false;
+  } // matchesCompanies
+
+  /// @brief Check the masked byte patterns of the manufacturer data
+  /// @param advertisement
+  /// @return bool
+  bool ScanFilter::matchesPatterns(const ParsedAdvertisement &advertisement) const {
+    for (size_t i = 0; i < advertisement.manufacturerDataCount(); ++i) {
+      const auto &item = advertisement.manufacturerData(i);
+      for (const auto &pattern : patterns_) {
+        if (pattern.companyId && *pattern.companyId != item.companyId) continue;
+        if (pattern.offset + pattern.data.size() > item.data.size) continue;
+
+        bool equal = true;
+        for (size_t j = 0; j < pattern.data.size() && equal; ++j)
+          equal = (item.data[pattern.offset + j] & pattern.mask[j]) == pattern.data[j];
+        if (equal) return true;
+      }
+    }
+    return false;
+  } // matchesPatterns
+
+  /// @brief Check the name prefixes
+  /// @param name
+  /// @return bool
+  bool ScanFilter::matchesName(std::string_view name) const {
+    if (name.empty()) return false;
+    for (const auto &prefix : namePrefixes_) {
+      if (name.substr(0, prefix.size()) == prefix) return true;
+    }
+    return false;
+  } // matchesName
+} // namespace layrz_ble
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "adv_parser.h"
+#include "uuid.h"
+
+namespace layrz_ble {
+  /// @brief Masked byte pattern matched against the manufacturer data of an advertisement
+  struct ManufacturerDataPattern {
+    /// @brief Company the data must belong to, any company when not set
+    std::optional<uint16_t> companyId;
+    /// @brief Position of the first pattern byte, relative to the data after the company ID
+    size_t offset = 0;
+    std::vector<uint8_t> data;
+    /// @brief Bits to compare for each byte of data, every bit when empty
+    std::vector<uint8_t> mask;
+  }; // struct ManufacturerDataPattern
+
+  /// @brief Outcome of ScanFilter::check
+  enum class FilterMatch : uint8_t {
+    /// @brief Below the RSSI floor, or not an allowed address
+    Rejected,
+    /// @brief Every criterion matched
+    Matched,
+    /// @brief Only the content criteria (services, companies, patterns, names) did not match
+    ContentMismatch,
+  };
+
+  /// @brief Set of scan criteria evaluated on the ingest thread, before any result is built.
+  ///
+  /// Every configured criterion must match (AND), while any entry of a criterion is enough (OR).
+  /// A filter is built with the add methods and compile(), then shared as a const object, so the
+  /// threads of the scan backend check it without locking while startScan publishes the next one.
+  ///
+  /// A device may split its data between the advertisement and the scan response, so a device that
+  /// matched once should keep passing every criterion but the RSSI floor and the addresses. The filter
+  /// keeps no state for this: the caller remembers which devices matched under which Generation(), and
+  /// passes it to matches().
+  class ScanFilter {
+    public:
+      bool empty() const;
+
+      void addAddress(uint64_t address);
+      bool addAddress(std::string_view address);
+      bool addServiceUuid(std::string_view uuid);
+      void addCompanyId(uint16_t companyId);
+      void addNamePrefix(std::string_view prefix);
+      void setMinRssi(int64_t minRssi);
+      bool addManufacturerDataPattern(ManufacturerDataPattern pattern);
+
+      /// @brief Sort and pre-mask the criteria, must be called after the last add and before check()
+      void compile();
+
+      /// @brief Unique number of the compiled filter, 0 before compile()
+      uint64_t Generation() const { return generation_; }
+
+      FilterMatch check(uint64_t address, int64_t rssi, const ParsedAdvertisement &advertisement) const;
+
+      /// @brief Check the advertisement against the criteria
+      /// @param address
+      /// @param rssi
+      /// @param advertisement
+      /// @param matchedBefore whether the device already matched this filter
+      /// @return bool
+      bool matches(uint64_t address, int64_t rssi, const ParsedAdvertisement &advertisement, bool matchedBefore = false) const {
+        auto match = check(address, rssi, advertisement);
+        return match == FilterMatch::Matched || (match == FilterMatch::ContentMismatch && matchedBefore);
+      }
+
+    private:
+      bool matchesServices(const ParsedAdvertisement &advertisement) const;
+      bool matchesCompanies(const ParsedAdvertisement &advertisement) const;
+      bool matchesPatterns(const ParsedAdvertisement &advertisement) const;
+      bool matchesName(std::string_view name) const;
+
+      std::vector<uint64_t> addresses_;
+      std::vector<Uuid> serviceUuids_;
+      std::vector<uint16_t> companyIds_;
+      std::vector<std::string> namePrefixes_;
+      std::optional<int64_t> minRssi_;
+      std::vector<ManufacturerDataPattern> patterns_;
+      bool hasContentCriteria_ = false;
+      uint64_t generation_ = 0;
+  }; // class ScanFilter
+} // namespace layrz_ble
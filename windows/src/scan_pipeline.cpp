@@ -0,0 +1,108 @@
+#include "scan_pipeline.h"
+
+#include "bt_address.h"
+
+namespace layrz_ble {
+  /// @brief Resize the visible devices for a new cap, dropping them only when the cap changes
+  /// @param maxDevices
+  void ScanPipeline::setMaxDevices(size_t maxDevices) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (devices_.capacity() != maxDevices)
+      devices_.reset(maxDevices);
+  } // setMaxDevices
+
+  /// @brief Find a visible device, without refreshing it
+  /// @param address
+  /// @return std::optional<BleScanResult>, a copy taken under the lock
+  std::optional<BleScanResult> ScanPipeline::find(uint64_t address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto visible = devices_.find(address))
+      return visible->result;
+    return std::nullopt;
+  } // find
+
+  /// @brief Build the scan result of an advertisement. The MAC address string is only built when the
+  /// device is first added to the visible devices
+  /// @param advertisement
+  /// @return BleScanResult
+  BleScanResult ScanPipeline::resultOf(const ReceivedAdvertisement &advertisement) {
+    const auto &parsed = *advertisement.parsed;
+
+    BleScanResult result;
+    result.setAddress(advertisement.address);
+
+    for (size_t i = 0; i < parsed.manufacturerDataCount(); ++i) {
+      const auto &item = parsed.manufacturerData(i);
+      if (!item.data.empty())
+        result.appendManufacturerData(item.companyId, item.data);
+    }
+
+    for (size_t i = 0; i < parsed.serviceDataCount(); ++i) {
+      const auto &item = parsed.serviceData(i);
+      result.appendServiceData(Uuid::fromLittleEndian(item.uuid.data, item.uuid.size), item.data);
+    }
+
+    if (!parsed.Name().empty())
+      result.setName(parsed.Name());
+
+    if (advertisement.rssi)
+      result.setRssi(advertisement.rssi);
+
+    if (advertisement.hasTxPower)
+      result.setTxPower(advertisement.txPower);
+
+    return result;
+  } // resultOf
+
+  /// @brief Check a scan result against the scan filter. A device that matched the filter once keeps
+  /// passing its content criteria, as its other advertisements may not carry the matched data
+  /// @param filter
+  /// @param address
+  /// @param rssi
+  /// @param parsed
+  /// @return bool
+  bool ScanPipeline::passes(const ScanFilter &filter, uint64_t address, int64_t rssi, const ParsedAdvertisement &parsed) {
+    auto match = filter.check(address, rssi, parsed);
+    if (match != FilterMatch::ContentMismatch)
+      return match == FilterMatch::Matched;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto visible = devices_.find(address);
+    return visible != nullptr && visible->filterGeneration == filter.Generation();
+  } // passes
+
+  /// @brief Merge a result into a visible device, with the lock held
+  /// @param device
+  /// @param result
+  /// @param inserted whether the device was just added, it then takes the result as is
+  void ScanPipeline::mergeInto(BleScanResult &device, BleScanResult &&result, bool inserted) {
+    if (inserted) {
+      if (result.DeviceId().empty()) {
+        char deviceId[18];
+        formatBluetoothAddress(result.Address(), deviceId);
+        result.setDeviceId(deviceId);
+      }
+      device = std::move(result);
+      return;
+    }
+
+    if (result.Name())
+      device.setName(*result.Name());
+
+    if (result.Rssi())
+      device.setRssi(result.Rssi());
+
+    if (result.TxPower())
+      device.setTxPower(result.TxPower());
+
+    if (!result.ServiceData()->empty()) {
+      for (auto &serviceData : result.takeServiceData())
+        device.appendServiceData(serviceData.first, std::move(serviceData.second));
+    }
+
+    if (!result.ManufacturerData()->empty()) {
+      for (auto &mfd : result.takeManufacturerData())
+        device.appendManufacturerData(mfd.first, std::move(mfd.second));
+    }
+  } // mergeInto
+} // namespace layrz_ble
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "change_detector.h"
+#include "device_table.hpp"
+#include "plugin_stats.h"
+#include "scan_backend.h"
+#include "scan_filter.h"
+#include "scan_result.h"
+
+namespace layrz_ble {
+  /// @brief Entry of the visible devices table
+  struct VisibleDevice {
+    BleScanResult result;
+    /// @brief What was last sent to Dart for the device
+    ChangeDetector::State change;
+    /// @brief Generation of the scan filter the device matched, see ScanFilter
+    uint64_t filterGeneration = 0;
+  }; // struct VisibleDevice
+
+  /// @brief Scan path of the plugin from a received advertisement to a result worth sending: the scan filter,
+  /// the merge into the visible devices and the suppression of unchanged results.
+  ///
+  /// handle() and merge() run on the threads of the scan backend. The visible devices are guarded by one
+  /// mutex, held while the emit callback builds the event of a result, so the callback sees the merged
+  /// device as it is and must not call back into the pipeline. Devices evicted by the cap or the TTL are
+  /// reported to the lost callback under the same lock. The filter is published atomically, so startScan
+  /// may replace it on the UI thread while the backend runs.
+  class ScanPipeline {
+    public:
+      using Clock = DeviceTable<VisibleDevice>::Clock;
+
+      static constexpr size_t kDefaultMaxDevices = 2048;
+
+      explicit ScanPipeline(ScanStats *stats = nullptr, size_t maxDevices = kDefaultMaxDevices)
+        : stats_(stats), devices_(maxDevices), changes_(stats) {}
+
+      ScanPipeline(const ScanPipeline &) = delete;
+      ScanPipeline &operator=(const ScanPipeline &) = delete;
+
+      std::shared_ptr<const ScanFilter> Filter() const { return std::atomic_load(&filter_); }
+      void setFilter(std::shared_ptr<const ScanFilter> filter) { std::atomic_store(&filter_, std::move(filter)); }
+
+      /// @brief Rules of the suppression of unchanged results
+      ChangeDetector &Changes() { return changes_; }
+
+      void setMaxDevices(size_t maxDevices);
+      std::optional<BleScanResult> find(uint64_t address);
+
+      static BleScanResult resultOf(const ReceivedAdvertisement &advertisement);
+      bool passes(const ScanFilter &filter, uint64_t address, int64_t rssi, const ParsedAdvertisement &parsed);
+
+      /// @brief Filter an advertisement and merge it into the visible devices
+      /// @param advertisement
+      /// @param emit called with the merged device when it is worth sending
+      /// @param onLost called with each device evicted to make room
+      /// @return bool false when the filter rejected the advertisement
+      template <typename Emit, typename Lost>
+      bool handle(const ReceivedAdvertisement &advertisement, Emit &&emit, Lost &&onLost) {
+        auto filter = Filter();
+        if (!passes(*filter, advertisement.address, advertisement.rssi, *advertisement.parsed)) {
+          if (stats_ != nullptr) stats_->filtered.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+
+        merge(resultOf(advertisement), filter->Generation(), emit, onLost);
+        return true;
+      } // handle
+
+      /// @brief Merge a result that passed the filter into the visible devices. A new device takes the
+      /// result as is, a known one takes its name, RSSI, txPower and data
+      /// @param result
+      /// @param filterGeneration generation of the scan filter the result passed
+      /// @param emit called with the merged device when it is worth sending
+      /// @param onLost called with each device evicted to make room
+      /// @return bool whether emit was called
+      template <typename Emit, typename Lost>
+      bool merge(BleScanResult &&result, uint64_t filterGeneration, Emit &&emit, Lost &&onLost) {
+        uint64_t address = result.Address();
+        if (address == 0)
+          return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool inserted = false;
+        auto now = Clock::now();
+        auto &visible = devices_.upsert(
+          address,
+          now,
+          inserted,
+          [&onLost](uint64_t, VisibleDevice &lost) { onLost(static_cast<const BleScanResult &>(lost.result)); }
+        );
+        visible.filterGeneration = filterGeneration;
+        mergeInto(visible.result, std::move(result), inserted);
+
+        // Nothing meaningful changed since the last result sent for this device
+        const auto &device = visible.result;
+        uint64_t fingerprint = changes_.enabled() ? device.ContentFingerprint() : 0;
+        if (!changes_.shouldEmit(visible.change, fingerprint, device.Rssi(), now))
+          return false;
+
+        emit(device);
+        return true;
+      } // merge
+
+      /// @brief Evict the devices not seen since the cutoff
+      /// @param cutoff
+      /// @param onLost called with each evicted device
+      /// @return size_t number of evicted devices
+      template <typename Lost>
+      size_t expire(Clock::time_point cutoff, Lost &&onLost) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return devices_.evictExpired(
+          cutoff,
+          [&onLost](uint64_t, VisibleDevice &lost) { onLost(static_cast<const BleScanResult &>(lost.result)); }
+        );
+      } // expire
+
+    private:
+      static void mergeInto(BleScanResult &device, BleScanResult &&result, bool inserted);
+
+      ScanStats *stats_ = nullptr;
+      std::shared_ptr<const ScanFilter> filter_ = std::make_shared<const ScanFilter>();
+
+      std::mutex mutex_;
+      DeviceTable<VisibleDevice> devices_;
+      ChangeDetector changes_;
+  }; // class ScanPipeline
+} // namespace layrz_ble
@@ -1,5 +1,4 @@
 #include "scan_result.h"
-#include <iostream>
 
 namespace layrz_ble {
 
@@ -42,8 +41,8 @@ namespace layrz_ble {
   }
 
   /// @brief Get the Rssi object
-  /// @return const int64_t  
-  const int64_t BleScanResult::Rssi() const {
+  /// @return int64_t  
+  int64_t BleScanResult::Rssi() const {
     return rssi_ ? *rssi_ : 0;
   }
 
@@ -81,16 +80,40 @@ namespace layrz_ble {
     manufacturerData_.insert_or_assign(companyId, data);
   }
 
+  /// @brief  Set the ManufacturerData object, taking ownership of the data
+  /// @param companyId
+  /// @param data
+  /// @return void
+  void BleScanResult::appendManufacturerData(const uint16_t& companyId, std::vector<uint8_t>&& data) {
+    manufacturerData_.insert_or_assign(companyId, std::move(data));
+  }
+
+  /// @brief  Set the ManufacturerData object, copying straight from the advertisement buffer
+  /// @param companyId
+  /// @param data
+  /// @return void
+  void BleScanResult::appendManufacturerData(const uint16_t& companyId, ByteView data) {
+    manufacturerData_[companyId].assign(data.begin(), data.end());
+  }
+
+  /// @brief Move the ManufacturerData out of this result, leaving it empty
+  /// @return AdvPacketType
+  AdvPacketType BleScanResult::takeManufacturerData() {
+    AdvPacketType manufacturerData = std::move(manufacturerData_);
+    manufacturerData_.clear();
+    return manufacturerData;
+  }
+
   /// @brief Get the ServiceData object
   /// @return const std::vector<uint8_t>*  
-  const AdvPacketType* BleScanResult::ServiceData() const {
+  const ServiceDataType* BleScanResult::ServiceData() const {
     return &serviceData_;
   }
 
   /// @brief Set the ServiceData object
   /// @param serviceData
   /// @return void  
-  void BleScanResult::setServiceData(const AdvPacketType* serviceData) {
+  void BleScanResult::setServiceData(const ServiceDataType* serviceData) {
     if (serviceData) {
       serviceData_ = *serviceData;
     }
@@ -99,13 +122,37 @@ namespace layrz_ble {
   /// @brief Set the ServiceData object
   /// @param serviceData
   /// @return void
-  void BleScanResult::appendServiceData(const uint16_t& serviceUuid, const std::vector<uint8_t>& data) {
+  void BleScanResult::appendServiceData(const Uuid& serviceUuid, const std::vector<uint8_t>& data) {
     serviceData_.insert_or_assign(serviceUuid, data);
   }
+
+  /// @brief Set the ServiceData object, taking ownership of the data
+  /// @param serviceUuid
+  /// @param data
+  /// @return void
+  void BleScanResult::appendServiceData(const Uuid& serviceUuid, std::vector<uint8_t>&& data) {
+    serviceData_.insert_or_assign(serviceUuid, std::move(data));
+  }
+
+  /// @brief Set the ServiceData object, copying straight from the advertisement buffer
+  /// @param serviceUuid
+  /// @param data
+  /// @return void
+  void BleScanResult::appendServiceData(const Uuid& serviceUuid, ByteView data) {
+    serviceData_[serviceUuid].assign(data.begin(), data.end());
+  }
+
+  /// @brief Move the ServiceData out of this result, leaving it empty
+  /// @return ServiceDataType
+  ServiceDataType BleScanResult::takeServiceData() {
+    ServiceDataType serviceData = std::move(serviceData_);
+    serviceData_.clear();
+    return serviceData;
+  }
   
   /// @brief Get the Address object
-  /// @return const uint64_t
-  const uint64_t BleScanResult::Address() const {
+  /// @return uint64_t
+  uint64_t BleScanResult::Address() const {
     return address_ ? *address_ : 0;
   }
 
@@ -116,22 +163,9 @@ namespace layrz_ble {
     address_ = address;
   }
 
-  /// @brief Get the Device object
-  /// @return const std::optional<BluetoothLEDevice>
-  const std::optional<BluetoothLEDevice> BleScanResult::Device() const {
-    return device_;
-  }
-
-  /// @brief Set the Device object
-  /// @param device
-  /// @return void
-  void BleScanResult::setDevice(const std::optional<BluetoothLEDevice> device) {
-    device_ = device;
-  }
-
   /// @brief Get the TxPower object
-  /// @return const uint8_t
-  const uint16_t BleScanResult::TxPower() const {
+  /// @return uint16_t
+  uint16_t BleScanResult::TxPower() const {
     return txPower_ ? *txPower_ : 0;
   }
 
@@ -141,4 +175,29 @@ namespace layrz_ble {
   void BleScanResult::setTxPower(uint16_t txPower) {
     txPower_ = txPower;
   }
+
+  /// @brief Fingerprint the name, manufacturer data and service data, the content worth re-sending
+  /// @return uint64_t
+  uint64_t BleScanResult::ContentFingerprint() const {
+    Fingerprint fingerprint;
+    if (name_) {
+      fingerprint.add(name_->size());
+      fingerprint.add(reinterpret_cast<const uint8_t *>(name_->data()), name_->size());
+    }
+
+    fingerprint.add(manufacturerData_.size());
+    for (const auto &mfd : manufacturerData_) {
+      fingerprint.add(mfd.first);
+      fingerprint.add(mfd.second.size());
+      fingerprint.add(mfd.second.data(), mfd.second.size());
+    }
+
+    fingerprint.add(serviceData_.size());
+    for (const auto &serviceData : serviceData_) {
+      fingerprint.add(serviceData.first.bytes, sizeof(serviceData.first.bytes));
+      fingerprint.add(serviceData.second.size());
+      fingerprint.add(serviceData.second.data(), serviceData.second.size());
+    }
+    return fingerprint.value();
+  }
 }
\ No newline at end of file
@@ -1,21 +1,20 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include <winrt/base.h>
-#include <flutter/standard_method_codec.h>
-
-#include <winrt/base.h>
-#include <winrt/Windows.Devices.Bluetooth.h>
+#include "adv_parser.h"
+#include "change_detector.h"
+#include "uuid.h"
 
 typedef std::map<uint16_t, std::vector<uint8_t>> AdvPacketType;
+typedef std::map<layrz_ble::Uuid, std::vector<uint8_t>> ServiceDataType;
 
 namespace layrz_ble {
-  using namespace winrt;
-  using namespace Windows::Devices::Bluetooth;
-  
   class BleScanResult {
     public:
       BleScanResult() = default;
@@ -28,39 +27,42 @@ namespace layrz_ble {
       void setName(const std::string_view* name);
       void setName(std::string_view name);
 
-      const int64_t Rssi() const;
+      int64_t Rssi() const;
       void setRssi(int64_t* rssi);
       void setRssi(int64_t rssi);
 
       const AdvPacketType* ManufacturerData() const;
       void setManufacturerData(const AdvPacketType* manufacturerData);
       void appendManufacturerData(const uint16_t& companyId, const std::vector<uint8_t>& data);
-
-      const AdvPacketType* ServiceData() const;
-      void setServiceData(const AdvPacketType* serviceData);
-      void appendServiceData(const uint16_t& serviceUuid, const std::vector<uint8_t>& data);
-
-      const uint64_t Address() const;
+      void appendManufacturerData(const uint16_t& companyId, std::vector<uint8_t>&& data);
+      void appendManufacturerData(const uint16_t& companyId, ByteView data);
+      AdvPacketType takeManufacturerData();
+
+      const ServiceDataType* ServiceData() const;
+      void setServiceData(const ServiceDataType* serviceData);
+      void appendServiceData(const Uuid& serviceUuid, const std::vector<uint8_t>& data);
+      void appendServiceData(const Uuid& serviceUuid, std::vector<uint8_t>&& data);
+      void appendServiceData(const Uuid& serviceUuid, ByteView data);
+      ServiceDataType takeServiceData();
+
+      uint64_t Address() const;
       void setAddress(uint64_t address);
 
-      const std::optional<BluetoothLEDevice> Device() const;
-      void setDevice(const std::optional<BluetoothLEDevice> device);
-
-      const uint16_t TxPower() const;
+      uint16_t TxPower() const;
       void setTxPower(uint16_t txPower);
 
+      uint64_t ContentFingerprint() const;
+
     private:
       std::string deviceId_;
       std::optional<std::string> name_;
       std::optional<int64_t> rssi_;
 
       AdvPacketType manufacturerData_;
-      AdvPacketType serviceData_;
+      ServiceDataType serviceData_;
 
       std::optional<uint64_t> address_;
 
-      std::optional<BluetoothLEDevice> device_;
-
       std::optional<uint16_t> txPower_;
   };
 }
\ No newline at end of file
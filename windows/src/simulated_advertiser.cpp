@@ -0,0 +1,153 @@
+#include "simulated_advertiser.h"
+
+#include <chrono>
+#include <utility>
+
+namespace layrz_ble {
+  SimulatedAdvertiser::SimulatedAdvertiser(const SimulationConfig &config) : config_(config), state_(config.seed) {
+    if (config_.advertisers == 0) config_.advertisers = 1;
+    if (config_.payloadSize > kMaxPayloadSize) config_.payloadSize = kMaxPayloadSize;
+    if (config_.rate < 0) config_.rate = 0;
+
+    advertisers_.reserve(config_.advertisers);
+    for (size_t i = 0; i < config_.advertisers; ++i) advertisers_.push_back(spawn());
+
+    // Flags, the longest name and the manufacturer data
+    payload_.reserve(3 + 12 + 4 + config_.payloadSize);
+  } // SimulatedAdvertiser
+
+  SimulatedAdvertiser::~SimulatedAdvertiser() { stop(); }
+
+  /// @brief Start emitting advertisements at the configured rate, from a thread of the advertiser
+  /// @param sink
+  /// @return false when already started, even when the run ended on its limit
+  bool SimulatedAdvertiser::start(Sink sink) {
+    if (started_.exchange(true, std::memory_order_acq_rel))
+      return false;
+
+    if (thread_.joinable()) thread_.join();
+    finished_.store(false, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = false;
+    }
+    thread_ = std::thread(&SimulatedAdvertiser::run, this, std::move(sink));
+    return true;
+  } // start
+
+  /// @brief Stop emitting, the sink is not called anymore once this returns
+  void SimulatedAdvertiser::stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
+      thread_.join();
+    started_.store(false, std::memory_order_release);
+  } // stop
+
+  void SimulatedAdvertiser::emit(size_t count, const Sink &sink) {
+    for (size_t i = 0; i < count; ++i) next(sink);
+  } // emit
+
+  /// @brief Emit the advertisements due since the start, then sleep for a millisecond, so high rates
+  /// are reached in bursts instead of one sleep per advertisement
+  /// @param sink
+  void SimulatedAdvertiser::run(Sink sink) {
+    using Clock = std::chrono::steady_clock;
+    auto startedAt = Clock::now();
+    uint64_t sent = 0;
+
+    while (true) {
+      uint64_t due = sent + 1024;
+      if (config_.rate > 0) {
+        auto elapsed = std::chrono::duration<double>(Clock::now() - startedAt).count();
+        due = static_cast<uint64_t>(elapsed * config_.rate);
+      }
+      if (config_.limit > 0 && due > config_.limit) due = config_.limit;
+
+      for (; sent < due; ++sent) next(sink);
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stopping_ || (config_.limit > 0 && sent >= config_.limit))
+        break;
+      if (config_.rate > 0)
+        wake_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return stopping_; });
+    }
+
+    finished_.store(true, std::memory_order_release);
+  } // run
+
+  /// @brief Build the next advertisement, from a random advertiser, and hand it to the sink
+  /// @param sink
+  void SimulatedAdvertiser::next(const Sink &sink) {
+    if (config_.churn > 0 && config_.rate > 0) {
+      churnDebt_ += config_.churn * static_cast<double>(advertisers_.size()) / config_.rate;
+      for (; churnDebt_ >= 1; churnDebt_ -= 1)
+        advertisers_[random() % advertisers_.size()] = spawn();
+    }
+
+    auto &advertiser = advertisers_[random() % advertisers_.size()];
+    if (uniform() < config_.changeRatio) ++advertiser.sequence;
+
+    payload_.clear();
+    payload_.insert(payload_.end(), {2, AdType::Flags, 0x06});
+
+    if (advertiser.named) {
+      static const char hex[] = "0123456789ABCDEF";
+      payload_.insert(payload_.end(), {11, AdType::CompleteLocalName, 'S', 'I', 'M', '-'});
+      for (int shift = 20; shift >= 0; shift -= 4)
+        payload_.push_back(static_cast<uint8_t>(hex[(advertiser.address >> shift) & 0x0F]));
+    }
+
+    payload_.push_back(static_cast<uint8_t>(3 + config_.payloadSize));
+    payload_.push_back(AdType::ManufacturerSpecificData);
+    payload_.push_back(static_cast<uint8_t>(kCompanyId & 0xFF));
+    payload_.push_back(static_cast<uint8_t>(kCompanyId >> 8));
+    // The sequence leads the data so that a change is visible whatever the size, the rest depends on the address only
+    for (size_t i = 0; i < config_.payloadSize; ++i) {
+      payload_.push_back(i < 4
+        ? static_cast<uint8_t>(advertiser.sequence >> (8 * i))
+        : static_cast<uint8_t>((advertiser.address >> (8 * (i % 6))) + i));
+    }
+
+    parsed_.clear();
+    parseAdvertisement(ByteView(payload_.data(), payload_.size()), parsed_);
+
+    ReceivedAdvertisement advertisement;
+    advertisement.address = advertiser.address;
+    advertisement.rssi = advertiser.rssi - static_cast<int64_t>(random() % 6);
+    advertisement.raw = ByteView(payload_.data(), payload_.size());
+    advertisement.parsed = &parsed_;
+
+    emitted_.fetch_add(1, std::memory_order_relaxed);
+    sink(advertisement);
+  } // next
+
+  /// @brief Create a device with a new static random address
+  /// @return Advertiser
+  SimulatedAdvertiser::Advertiser SimulatedAdvertiser::spawn() {
+    Advertiser advertiser;
+    advertiser.address = (random() & 0xFFFFFFFFFFFFULL) | 0xC00000000000ULL;
+    advertiser.sequence = 0;
+    advertiser.rssi = static_cast<int16_t>(-40 - static_cast<int16_t>(random() % 55));
+    advertiser.named = uniform() < config_.namedRatio;
+    return advertiser;
+  } // spawn
+
+  /// @brief splitmix64
+  /// @return uint64_t
+  uint64_t SimulatedAdvertiser::random() {
+    uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  } // random
+
+  /// @brief Uniform double in [0, 1)
+  /// @return double
+  double SimulatedAdvertiser::uniform() {
+    return static_cast<double>(random() >> 11) * (1.0 / 9007199254740992.0);
+  } // uniform
+} // namespace layrz_ble
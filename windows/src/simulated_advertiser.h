@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "adv_parser.h"
+#include "scan_backend.h"
+
+namespace layrz_ble {
+  struct SimulationConfig {
+    /// @brief Number of virtual devices advertising at once
+    size_t advertisers = 1000;
+    /// @brief Advertisements per second over every advertiser, 0 to emit as fast as possible
+    double rate = 10000;
+    /// @brief Size of the manufacturer data of each advertisement, up to 252 bytes
+    size_t payloadSize = 20;
+    /// @brief Fraction of the advertisers replaced by new devices every second of emitted advertisements
+    double churn = 0;
+    /// @brief Fraction of the advertisements whose manufacturer data changed since the previous one of their device
+    double changeRatio = 0.1;
+    /// @brief Fraction of the advertisers that advertise a local name
+    double namedRatio = 0.5;
+    /// @brief Seed of the generator, the same seed and config give the same advertisements
+    uint64_t seed = 1;
+    /// @brief Number of advertisements after which the backend stops, 0 to run until stopped
+    uint64_t limit = 0;
+  }; // struct SimulationConfig
+
+  /// @brief Deterministic ScanBackend of virtual advertisers, to load the scan pipeline without a radio.
+  ///
+  /// Each advertisement is a raw AD payload (flags, an optional complete local name and the manufacturer
+  /// data of the test company 0xFFFF) parsed by parseAdvertisement, as a real one would be. Timing only
+  /// affects when advertisements are emitted, never what they contain, so a run can be reproduced from
+  /// its seed. Churn is counted in emitted advertisements (rate of them per second), not in wall time.
+  class SimulatedAdvertiser : public ScanBackend {
+    public:
+      static constexpr uint16_t kCompanyId = 0xFFFF;
+      static constexpr size_t kMaxPayloadSize = 252;
+
+      explicit SimulatedAdvertiser(const SimulationConfig &config);
+      ~SimulatedAdvertiser() override;
+
+      SimulatedAdvertiser(const SimulatedAdvertiser &) = delete;
+      SimulatedAdvertiser &operator=(const SimulatedAdvertiser &) = delete;
+
+      bool start(Sink sink) override;
+      void stop() override;
+      /// @brief Whether the backend is emitting. A run that reached its limit is not running anymore, but
+      /// stays started, so start() fails until stop() is called
+      bool running() const override {
+        return started_.load(std::memory_order_acquire) && !finished_.load(std::memory_order_acquire);
+      }
+
+      /// @brief Emit advertisements on the calling thread, without pacing. Not to be called while running
+      /// @param count
+      /// @param sink
+      void emit(size_t count, const Sink &sink);
+
+      const SimulationConfig &Config() const { return config_; }
+      uint64_t Emitted() const { return emitted_.load(std::memory_order_relaxed); }
+
+    private:
+      struct Advertiser {
+        uint64_t address;
+        uint32_t sequence;
+        int16_t rssi;
+        bool named;
+      }; // struct Advertiser
+
+      void run(Sink sink);
+      void next(const Sink &sink);
+      Advertiser spawn();
+      uint64_t random();
+      double uniform();
+
+      SimulationConfig config_;
+      std::vector<Advertiser> advertisers_;
+      uint64_t state_;
+      double churnDebt_ = 0;
+
+      std::vector<uint8_t> payload_;
+      ParsedAdvertisement parsed_;
+
+      std::atomic<uint64_t> emitted_{0};
+      /// @brief Set by start() and cleared by stop() only
+      std::atomic<bool> started_{false};
+      /// @brief Set by the thread once it returns
+      std::atomic<bool> finished_{false};
+      bool stopping_ = false;
+      std::mutex mutex_;
+      std::condition_variable wake_;
+      std::thread thread_;
+  }; // class SimulatedAdvertiser
+} // namespace layrz_ble
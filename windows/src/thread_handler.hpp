@@ -5,18 +5,25 @@
 #include <flutter/plugin_registrar_windows.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <list>
 #include <optional>
 #include <mutex>
 
+#include "mpsc_queue.hpp"
+#include "plugin_stats.h"
+
 class LayrzBlePluginUiThreadHandler
 {
 public:
 
     /// @brief Construct a new LayrzBlePluginUiThreadHandler
     /// @param registrar 
-    explicit LayrzBlePluginUiThreadHandler(flutter::PluginRegistrarWindows *registrar)
-      : registrar_(registrar)
+    /// @param stats receives the depth of the queue and the wait of each task, may be nullptr
+    explicit LayrzBlePluginUiThreadHandler(flutter::PluginRegistrarWindows *registrar, layrz_ble::UiQueueStats *stats = nullptr)
+      : registrar_(registrar), stats_(stats)
     {
       windowProcId_ = registrar_->RegisterTopLevelWindowProcDelegate(
         [this](HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam)
@@ -36,24 +43,65 @@ public:
     /// @brief Copy assignment operator
     LayrzBlePluginUiThreadHandler &operator=(const LayrzBlePluginUiThreadHandler &) = delete;
 
-    /// @brief Move constructor
-    void Post(std::function<void()> &&func)
+    /// @brief Queue a function to be run on the UI thread, callable from any thread.
+    /// Closures up to kInlineTaskSize bytes are stored in the queue slot without allocating.
+    /// @param func
+    template <typename F>
+    void Post(F &&func)
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      queuedFuncs_.emplace_back(std::move(func));
-      Notify();
+      QueuedTask task{Task(std::forward<F>(func)), Clock::now()};
+      bool overflow = overflowing_.load(std::memory_order_acquire) || !queue_.tryPush(task);
+      if (overflow)
+      {
+        // The ring is full (the UI thread is stalled), keep the order and spill to the locked list
+        std::lock_guard<std::mutex> lock(mutex_);
+        overflowing_.store(true, std::memory_order_release);
+        overflowFuncs_.emplace_back(std::move(task));
+      }
+      if (stats_ != nullptr)
+        stats_->recordPost(overflow);
+
+      // Only wake the UI thread when there is no drain pending already
+      if (!notifyPending_.exchange(true, std::memory_order_seq_cst))
+        Notify();
     }
 
 private:
 
     static const UINT kWmCallQueuedFunctions = WM_APP + 0x1d7;
+    static constexpr size_t kInlineTaskSize = 48;
+    static constexpr size_t kQueueCapacity = 1024;
+
+    using Task = layrz_ble::InplaceTask<kInlineTaskSize>;
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Task with the time of its post, kept next to the closure so it does not take inline space
+    struct QueuedTask
+    {
+      Task task;
+      Clock::time_point postedAt;
+    };
+
+    /// @brief Run a task and count its wait
+    /// @param queued
+    void Run(QueuedTask &queued)
+    {
+      if (stats_ != nullptr)
+      {
+        auto waitUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued.postedAt).count();
+        stats_->recordRun(waitUs > 0 ? static_cast<uint64_t>(waitUs) : 0);
+      }
+      queued.task();
+    }
 
     /// @brief Notify the UI thread to process queued functions    
     void Notify()
     {
-        if (hwnd_ != 0)
+        HWND hwnd = hwnd_.load(std::memory_order_acquire);
+        if (hwnd != 0)
         {
-            PostMessage(hwnd_, kWmCallQueuedFunctions, 0, reinterpret_cast<LPARAM>(this));
+            if (!PostMessage(hwnd, kWmCallQueuedFunctions, 0, reinterpret_cast<LPARAM>(this)))
+              notifyPending_.store(false, std::memory_order_release);
         }
     }
 
@@ -66,21 +114,35 @@ private:
     std::optional<LRESULT> HandleWindowMessage(
         HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam)
     {
-        if (hwnd_ == 0)
+        if (hwnd_.load(std::memory_order_relaxed) == 0)
         {
-          hwnd_ = hwnd;
-          Notify(); // Make sure queued functions are processed
+          hwnd_.store(hwnd, std::memory_order_release);
+          // Make sure functions queued before the window existed are processed
+          if (notifyPending_.load(std::memory_order_acquire))
+            Notify();
         }
         if (message == kWmCallQueuedFunctions && lparam == reinterpret_cast<LPARAM>(this))
         {
-          std::list<std::function<void()>> queuedFuncs;
+          // Clear the flag before draining, so a post racing with the drain wakes us up again
+          notifyPending_.store(false, std::memory_order_seq_cst);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          QueuedTask task;
+          while (queue_.tryPop(task))
+          {
+            Run(task);
+            task.task.reset();
+          }
+
+          std::list<QueuedTask> overflowFuncs;
           {
             std::lock_guard<std::mutex> lock(mutex_);
-            std::swap(queuedFuncs_, queuedFuncs);
+            std::swap(overflowFuncs_, overflowFuncs);
+            overflowing_.store(false, std::memory_order_release);
           }
-          for (auto &func : queuedFuncs)
+          for (auto &func : overflowFuncs)
           {
-            func();
+            Run(func);
           }
         }
         return std::nullopt;
@@ -88,7 +150,13 @@ private:
 
     flutter::PluginRegistrarWindows *registrar_;
     int windowProcId_ = 0;
-    HWND hwnd_ = 0;
-    std::list<std::function<void()>> queuedFuncs_;
+    std::atomic<HWND> hwnd_{0};
+    std::atomic<bool> notifyPending_{false};
+    layrz_ble::MpscQueue<QueuedTask, kQueueCapacity> queue_;
+    layrz_ble::UiQueueStats *stats_;
+
+    // Used only when the queue is full
+    std::atomic<bool> overflowing_{false};
+    std::list<QueuedTask> overflowFuncs_;
     std::mutex mutex_;
 };
\ No newline at end of file
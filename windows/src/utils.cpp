@@ -1,15 +1,8 @@
 #include "utils.h"
-
-#define MAC_ADDRESS_STR_LENGTH (size_t)17
+#include "bt_address.h"
 
 
 namespace layrz_ble {
-  /// @brief Log a message to the console
-  /// @param message 
-  void Log(const std::string &message) {
-    std::cout << "LayrzBlePlugin/Windows: " << message << std::endl;
-  } // Log
-
   /// @brief Convert a wide string to a UTF-8 string
   /// @param wstr 
   /// @return std::string
@@ -41,10 +34,9 @@ namespace layrz_ble {
   /// @param mac_address
   /// @return std::string
   std::string formatBluetoothAddress(uint64_t mac_address) {
-    uint8_t *mac_ptr = (uint8_t *)&mac_address;
-    char mac_str[MAC_ADDRESS_STR_LENGTH + 1] = {0};
-    snprintf(mac_str, MAC_ADDRESS_STR_LENGTH + 1, "%02x:%02x:%02x:%02x:%02x:%02x", mac_ptr[5], mac_ptr[4], mac_ptr[3], mac_ptr[2], mac_ptr[1], mac_ptr[0]);
-    return std::string(mac_str);
+    char mac_str[18];
+    formatBluetoothAddress(mac_address, mac_str);
+    return std::string(mac_str, 17);
   } // formatBluetoothAddress
 
   /// @brief Convert a string to lowercase
@@ -60,42 +52,52 @@ namespace layrz_ble {
     return lower;
   } // toLowercase
 
-  /// @brief Convert a GUID to a string
+  /// @brief Convert a GUID to its lowercase canonical string
   /// @param guid
   /// @return std::string
   std::string GuidToString(const winrt::guid &guid) {
-    std::ostringstream oss;
-    oss << std::hex << std::uppercase << std::setfill('0')
-        << std::setw(8) << guid.Data1 << '-'
-        << std::setw(4) << guid.Data2 << '-'
-        << std::setw(4) << guid.Data3 << '-'
-        << std::setw(2) << static_cast<int>(guid.Data4[0])
-        << std::setw(2) << static_cast<int>(guid.Data4[1]) << '-';
-
-    for (int i = 2; i < 8; ++i) {
-        oss << std::setw(2) << static_cast<int>(guid.Data4[i]);
-    }
-
-    return oss.str();
+    return GuidToUuid(guid).toString();
   }
 
-  /// @brief Convert a string to a GUID
+  /// @brief Convert a string to a GUID, an invalid string gives the empty GUID
   /// @param str
   /// @return winrt::guid
   winrt::guid StringToGuid(const std::string &str) {
+    Uuid uuid{};
+    Uuid::parse(str, uuid);
+    return UuidToGuid(uuid);
+  }
+
+  /// @brief Convert a GUID to a Uuid, the GUID fields are stored in native byte order
+  /// @param guid
+  /// @return Uuid
+  Uuid GuidToUuid(const winrt::guid &guid) {
+    Uuid uuid;
+    uuid.bytes[0] = static_cast<uint8_t>(guid.Data1 >> 24);
+    uuid.bytes[1] = static_cast<uint8_t>(guid.Data1 >> 16);
+    uuid.bytes[2] = static_cast<uint8_t>(guid.Data1 >> 8);
+    uuid.bytes[3] = static_cast<uint8_t>(guid.Data1);
+    uuid.bytes[4] = static_cast<uint8_t>(guid.Data2 >> 8);
+    uuid.bytes[5] = static_cast<uint8_t>(guid.Data2);
+    uuid.bytes[6] = static_cast<uint8_t>(guid.Data3 >> 8);
+    uuid.bytes[7] = static_cast<uint8_t>(guid.Data3);
+    for (int i = 0; i < 8; ++i) {
+      uuid.bytes[8 + i] = guid.Data4[i];
+    }
+    return uuid;
+  }
+
+  /// @brief Convert a Uuid to a GUID
+  /// @param uuid
+  /// @return winrt::guid
+  winrt::guid UuidToGuid(const Uuid &uuid) {
     winrt::guid guid;
-    std::istringstream iss(str);
-    iss >> std::hex >> guid.Data1;
-    iss.ignore(1); // Skip '-'
-    iss >> std::hex >> guid.Data2;
-    iss.ignore(1); // Skip '-'
-    iss >> std::hex >> guid.Data3;
-    iss.ignore(1); // Skip '-'
-    iss >> std::hex >> guid.Data4[0];
-    iss >> std::hex >> guid.Data4[1];
-    iss.ignore(1); // Skip '-'
-    for (int i = 2; i < 8; ++i) {
-        iss >> std::hex >> guid.Data4[i];
+    guid.Data1 = (static_cast<uint32_t>(uuid.bytes[0]) << 24) | (static_cast<uint32_t>(uuid.bytes[1]) << 16) |
+      (static_cast<uint32_t>(uuid.bytes[2]) << 8) | uuid.bytes[3];
+    guid.Data2 = static_cast<uint16_t>((uuid.bytes[4] << 8) | uuid.bytes[5]);
+    guid.Data3 = static_cast<uint16_t>((uuid.bytes[6] << 8) | uuid.bytes[7]);
+    for (int i = 0; i < 8; ++i) {
+      guid.Data4[i] = uuid.bytes[8 + i];
     }
     return guid;
   }
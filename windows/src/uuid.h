@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace layrz_ble {
+  /// @brief 128-bit UUID stored as its 16 bytes in canonical (big-endian) order.
+  ///
+  /// Trivially copyable, so it can be used as a map key, compared and hashed without building strings.
+  /// 16 and 32-bit Bluetooth UUIDs are stored expanded over the Bluetooth Base UUID
+  /// 00000000-0000-1000-8000-00805F9B34FB.
+  struct Uuid {
+    uint8_t bytes[16];
+
+    /// @brief Expand a 16 or 32-bit Bluetooth UUID over the Bluetooth Base UUID
+    /// @param value
+    /// @return Uuid
+    static constexpr Uuid fromShort(uint32_t value) {
+      Uuid uuid = base();
+      uuid.bytes[0] = static_cast<uint8_t>(value >> 24);
+      uuid.bytes[1] = static_cast<uint8_t>(value >> 16);
+      uuid.bytes[2] = static_cast<uint8_t>(value >> 8);
+      uuid.bytes[3] = static_cast<uint8_t>(value);
+      return uuid;
+    } // fromShort
+
+    /// @brief Read a 16, 32 or 128-bit UUID as transmitted over the air, in little-endian order
+    /// @param data
+    /// @param size 2, 4 or 16, any other size gives the Bluetooth Base UUID
+    /// @return Uuid
+    static constexpr Uuid fromLittleEndian(const uint8_t *data, size_t size) {
+      if (size == 16) {
+        Uuid uuid{};
+        for (size_t i = 0; i < 16; ++i) uuid.bytes[i] = data[15 - i];
+        return uuid;
+      }
+
+      uint32_t value = 0;
+      if (size == 2 || size == 4) {
+        for (size_t i = 0; i < size; ++i) value |= static_cast<uint32_t>(data[i]) << (8 * i);
+      }
+      return fromShort(value);
+    } // fromLittleEndian
+
+    /// @brief Parse a UUID in its 16, 32 or 128-bit form. Dashes, a 0x prefix and any letter case are accepted
+    /// @param str
+    /// @param uuid
+    /// @return false if the string is not a valid UUID
+    static constexpr bool parse(std::string_view str, Uuid &uuid) {
+      if (str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        str.remove_prefix(2);
+
+      uint8_t parsed[16] = {};
+      size_t count = 0;
+      int high = -1;
+      for (char c : str) {
+        if (c == '-') continue;
+
+        int nibble = hexValue(c);
+        if (nibble < 0) return false;
+
+        if (high < 0) {
+          high = nibble;
+          continue;
+        }
+        if (count == 16) return false;
+        parsed[count++] = static_cast<uint8_t>((high << 4) | nibble);
+        high = -1;
+      }
+
+      if (high >= 0) return false;
+      if (count == 2) {
+        uuid = fromShort((static_cast<uint32_t>(parsed[0]) << 8) | parsed[1]);
+        return true;
+      }
+      if (count == 4) {
+        uuid = fromShort(
+          (static_cast<uint32_t>(parsed[0]) << 24) | (static_cast<uint32_t>(parsed[1]) << 16) |
+          (static_cast<uint32_t>(parsed[2]) << 8) | parsed[3]
+        );
+        return true;
+      }
+      if (count != 16) return false;
+
+      for (size_t i = 0; i < 16; ++i) uuid.bytes[i] = parsed[i];
+      return true;
+    } // parse
+
+    /// @brief Format as the lowercase canonical form xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+    /// @param out receives the 36 characters and a null terminator
+    constexpr void format(char (&out)[37]) const {
+      constexpr char kHex[] = "0123456789abcdef";
+      size_t position = 0;
+      for (size_t i = 0; i < 16; ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) out[position++] = '-';
+        out[position++] = kHex[bytes[i] >> 4];
+        out[position++] = kHex[bytes[i] & 0x0F];
+      }
+      out[position] = '\0';
+    } // format
+
+    /// @brief Format as the lowercase canonical form
+    /// @return std::string
+    std::string toString() const {
+      char out[37];
+      format(out);
+      return std::string(out, 36);
+    } // toString
+
+    /// @brief Check if the UUID is a 16 or 32-bit Bluetooth UUID expanded over the Base UUID
+    /// @return bool
+    constexpr bool isShort() const {
+      Uuid reference = base();
+      for (size_t i = 4; i < 16; ++i) {
+        if (bytes[i] != reference.bytes[i]) return false;
+      }
+      return true;
+    } // isShort
+
+    /// @brief The 32-bit value of a short UUID, the first 4 bytes of any other UUID
+    /// @return uint32_t
+    constexpr uint32_t shortValue() const {
+      return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+        (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+    } // shortValue
+
+    friend constexpr bool operator==(const Uuid &a, const Uuid &b) {
+      for (size_t i = 0; i < 16; ++i) {
+        if (a.bytes[i] != b.bytes[i]) return false;
+      }
+      return true;
+    }
+
+    friend constexpr bool operator!=(const Uuid &a, const Uuid &b) { return !(a == b); }
+
+    friend constexpr bool operator<(const Uuid &a, const Uuid &b) {
+      for (size_t i = 0; i < 16; ++i) {
+        if (a.bytes[i] != b.bytes[i]) return a.bytes[i] < b.bytes[i];
+      }
+      return false;
+    }
+
+    private:
+      static constexpr Uuid base() {
+        return Uuid{{
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+          0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB,
+        }};
+      }
+
+      static constexpr int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+      }
+  }; // struct Uuid
+
+  /// @brief Hash of a Uuid, folding both 64-bit halves and mixing them (splitmix64 finalizer)
+  struct UuidHash {
+    size_t operator()(const Uuid &uuid) const noexcept {
+      uint64_t high;
+      uint64_t low;
+      std::memcpy(&high, uuid.bytes, 8);
+      std::memcpy(&low, uuid.bytes + 8, 8);
+
+      uint64_t hash = high ^ (low * 0x9E3779B97F4A7C15ULL);
+      hash ^= hash >> 30;
+      hash *= 0xBF58476D1CE4E5B9ULL;
+      hash ^= hash >> 27;
+      hash *= 0x94D049BB133111EBULL;
+      hash ^= hash >> 31;
+      return static_cast<size_t>(hash);
+    }
+  }; // struct UuidHash
+} // namespace layrz_ble
@@ -0,0 +1,88 @@
+#include "winrt_scan_backend.h"
+
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Storage.Streams.h>
+
+#include <vector>
+
+namespace layrz_ble {
+  using namespace winrt::Windows::Foundation::Collections;
+
+  /// @brief Create the watcher and start it
+  /// @param sink
+  /// @return false when the watcher could not start
+  bool WinRtScanBackend::start(Sink sink) {
+    if (watcher_ == nullptr) {
+      watcher_ = BluetoothLEAdvertisementWatcher();
+      watcher_.ScanningMode(BluetoothLEScanningMode::Active);
+      receivedToken_ = watcher_.Received([this, sink = std::move(sink)](
+        BluetoothLEAdvertisementWatcher const &,
+        BluetoothLEAdvertisementReceivedEventArgs const &args
+      ) {
+        ReceivedAdvertisement received;
+        received.address = args.BluetoothAddress();
+        received.rssi = args.RawSignalStrengthInDBm();
+
+        // Walk the raw AD structures once, reading every section buffer in place.
+        // Manufacturer data is carried by the 0xFF sections, so ManufacturerData() is not needed.
+        // The sections (and their buffers) must outlive `parsed`, as it only points into them.
+        auto advertisement = args.Advertisement();
+        IVector<BluetoothLEAdvertisementDataSection> sections{nullptr};
+        ParsedAdvertisement parsed;
+        // The raw structures are only rebuilt for a capture, reusing the buffer of the thread
+        bool keepRaw = keepRaw_.load(std::memory_order_relaxed);
+        thread_local std::vector<uint8_t> raw;
+        raw.clear();
+        if (advertisement != nullptr) {
+          sections = advertisement.DataSections();
+          for (const auto &section : sections) {
+            auto dataBuffer = section.Data();
+            if (!dataBuffer)
+              continue;
+
+            parsed.add(section.DataType(), ByteView(dataBuffer.data(), dataBuffer.Length()));
+            if (keepRaw) {
+              // An AD structure holds at most 254 bytes after its type
+              uint32_t length = dataBuffer.Length() < 254 ? dataBuffer.Length() : 254;
+              raw.push_back(static_cast<uint8_t>(length + 1));
+              raw.push_back(section.DataType());
+              raw.insert(raw.end(), dataBuffer.data(), dataBuffer.data() + length);
+            }
+          }
+        }
+        received.parsed = &parsed;
+        received.raw = ByteView(raw.data(), raw.size());
+
+        if (args.TransmitPowerLevelInDBm()) {
+          received.hasTxPower = true;
+          received.txPower = args.TransmitPowerLevelInDBm().Value();
+        }
+
+        sink(received);
+      });
+    }
+
+    try {
+      if (watcher_.Status() != BluetoothLEAdvertisementWatcherStatus::Started)
+        watcher_.Start();
+    } catch (...) {
+      return false;
+    }
+    return true;
+  } // start
+
+  /// @brief Stop the watcher and release it
+  void WinRtScanBackend::stop() {
+    if (watcher_ == nullptr)
+      return;
+
+    watcher_.Received(receivedToken_);
+    watcher_.Stop();
+    watcher_ = nullptr;
+    receivedToken_ = {};
+  } // stop
+
+  bool WinRtScanBackend::running() const {
+    return watcher_ != nullptr && watcher_.Status() == BluetoothLEAdvertisementWatcherStatus::Started;
+  } // running
+} // namespace layrz_ble
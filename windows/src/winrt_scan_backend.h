@@ -0,0 +1,31 @@
+#pragma once
+
+#include <winrt/Windows.Devices.Bluetooth.Advertisement.h>
+
+#include <atomic>
+
+#include "scan_backend.h"
+
+namespace layrz_ble {
+  using namespace winrt::Windows::Devices::Bluetooth::Advertisement;
+
+  /// @brief ScanBackend of the WinRT advertisement watcher, in active scanning mode
+  class WinRtScanBackend : public ScanBackend {
+    public:
+      WinRtScanBackend() = default;
+      ~WinRtScanBackend() override { stop(); }
+
+      WinRtScanBackend(const WinRtScanBackend &) = delete;
+      WinRtScanBackend &operator=(const WinRtScanBackend &) = delete;
+
+      bool start(Sink sink) override;
+      void stop() override;
+      bool running() const override;
+      void keepRaw(bool keep) override { keepRaw_.store(keep, std::memory_order_relaxed); }
+
+    private:
+      BluetoothLEAdvertisementWatcher watcher_{nullptr};
+      winrt::event_token receivedToken_{};
+      std::atomic<bool> keepRaw_{false};
+  }; // class WinRtScanBackend
+} // namespace layrz_ble